@@ -1,10 +1,12 @@
 """
 colour.py
 
-NakedMud's base colour module. Contains functions for outbound text processing
-to add ASCII colour codes to the text.
+NakedMud's base colour module. Colour codes in outbound text (e.g. {r, {G, {n)
+are turned into ASCII colour codes by the mud itself when output is flushed.
+This module holds the base colour symbols, and lets new colour codes be added
+on top of them.
 """
-import mud, mudsock, hooks
+import mud, mudsock
 
 
 
@@ -25,68 +27,28 @@ c_magenta = 'p'
 c_cyan    = 'c'
 c_white   = 'w'
 
-# maps of colour symbols to their ASCII number type thing
+# maps of colour symbols to their ASCII number type thing. These are built
+# into the mud; they are only here for reference
 base_colours = { c_none    : '0',
-                 c_dark    : '30',  
-                 c_red     : '31',  
-                 c_green   : '32',  
-                 c_yellow  : '33',  
-                 c_blue    : '34',  
-                 c_magenta : '35',  
-                 c_cyan    : '36',  
+                 c_dark    : '30',
+                 c_red     : '31',
+                 c_green   : '32',
+                 c_yellow  : '33',
+                 c_blue    : '34',
+                 c_magenta : '35',
+                 c_cyan    : '36',
                  c_white   : '37' }
 
 
 
 ################################################################################
-# colour processing hooks
+# adding new colours
 ################################################################################
-def process_colour_hook(info):
-    """When outbound text is being processed, find colour codes and replace them
-       by the proper colour escape sequences."""
-    sock,  = hooks.parse_info(info)
-    buf    = sock.outbound_text
-    newbuf = []
-
-    # go through our outbound text and process all of the colour codes
-    i = 0
-    while i < len(buf):
-        if buf[i] == base_colour_marker and i + 1 < len(buf):
-            i = i + 1
-            char  = buf[i]
-
-            # upper case is bright, lower case is dark
-            shade = cLIGHT
-            if char == char.lower():
-                shade = cDARK
-
-            # if it's a valid colour code, build it
-            if base_colours.has_key(char.lower()):
-                newbuf.append(colour_start + shade + ';' + \
-                              base_colours[char.lower()] + 'm')
-
-            # if it was an invalid code, ignore it
-            else:
-                newbuf.append(base_colour_marker)
-                if not char == base_colour_marker:
-                    i = i - 1
-
-        else:
-            newbuf.append(buf[i])
-        i = i + 1
-
-    # replace our outbound buffer with the processed text
-    sock.outbound_text = ''.join(newbuf)
-
-
-
-################################################################################
-# initializing and unloading our hooks
-################################################################################
-hooks.add("process_outbound_text",   process_colour_hook)
-hooks.add("process_outbound_prompt", process_colour_hook)
-
-def __unload__():
-    '''detaches our colour module from the game'''
-    hooks.remove("process_outbound_text",   process_colour_hook)
-    hooks.remove("process_outbound_prompt", process_colour_hook)
+def add_colour(symbol, number):
+    """Add a new colour symbol, using the given ASCII colour number. The lower
+       case symbol becomes the dark shade of the colour, and the upper case
+       symbol the bright shade."""
+    mudsock.add_colour_code(symbol.lower(),
+                            colour_start + cDARK  + ';' + number + 'm')
+    mudsock.add_colour_code(symbol.upper(),
+                            colour_start + cLIGHT + ';' + number + 'm')
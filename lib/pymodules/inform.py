@@ -88,7 +88,7 @@ def list_room_exits(ch, room, filter_compass = False):
 
 def list_one_furniture(ch, obj):
     '''list the contents of a piece of furniture to the character.'''
-    sitters = obj.chars
+    sitters = list(obj.chars)
     am_on   = ch in sitters
     if am_on:
         sitters.remove(ch)
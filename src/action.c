@@ -7,6 +7,12 @@
 // may only be taking 1 action at a time, and any time a new action for a
 // character is added, the previous one is terminated.
 //
+// Oct 16/26
+//  * actions are now kept in a timing wheel (see timer_wheel.h), so pulsing
+//    only touches the actions that complete on that pulse, and they complete
+//    in order of their remaining delay. Each character keeps its own chain of
+//    actions, so is_acting and interrupt_action never look at anyone else's.
+//
 // Dec 15/04
 //  * expanded actions to support actions for different places (e.g mental, 
 //    feet, left/right hands). 
@@ -31,6 +37,7 @@
 #include "mud.h"
 #include "utils.h"
 #include "character.h"
+#include "timer_wheel.h"
 #include "action.h"
 #include "hooks.h"
 
@@ -39,15 +46,21 @@
 #endif
 
 typedef struct action_data ACTION_DATA;
-MAP *actors = NULL;
+
+// all of the actions being taken, ordered by when they complete
+TIMER_WHEEL *actions = NULL;
 
 struct action_data {
   void (*  on_complete)(void *ch, void *data, bitvector_t where, char *arg);
   void (* on_interrupt)(void *ch, void *data, bitvector_t where, char *arg);
   bitvector_t where; // which bodyparts are participating in the action?
-  int   delay;       // how much longer until the action is complete?
+  void *ch;    // the character taking the action
   void *data;  // data for the action (e.g. spell data, char mining state)
   char *arg;   // an argument supplied to an action (e.g. the target of a kick)
+
+  TIMER_NODE   timer; // our place in the action wheel
+  ACTION_DATA  *prev; // the character's other actions
+  ACTION_DATA  *next; //
 };
 
 
@@ -55,7 +68,7 @@ struct action_data {
 //*****************************************************************************
 // single action handling
 //*****************************************************************************
-ACTION_DATA *newAction(int delay, 	
+ACTION_DATA *newAction(void *ch,
 		       bitvector_t where,
 		       void *on_complete,
 		       void *on_interrupt,
@@ -63,10 +76,13 @@ ACTION_DATA *newAction(int delay,
   struct action_data *action = malloc(sizeof(ACTION_DATA));
   action->on_complete  = on_complete;
   action->on_interrupt = on_interrupt;
-  action->delay        = delay;
+  action->ch           = ch;
   action->data         = data;
   action->arg          = strdupsafe(arg);
   action->where        = where;
+  action->prev         = NULL;
+  action->next         = NULL;
+  timerNodeInit(&action->timer, action);
   return action;
 }
 
@@ -80,6 +96,30 @@ void run_action(void *ch, ACTION_DATA *action) {
     action->on_complete(ch, action->data, action->where, action->arg);
 }
 
+//
+// attach an action to the front of its character's chain
+void action_link(ACTION_DATA *action) {
+  ACTION_DATA *first = charGetActions(action->ch);
+  action->prev = NULL;
+  action->next = first;
+  if(first != NULL)
+    first->prev = action;
+  charSetActions(action->ch, action);
+}
+
+//
+// take an action out of its character's chain, and out of the wheel
+void action_unlink(ACTION_DATA *action) {
+  if(action->prev != NULL)
+    action->prev->next = action->next;
+  else
+    charSetActions(action->ch, action->next);
+  if(action->next != NULL)
+    action->next->prev = action->prev;
+  action->prev = action->next = NULL;
+  timerWheelRemove(actions, &action->timer);
+}
+
 
 // used to kill all of a character's actions on death
 void stop_all_actions(CHAR_DATA *ch) {
@@ -91,9 +131,9 @@ void stop_all_actions(CHAR_DATA *ch) {
 }
 
 // allows stop_all_actions to run as a hook
-void stop_actions_hook(const char *info) {
+void stop_actions_hook(HOOK_ARGS *args) {
   CHAR_DATA *ch = NULL;
-  hookParseInfo(info, &ch);
+  hookArgsParse(args, &ch);
   stop_all_actions(ch);
 }
 
@@ -103,68 +143,43 @@ void stop_actions_hook(const char *info) {
 // actor list handling
 //*****************************************************************************
 void init_actions() {
-  // use the standard pointer hasher and comparator
-  actors = newMap(NULL, NULL);
+  actions = newTimerWheel();
 
   // make sure the character does not continue actions after being extracted
-  hookAdd("char_from_game", stop_actions_hook);
+  hookAddTyped("char_from_game", stop_actions_hook);
 }
 
 bool is_acting(void *ch, bitvector_t where) {
-  LIST *actions = mapGet(actors, ch);
-  if(actions == NULL || listSize(actions) == 0)
-    return FALSE;
+  ACTION_DATA *action = NULL;
 
-  bool action_found    = FALSE;
-  LIST_ITERATOR *act_i = newListIterator(actions);
-  ACTION_DATA  *action = NULL;
-
-  // iterate across all of our current actions and see if any
+  // go across all of our current actions and see if any
   // involve the faculties of "where"
-  ITERATE_LIST(action, act_i) {
-    if(IS_SET(action->where, where)) {
-      action_found = TRUE;
-      break;
-    }
-  } deleteListIterator(act_i);
-
-  return action_found;
+  for(action = charGetActions(ch); action != NULL; action = action->next)
+    if(IS_SET(action->where, where))
+      return TRUE;
+  return FALSE;
 }
 
 void interrupt_action(void *ch, bitvector_t where) {
-  // get the list of all the actions we're performing
-  LIST *actions = mapGet(actors, ch);
-  if(actions == NULL)
-    return;
-
-  // if we have actions, go through and stop 'em all
-  if(listSize(actions) > 0) {
-    LIST_ITERATOR *act_i = newListIterator(actions);
-    ACTION_DATA *action  = NULL;
-
-    ITERATE_LIST(action, act_i) {
-      // check to see if we've found an action that needs interruption
-      if(IS_SET(action->where, where)) {
-	if(action->on_interrupt)
-	  action->on_interrupt(ch, action->data, action->where, action->arg);
-	listRemove(actions, action);
-	deleteAction(action);
-      }
-    } deleteListIterator(act_i);
+  ACTION_DATA *action = NULL, *next = NULL, *stopped = NULL;
+
+  // pull out everything that needs interrupting before we run any of the
+  // interrupt functions; they might start or stop other actions on us
+  for(action = charGetActions(ch); action != NULL; action = next) {
+    next = action->next;
+    if(IS_SET(action->where, where)) {
+      action_unlink(action);
+      action->next = stopped;
+      stopped      = action;
+    }
   }
 
-  // if all of the actions are gone, delete the list
-  if(listSize(actions) == 0) {
-    /*
-     * Nope! We can't do this. If we interrupt an action midway through
-     * processing actions and the list gets deleted, the iterator over it will
-     * blow up when we try to delete it. Instead, deletion will now occur when
-     * we try to process actions and realize there is nothing in the list to
-     * process.
-     *
-    mapRemove(actors, ch);
-    deleteList(actions);
-    */
+  // now, let everyone know they were interrupted
+  while((action = stopped) != NULL) {
+    stopped = action->next;
+    if(action->on_interrupt)
+      action->on_interrupt(ch, action->data, action->where, action->arg);
+    deleteAction(action);
   }
 }
 
@@ -176,55 +191,26 @@ void start_action(void           *ch,
 		  void         *data,
 		  const char    *arg) {
   interrupt_action(ch, where);
-  ACTION_DATA *newact = newAction(delay, where, on_complete, 
+  ACTION_DATA *newact = newAction(ch, where, on_complete, 
 				  on_interrupt, data, arg);
-  // get the current list
-  LIST *curr_acts     = mapGet(actors, ch);
-  
-  // if it's null, make a new one and add it to the map of actions
-  if(curr_acts == NULL) {
-    curr_acts = newList();
-    mapPut(actors, ch, curr_acts);
-  }
+  action_link(newact);
 
-  listPut(curr_acts, newact);
+  // actions always take at least one pulse to complete
+  timerWheelAdd(actions, &newact->timer, MAX(1, delay));
 }
 
 void pulse_actions(int time) {
-  MAP_ITERATOR    *ch_i = newMapIterator(actors);
-  ACTION_DATA   *action = NULL;
-  LIST_ITERATOR  *act_i = NULL;
-  LIST         *actions = NULL;
-  const CHAR_DATA *map_actor = NULL;
-  CHAR_DATA         *ch = NULL;
-
-  ITERATE_MAP(map_actor, actions, ch_i) {
-    actions = mapIteratorCurrentVal(ch_i);
-
-    // weird, we shouldn't be in here
-    if(listSize(actions) == 0) {
-      mapRemove(actors, map_actor);
-      deleteList(actions);
-    }
-    // if we have actions, then go through 'em all
-    else {
-      // eek... small problem. The key for maps is constant, but we need
-      // a non-constant character to send to run_action. Let's get the char's
-      // UID, and re-look him up in the player table
-      ch = propertyTableGet(mob_table, charGetUID(map_actor));
-
-      act_i = newListIterator(actions);
-
-      ITERATE_LIST(action, act_i) {
-	// decrement the delay
-	action->delay -= time;
-	// pop the action from the list, and run it
-	if(action->delay <= 0) {
-	  listRemove(actions, action);
-	  run_action(ch, action);
-	  deleteAction(action);
-	}
-      } deleteListIterator(act_i);
+  TIMER_NODE *timer = NULL;
+
+  for(; time > 0; time--) {
+    timerWheelAdvance(actions);
+
+    // pop everything that has completed, and run it
+    while((timer = timerWheelPop(actions)) != NULL) {
+      ACTION_DATA *action = timerNodeElem(timer);
+      action_unlink(action);
+      run_action(action->ch, action);
+      deleteAction(action);
     }
-  } deleteMapIterator(ch_i);
+  }
 }
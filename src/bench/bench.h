@@ -0,0 +1,56 @@
+#ifndef BENCH_H
+#define BENCH_H
+//*****************************************************************************
+//
+// bench.h
+//
+// Odds and ends shared by the micro-benchmarks in this directory. The
+// benchmarks are not part of the mud; they are built with "make bench" from
+// the src directory, and each one links against only the pieces of the mud
+// it is measuring.
+//
+//*****************************************************************************
+
+#include <time.h>
+
+//
+// the current time, in nanoseconds, from a clock that never goes backwards
+static inline double bench_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+//
+// hashtable implementations, as seen by hash_bench. The functions are kept as
+// void pointers so the old and new tables can be described the same way
+typedef struct bench_hash_api {
+  const char *name;
+  void *(* new)(void);
+  void  (* delete)(void *table);
+  int   (* put)(void *table, const char *key, void *val);
+  void *(* get)(void *table, const char *key);
+  void *(* remove)(void *table, const char *key);
+  void *(* new_iterator)(void *table);
+  void  (* delete_iterator)(void *I);
+  void  (* iterator_next)(void *I);
+  const char *(* iterator_key)(void *I);
+} BENCH_HASH_API;
+
+//
+// list implementations, as seen by list_bench. iterator_start is handed a
+// buffer it may use for the iterator instead of allocating one
+typedef struct bench_list_api {
+  const char *name;
+  void *(* new)(void);
+  void  (* delete)(void *list);
+  void  (* put)(void *list, void *elem);
+  void  (* queue)(void *list, void *elem);
+  int   (* remove)(void *list, const void *elem);
+  void *(* iterator_start)(void *buf, void *list);
+  void  (* iterator_stop)(void *I);
+  void *(* iterator_current)(void *I);
+  void *(* iterator_next)(void *I);
+} BENCH_LIST_API;
+
+#endif // BENCH_H
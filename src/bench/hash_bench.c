@@ -0,0 +1,192 @@
+//*****************************************************************************
+//
+// hash_bench.c
+//
+// Times the hashtable in hashtable.c against the list-of-buckets table it
+// replaced (see hashtable_old.c). The workloads are meant to look like the
+// ways the mud uses its tables: lots of tiny tables (auxiliary data, storage
+// sets, room exits) that are mostly read from, and a few big ones (the world's
+// prototypes, zones, hooks) that are read from constantly.
+//
+// usage: ./hash_bench [scale]
+//   scale multiplies how many operations each workload does. Defaults to 1
+//
+//*****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../list.h"
+#include "../hashtable.h"
+#include "bench.h"
+
+
+
+//*****************************************************************************
+// local datastructures, functions, and defines
+//*****************************************************************************
+
+// the tables we're comparing. The old one lives in hashtable_old.c
+extern BENCH_HASH_API old_hash_api;
+BENCH_HASH_API new_hash_api = {
+  "open addressing",
+  (void *)newHashtable,
+  (void *)deleteHashtable,
+  (void *)hashPut,
+  (void *)hashGet,
+  (void *)hashRemove,
+  (void *)newHashIterator,
+  (void *)deleteHashIterator,
+  (void *)hashIteratorNext,
+  (void *)hashIteratorCurrentKey,
+};
+
+// make sure the compiler can't throw our lookups away
+volatile unsigned long bench_sink = 0;
+
+//
+// make a set of keys that look something like the mud's prototype keys,
+// which are name@zone
+char **bench_make_keys(int num, const char *fmt) {
+  char **keys = malloc(sizeof(char *) * num);
+  char   buf[64];
+  int i;
+  for(i = 0; i < num; i++) {
+    snprintf(buf, sizeof(buf), fmt, i, i % 37);
+    keys[i] = strdup(buf);
+  }
+  return keys;
+}
+
+void bench_free_keys(char **keys, int num) {
+  int i;
+  for(i = 0; i < num; i++)
+    free(keys[i]);
+  free(keys);
+}
+
+//
+// print out how long one operation took, on average, for both tables
+void bench_report(const char *what, double old_ns, double new_ns, long ops) {
+  printf("%-34s %10.1f %10.1f %8.2fx\n", what, old_ns / ops, new_ns / ops,
+	 old_ns / new_ns);
+}
+
+//
+// a big table: fill it, look up everything in it many times over, look up
+// keys that aren't there, walk over it, and then empty it out
+void bench_big_table(BENCH_HASH_API *api, int num_keys, int rounds,
+		     double *times) {
+  char **keys   = bench_make_keys(num_keys, "proto_%d@zone%d");
+  char **misses = bench_make_keys(num_keys, "missing_%d@zone%d");
+  void  *table  = api->new();
+  double start;
+  int i, round;
+
+  start = bench_now();
+  for(i = 0; i < num_keys; i++)
+    api->put(table, keys[i], keys[i]);
+  times[0] += bench_now() - start;
+
+  start = bench_now();
+  for(round = 0; round < rounds; round++)
+    for(i = 0; i < num_keys; i++)
+      bench_sink += (unsigned long)api->get(table, keys[i]);
+  times[1] += bench_now() - start;
+
+  start = bench_now();
+  for(round = 0; round < rounds; round++)
+    for(i = 0; i < num_keys; i++)
+      bench_sink += (unsigned long)api->get(table, misses[i]);
+  times[2] += bench_now() - start;
+
+  start = bench_now();
+  for(round = 0; round < rounds; round++) {
+    void *I = api->new_iterator(table);
+    const char *key;
+    for(; (key = api->iterator_key(I)) != NULL; api->iterator_next(I))
+      bench_sink += key[0];
+    api->delete_iterator(I);
+  }
+  times[3] += bench_now() - start;
+
+  start = bench_now();
+  for(i = 0; i < num_keys; i++)
+    bench_sink += (unsigned long)api->remove(table, keys[i]);
+  times[4] += bench_now() - start;
+
+  api->delete(table);
+  bench_free_keys(keys, num_keys);
+  bench_free_keys(misses, num_keys);
+}
+
+//
+// lots of small tables, like the auxiliary data every character, object and
+// room carries around. Time creating and filling them, and reading from them
+void bench_small_tables(BENCH_HASH_API *api, int num_tables, int rounds,
+			double *times) {
+  const char *aux[] = { "dyn_var_data", "alias_data", "worn_data",
+			"quest_data", "persistent_data", "stats_data" };
+  int num_aux = sizeof(aux) / sizeof(aux[0]);
+  void **tables = malloc(sizeof(void *) * num_tables);
+  double start;
+  int i, j, round;
+
+  start = bench_now();
+  for(i = 0; i < num_tables; i++) {
+    tables[i] = api->new();
+    for(j = 0; j < num_aux; j++)
+      api->put(tables[i], aux[j], tables);
+  }
+  times[0] += bench_now() - start;
+
+  start = bench_now();
+  for(round = 0; round < rounds; round++)
+    for(i = 0; i < num_tables; i++)
+      bench_sink += (unsigned long)api->get(tables[i], aux[round % num_aux]);
+  times[1] += bench_now() - start;
+
+  start = bench_now();
+  for(i = 0; i < num_tables; i++)
+    api->delete(tables[i]);
+  times[2] += bench_now() - start;
+  free(tables);
+}
+
+
+
+//*****************************************************************************
+// the benchmark itself
+//*****************************************************************************
+int main(int argc, char **argv) {
+  int    scale = (argc > 1 ? atoi(argv[1]) : 1);
+  int big_keys = 50000, big_rounds;
+  int   tables = 20000, small_rounds;
+  double big_old[5] = { 0 }, big_new[5] = { 0 };
+  double small_old[3] = { 0 }, small_new[3] = { 0 };
+  long   big_ops;
+
+  if(scale < 1)
+    scale = 1;
+  big_rounds   = 20 * scale;
+  small_rounds = 50 * scale;
+  big_ops      = (long)big_keys * big_rounds;
+
+  bench_big_table(&old_hash_api, big_keys, big_rounds, big_old);
+  bench_big_table(&new_hash_api, big_keys, big_rounds, big_new);
+  bench_small_tables(&old_hash_api, tables, small_rounds, small_old);
+  bench_small_tables(&new_hash_api, tables, small_rounds, small_new);
+
+  printf("ns per operation %20s %10s %10s %9s\n", "", old_hash_api.name,
+	 new_hash_api.name, "speedup");
+  bench_report("put, 50k keys",        big_old[0], big_new[0], big_keys);
+  bench_report("get, hit",             big_old[1], big_new[1], big_ops);
+  bench_report("get, miss",            big_old[2], big_new[2], big_ops);
+  bench_report("iterate, per key",     big_old[3], big_new[3], big_ops);
+  bench_report("remove",               big_old[4], big_new[4], big_keys);
+  bench_report("new + 6 puts, small",  small_old[0], small_new[0], tables);
+  bench_report("get, small table",     small_old[1], small_new[1],
+	       (long)tables * small_rounds);
+  bench_report("delete, small table",  small_old[2], small_new[2], tables);
+  return 0;
+}
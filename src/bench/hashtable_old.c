@@ -0,0 +1,370 @@
+//*****************************************************************************
+//
+// hashtable_old.c
+//
+// The list-of-buckets hashtable that was used before hashtable.c went flat
+// and open-addressed, kept around so hash_bench has something to compare the
+// current implementation against. Only what hash_bench calls is kept. Its
+// functions are renamed so both can be linked into the same program; the code
+// itself is left as it was, along with the pearson hashing it used from
+// utils.c.
+//
+//*****************************************************************************
+
+#include <stdlib.h>
+#include <ctype.h>
+#include <string.h>
+
+#define newHashtableSize        oldNewHashtableSize
+#define newHashtable            oldNewHashtable
+#define deleteHashtable         oldDeleteHashtable
+#define hashPut                 oldHashPut
+#define hashGet                 oldHashGet
+#define hashRemove              oldHashRemove
+#define hashExpand              oldHashExpand
+#define newHashIterator         oldNewHashIterator
+#define deleteHashIterator      oldDeleteHashIterator
+#define hashIteratorReset       oldHashIteratorReset
+#define hashIteratorNext        oldHashIteratorNext
+#define hashIteratorCurrentKey  oldHashIteratorCurrentKey
+#define hashGetEntry            oldHashGetEntry
+#define newHashtableEntry       oldNewHashtableEntry
+#define deleteHashtableEntry    oldDeleteHashtableEntry
+#define hashCollectEntries      oldHashCollectEntries
+
+#include "../list.h"
+#include "../hashtable.h"
+#include "bench.h"
+
+static unsigned long string_hash(const char *key);
+
+// how big of a size do our hashtables start out at?
+#define DEFAULT_HASH_SIZE        5
+
+struct hashtable_iterator {
+  unsigned int curr_bucket;
+  HASHTABLE *table;
+  LIST_ITERATOR *bucket_i;
+};
+
+typedef struct hashtable_entry {
+  char *key;
+  void *val;
+} HASH_ENTRY;
+
+struct hashtable {
+  int size;
+  int num_buckets;
+  LIST **buckets;
+};
+
+
+//
+// an internal form of hashGet that returns the entire entry (key and val)
+HASH_ENTRY *hashGetEntry(HASHTABLE *table, const char *key){
+  unsigned int bucket = string_hash(key) % table->num_buckets;
+
+  if(table->buckets[bucket] == NULL)
+    return NULL;
+  else {
+    LIST_ITERATOR *list_i = newListIterator(table->buckets[bucket]);
+    HASH_ENTRY      *elem = NULL;
+
+    for(;(elem = listIteratorCurrent(list_i)) != NULL; listIteratorNext(list_i))
+      if(!strcasecmp(key, elem->key))
+	break;
+    deleteListIterator(list_i);
+
+    return elem;
+  }
+}
+
+HASH_ENTRY *newHashtableEntry(const char *key, void *val) {
+  HASH_ENTRY *entry = malloc(sizeof(HASH_ENTRY));
+  entry->key = strdup(key);
+  entry->val = val;
+  return entry;
+}
+
+void deleteHashtableEntry(HASH_ENTRY *entry) {
+  if(entry->key) free(entry->key);
+  free(entry);
+}
+
+//
+// Collect all of the HASH_ENTRYs in a hashtable into a single list
+LIST *hashCollectEntries(HASHTABLE *table) {
+  LIST *list = newList();
+  int i;
+  for(i = 0; i < table->num_buckets; i++) {
+    if(table->buckets[i] == NULL) continue;
+    LIST_ITERATOR *list_i = newListIterator(table->buckets[i]);
+    HASH_ENTRY      *elem = NULL;
+    for(;(elem=listIteratorCurrent(list_i)) != NULL;listIteratorNext(list_i))
+      listPut(list, elem);
+    deleteListIterator(list_i);
+  }
+  return list;
+}
+
+
+
+//*****************************************************************************
+// implementation of hashtable.h
+// documentation in hashtable.h
+//*****************************************************************************
+HASHTABLE *newHashtableSize(int num_buckets) {
+  int i;
+  HASHTABLE *table   = malloc(sizeof(HASHTABLE));
+  table->num_buckets = num_buckets;
+  table->size        = 0;
+  table->buckets = malloc(sizeof(LIST *) * num_buckets);
+  for(i = 0; i < num_buckets; i++)
+    table->buckets[i] = NULL;
+  return table;
+}
+
+HASHTABLE *newHashtable(void) {
+  return newHashtableSize(DEFAULT_HASH_SIZE);
+}
+
+
+void  deleteHashtable(HASHTABLE *table) {
+  int i;
+  for(i = 0; i < table->num_buckets; i++) {
+    if(table->buckets[i])
+      deleteListWith(table->buckets[i], deleteHashtableEntry);
+  }
+
+  free(table->buckets);
+  free(table);
+}
+
+//
+// expand a hashtable to the new size
+void hashExpand(HASHTABLE *table, int size) {
+  // collect all of the key:value pairs
+  LIST     *entries = hashCollectEntries(table);
+  HASH_ENTRY *entry = NULL;
+  int i;
+
+  // delete all of the current buckets
+  for(i = 0; i < table->num_buckets; i++) {
+    if(table->buckets[i] == NULL) continue;
+    deleteList(table->buckets[i]);
+  }
+  free(table->buckets);
+
+  // now, make new buckets and set them to NULL
+  table->buckets = calloc(size, sizeof(LIST *));
+  table->num_buckets = size;
+
+  // now, we put all of our entries back into the new buckets
+  while((entry = listPop(entries)) != NULL) {
+    unsigned int bucket = string_hash(entry->key) % table->num_buckets;
+    if(table->buckets[bucket] == NULL) table->buckets[bucket] = newList();
+    listPut(table->buckets[bucket], entry);
+  }
+  deleteList(entries);
+}
+
+
+int hashPut(HASHTABLE *table, const char *key, void *val) {
+  HASH_ENTRY *elem = hashGetEntry(table, key);
+
+  // if it's already in, update the value
+  if(elem) {
+    elem->val = val;
+    return 1;
+  }
+  else {
+    // first, see if we'll need to expand the table
+    if((table->size * 80)/100 > table->num_buckets)
+      hashExpand(table, (table->num_buckets * 150)/100);
+
+    unsigned int bucket = string_hash(key) % table->num_buckets;
+
+    // if the bucket doesn't exist yet, create it
+    if(table->buckets[bucket] == NULL)
+      table->buckets[bucket] = newList();
+
+    HASH_ENTRY *entry = newHashtableEntry(key, val);
+    listPut(table->buckets[bucket], entry);
+    table->size++;
+    return 1;
+  }
+}
+
+void *hashGet(HASHTABLE *table, const char *key) {
+  HASH_ENTRY *elem = hashGetEntry(table, key);
+  if(elem != NULL)
+    return elem->val;
+  else
+    return NULL;
+}
+
+void *hashRemove(HASHTABLE *table, const char *key) {
+  unsigned int bucket = string_hash(key) % table->num_buckets;
+
+  if(table->buckets[bucket] == NULL)
+    return NULL;
+  else {
+    LIST_ITERATOR *list_i = newListIterator(table->buckets[bucket]);
+    HASH_ENTRY *elem = NULL;
+
+    for(;(elem = listIteratorCurrent(list_i)) != NULL; listIteratorNext(list_i))
+      if(!strcasecmp(key, elem->key))
+	break;
+    deleteListIterator(list_i);
+
+    if(elem) {
+      void *val = elem->val;
+      listRemove(table->buckets[bucket], elem);
+      deleteHashtableEntry(elem);
+      table->size--;
+      return val;
+    }
+    else
+      return NULL;
+  }
+}
+
+
+
+//*****************************************************************************
+// implementation of the hashtable iterator
+// documentation in hashtable.h
+//*****************************************************************************
+HASH_ITERATOR *newHashIterator(HASHTABLE *table) {
+  HASH_ITERATOR *I = malloc(sizeof(HASH_ITERATOR));
+  I->table = table;
+  I->bucket_i = NULL;
+  hashIteratorReset(I);
+
+  return I;
+}
+
+void        deleteHashIterator     (HASH_ITERATOR *I) {
+  if(I->bucket_i) deleteListIterator(I->bucket_i);
+  free(I);
+}
+
+void        hashIteratorReset      (HASH_ITERATOR *I) {
+  int i;
+
+  if(I->bucket_i) deleteListIterator(I->bucket_i);
+  I->bucket_i = NULL;
+  I->curr_bucket = 0;
+
+  // bucket_i will be NULL if there are no elements
+  for(i = 0; i < I->table->num_buckets; i++) {
+    if(I->table->buckets[i] != NULL &&
+       listSize(I->table->buckets[i]) > 0) {
+      I->curr_bucket = i;
+      I->bucket_i = newListIterator(I->table->buckets[i]);
+      break;
+    }
+  }
+}
+
+
+void        hashIteratorNext       (HASH_ITERATOR *I) {
+  // no elements in the hashtable
+  if(I->bucket_i == NULL) 
+    return;
+  // we're at the end of our list
+  else if(listIteratorNext(I->bucket_i) == NULL) {
+    deleteListIterator(I->bucket_i);
+    I->bucket_i = NULL;
+    I->curr_bucket++;
+    
+    for(; I->curr_bucket < I->table->num_buckets; I->curr_bucket++) {
+      if(I->table->buckets[I->curr_bucket] != NULL &&
+	 listSize(I->table->buckets[I->curr_bucket]) > 0) {
+	I->bucket_i = newListIterator(I->table->buckets[I->curr_bucket]);
+	break;
+      }
+    }
+  }
+}
+
+
+const char *hashIteratorCurrentKey (HASH_ITERATOR *I) {
+  if(!I->bucket_i) 
+    return NULL;
+  else {
+    HASH_ENTRY *entry = listIteratorCurrent(I->bucket_i);
+    if(entry)
+      return entry->key;
+    else
+      return NULL;
+  }
+}
+
+
+//*****************************************************************************
+// the hashing the old table used, from utils.c
+//*****************************************************************************
+//
+// hashing array 1 for pearson hashing
+static int old_pearson_table1[] = { 66, 93, 11, 153, 155, 113, 214, 132, 91, 193, 240, 82, 175, 145, 84, 34, 76, 217, 250, 230, 139, 172, 65, 254, 196, 56, 165, 116, 48, 219, 199, 142, 35, 27, 210, 149, 45, 127, 41, 150, 85, 87, 253, 100, 234, 216, 192, 226, 154, 106, 78, 146, 131, 38, 120, 151, 177, 29, 50, 231, 68, 168, 227, 161, 126, 141, 36, 191, 110, 81, 197, 190, 9, 236, 140, 0, 20, 162, 23, 189, 42, 130, 117, 86, 243, 123, 237, 249, 64, 135, 61, 167, 39, 57, 96, 148, 118, 13, 235, 188, 19, 71, 49, 115, 21, 182, 15, 200, 179, 251, 75, 77, 204, 32, 180, 16, 218, 22, 171, 88, 30, 248, 47, 238, 105, 94, 92, 67, 28, 69, 33, 215, 1, 7, 241, 109, 209, 98, 12, 208, 156, 52, 195, 89, 185, 55, 170, 104, 17, 173, 122, 138, 4, 202, 136, 247, 169, 222, 163, 211, 144, 252, 2, 186, 201, 40, 207, 107, 18, 24, 46, 129, 44, 14, 174, 26, 124, 194, 37, 223, 102, 183, 99, 114, 70, 158, 53, 111, 147, 119, 73, 152, 79, 203, 157, 221, 10, 97, 133, 62, 229, 178, 205, 184, 164, 176, 198, 80, 58, 245, 31, 59, 128, 101, 60, 181, 246, 232, 63, 143, 121, 213, 187, 206, 43, 134, 6, 225, 228, 72, 54, 233, 224, 5, 8, 239, 112, 244, 255, 137, 3, 74, 108, 159, 83, 125, 103, 51, 220, 25, 166, 90, 160, 212, 95, 242 };
+
+static int old_pearson_table2[] = { 202, 142, 134, 22, 233, 237, 13, 31, 41, 97, 141, 148, 74, 165, 7, 162, 53, 117, 210, 226, 174, 88, 5, 163, 17, 49, 170, 99, 93, 39, 69, 108, 207, 244, 254, 101, 159, 30, 188, 67, 235, 150, 24, 136, 208, 221, 234, 43, 96, 12, 78, 10, 25, 81, 239, 120, 37, 21, 42, 183, 121, 213, 14, 161, 137, 23, 9, 255, 245, 209, 222, 236, 119, 199, 216, 71, 115, 110, 63, 107, 173, 70, 20, 89, 91, 102, 227, 1, 177, 113, 104, 111, 253, 181, 95, 243, 72, 6, 124, 131, 190, 86, 164, 85, 251, 3, 50, 154, 217, 155, 8, 105, 82, 28, 75, 147, 0, 80, 252, 140, 29, 2, 242, 160, 57, 34, 247, 167, 47, 126, 144, 168, 18, 231, 44, 58, 206, 77, 125, 171, 36, 76, 98, 26, 241, 180, 61, 151, 194, 15, 45, 84, 212, 32, 196, 92, 192, 139, 112, 229, 100, 109, 189, 248, 156, 94, 153, 145, 127, 146, 175, 138, 215, 195, 198, 128, 182, 218, 19, 250, 132, 40, 214, 103, 83, 73, 106, 133, 135, 186, 123, 219, 158, 38, 152, 232, 116, 64, 172, 52, 200, 204, 240, 224, 203, 249, 59, 157, 114, 191, 230, 48, 166, 122, 65, 228, 184, 4, 205, 220, 225, 62, 169, 79, 27, 197, 11, 87, 193, 179, 223, 56, 68, 178, 187, 149, 143, 16, 55, 35, 201, 118, 185, 51, 66, 33, 54, 176, 60, 46, 211, 246, 238, 130, 90, 129 };
+
+static int old_pearson_table3[] = { 44, 181, 139, 127, 174, 243, 236, 14, 5, 200, 235, 180, 195, 185, 193, 116, 161, 110, 72, 121, 9, 3, 104, 224, 136, 182, 15, 94, 222, 84, 186, 20, 239, 147, 21, 34, 183, 93, 61, 164, 189, 89, 17, 226, 56, 205, 176, 51, 128, 201, 73, 75, 190, 163, 96, 178, 102, 33, 150, 130, 98, 76, 120, 240, 79, 158, 24, 196, 78, 4, 202, 168, 48, 255, 227, 97, 138, 101, 207, 170, 58, 27, 45, 225, 179, 215, 251, 123, 209, 38, 63, 36, 6, 175, 62, 208, 86, 65, 107, 188, 249, 146, 198, 194, 254, 230, 253, 103, 46, 133, 192, 26, 108, 219, 191, 77, 137, 81, 145, 66, 91, 106, 7, 10, 29, 95, 165, 88, 119, 151, 40, 22, 1, 122, 114, 134, 37, 214, 217, 68, 0, 83, 199, 70, 80, 156, 140, 144, 90, 118, 42, 173, 111, 157, 204, 171, 212, 241, 53, 11, 148, 135, 206, 172, 23, 109, 13, 220, 245, 197, 177, 47, 59, 210, 49, 74, 54, 25, 234, 115, 43, 169, 218, 50, 87, 31, 143, 248, 69, 92, 160, 141, 41, 228, 184, 233, 117, 2, 231, 252, 28, 216, 125, 153, 18, 100, 166, 8, 52, 124, 250, 132, 67, 244, 12, 246, 32, 64, 213, 242, 247, 223, 82, 131, 112, 221, 113, 155, 71, 211, 60, 129, 149, 237, 30, 85, 55, 152, 229, 35, 232, 187, 19, 105, 203, 39, 159, 238, 167, 162, 57, 126, 99, 154, 142, 16 };
+
+static int old_pearson_table4[] = { 231, 223, 174, 160, 113, 173, 104, 49, 122, 229, 13, 8, 232, 81, 38, 90, 64, 131, 123, 176, 33, 84, 166, 241, 16, 190, 159, 144, 189, 193, 66, 137, 163, 162, 111, 26, 15, 9, 1, 119, 255, 136, 167, 178, 94, 130, 114, 32, 110, 99, 78, 153, 239, 179, 243, 249, 133, 76, 86, 242, 165, 169, 19, 155, 152, 67, 215, 220, 36, 24, 213, 105, 117, 168, 128, 204, 248, 238, 177, 161, 222, 205, 108, 186, 116, 51, 230, 68, 181, 58, 39, 47, 71, 211, 209, 101, 251, 164, 60, 10, 12, 83, 180, 50, 172, 55, 158, 20, 70, 107, 147, 170, 91, 118, 40, 140, 3, 252, 184, 34, 146, 127, 28, 254, 150, 57, 228, 126, 192, 14, 253, 45, 227, 225, 30, 4, 17, 44, 95, 201, 18, 149, 124, 65, 129, 154, 195, 102, 212, 219, 6, 75, 132, 244, 52, 187, 240, 198, 85, 217, 185, 224, 208, 21, 250, 87, 216, 183, 245, 203, 79, 61, 100, 200, 246, 80, 138, 109, 120, 92, 247, 143, 202, 72, 134, 156, 207, 233, 218, 37, 23, 125, 82, 234, 56, 151, 106, 112, 197, 41, 88, 96, 171, 31, 175, 93, 182, 188, 135, 48, 148, 5, 226, 103, 29, 97, 139, 115, 0, 77, 89, 74, 35, 42, 157, 59, 69, 2, 62, 236, 142, 196, 145, 7, 54, 237, 206, 194, 73, 121, 98, 199, 27, 235, 11, 221, 46, 141, 43, 63, 25, 22, 210, 53, 191, 214 };
+
+static unsigned long old_pearson_hash8(const char *string, int *table) {
+  unsigned long h = 0;
+  for(; *string; string++)
+    h = table[h ^ tolower(*string)];
+  return h;
+}
+
+static unsigned long old_pearson_hash8_1(const char *string) {
+  return old_pearson_hash8(string, old_pearson_table1);
+}
+
+static unsigned long old_pearson_hash8_2(const char *string) {
+  return old_pearson_hash8(string, old_pearson_table2);
+}
+
+static unsigned long old_pearson_hash8_3(const char *string) {
+  return old_pearson_hash8(string, old_pearson_table3);
+}
+
+static unsigned long old_pearson_hash8_4(const char *string) {
+  return old_pearson_hash8(string, old_pearson_table4);
+}
+
+// concatinate four strings of 8 bits
+static unsigned long old_pearson_hash32(const char *string) {
+  return ((old_pearson_hash8_1(string))       | (old_pearson_hash8_2(string) << 8) |
+	  (old_pearson_hash8_3(string) << 16) | (old_pearson_hash8_4(string) << 24));
+}
+
+//
+// just a generic function for hashing a string. This could be 
+// sped up tremendously if it's performance becoming a problem.
+static unsigned long string_hash(const char *key) {
+  return old_pearson_hash32(key);
+}
+
+
+
+//*****************************************************************************
+// the old table, as seen by hash_bench
+//*****************************************************************************
+BENCH_HASH_API old_hash_api = {
+  "list buckets",
+  (void *)oldNewHashtable,
+  (void *)oldDeleteHashtable,
+  (void *)oldHashPut,
+  (void *)oldHashGet,
+  (void *)oldHashRemove,
+  (void *)oldNewHashIterator,
+  (void *)oldDeleteHashIterator,
+  (void *)oldHashIteratorNext,
+  (void *)oldHashIteratorCurrentKey,
+};
@@ -0,0 +1,193 @@
+//*****************************************************************************
+//
+// list_bench.c
+//
+// Times the list in list.c (pooled nodes, iterators on the stack) against
+// the list it replaced (see list_old.c). message() and do_cmd() can't be run
+// without the rest of the game, so the workloads here repeat the list work
+// they do instead:
+//
+//   message()  starts an iterator over the room's characters, and checks
+//              each one as a recipient
+//   do_cmd()   builds a list of the command tables to search, tokenizes the
+//              argument into a list (parse_args), looks for a target among
+//              the room's characters and then its objects, and runs the
+//              command hooks and their monitors
+//   movement   takes a character out of one room's list and puts it into
+//              another's, as char_from_room/char_to_room do
+//   big lists  builds a list of a lot of elements and deletes it
+//
+// usage: ./list_bench [scale]
+//   scale multiplies how many operations each workload does. Defaults to 1
+//
+//*****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../list.h"
+#include "bench.h"
+
+
+
+//*****************************************************************************
+// local datastructures, functions, and defines
+//*****************************************************************************
+
+// how many characters and objects are in our room
+#define ROOM_CHARS             12
+#define ROOM_OBJS               8
+
+// how many elements go in a big list
+#define BIG_LIST_SIZE       50000
+
+// the lists we're comparing. The old one lives in list_old.c
+extern BENCH_LIST_API old_list_api;
+
+void *new_list_iterator_start(LIST_ITERATOR *buf, LIST *L) {
+  listIteratorStart(buf, L);
+  return buf;
+}
+
+BENCH_LIST_API new_list_api = {
+  "new list",
+  (void *)newList,
+  (void *)deleteList,
+  (void *)listPut,
+  (void *)listQueue,
+  (void *)listRemove,
+  (void *)new_list_iterator_start,
+  (void *)listIteratorStop,
+  (void *)listIteratorCurrent,
+  (void *)listIteratorNext,
+};
+
+// make sure the compiler can't throw our work away
+volatile unsigned long bench_sink = 0;
+
+// the things we put in lists. Only their addresses matter
+int things[BIG_LIST_SIZE];
+
+//
+// go over everything in a list, like an ITERATE_LIST would
+void bench_iterate(BENCH_LIST_API *api, void *list) {
+  LIST_ITERATOR buf;
+  void *I = api->iterator_start(&buf, list), *elem;
+  for(elem = api->iterator_current(I); elem; elem = api->iterator_next(I))
+    bench_sink += *(int *)elem;
+  api->iterator_stop(I);
+}
+
+//
+// one message() to the room
+void bench_message(BENCH_LIST_API *api, void *room_chars) {
+  bench_iterate(api, room_chars);
+}
+
+//
+// the list work for one do_cmd()
+void bench_do_cmd(BENCH_LIST_API *api, void *room_chars, void *room_objs,
+		  void *hooks, void *monitors) {
+  void *cmd_tables = api->new();
+  void *tokens     = api->new();
+  api->queue(cmd_tables, &things[0]);
+  api->queue(cmd_tables, &things[1]);
+  bench_iterate(api, cmd_tables);
+  api->queue(tokens, &things[2]);
+  api->queue(tokens, &things[3]);
+  bench_iterate(api, tokens);
+  bench_iterate(api, room_chars);
+  bench_iterate(api, room_objs);
+  bench_iterate(api, hooks);
+  bench_iterate(api, monitors);
+  api->delete(tokens);
+  api->delete(cmd_tables);
+}
+
+//
+// run all of our workloads on one list, and record how long each took
+void bench_list(BENCH_LIST_API *api, int rounds, double *times) {
+  void *room_chars = api->new(), *room_objs = api->new();
+  void *hooks      = api->new(), *monitors  = api->new();
+  void *to_room    = api->new();
+  double start;
+  int i, round;
+
+  for(i = 0; i < ROOM_CHARS; i++)
+    api->put(room_chars, &things[i]);
+  for(i = 0; i < ROOM_OBJS; i++)
+    api->put(room_objs, &things[ROOM_CHARS + i]);
+  for(i = 0; i < 3; i++)
+    api->put(hooks, &things[i]);
+  api->put(monitors, &things[0]);
+
+  start = bench_now();
+  for(round = 0; round < rounds; round++)
+    bench_message(api, room_chars);
+  times[0] += bench_now() - start;
+
+  start = bench_now();
+  for(round = 0; round < rounds; round++)
+    bench_do_cmd(api, room_chars, room_objs, hooks, monitors);
+  times[1] += bench_now() - start;
+
+  start = bench_now();
+  for(round = 0; round < rounds; round++) {
+    void *elem = &things[round % ROOM_CHARS];
+    api->remove(room_chars, elem);
+    api->put(to_room, elem);
+    api->remove(to_room, elem);
+    api->put(room_chars, elem);
+  }
+  times[2] += bench_now() - start;
+
+  start = bench_now();
+  for(round = 0; round < 10; round++) {
+    void *big = api->new();
+    for(i = 0; i < BIG_LIST_SIZE; i++)
+      api->put(big, &things[i]);
+    api->delete(big);
+  }
+  times[3] += bench_now() - start;
+
+  api->delete(room_chars);
+  api->delete(room_objs);
+  api->delete(hooks);
+  api->delete(monitors);
+  api->delete(to_room);
+}
+
+//
+// print out how long one operation took, on average, for both lists
+void bench_report(const char *what, double old_ns, double new_ns, long ops) {
+  printf("%-34s %10.1f %10.1f %8.2fx\n", what, old_ns / ops, new_ns / ops,
+	 old_ns / new_ns);
+}
+
+
+
+//*****************************************************************************
+// the benchmark itself
+//*****************************************************************************
+int main(int argc, char **argv) {
+  int scale = (argc > 1 ? atoi(argv[1]) : 1), rounds;
+  double old_times[4] = { 0 }, new_times[4] = { 0 };
+
+  if(scale < 1)
+    scale = 1;
+  rounds = 1000000 * scale;
+
+  bench_list(&old_list_api, rounds, old_times);
+  bench_list(&new_list_api, rounds, new_times);
+
+  printf("ns per operation %20s %10s %10s %9s\n", "", old_list_api.name,
+	 new_list_api.name, "speedup");
+  bench_report("message() to a room of 12",  old_times[0], new_times[0],
+	       rounds);
+  bench_report("do_cmd() list work",         old_times[1], new_times[1],
+	       rounds);
+  bench_report("move between rooms",         old_times[2], new_times[2],
+	       rounds);
+  bench_report("build + delete, per element", old_times[3], new_times[3],
+	       10L * BIG_LIST_SIZE);
+  return 0;
+}
@@ -0,0 +1,290 @@
+//*****************************************************************************
+//
+// list_old.c
+//
+// The list that was used before list.c started pooling its nodes and allowing
+// iterators on the stack, kept around so list_bench has something to compare
+// the current implementation against. Only what list_bench calls is kept.
+// Its functions are renamed so both can be linked into the same program. The
+// code is left as it was, except that its iterator struct now comes from
+// list.h (it is laid out the same).
+//
+//*****************************************************************************
+
+#include <stdlib.h>
+
+#define deleteList              oldDeleteList
+#define deleteListIterator      oldDeleteListIterator
+#define deleteListNode          oldDeleteListNode
+#define listCleanRemoved        oldListCleanRemoved
+#define listIteratorCurrent     oldListIteratorCurrent
+#define listIteratorNext        oldListIteratorNext
+#define listPut                 oldListPut
+#define listQueue               oldListQueue
+#define listRemove              oldListRemove
+#define newList                 oldNewList
+#define newListIterator         oldNewListIterator
+#define newListNode             oldNewListNode
+
+#include "../list.h"
+#include "bench.h"
+
+#ifndef FALSE
+#define FALSE   0
+#define TRUE    !(FALSE)
+#endif
+
+typedef struct list_node {
+  void *elem;              // the data we contain
+  struct list_node *next;  // the next node in the list
+  char removed;            // has the item been removed from the list? 
+                           // char == bool
+} LIST_NODE;
+
+struct list {
+  LIST_NODE *head;         // first element in the list
+  LIST_NODE *tail;         // last element in the list
+  int size;                // how many elements are in the list?
+  int iterators;           // how many iterators are going over us?
+  char remove_pending;     // do we have to do a remove when the iterators die?
+};
+
+
+//
+// Delete a list node, and all nodes attached to it
+//
+void deleteListNode(LIST_NODE *N) {
+  if(N->next) deleteListNode(N->next);
+  free(N);
+};
+
+//
+// Create a new list node containing the given element
+//
+LIST_NODE *newListNode(void *elem) {
+  LIST_NODE *N = malloc(sizeof(LIST_NODE));
+  N->elem    = elem;
+  N->next    = NULL;
+  N->removed = FALSE;
+  return N;
+};
+
+
+//
+// take out all of the nodes that have been flagged as "removed"
+// from the list.
+//
+void listCleanRemoved(LIST *L) {
+  // go through and kill all of the elements we removed if removes are pending
+  if(L->remove_pending) {
+    LIST_NODE *node = L->head;
+    L->remove_pending = FALSE;
+
+    // while our head is a removed element, 
+    // pop it off and delete the list node
+    while(node && node->removed) {
+      L->head = node->next;
+      node->next = NULL;
+      deleteListNode(node);
+      node = L->head;
+    }
+    
+    // go through the rest of the list
+    if(node != NULL) {
+      while(node->next != NULL) {
+	// is our next element to be removed?
+	if(node->next->removed) {
+	  LIST_NODE *removed = node->next;
+	  node->next = removed->next;
+	  removed->next = NULL;
+	  deleteListNode(removed);
+	  // if we just removed the last element in the list, our next 
+	  // node should be NULL and we cannot keep do our next loop, 
+	  // as we'll try to assign NULL to the current node
+	  if(node->next == NULL) break;
+	}
+	node = node->next;
+      }
+    }
+    
+    // reset the tail of our list
+    L->tail = node;
+    
+    // if we have no elements left, clear our head and tail
+    if(L->size == 0)
+      L->head = L->tail = NULL;
+  }
+}
+
+
+
+//*****************************************************************************
+//
+// List interface functions. Documentation in list.h
+//
+//*****************************************************************************
+LIST *newList() {
+  LIST *L    = malloc(sizeof(LIST));
+  L->head           = NULL;
+  L->tail           = NULL;
+  L->size           = 0;
+  L->iterators      = 0;
+  L->remove_pending = FALSE;
+  return L;
+};
+
+
+void deleteList(LIST *L) {
+  if(L->head) deleteListNode(L->head);
+  free(L);
+};
+
+void listPut(LIST *L, void *elem) {
+  //  if(listIn(L, elem))
+  //    return;
+
+  LIST_NODE *N = newListNode(elem);
+  N->next = L->head;
+  L->head = N;
+  L->size++;
+  if(L->tail == NULL)
+    L->tail = N;
+};
+
+
+void listQueue(LIST *L, void *elem) {
+  //  if(listIn(L, elem))
+  //    return;
+
+  LIST_NODE *N = newListNode(elem);
+
+  if(L->head == NULL) {
+    L->head = N;
+    L->tail = N;
+  }
+  else {
+    L->tail->next = N;
+    L->tail       = N;
+  }
+  L->size++;
+}
+
+
+int listRemove(LIST *L, const void *elem) {
+  LIST_NODE *N = L->head;
+
+  // we don't have any contents
+  if(N == NULL)
+    return FALSE;
+
+  // we first have to check if it is the head
+  if(!N->removed && N->elem == elem) {
+    // check to see if there's an iterator on us
+    if(L->iterators > 0) {
+      N->removed = TRUE;
+      L->size--;
+      L->remove_pending = TRUE;
+      return TRUE;
+    }
+    else {
+      L->head = N->next;
+      N->next = NULL;
+      deleteListNode(N);
+      L->size--;
+      if(L->size == 0)
+	L->tail = NULL;
+      return TRUE;
+    }
+  }
+  // otherwise, we can check if it's another element
+  else {
+    while(N->next) {
+      // we found it ... remove it now
+      if(!N->next->removed && N->next->elem == elem) {
+	// check to see if there's an iterator on us
+	if(L->iterators > 0) {
+	  N->next->removed = TRUE;
+	  L->remove_pending = TRUE;
+	  L->size--;
+	  return TRUE;
+	}
+	else {
+	  if(N->next == L->tail)
+	    L->tail = N;
+	  LIST_NODE *tmp = N->next;
+	  N->next = tmp->next;
+	  tmp->next = NULL;
+	  deleteListNode(tmp);
+	  L->size--;
+	  return TRUE;
+	}
+      }
+      N = N->next;
+    }
+  }
+  // we didn't find it
+  return FALSE;
+};
+
+
+
+//*****************************************************************************
+//
+// The functions for the list iterator interface. Documentation is in list.h
+//
+//*****************************************************************************
+LIST_ITERATOR *newListIterator(LIST *L) {
+  LIST_ITERATOR *I = malloc(sizeof(LIST_ITERATOR));
+  I->L    = L;
+  I->curr = I->L->head;
+  L->iterators++;
+  return I;
+};
+
+void deleteListIterator(LIST_ITERATOR *I) {
+  I->L->iterators--;
+  // if we're at 0 iterators, clean the list of all removed elements
+  if(I->L->iterators == 0)
+    listCleanRemoved(I->L);
+  free(I);
+};
+
+void *listIteratorNext(LIST_ITERATOR *I) {
+  if(I->curr)
+    I->curr = I->curr->next;
+
+  // skip all of the removed elements
+  while(I->curr && I->curr->removed)
+    I->curr = I->curr->next;
+
+  return (I->curr ? I->curr->elem : NULL);
+};
+
+void *listIteratorCurrent(LIST_ITERATOR *I) {
+  // hmmm... what if we're on a removed node?
+  while(I->curr && I->curr->removed)
+    I->curr = I->curr->next;
+
+  return (I->curr ? I->curr->elem : NULL);
+};
+
+
+//*****************************************************************************
+// the old list, as seen by list_bench. Iterators always go on the heap
+//*****************************************************************************
+void *old_list_iterator_start(void *buf, LIST *L) {
+  return oldNewListIterator(L);
+}
+
+BENCH_LIST_API old_list_api = {
+  "old list",
+  (void *)oldNewList,
+  (void *)oldDeleteList,
+  (void *)oldListPut,
+  (void *)oldListQueue,
+  (void *)oldListRemove,
+  (void *)old_list_iterator_start,
+  (void *)oldDeleteListIterator,
+  (void *)oldListIteratorCurrent,
+  (void *)oldListIteratorNext,
+};
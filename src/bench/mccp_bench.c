@@ -0,0 +1,300 @@
+//*****************************************************************************
+//
+// mccp_bench.c
+//
+// Times a pulse of output_handler's work for a room full of clients, with and
+// without MCCP. Every pulse each client is sent what a busy room sends: a few
+// lines of combat spam that everyone sees, a line or two of their own, and
+// then their prompt. What is timed is getting that into each client's output
+// queue; writing the queues out costs the same whichever way they were
+// compressed, so they are emptied between pulses without being timed.
+//
+// Compressed clients are timed the way they used to be compressed (see
+// mccp_old.c), where the text and the prompt were each deflated and flushed
+// on their own at level 9, and through deflate_pool streams, flushed once per
+// pulse: at level 9, at the default level, and at the default level on
+// workers.
+//
+// Before anything is timed, what every compressed client was sent is
+// inflated again and checked against what they should have been sent.
+//
+// usage: ./mccp_bench [scale] [workers]
+//   scale multiplies how many pulses are timed. Defaults to 1
+//   workers is how many threads compress in the last test. Defaults to 4
+//
+//*****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#include "../mud.h"
+#include "../outqueue.h"
+#include "../deflate_pool.h"
+#include "bench.h"
+
+
+
+//*****************************************************************************
+// local datastructures, functions, and defines
+//*****************************************************************************
+
+// the most clients a pulse is sent to, and how many are checked
+#define BENCH_MAX_CLIENTS      1000
+#define BENCH_CHECK_CLIENTS      20
+#define BENCH_CHECK_PULSES       50
+
+// how the old version compressed; see mccp_old.c
+typedef struct {
+  z_stream      * out_compress;
+  unsigned char * out_compress_buf;
+  OUT_QUEUE     * outq;
+} OLD_MCCP;
+
+bool old_compress_start(OLD_MCCP *dsock);
+void old_compress_end(OLD_MCCP *dsock);
+bool old_socket_queue(OLD_MCCP *dsock, const char *txt, int len);
+
+//
+// the ways a pulse's output can be sent
+typedef enum {
+  BENCH_PLAIN,   // no MCCP
+  BENCH_OLD,     // deflated as it's queued, at level 9
+  BENCH_LEVEL9,  // flushed once per pulse, at level 9
+  BENCH_DEFAULT, // flushed once per pulse, at the default level
+  BENCH_WORKERS, // as above, on the workers
+  NUM_BENCH_WAYS
+} BENCH_WAY;
+
+const char *bench_way_names[NUM_BENCH_WAYS] = {
+  "uncompressed", "old, level 9", "per pulse, level 9",
+  "per pulse, default level", "per pulse, on workers"
+};
+
+typedef struct {
+  OUT_QUEUE       *outq;
+  OLD_MCCP          old;
+  DEFLATE_STREAM *stream;
+  char       text[1024]; // what they are sent this pulse, and their prompt
+  char      prompt[64];
+} BENCH_CLIENT;
+
+BENCH_CLIENT bench_clients[BENCH_MAX_CLIENTS];
+
+// what the room sees; the fighters change from pulse to pulse
+const char *bench_spam[] = {
+  "Person%d hits Person%d with a rusty longsword.\r\n",
+  "Person%d swings an iron mace at Person%d, but misses.\r\n",
+  "Person%d dodges Person%d's attack; he stumbles past.\r\n",
+  "Person%d wounds Person%d with a gnarled staff!\r\n",
+  "Person%d is bleeding badly.\r\n",
+};
+#define NUM_SPAM   (sizeof(bench_spam) / sizeof(bench_spam[0]))
+
+//
+// the deflate pool logs if it can't start its workers
+void log_string(const char *txt, ...) {
+  va_list args;
+  va_start(args, txt);
+  vfprintf(stderr, txt, args);
+  va_end(args);
+  fprintf(stderr, "\n");
+}
+
+//
+// work out what each of the clients is sent this pulse
+void bench_compose(int clients, int pulse) {
+  char room[512];
+  int  len = 0, i;
+  for(i = 0; i < 6; i++)
+    len += snprintf(room + len, sizeof(room) - len,
+		    bench_spam[(pulse + i) % NUM_SPAM],
+		    (pulse * 7 + i) % 40, (pulse * 3 + i * 5) % 40);
+  for(i = 0; i < clients; i++) {
+    snprintf(bench_clients[i].text, sizeof(bench_clients[i].text),
+	     "\r\n%sYou are carrying %d coins.\r\n", room, (pulse + i) % 997);
+    snprintf(bench_clients[i].prompt, sizeof(bench_clients[i].prompt),
+	     "\r\n<%dhp %dmp %dmv> ", 100 - pulse % 50, 80 + i % 20, 120);
+  }
+}
+
+void bench_setup(BENCH_WAY way, int clients) {
+  int i;
+  for(i = 0; i < clients; i++) {
+    BENCH_CLIENT *client = &bench_clients[i];
+    client->outq = newOutQueue();
+    if(way == BENCH_OLD) {
+      client->old.outq = client->outq;
+      old_compress_start(&client->old);
+    }
+    else if(way != BENCH_PLAIN)
+      client->stream = newDeflateStream((way == BENCH_LEVEL9 ? 9 :
+					 DFLT_MCCP_LEVEL),
+					DFLT_MCCP_MEM_LEVEL);
+  }
+}
+
+void bench_teardown(BENCH_WAY way, int clients) {
+  int i;
+  for(i = 0; i < clients; i++) {
+    BENCH_CLIENT *client = &bench_clients[i];
+    if(way == BENCH_OLD)
+      old_compress_end(&client->old);
+    else if(client->stream != NULL)
+      deleteDeflateStream(client->stream);
+    client->stream = NULL;
+    deleteOutQueue(client->outq);
+  }
+}
+
+//
+// queue one pulse of output for every client, the way flush_output does
+void bench_pulse(BENCH_WAY way, int clients) {
+  int i;
+  for(i = 0; i < clients; i++) {
+    BENCH_CLIENT *client = &bench_clients[i];
+    if(way == BENCH_PLAIN) {
+      outQueueCat(client->outq, client->text,   strlen(client->text));
+      outQueueCat(client->outq, client->prompt, strlen(client->prompt));
+    }
+    else if(way == BENCH_OLD) {
+      old_socket_queue(&client->old, client->text,   strlen(client->text));
+      old_socket_queue(&client->old, client->prompt, strlen(client->prompt));
+    }
+    else {
+      deflateStreamCat(client->stream, client->text,   strlen(client->text));
+      deflateStreamCat(client->stream, client->prompt, strlen(client->prompt));
+      deflateStreamFlush(client->stream, way == BENCH_WORKERS);
+      if(way != BENCH_WORKERS)
+	deflateStreamCollect(client->stream, client->outq);
+    }
+  }
+
+  // and if the workers were compressing, wait for them like output_handler
+  if(way == BENCH_WORKERS)
+    for(i = 0; i < clients; i++)
+      deflateStreamCollect(bench_clients[i].stream, bench_clients[i].outq);
+}
+
+//
+// empty everyone's output queue. Returns how many bytes were in them
+long bench_drain(int clients) {
+  long bytes = 0;
+  int i;
+  for(i = 0; i < clients; i++)
+    bytes += outQueueClear(bench_clients[i].outq);
+  return bytes;
+}
+
+//
+// send a few pulses, and check each client can inflate what they were sent
+// back into what they should have been. Returns how many could not
+int bench_check(BENCH_WAY way) {
+  static char   want[BENCH_CHECK_PULSES * 600];
+  static char    got[BENCH_CHECK_PULSES * 600];
+  int bad = 0, i, pulse, want_len = 0;
+  FILE *fp[BENCH_CHECK_CLIENTS];
+
+  bench_setup(way, BENCH_CHECK_CLIENTS);
+  for(i = 0; i < BENCH_CHECK_CLIENTS; i++)
+    fp[i] = tmpfile();
+  for(pulse = 0; pulse < BENCH_CHECK_PULSES; pulse++) {
+    bench_compose(BENCH_CHECK_CLIENTS, pulse);
+    bench_pulse(way, BENCH_CHECK_CLIENTS);
+    for(i = 0; i < BENCH_CHECK_CLIENTS; i++) {
+      bool blocked = FALSE;
+      outQueueFlush(bench_clients[i].outq, fileno(fp[i]), &blocked);
+    }
+  }
+
+  for(i = 0; i < BENCH_CHECK_CLIENTS; i++) {
+    // what they should have gotten
+    want_len = 0;
+    for(pulse = 0; pulse < BENCH_CHECK_PULSES; pulse++) {
+      bench_compose(BENCH_CHECK_CLIENTS, pulse);
+      want_len += sprintf(want + want_len, "%s%s",
+			  bench_clients[i].text, bench_clients[i].prompt);
+    }
+
+    // and what they did
+    static unsigned char wire[BENCH_CHECK_PULSES * 600];
+    long wire_len = ftell(fp[i]);
+    rewind(fp[i]);
+    fread(wire, 1, wire_len, fp[i]);
+    fclose(fp[i]);
+
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    inflateInit(&z);
+    z.next_in   = wire;
+    z.avail_in  = wire_len;
+    z.next_out  = (unsigned char *)got;
+    z.avail_out = sizeof(got);
+    inflate(&z, Z_SYNC_FLUSH);
+    int got_len = sizeof(got) - z.avail_out;
+    inflateEnd(&z);
+
+    if(got_len != want_len || memcmp(got, want, want_len)) {
+      printf("%s: client %d was sent something different\n",
+	     bench_way_names[way], i);
+      bad++;
+    }
+  }
+  bench_teardown(way, BENCH_CHECK_CLIENTS);
+  return bad;
+}
+
+//
+// send pulses pulses to clients clients. Returns how long they took, in ns,
+// and how many bytes were queued for them
+double bench_replay(BENCH_WAY way, int clients, int pulses, long *bytes) {
+  double elapsed = 0;
+  int pulse;
+  *bytes = 0;
+  bench_setup(way, clients);
+  for(pulse = 0; pulse < pulses; pulse++) {
+    bench_compose(clients, pulse);
+    double start = bench_now();
+    bench_pulse(way, clients);
+    elapsed += bench_now() - start;
+    *bytes  += bench_drain(clients);
+  }
+  bench_teardown(way, clients);
+  return elapsed;
+}
+
+
+
+//*****************************************************************************
+// the benchmark itself
+//*****************************************************************************
+int main(int argc, char **argv) {
+  int scale   = (argc > 1 ? atoi(argv[1]) : 1);
+  int workers = (argc > 2 ? atoi(argv[2]) : 4);
+  int client_counts[] = { 50, 200, 1000 };
+  int bad = 0, i, way;
+  if(scale < 1)
+    scale = 1;
+  init_deflate_pool(workers);
+
+  for(way = BENCH_OLD; way < NUM_BENCH_WAYS; way++)
+    bad += bench_check(way);
+
+  printf("one pulse of a busy room's output; %d clients had something "
+	 "different sent\n", bad);
+  printf("%-8s %-26s %14s %17s\n", "clients", "", "ms per pulse",
+	 "bytes per client");
+  for(i = 0; i < (int)(sizeof(client_counts) / sizeof(int)); i++) {
+    int clients = client_counts[i];
+    int  pulses = 200 * scale * 50 / clients;
+    for(way = 0; way < NUM_BENCH_WAYS; way++) {
+      long   bytes = 0;
+      double    ns = bench_replay(way, clients, pulses, &bytes);
+      printf("%-8d %-26s %14.3f %17.1f\n", clients, bench_way_names[way],
+	     ns / pulses / 1e6, (double)bytes / pulses / clients);
+    }
+  }
+  printf("(on workers is with %d worker%s)\n",
+	 deflatePoolWorkers(), (deflatePoolWorkers() == 1 ? "" : "s"));
+  return (bad > 0);
+}
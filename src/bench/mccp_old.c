@@ -0,0 +1,100 @@
+//*****************************************************************************
+//
+// mccp_old.c
+//
+// How MCCP compressed output before streams were flushed once per pulse, kept
+// around so mccp_bench has something to compare the current version against.
+// Every piece of output (a pulse's text, then its prompt) was deflated as soon
+// as it was queued, with a sync flush of its own, at level 9, through an 8k
+// buffer. The code is socket_queue's and compressStart's from socket.c, but
+// for working on a stand-in for the socket.
+//
+//*****************************************************************************
+
+#include <zlib.h>
+#include "../mud.h"
+#include "../outqueue.h"
+
+#define COMPRESS_BUF_SIZE   8192
+
+//
+// the parts of the socket the old code used
+typedef struct {
+  z_stream      * out_compress;
+  unsigned char * out_compress_buf;
+  OUT_QUEUE     * outq;
+} OLD_MCCP;
+
+void *old_zlib_alloc(void *opaque, unsigned int items, unsigned int size)
+{
+  return calloc(items, size);
+}
+
+void old_zlib_free(void *opaque, void *address)
+{
+  free(address);
+}
+
+bool old_compress_start(OLD_MCCP *dsock)
+{
+  z_stream *s;
+
+  /* allocate and init stream, buffer */
+  s = (z_stream *) malloc(sizeof(*s));
+  dsock->out_compress_buf = (unsigned char *) malloc(COMPRESS_BUF_SIZE);
+
+  s->next_in    =  NULL;
+  s->avail_in   =  0;
+  s->next_out   =  dsock->out_compress_buf;
+  s->avail_out  =  COMPRESS_BUF_SIZE;
+  s->zalloc     =  old_zlib_alloc;
+  s->zfree      =  old_zlib_free;
+  s->opaque     =  NULL;
+
+  if (deflateInit(s, 9) != Z_OK)
+  {
+    free(dsock->out_compress_buf);
+    free(s);
+    return FALSE;
+  }
+
+  dsock->out_compress = s;
+  return TRUE;
+}
+
+void old_compress_end(OLD_MCCP *dsock)
+{
+  deflateEnd(dsock->out_compress);
+  free(dsock->out_compress_buf);
+  free(dsock->out_compress);
+}
+
+//
+// move whatever MCCP has compressed for us into our output queue
+void old_socket_queue_compressed(OLD_MCCP *dsock) {
+  int len = dsock->out_compress->next_out - dsock->out_compress_buf;
+  if(len > 0) {
+    outQueueCat(dsock->outq, (char *) dsock->out_compress_buf, len);
+    dsock->out_compress->next_out = dsock->out_compress_buf;
+  }
+}
+
+bool old_socket_queue(OLD_MCCP *dsock, const char *txt, int len) {
+  dsock->out_compress->next_in  = (unsigned char *) txt;
+  dsock->out_compress->avail_in = len;
+
+  // keep going until zlib has given us everything, which it has not done if
+  // it filled up our buffer
+  do {
+    dsock->out_compress->avail_out = COMPRESS_BUF_SIZE - (dsock->out_compress->next_out - dsock->out_compress_buf);
+    int status = deflate(dsock->out_compress, Z_SYNC_FLUSH);
+    // no progress means there was nothing left for it to give us
+    if (status == Z_BUF_ERROR)
+      break;
+    if (status != Z_OK)
+      return FALSE;
+    old_socket_queue_compressed(dsock);
+  } while (dsock->out_compress->avail_in > 0 ||
+	   dsock->out_compress->avail_out == 0);
+  return TRUE;
+}
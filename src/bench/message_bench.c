@@ -0,0 +1,247 @@
+//*****************************************************************************
+//
+// message_bench.c
+//
+// Times message(), which compiles each format once and renders each way of
+// seeing a message once, against the version that worked through the format
+// again for every person it went to (see message_old.c). What is replayed is
+// combat spam in a crowded room: pairs of fighters trading blows, with every
+// swing sent to the attacker, the victim, and everyone watching. Some of the
+// watchers are asleep, some of the fighters are invisible, and a few people
+// in the room are mobiles with nobody to read what they are sent.
+//
+// Everything is run through both versions first, and what each person was
+// sent is compared.
+//
+// usage: ./message_bench [scale]
+//   scale multiplies how many rounds of combat are replayed. Defaults to 1
+//
+//*****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../mud.h"
+#include "../utils.h"
+#include "../character.h"
+#include "../object.h"
+#include "../room.h"
+#include "../inform.h"
+#include "bench.h"
+
+
+
+//*****************************************************************************
+// local datastructures, functions, and defines
+//*****************************************************************************
+
+// how many people are in the room, and how many of them are fighting
+#define BENCH_CROWD              60
+#define BENCH_FIGHTERS           12
+
+typedef void (* MESSAGE_FUNC)(CHAR_DATA *ch,  CHAR_DATA *vict,
+			      OBJ_DATA  *obj, OBJ_DATA  *vobj,
+			      int hide_nosee, bitvector_t range,
+			      const char *mssg);
+
+void old_message(CHAR_DATA *ch,  CHAR_DATA *vict,
+		 OBJ_DATA  *obj, OBJ_DATA  *vobj,
+		 int hide_nosee, bitvector_t range,
+		 const char *mssg);
+
+//
+// the parts of characters, objects, and rooms that message() looks at. Each
+// person keeps what the old and the new versions sent them apart
+struct char_data {
+  char          name[32];
+  int                sex;
+  bool        has_socket;
+  bool            asleep; // can't see anything
+  bool             invis; // can only be seen by those who see invisible
+  bool        sees_invis;
+  ROOM_DATA        *room;
+  BUFFER         *out[2];
+};
+
+struct object_data {
+  const char *name;
+};
+
+struct room_data {
+  LIST *chars;
+};
+
+// which of the buffers in char_data output is going to
+int   bench_out = 0;
+LIST *mobile_list = NULL;
+
+//
+// what message() needs from the rest of the mud
+const char  *charGetName(CHAR_DATA *ch)    { return ch->name; }
+int           charGetSex(CHAR_DATA *ch)    { return ch->sex; }
+ROOM_DATA   *charGetRoom(CHAR_DATA *ch)    { return ch->room; }
+const char   *objGetName(OBJ_DATA *obj)    { return obj->name; }
+LIST  *roomGetCharacters(const ROOM_DATA *room) { return room->chars; }
+
+SOCKET_DATA *charGetSocket(CHAR_DATA *ch) {
+  return (ch->has_socket ? (SOCKET_DATA *)ch : NULL);
+}
+
+bool can_see_char(CHAR_DATA *ch, CHAR_DATA *target) {
+  return (!ch->asleep && (ch == target || !target->invis || ch->sees_invis));
+}
+
+bool can_see_obj(CHAR_DATA *ch, OBJ_DATA *target) {
+  return !ch->asleep;
+}
+
+const char *see_char_as(CHAR_DATA *ch, CHAR_DATA *target) {
+  return (can_see_char(ch, target) ? charGetName(target) : SOMEONE);
+}
+
+const char *see_obj_as(CHAR_DATA *ch, OBJ_DATA *target) {
+  return (can_see_obj(ch, target) ? objGetName(target) : SOMETHING);
+}
+
+//
+// the real one also busts the prompt and logs, which costs the same for both
+void text_to_char(CHAR_DATA *ch, const char *txt) {
+  if(txt && *txt && ch->has_socket)
+    bufferCat(ch->out[bench_out], txt);
+}
+
+// the room, who is in it, and what the fighters are swinging
+ROOM_DATA  bench_room;
+CHAR_DATA  bench_crowd[BENCH_CROWD];
+OBJ_DATA   bench_weapons[] = {
+  { "a rusty longsword" }, { "an iron mace" }, { "a pair of fists" },
+  { "a gnarled staff" }
+};
+#define NUM_WEAPONS   (sizeof(bench_weapons) / sizeof(bench_weapons[0]))
+
+//
+// one swing's worth of messages
+typedef struct {
+  const char *to_char;
+  const char *to_vict;
+  const char *to_room;
+} BENCH_SWING;
+
+BENCH_SWING bench_swings[] = {
+  { "You hit $N with $o.",
+    "$n hits you with $s $o.",
+    "$n hits $N with $s $o." },
+  { "You miss $N.",
+    "$n swings $s $o at you, but misses.",
+    "$n swings $s $o at $N, but misses $M." },
+  { "$N dodges your attack.",
+    "You dodge $n's attack.",
+    "$N dodges $n's attack; $e stumbles past $M." },
+  { "You wound $N with $a $o!",
+    "$n wounds you with $a $o!",
+    "$n wounds $N with $a $o!" },
+};
+#define NUM_SWINGS   (sizeof(bench_swings) / sizeof(bench_swings[0]))
+
+void bench_setup(void) {
+  int i;
+  bench_room.chars = newList();
+  mobile_list      = bench_room.chars;
+  for(i = 0; i < BENCH_CROWD; i++) {
+    CHAR_DATA *ch = &bench_crowd[i];
+    snprintf(ch->name, sizeof(ch->name), "Person%d", i);
+    ch->sex        = i % 3;
+    ch->has_socket = (i % 6 != 5);
+    ch->asleep     = (i % 10 == 7);
+    ch->invis      = (i < BENCH_FIGHTERS && i % 4 == 3);
+    ch->sees_invis = (i % 8 == 0);
+    ch->room       = &bench_room;
+    ch->out[0]     = newBuffer(MAX_BUFFER);
+    ch->out[1]     = newBuffer(MAX_BUFFER);
+    listQueue(bench_room.chars, ch);
+  }
+}
+
+void bench_clear_output(void) {
+  int i;
+  for(i = 0; i < BENCH_CROWD; i++)
+    bufferClear(bench_crowd[i].out[bench_out]);
+}
+
+//
+// fight one round: each fighter takes a swing at the next one along
+void bench_round(MESSAGE_FUNC mssg, int round, int *sent) {
+  int i;
+  for(i = 0; i < BENCH_FIGHTERS; i++) {
+    CHAR_DATA     *ch = &bench_crowd[i];
+    CHAR_DATA   *vict = &bench_crowd[(i + 1) % BENCH_FIGHTERS];
+    OBJ_DATA  *weapon = &bench_weapons[(i + round) % NUM_WEAPONS];
+    BENCH_SWING *swing = &bench_swings[(i + round) % NUM_SWINGS];
+    mssg(ch, vict, weapon, NULL, FALSE, TO_CHAR, swing->to_char);
+    mssg(ch, vict, weapon, NULL, FALSE, TO_VICT, swing->to_vict);
+    mssg(ch, vict, weapon, NULL, TRUE,  TO_ROOM, swing->to_room);
+    *sent += 3;
+  }
+}
+
+//
+// check both versions send everybody the same thing. Returns how many people
+// were sent something different
+int bench_verify(void) {
+  int bad = 0, sent = 0, i;
+  for(bench_out = 0; bench_out < 2; bench_out++) {
+    bench_clear_output();
+    for(i = 0; i < (int)(NUM_SWINGS * NUM_WEAPONS); i++)
+      bench_round(bench_out == 0 ? old_message : message, i, &sent);
+  }
+  bench_out = 0;
+
+  for(i = 0; i < BENCH_CROWD; i++) {
+    if(strcmp(bufferString(bench_crowd[i].out[0]),
+	      bufferString(bench_crowd[i].out[1]))) {
+      printf("sent differently: %s\n", bench_crowd[i].name);
+      bad++;
+    }
+  }
+  return bad;
+}
+
+//
+// fight rounds rounds of combat. Returns how long it took, in ns
+double bench_replay(MESSAGE_FUNC mssg, int rounds, int *sent) {
+  double elapsed = 0;
+  int i;
+  *sent = 0;
+  for(i = 0; i < rounds; i++) {
+    // don't time emptying everyone's output
+    double start = bench_now();
+    bench_round(mssg, i, sent);
+    elapsed += bench_now() - start;
+    bench_clear_output();
+  }
+  return elapsed;
+}
+
+
+
+//*****************************************************************************
+// the benchmark itself
+//*****************************************************************************
+int main(int argc, char **argv) {
+  int scale = (argc > 1 ? atoi(argv[1]) : 1), rounds, sent, bad;
+  if(scale < 1)
+    scale = 1;
+  rounds = 20000 * scale;
+
+  bench_setup();
+  bad = bench_verify();
+  double old_ns = bench_replay(old_message, rounds, &sent);
+  double new_ns = bench_replay(message,     rounds, &sent);
+
+  printf("%d messages sent to a room of %d; %d people sent something "
+	 "different\n", sent, BENCH_CROWD, bad);
+  printf("%-24s %10s %10s %9s\n", "", "old", "new", "speedup");
+  printf("%-24s %10.1f %10.1f %8.2fx\n", "ns per message",
+	 old_ns / sent, new_ns / sent, old_ns / new_ns);
+  return (bad > 0);
+}
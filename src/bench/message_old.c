@@ -0,0 +1,192 @@
+//*****************************************************************************
+//
+// message_old.c
+//
+// The message() that was used before formats were compiled once and cached,
+// kept around so message_bench has something to compare the current version
+// against. It worked through the format again for every person the message
+// went to. Only message() and the send_message() it called are kept. They
+// are renamed so both can be linked into the same program; the code is left
+// as it was in inform.c, but for the includes.
+//
+//*****************************************************************************
+
+#define message                         old_message
+#define send_message                    old_send_message
+
+#include "../mud.h"
+#include "../utils.h"
+#include "../character.h"
+#include "../object.h"
+#include "../room.h"
+#include "../inform.h"
+
+
+
+//
+// Send a message out
+//
+// Converts the following symbols:
+//  $n = ch name
+//  $N = vict name
+//  $m = him/her of char
+//  $M = him/her of vict
+//  $s = his/hers of char
+//  $S = his/hers of vict
+//  $e = he/she of char
+//  $E = he/she of vict
+//
+//  $o = obj name
+//  $O = vobj name
+//  $a = a/an of obj
+//  $A = a/an of vobj
+void send_message(CHAR_DATA *to, 
+		  const char *str,
+		  CHAR_DATA *ch, CHAR_DATA *vict,
+		  OBJ_DATA *obj, OBJ_DATA *vobj) {
+  static char buf[MAX_BUFFER];
+  int i, j;
+  *buf = '\0';
+
+  // if there's nothing to send the message to, don't go through all
+  // the work it takes to parse the string
+  if(charGetSocket(to) == NULL)
+    return;
+
+  for(i = 0, j = 0; str[i] != '\0'; i++) {
+    if(str[i] != '$') {
+      buf[j] = str[i];
+      j++;
+    }
+    else {
+      i++;
+
+      switch(str[i]) {
+      case 'n':
+	if(!ch) break;
+	sprintf(buf+j, see_char_as(to, ch));
+	while(buf[j] != '\0') j++;
+	break;
+      case 'N':
+	if(!vict) break;
+	sprintf(buf+j, see_char_as(to, vict));
+	while(buf[j] != '\0') j++;
+	break;
+      case 'm':
+	if(!ch) break;
+	sprintf(buf+j, (can_see_char(to, ch) ? HIMHER(ch) : SOMEONE));
+	while(buf[j] != '\0') j++;
+	break;
+      case 'M':
+	if(!vict) break;
+	sprintf(buf+j, (can_see_char(to, vict) ? HIMHER(vict) : SOMEONE));
+	while(buf[j] != '\0') j++;
+	break;
+      case 's':
+	if(!ch) break;
+	sprintf(buf+j, (can_see_char(to, ch) ? HISHER(ch) :SOMEONE"'s"));
+	while(buf[j] != '\0') j++;
+	break;
+      case 'S':
+	if(!vict) break;
+	sprintf(buf+j, (can_see_char(to, vict) ? HISHER(vict) :SOMEONE"'s"));
+	while(buf[j] != '\0') j++;
+	break;
+      case 'e':
+	if(!ch) break;
+	sprintf(buf+j, (can_see_char(to, ch) ? HESHE(ch) : SOMEONE));
+	while(buf[j] != '\0') j++;
+	break;
+      case 'E':
+	if(!vict) break;
+	sprintf(buf+j, (can_see_char(to, vict) ? HESHE(vict) : SOMEONE));
+	while(buf[j] != '\0') j++;
+	break;
+      case 'o':
+	if(!obj) break;
+	sprintf(buf+j, see_obj_as(to, obj));
+	while(buf[j] != '\0') j++;
+	break;
+      case 'O':
+	if(!vobj) break;
+	sprintf(buf+j, see_obj_as(to, vobj));
+	while(buf[j] != '\0') j++;
+	break;
+      case 'a':
+	if(!obj) break;
+	sprintf(buf+j, AN(see_obj_as(to, obj)));
+	while(buf[j] != '\0') j++;
+	break;
+      case 'A':
+	if(!vobj) break;
+	sprintf(buf+j, AN(see_obj_as(to, vobj)));
+	while(buf[j] != '\0') j++;
+	break;
+      case '$':
+	buf[j] = '$';
+	j++;
+	break;
+      default:
+	// do nothing
+	break;
+      }
+    }
+  }
+
+  //  buf[0] = toupper(buf[0]);
+  sprintf(buf+j, "{n\r\n");
+  text_to_char(to, buf);
+}
+
+
+void message(CHAR_DATA *ch,  CHAR_DATA *vict,
+	     OBJ_DATA  *obj, OBJ_DATA  *vobj,
+	     int hide_nosee, bitvector_t range, 
+	     const char *mssg) {
+  if(!mssg || !*mssg)
+    return;
+
+  // what's our scope?
+  if(IS_SET(range, TO_VICT) && vict &&
+     (!hide_nosee ||
+      // make sure the vict can the character, or the
+      // object if there is no character
+      ((!ch || can_see_char(vict, ch)) &&
+       (ch  || (!obj || can_see_obj(vict, obj))))))
+    send_message(vict, mssg, ch, vict, obj, vobj);
+
+  // characters can always see themselves. No need to do checks here
+  if(IS_SET(range, TO_CHAR) && ch)
+    send_message(ch, mssg, ch, vict, obj, vobj);
+
+  LIST *recipients = NULL;
+  // check if the scope of this message is everyone in the world
+  if(IS_SET(range, TO_WORLD))
+    recipients = mobile_list;
+  else if(IS_SET(range, TO_ROOM) && charGetRoom(ch) != NULL)
+    recipients = roomGetCharacters(charGetRoom(ch));
+
+  // if we have a list to send the message to, do it
+  if(recipients != NULL) {
+    LIST_ITERATOR rec_i;
+    listIteratorStart(&rec_i, recipients);
+    CHAR_DATA *rec = NULL;
+
+    // go through everyone in the list
+    ITERATE_LIST(rec, &rec_i) {
+      // if we wanted to send to ch or vict, we would have already...
+      if(rec == vict || rec == ch)
+	continue;
+      // skip by people who are in the game but not in the world yet
+      if(charGetRoom(rec) == NULL)
+	continue;
+      if(rec == ch ||
+	 (!hide_nosee ||
+	  // make sure the vict can see the character, or the
+	  // object if there is no character
+	  ((!ch || can_see_char(rec, ch)) &&
+	   (ch  || (!obj || can_see_obj(rec, obj))))))
+      send_message(rec, mssg, ch, vict, obj, vobj);
+    } listIteratorStop(&rec_i);
+  }
+}
@@ -0,0 +1,297 @@
+//*****************************************************************************
+//
+// parse_bench.c
+//
+// Times parse_args, which compiles each format once and keeps its variables
+// on the stack, against the version that broke its format down and built a
+// list of malloc'd variables on every call (see parse_old.c). The lines that
+// are replayed are what players type for get, give, put, look, and open, run
+// through the formats those commands actually use. There is no world to
+// search, so find_specific is stood in for by a lookup in a small, made up
+// room; it costs the same for both versions.
+//
+// Every line is run through both versions first, and what they parsed out is
+// compared.
+//
+// usage: ./parse_bench [scale]
+//   scale multiplies how many lines are replayed. Defaults to 1
+//
+//*****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../mud.h"
+#include "../handler.h"
+#include "../parse.h"
+#include "../scripts/scripts.h"
+#include "../scripts/pyexit.h"
+#include "bench.h"
+
+
+
+//*****************************************************************************
+// local datastructures, functions, and defines
+//*****************************************************************************
+
+// the most values a format we replay hands back
+#define MAX_BENCH_VARS          8
+
+typedef bool (* PARSE_ARGS_FUNC)(CHAR_DATA *looker, bool show_errors,
+				 const char *cmd, char *args,
+				 const char *syntax, ...);
+
+bool old_parse_args(CHAR_DATA *looker, bool show_errors, const char *cmd,
+		    char *args, const char *syntax, ...);
+
+//
+// one line a player might type, and the format its command parses it with.
+// list_var is the value that may hold a list of everything that was found,
+// and multi_var the one that says whether it does. NOTHING if there are none
+typedef struct {
+  const char *cmd;
+  const char *format;
+  const char *line;
+  int     list_var;
+  int    multi_var;
+} BENCH_LINE;
+
+BENCH_LINE bench_lines[] = {
+  { "get",  "[the] word(object) | [from] obj.room.inv.eq",
+    "sword", NOTHING, NOTHING },
+  { "get",  "[the] word(object) | [from] obj.room.inv.eq",
+    "the sword from bag", NOTHING, NOTHING },
+  { "get",  "[the] word(object) | [from] obj.room.inv.eq",
+    "2.coin from the bag", NOTHING, NOTHING },
+  { "get",  "obj.room.multiple",
+    "all", 0, 1 },
+  { "get",  "obj.room.multiple",
+    "bread", 0, 1 },
+  { "give", "[the] obj.inv.multiple [to] ch.room.noself",
+    "sword to bob", 0, 1 },
+  { "give", "[the] obj.inv.multiple [to] ch.room.noself",
+    "all.coin to bob", 0, 1 },
+  { "give", "[the] obj.inv.multiple [to] ch.room.noself",
+    "the bread to alice", 0, 1 },
+  { "give", "[the] obj.inv.multiple [to] ch.room.noself",
+    "sword to nobody", 0, 1 },
+  { "put",  "[the] obj.inv.multiple [in] [the] obj.room.inv",
+    "sword in bag", 0, 1 },
+  { "put",  "[the] obj.inv.multiple [in] [the] obj.room.inv",
+    "all in the bag", 0, 1 },
+  { "open", "[the] {obj.room.inv exit }",
+    "the bag", NOTHING, NOTHING },
+  { "open", "[the] {obj.room.inv exit }",
+    "north", NOTHING, NOTHING },
+  { "open", "[the] {obj.room.inv exit }",
+    "door", NOTHING, NOTHING },
+  { NULL, NULL, NULL, NOTHING, NOTHING }
+};
+
+// and the lines look takes, which go through generic_find's three formats
+const char *look_lines[] = {
+  "at the sword", "sword on table", "bag", "in bag", "the bar sign", NULL
+};
+
+// the things in our made up room
+char thing_buf[16];
+CHAR_DATA *looker = (CHAR_DATA *)&thing_buf[0];
+#define THING(n)         ((void *)&thing_buf[n])
+
+typedef struct {
+  const char   *name;
+  bitvector_t   type;
+  void        *thing;
+} BENCH_THING;
+
+BENCH_THING bench_things[] = {
+  { "sword",  FIND_TYPE_OBJ,  THING(1)  },
+  { "bag",    FIND_TYPE_OBJ,  THING(2)  },
+  { "coin",   FIND_TYPE_OBJ,  THING(3)  },
+  { "bread",  FIND_TYPE_OBJ,  THING(4)  },
+  { "table",  FIND_TYPE_OBJ,  THING(5)  },
+  { "sign",   FIND_TYPE_OBJ,  THING(6)  },
+  { "bob",    FIND_TYPE_CHAR, THING(7)  },
+  { "alice",  FIND_TYPE_CHAR, THING(8)  },
+  { "north",  FIND_TYPE_EXIT, THING(9)  },
+  { "door",   FIND_TYPE_EXIT, THING(10) },
+  { NULL, 0, NULL }
+};
+
+//
+// look for something in our made up room. all and all.x find every object
+void *find_specific(CHAR_DATA *looker, const char *at, const char *on,
+		    const char *in, bitvector_t find_types,
+		    bitvector_t find_scope, bool all_ok, int *found_type) {
+  const char *dot = strchr(at, '.');
+  int i;
+
+  if(all_ok && (find_types & FIND_TYPE_OBJ) &&
+     (!strcasecmp(at, "all") || !strncasecmp(at, "all.", 4))) {
+    LIST *list = newList();
+    for(i = 0; bench_things[i].name != NULL; i++)
+      if(bench_things[i].type == FIND_TYPE_OBJ)
+	listQueue(list, bench_things[i].thing);
+    if(found_type) *found_type = FOUND_LIST;
+    return list;
+  }
+
+  if(dot != NULL)
+    at = dot + 1;
+  for(i = 0; bench_things[i].name != NULL; i++) {
+    if(!(bench_things[i].type & find_types) ||
+       strcasecmp(bench_things[i].name, at))
+      continue;
+    if(found_type)
+      *found_type = (bench_things[i].type == FIND_TYPE_OBJ  ? FOUND_OBJ :
+		     bench_things[i].type == FIND_TYPE_CHAR ? FOUND_CHAR :
+		     FOUND_EXIT);
+    return bench_things[i].thing;
+  }
+  return NULL;
+}
+
+//
+// the rest of the mud that parse.c needs. Only Py_parse_args makes use of
+// the Python forms, and we don't call it
+void send_to_char(CHAR_DATA *ch, const char *format, ...) { }
+void log_string(const char *txt, ...) { }
+PyObject *charGetPyForm(CHAR_DATA *ch)         { return NULL; }
+PyObject *charGetPyFormBorrowed(CHAR_DATA *ch) { return NULL; }
+PyObject *objGetPyForm(OBJ_DATA *obj)          { return NULL; }
+PyObject *objGetPyFormBorrowed(OBJ_DATA *obj)  { return NULL; }
+PyObject *roomGetPyFormBorrowed(ROOM_DATA *rm) { return NULL; }
+PyObject *newPyExit(EXIT_DATA *exit)           { return NULL; }
+PyObject *PyList_fromList(LIST *list, void *convertor) { return NULL; }
+
+// these live in utils.c, which would drag in the rest of the mud
+int next_letter_in(const char *string, char marker) {
+  int i = 0;
+  for(i = 0; string[i] != '\0'; i++)
+    if(string[i] == marker)
+      return i;
+  return -1;
+}
+
+bool endswith(const char *string, const char *end) {
+  int slen = strlen(string);
+  int elen = strlen(end);
+  return (slen >= elen && !strcasecmp(string + slen - elen, end));
+}
+
+bool startswith(const char *string, const char *start) {
+  return !strncasecmp(string, start, strlen(start));
+}
+
+//
+// parse one line the way its command does. What was parsed out goes in vars,
+// and lists of things found are traded for their size, so the results of
+// two parses can be compared. Returns whether the line parsed
+bool bench_parse_line(PARSE_ARGS_FUNC parse, BENCH_LINE *line, void **vars) {
+  char buf[SMALL_BUFFER];
+  bool   ok = FALSE;
+  memset(vars, 0, sizeof(void *) * MAX_BENCH_VARS);
+  strcpy(buf, line->line);
+  ok = parse(looker, FALSE, line->cmd, buf, line->format,
+	     &vars[0], &vars[1], &vars[2], &vars[3],
+	     &vars[4], &vars[5], &vars[6], &vars[7]);
+  if(ok && line->multi_var != NOTHING && *(bool *)&vars[line->multi_var]) {
+    LIST *list = vars[line->list_var];
+    vars[line->list_var] = (void *)(long)listSize(list);
+    deleteList(list);
+  }
+  return ok;
+}
+
+//
+// parse a look line the way generic_find does
+bool bench_parse_look(PARSE_ARGS_FUNC parse, const char *line, char **vars) {
+  char buf[SMALL_BUFFER];
+  bool   ok = FALSE;
+  vars[0] = vars[1] = vars[2] = NULL;
+  strcpy(buf, line);
+  if(!(ok = parse(looker, FALSE, "", buf, "[at] [the] word | <on> [the] word",
+		  &vars[0], &vars[1]))) {
+    strcpy(buf, line);
+    if(!(ok = parse(looker, FALSE, "", buf,
+		    "[at] [the] word | <in> [the] word", &vars[0], &vars[2]))) {
+      strcpy(buf, line);
+      ok = parse(looker, FALSE, "", buf, "[at] [the] string", &vars[0]);
+    }
+  }
+  // strings point into the buffer, which we're about to lose
+  vars[0] = (char *)(vars[0] ? vars[0] - buf + 1 : 0);
+  vars[1] = (char *)(vars[1] ? vars[1] - buf + 1 : 0);
+  vars[2] = (char *)(vars[2] ? vars[2] - buf + 1 : 0);
+  return ok;
+}
+
+//
+// check both versions parse every line the same way. Returns how many don't
+int bench_verify(void) {
+  void *old_vars[MAX_BENCH_VARS], *new_vars[MAX_BENCH_VARS];
+  int   bad = 0, i, j;
+  for(i = 0; bench_lines[i].line != NULL; i++) {
+    bool old_ok = bench_parse_line(old_parse_args, &bench_lines[i], old_vars);
+    bool new_ok = bench_parse_line(parse_args,     &bench_lines[i], new_vars);
+    bool   same = (old_ok == new_ok);
+    // word and string values point into a buffer that is gone now, but they
+    // were the same buffer, so they can still be compared as numbers
+    for(j = 0; same && j < MAX_BENCH_VARS; j++)
+      same = (old_vars[j] == new_vars[j]);
+    if(!same) {
+      printf("parsed differently: %s %s\n", bench_lines[i].cmd,
+	     bench_lines[i].line);
+      bad++;
+    }
+  }
+  for(i = 0; look_lines[i] != NULL; i++) {
+    char *old_vars[3], *new_vars[3];
+    bool old_ok = bench_parse_look(old_parse_args, look_lines[i], old_vars);
+    bool new_ok = bench_parse_look(parse_args,     look_lines[i], new_vars);
+    if(old_ok != new_ok || memcmp(old_vars, new_vars, sizeof(old_vars))) {
+      printf("parsed differently: look %s\n", look_lines[i]);
+      bad++;
+    }
+  }
+  return bad;
+}
+
+//
+// replay every line rounds times. Returns how long it took, in ns
+double bench_replay(PARSE_ARGS_FUNC parse, int rounds, int *lines) {
+  void *vars[MAX_BENCH_VARS];
+  char *look_vars[3];
+  double start = bench_now();
+  int i, j;
+  *lines = 0;
+  for(i = 0; i < rounds; i++) {
+    for(j = 0; bench_lines[j].line != NULL; j++, (*lines)++)
+      bench_parse_line(parse, &bench_lines[j], vars);
+    for(j = 0; look_lines[j] != NULL; j++, (*lines)++)
+      bench_parse_look(parse, look_lines[j], look_vars);
+  }
+  return bench_now() - start;
+}
+
+
+
+//*****************************************************************************
+// the benchmark itself
+//*****************************************************************************
+int main(int argc, char **argv) {
+  int scale = (argc > 1 ? atoi(argv[1]) : 1), rounds, lines, bad;
+  if(scale < 1)
+    scale = 1;
+  rounds = 50000 * scale;
+
+  bad = bench_verify();
+  double old_ns = bench_replay(old_parse_args, rounds, &lines);
+  double new_ns = bench_replay(parse_args,     rounds, &lines);
+
+  printf("%d lines replayed; %d parsed differently\n", lines, bad);
+  printf("%-24s %10s %10s %9s\n", "", "old", "new", "speedup");
+  printf("%-24s %10.1f %10.1f %8.2fx\n", "ns per line",
+	 old_ns / lines, new_ns / lines, old_ns / new_ns);
+  return (bad > 0);
+}
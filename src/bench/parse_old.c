@@ -0,0 +1,688 @@
+//*****************************************************************************
+//
+// parse_old.c
+//
+// The parse_args that was used before formats were compiled once and cached,
+// kept around so parse_bench has something to compare the current version
+// against. It broke its format down into a list of tokens, and built a list
+// of malloc'd variables, every time it was called. Only the parse_args path
+// parse_bench times is kept: Py_parse_args is gone, and so are the syntax
+// error messages, since the bench never asks for errors to be shown. Only the
+// token types and options the replayed formats use are understood (word,
+// string, ch, obj, exit, flavor, { } and |), and the ch, obj, and exit
+// handling that was copied three times is done once. Its functions are
+// renamed so both can be linked into the same program; the rest of the code
+// is left as it was, except that its includes now point up a directory.
+//
+//*****************************************************************************
+
+#define compose_variable_list           old_compose_variable_list
+#define decompose_parse_format          old_decompose_parse_format
+#define deleteParseToken                old_deleteParseToken
+#define deleteParseVar                  old_deleteParseVar
+#define newParseToken                   old_newParseToken
+#define newParseTokenDescriptive        old_newParseTokenDescriptive
+#define newParseVar                     old_newParseVar
+#define parse_args                      old_parse_args
+#define parse_assign_vars               old_parse_assign_vars
+#define parse_flavor_token              old_parse_flavor_token
+#define parse_multi_token               old_parse_multi_token
+#define parse_one_datatype              old_parse_one_datatype
+#define parse_one_token                 old_parse_one_token
+#define parse_optional_token            old_parse_optional_token
+#define parse_token_thing               old_parse_token_thing
+#define use_one_parse_token             old_use_one_parse_token
+#define use_one_parse_token_thing       old_use_one_parse_token_thing
+
+#include "../mud.h"
+#include "../utils.h"
+#include "../handler.h"
+#include "../inform.h"
+#include "../parse.h"
+
+
+
+//*****************************************************************************
+// local datastructures, variables, and defines
+//*****************************************************************************
+#define PARSE_TOKEN_CHAR       0
+#define PARSE_TOKEN_OBJ        1
+#define PARSE_TOKEN_EXIT       3
+#define PARSE_TOKEN_MULTI      4
+#define PARSE_TOKEN_FLAVOR     5
+#define PARSE_TOKEN_WORD       6
+#define PARSE_TOKEN_OPTIONAL  10
+#define PARSE_TOKEN_STRING    11
+
+#define PARSE_VAR_CHAR         4
+#define PARSE_VAR_OBJ          5
+#define PARSE_VAR_EXIT         7
+#define PARSE_VAR_STRING       8
+
+
+//
+// data for one format argument
+typedef struct {
+  int             type; // ch, obj, exit, string, etc...?
+  bitvector_t    scope; // what scope arguments are supplied to find?
+  bool          all_ok; // is all. syntax allowed?
+  bool         self_ok; // if we're looking for a char, can we find ourself?
+  LIST     *token_list; // if we're a multi-type, a list of our possible format
+  char         *flavor; // if we're a flavor type, the string we accept
+  bool flavor_optional; // pretty self-explanatory :)
+} PARSE_TOKEN;
+
+//
+// create a new parse token of the specified type
+PARSE_TOKEN *newParseToken(int type) {
+  PARSE_TOKEN *token = calloc(1, sizeof(PARSE_TOKEN));
+  token->type = type;
+  if(type == PARSE_TOKEN_MULTI)
+    token->token_list = newList();
+  else if(type == PARSE_TOKEN_OBJ) {
+    SET_BIT(token->scope, FIND_SCOPE_VISIBLE);
+  }
+  else if(type == PARSE_TOKEN_EXIT) {
+    SET_BIT(token->scope, FIND_SCOPE_VISIBLE);
+    SET_BIT(token->scope, FIND_SCOPE_ROOM);
+  }
+  else if(type == PARSE_TOKEN_CHAR) {
+    SET_BIT(token->scope, FIND_SCOPE_VISIBLE);
+    token->self_ok = TRUE;
+  }
+  return token;
+}
+
+PARSE_TOKEN *newParseTokenDescriptive(int type, const char *format) {
+  PARSE_TOKEN *token = newParseToken(type);
+  // do we have a describer between ( and )?
+  if(endswith(format, ")") && strchr(format, '(')) {
+    format = format + next_letter_in(format, '(') + 1;
+    token->flavor = strdup(format);
+    token->flavor[strlen(token->flavor)-1] = '\0';
+  }
+  return token;
+}
+
+//
+// free a token from memory
+void deleteParseToken(PARSE_TOKEN *arg) {
+  if(arg->token_list)
+    deleteListWith(arg->token_list, deleteParseToken);
+  if(arg->flavor)
+    free(arg->flavor);
+  free(arg);
+}
+
+
+//
+// data for one parsed variable
+typedef struct {
+  int               type; // the type we parsed out
+  void          *ptr_val; // pointer value (ch, obj, exit, string)
+  int disambiguated_type; // our parse type (in parse.h) if we were parsed 
+                          // from a set of multiple possible types
+  bool multiple_possible; // was it possible to parse multiple variables
+  bool          multiple; // were multiple things parsed
+} PARSE_VAR;
+
+//
+// create a new parse var of the specified type
+PARSE_VAR *newParseVar(int type) {
+  PARSE_VAR          *var = calloc(1, sizeof(PARSE_VAR));
+  var->disambiguated_type = PARSE_NONE;
+  var->type               = type;
+  return var;
+}  
+
+//
+// delete a parse var
+void deleteParseVar(PARSE_VAR *var) {
+  free(var);
+}
+
+
+
+//*****************************************************************************
+// local functions
+//*****************************************************************************
+
+//
+// makes a ch, obj, or exit token, and parses the options the formats we replay
+// use. Returns NULL if there's bad options
+PARSE_TOKEN *parse_token_thing(int type, const char *options) {
+  // make it
+  PARSE_TOKEN *token = newParseTokenDescriptive(type, options);
+
+  // search for options
+  while(*options != '\0') {
+    if(type != PARSE_TOKEN_EXIT && !strncasecmp(options, ".room", 5)) {
+      options = options + 5;
+      SET_BIT(token->scope, FIND_SCOPE_ROOM);
+    }
+    else if(type == PARSE_TOKEN_OBJ && !strncasecmp(options, ".inv", 4)) {
+      options = options + 4;
+      SET_BIT(token->scope, FIND_SCOPE_INV);
+    }
+    else if(type == PARSE_TOKEN_OBJ && !strncasecmp(options, ".eq", 3)) {
+      options = options + 3;
+      SET_BIT(token->scope, FIND_SCOPE_WORN);
+    }
+    else if(type != PARSE_TOKEN_EXIT && !strncasecmp(options, ".multiple", 9)) {
+      options = options + 9;
+      token->all_ok = TRUE;
+    }
+    else if(type == PARSE_TOKEN_CHAR && !strncasecmp(options, ".noself", 7)) {
+      options = options + 7;
+      token->self_ok = FALSE;
+    }
+    else if(*options == '(' && endswith(options, ")"))
+      break;
+    // didn't recognize the option
+    else {
+      deleteParseToken(token);
+      token = NULL;
+      break;
+    }
+  }
+
+  // if we successfully parsed the token, make sure there's a scope to look in
+  if(token != NULL && type != PARSE_TOKEN_EXIT &&
+     !IS_SET(token->scope, FIND_SCOPE_ROOM | FIND_SCOPE_INV | FIND_SCOPE_WORN)){
+    deleteParseToken(token);
+    token = NULL;
+  }
+
+  return token;
+}
+
+//
+// parses one actual thing (word, string, ch, obj, exit) marker.
+// Does not understand { }, ( ), [ ], |, or *. Assumes no leading whitespaces.
+PARSE_TOKEN *parse_one_datatype(const char **format) {
+  char buf[SMALL_BUFFER];
+  const char    *fmt = *format;
+  PARSE_TOKEN *token = NULL;
+  int i = 0;
+
+  // copy what we're trying to parse
+  for(i = 0; isalpha(*fmt) || (strchr("_.()", *fmt) && *fmt); i++, fmt++)
+    // *fmt == '_' || *fmt == '.'; i++, fmt++)
+    buf[i] = *fmt;
+  buf[i] = '\0';
+
+  // figure out our type
+  if(startswith(buf, "word"))
+    token = newParseTokenDescriptive(PARSE_TOKEN_WORD, buf);
+  else if(startswith(buf, "string"))
+    token = newParseTokenDescriptive(PARSE_TOKEN_STRING, buf);
+
+  // exits, chars, and objs can have arguments tagged to the end of them. For
+  // exits, it is optional. For both chars and objs, it is neccessary to specify
+  // at least the scope of search (e.g. ch.room, obj.inv, obj.room.inv)
+  else if(!strcasecmp(buf, "exit") || !strncasecmp(buf, "exit.", 5))
+    token = parse_token_thing(PARSE_TOKEN_EXIT, buf+4);
+  else if(!strncasecmp(buf, "ch.", 3))
+    token = parse_token_thing(PARSE_TOKEN_CHAR, buf+2);
+  else if(!strncasecmp(buf, "obj.", 4))
+    token = parse_token_thing(PARSE_TOKEN_OBJ, buf+3);
+
+  // up the location of format if we successfully parsed something
+  if(token != NULL)
+    *format = fmt;
+
+  // return whatever we found
+  return token;
+}
+
+//
+// parses a multi token assumes no leading whitespace
+PARSE_TOKEN *parse_multi_token(const char **format) {
+  const char *fmt = *format;
+  bool close_found = FALSE;
+
+  // skip our opening {
+  fmt++;
+
+  // skip any leading whitespace
+  while(isspace(*fmt))
+    fmt++;
+
+  // make our multi-token
+  PARSE_TOKEN *multi_token = newParseToken(PARSE_TOKEN_MULTI);
+
+  // parse all of our tokens and add them to the multi-list
+  while(*fmt != '\0' && !close_found) {
+    PARSE_TOKEN *one_token = parse_one_datatype(&fmt);
+
+    // did we parse the token alright?
+    if(one_token != NULL) {
+      listQueue(multi_token->token_list, one_token);
+      // up the positioning of format
+      *format = fmt;
+    }
+    // syntactic error. break out!
+    else
+      break;
+
+    // skip any whitespace
+    while(isspace(*fmt))
+      fmt++;
+
+    // have we encountered the closing bracket?
+    if(*fmt == '}')
+      close_found = TRUE;
+  }
+
+  // if we never found a close, or we didn't parse any arguments,
+  // delete the token because it was not finished
+  if(close_found == FALSE || listSize(multi_token->token_list) == 0) {
+    deleteParseToken(multi_token);
+    multi_token = NULL;
+  }
+  // otherwise, skip the closing bracket and up the position of format
+  else {
+    fmt++;
+    *format = fmt;
+  }
+
+  return multi_token;
+}
+
+//
+// parses a flavor token
+PARSE_TOKEN *parse_flavor_token(const char **format, bool optional) {
+  // make it
+  char buf[SMALL_BUFFER];
+  PARSE_TOKEN     *token = newParseToken(PARSE_TOKEN_FLAVOR);
+  token->flavor_optional = optional;
+  char       open_marker = (optional ? '[' : '<');
+  char      close_marker = (optional ? ']' : '>');
+  const char        *fmt = *format;
+  int      i, open_count = 1;
+
+  // skip the opening marker
+  fmt++;
+
+  // copy the flavor over to our buffer
+  for(i = 0; *fmt != '\0'; i++, fmt++) {
+    // did we encounter an open marker? if so, up our open count
+    if(*fmt == open_marker)
+      open_count++;
+    // did we encounter a close marker? if so, lower our open count
+    else if(*fmt == close_marker)
+      open_count--;
+    // did we just close everything off? if so, break out and skip last token
+    if(open_count == 0) {
+      fmt++;
+      break;
+    }
+    buf[i] = *fmt;
+  }
+  buf[i] = '\0';
+
+  // make sure we closed everything off
+  if(open_count > 0) {
+    deleteParseToken(token);
+    token = NULL;
+  }
+  // move our format up and copy over the flavor string
+  else {
+    token->flavor = strdup(buf);
+    *format = fmt;
+  }
+
+  return token;
+}
+
+//
+// parse an optional marker
+PARSE_TOKEN *parse_optional_token(const char **format) {
+  // skip over the optional marker
+  (*format)++;
+  return newParseToken(PARSE_TOKEN_OPTIONAL);
+}
+
+//
+// parses out one argument. Returns NULL if an error was encountered. If there
+// was no error, ups the location of fmt to the end of the last argument parsed
+PARSE_TOKEN *parse_one_token(const char **format) {
+  const char    *fmt = *format;
+  PARSE_TOKEN *token = NULL;
+
+  // skip whitespaces
+  while(isspace(*fmt))
+    fmt++;
+
+  // are we trying to parse multiple arguments?
+  if(*fmt == '{')
+    token = parse_multi_token(&fmt);
+
+  // optional flavor format
+  else if(*fmt == '[')
+    token = parse_flavor_token(&fmt, TRUE);
+
+  // mandatory flavor format
+  else if(*fmt == '<')
+    token = parse_flavor_token(&fmt, FALSE);
+
+  // optional marker
+  else if(*fmt == '|')
+    token = parse_optional_token(&fmt);
+
+  // a datatype token
+  else
+    token = parse_one_datatype(&fmt);
+
+  // up the location of our format
+  *format = fmt;
+  
+  return token;
+}
+
+//
+// breaks up a format string into its parts and returns a list of them
+LIST *decompose_parse_format(const char *format) {
+  const char  *fmt = format; 
+  bool       error = FALSE;
+  LIST *token_list = newList();
+
+  // try to parse all of our format down into tokens
+  while(*fmt != '\0' && !error) {
+    PARSE_TOKEN *token = parse_one_token(&fmt);
+
+    // did the token parse OK?
+    if(token != NULL)
+      listQueue(token_list, token);
+    else
+      error = TRUE;
+  }
+
+  // did we encounter an error?
+  if(error == TRUE) {
+    deleteListWith(token_list, deleteParseToken);
+    token_list = NULL;
+  }
+
+  return token_list;
+}
+
+//
+// tries to make a ch, obj, or exit parse var. Only objects come back as lists
+// in the room we search, so only they can be multiple
+PARSE_VAR *use_one_parse_token_thing(CHAR_DATA *looker, PARSE_TOKEN *tok,
+				     const char *name) {
+  bitvector_t find_type = (tok->type == PARSE_TOKEN_CHAR ? FIND_TYPE_CHAR :
+			   tok->type == PARSE_TOKEN_OBJ  ? FIND_TYPE_OBJ  :
+			   FIND_TYPE_EXIT);
+  int    type = FOUND_NONE;
+  void *found = find_specific(looker, name, "", "", find_type, tok->scope,
+			      tok->all_ok, &type);
+
+  // make sure we found something
+  if(found == NULL)
+    return NULL;
+  else {
+    PARSE_VAR *var = newParseVar(tok->type == PARSE_TOKEN_CHAR ? PARSE_VAR_CHAR:
+				 tok->type == PARSE_TOKEN_OBJ  ? PARSE_VAR_OBJ :
+				 PARSE_VAR_EXIT);
+
+    // if multiple vals were possible, flag it
+    var->multiple_possible = tok->all_ok;
+
+    // is it multiple items?
+    if(type == FOUND_LIST) {
+      if(listSize(found) > 1) {
+	var->ptr_val = found;
+	var->multiple = TRUE;
+      }
+      else if(listSize(found) == 1) {
+	var->ptr_val = listPop(found);
+	deleteList(found);
+      }
+      else {
+	deleteList(found);
+	deleteParseVar(var);
+	var = NULL;
+      }
+    }
+    // make sure it's not us if that's not allowed
+    else if(tok->type != PARSE_TOKEN_CHAR || tok->self_ok || looker != found)
+      var->ptr_val = found;
+    else {
+      deleteParseVar(var);
+      var = NULL;
+    }
+
+    // return whatever we found
+    return var;
+  }
+}
+
+//
+// Tries to apply a token to args, to parse something out. Returns a PARSE_VAR
+// if the token's usage resulted in the creation of a variable. If an error was
+// encountered, make this apparent by setting the value of the variable at error
+PARSE_VAR *use_one_parse_token(CHAR_DATA *looker, PARSE_TOKEN *tok, 
+			       char **args, bool *error) {
+  char buf[SMALL_BUFFER];
+  PARSE_VAR  *var = NULL;
+  char       *arg = *args;
+
+  // skip over any leading spaces we might have
+  while(isspace(*arg))
+    arg++;
+
+  switch(tok->type) {
+  case PARSE_TOKEN_MULTI: {
+    // make a proxy error value so we don't accidentally set it when it turns
+    // out we find something on a var past the first
+    bool multi_err = FALSE;
+
+    // go through all of our possible types until we find something
+    LIST_ITERATOR multi_i;
+    listIteratorStart(&multi_i, tok->token_list);
+    PARSE_TOKEN      *mtok = NULL;
+    bool multiple_possible = FALSE;
+    ITERATE_LIST(mtok, &multi_i) {
+      if(mtok->all_ok)
+	multiple_possible = TRUE;
+      var = use_one_parse_token(looker, mtok, &arg, &multi_err);
+      // reset our error value for the next pass at it...
+      if(var == NULL)
+	multi_err = FALSE;
+      // found something! Disambiguate the type
+      else {
+	switch(mtok->type) {
+	case PARSE_TOKEN_CHAR:    var->disambiguated_type = PARSE_CHAR;   break;
+	case PARSE_TOKEN_EXIT:    var->disambiguated_type = PARSE_EXIT;   break;
+	case PARSE_TOKEN_OBJ:     var->disambiguated_type = PARSE_OBJ;    break;
+	case PARSE_TOKEN_WORD:    var->disambiguated_type = PARSE_STRING; break;
+	case PARSE_TOKEN_STRING:  var->disambiguated_type = PARSE_STRING; break;
+	}
+	// break out of the loop... we found something
+	break;
+      }
+    } listIteratorStop(&multi_i);
+
+    // did we manage not to find something?
+    if(var != NULL)
+      var->multiple_possible = multiple_possible;
+    else
+      *error = TRUE;
+    break;
+  }
+
+  case PARSE_TOKEN_FLAVOR: {
+    int len = strlen(tok->flavor);
+    // have we found the flavor text?
+    if(strncasecmp(tok->flavor, arg, len) == 0 &&
+	 (arg[len] == '\0' || isspace(arg[len])))
+      arg = arg + len;
+    // do we need to do something about it?
+    else if(!tok->flavor_optional)
+      *error = TRUE;
+    break;
+  }
+
+    // parse out a char, obj, or exit value
+  case PARSE_TOKEN_CHAR:
+  case PARSE_TOKEN_OBJ:
+  case PARSE_TOKEN_EXIT:
+    arg = one_arg(arg, buf);
+    var = use_one_parse_token_thing(looker, tok, buf);
+    if(var == NULL)
+      *error = TRUE;
+    break;
+
+    // parse out a single word
+  case PARSE_TOKEN_WORD: {
+    var = newParseVar(PARSE_VAR_STRING);
+    var->ptr_val    = arg;
+    bool multi_word = FALSE;
+    char multi_mark = '"';
+
+    // are we using quotation marks to specify multiple words?
+    if(*arg == '"' || *arg == '\'') {
+      multi_word = TRUE;
+      multi_mark = *arg;
+      arg++;
+      var->ptr_val = arg;
+    }
+
+    // go through arg to the next space, and delimit the word
+    for(; *arg != '\0'; arg++) {
+      if((multi_word && *arg == multi_mark) || (!multi_word && isspace(*arg))) {
+	*arg = '\0';
+	arg++;
+	break;
+      }
+    }
+    break;
+  }
+
+    // copies whatever is left
+  case PARSE_TOKEN_STRING:
+    var = newParseVar(PARSE_VAR_STRING);
+    var->ptr_val = arg;
+    // skip up the place of the arg...
+    while(*arg != '\0')
+      arg++;
+    break;
+
+    // since this doesn't really parse a value...
+  case PARSE_TOKEN_OPTIONAL:
+    break;
+  }
+
+  // up the placement of our arg if we didn't encounter an error
+  if(!*error)
+    *args = arg;
+
+  return var;
+}
+
+//
+// builds up a list of variables out of the token list, and arguments. Returns
+// NULL if the arguments don't fit the tokens
+LIST *compose_variable_list(CHAR_DATA *looker, LIST *tokens, char *args) {
+  LIST      *variables = newList();
+  LIST_ITERATOR tok_i;
+  listIteratorStart(&tok_i, tokens);
+  PARSE_TOKEN     *tok = NULL;
+  bool           error = FALSE;
+  bool  optional_found = FALSE;
+
+  // go through our list of tokens, and try dealing with the args
+  ITERATE_LIST(tok, &tok_i) {
+    PARSE_VAR *var = NULL;
+
+    // did we just encounter an optional value?
+    if(tok->type == PARSE_TOKEN_OPTIONAL) {
+      optional_found = TRUE;
+      continue;
+    }
+    
+    // can we still use tokens to process stuff?
+    if(*args != '\0')
+      var = use_one_parse_token(looker, tok, &args, &error);
+    // we haven't found an "optional" marker yet - this isn't allowed
+    else if(optional_found == FALSE)
+      error = TRUE;
+    // we have found an "optional" marker. Just break out of the loop
+    else 
+      break;
+
+    // if use of the token returned a new variable, append it
+    if(var != NULL)
+      listQueue(variables, var);
+    // if we enountered an error, stop here
+    else if(error == TRUE) {
+      deleteListWith(variables, deleteParseVar);
+      variables = NULL;
+      break;
+    }
+  } listIteratorStop(&tok_i);
+
+  return variables;
+}
+
+//
+// Goes through the list of variables and fills up vargs with them as needed
+void parse_assign_vars(LIST *variables, va_list vargs) {
+  LIST_ITERATOR var_i;
+  listIteratorStart(&var_i, variables);
+  PARSE_VAR   *one_var = NULL;
+
+  // go through each variable and assign to vargs as needed
+  ITERATE_LIST(one_var, &var_i) {
+    // first, do our basic type. Everything we parse out is a pointer
+    *va_arg(vargs, void **) = one_var->ptr_val;
+
+    // now see if we have a multi_type
+    if(one_var->disambiguated_type != PARSE_NONE)
+      *va_arg(vargs, int *) = one_var->disambiguated_type;
+
+    // and if we parsed multiple occurences
+    if(one_var->multiple_possible == TRUE)
+      *va_arg(vargs, bool *) = one_var->multiple;
+  } listIteratorStop(&var_i);
+}
+
+
+//*****************************************************************************
+// implementation of parse.h
+//*****************************************************************************
+
+bool parse_args(CHAR_DATA *looker, bool show_errors, const char *cmd,
+		char *args, const char *syntax, ...) {
+  bool       parse_ok = TRUE;
+  LIST       *tokens  = NULL;
+  LIST     *variables = NULL;
+
+  // get our list of tokens
+  if((tokens = decompose_parse_format(syntax)) == NULL) {
+    log_string("Command '%s', format error in argument parsing: %s",cmd,syntax);
+    parse_ok = FALSE;
+  }
+  // try to use our tokens to compose a variable list
+  else if((variables = compose_variable_list(looker, tokens, args))
+	  == NULL)
+    parse_ok = FALSE;
+  else {
+    // go through all of our vars and assign them to the proper args
+    va_list vargs;
+    va_start(vargs, syntax);
+    parse_assign_vars(variables, vargs);
+    va_end(vargs);
+  }
+
+  // clean up our mess
+  if(tokens != NULL)
+    deleteListWith(tokens, deleteParseToken);
+  if(variables != NULL)
+    deleteListWith(variables, deleteParseVar);
+
+  // return our parse status
+  return parse_ok;
+}
@@ -0,0 +1,196 @@
+//*****************************************************************************
+//
+// storage_bench.c
+//
+// Times loading a whole directory of storage files (e.g. the world) as text,
+// and then again after converting each file to the binary format. Every file
+// under the directory is copied into a scratch directory in both formats
+// first, so the files being timed are the same ones, and the originals are
+// never touched. Each set read in binary is checked against the same set
+// read as text.
+//
+// usage: ./storage_bench <directory> [rounds]
+//   e.g. ./bench/storage_bench ../lib/world 50
+//   rounds is how many times the whole directory is loaded. Defaults to 20
+//
+//*****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "../mud.h"
+#include "../storage.h"
+#include "bench.h"
+
+
+
+//*****************************************************************************
+// local datastructures, functions, and defines
+//*****************************************************************************
+
+// the most files we'll load from a directory
+#define MAX_BENCH_FILES     100000
+
+char *text_files[MAX_BENCH_FILES];
+char  *bin_files[MAX_BENCH_FILES];
+int    num_files = 0;
+long  text_bytes = 0;
+long   bin_bytes = 0;
+
+//
+// storage_read reports binary files it can't parse through bug()
+void bug(const char *txt, ...) {
+  va_list args;
+  va_start(args, txt);
+  vfprintf(stderr, txt, args);
+  va_end(args);
+  fprintf(stderr, "\n");
+}
+
+long file_size(const char *fname) {
+  struct stat st;
+  return (stat(fname, &st) == 0 ? (long)st.st_size : 0);
+}
+
+//
+// return whether two files hold the same bytes
+bool same_file(const char *fname1, const char *fname2) {
+  FILE *fl1 = fopen(fname1, "rb"), *fl2 = fopen(fname2, "rb");
+  int   c1 = EOF, c2 = EOF;
+  if(fl1 != NULL && fl2 != NULL) {
+    do {
+      c1 = fgetc(fl1);
+      c2 = fgetc(fl2);
+    } while(c1 == c2 && c1 != EOF);
+  }
+  if(fl1) fclose(fl1);
+  if(fl2) fclose(fl2);
+  return (fl1 != NULL && fl2 != NULL && c1 == c2);
+}
+
+//
+// copy every storage file under path into the scratch directory, once as
+// text and once as binary
+void bench_collect(const char *path, const char *scratch) {
+  struct stat st;
+  STORAGE_SET *set = NULL;
+  char buf[MAX_BUFFER];
+
+  if(stat(path, &st) != 0 || num_files == MAX_BENCH_FILES)
+    return;
+  else if(S_ISDIR(st.st_mode)) {
+    DIR             *dir = opendir(path);
+    struct dirent *entry = NULL;
+    if(dir == NULL)
+      return;
+    while((entry = readdir(dir)) != NULL) {
+      if(*entry->d_name == '.')
+	continue;
+      snprintf(buf, sizeof(buf), "%s/%s", path, entry->d_name);
+      bench_collect(buf, scratch);
+    }
+    closedir(dir);
+  }
+  else if((set = storage_read(path)) != NULL) {
+    snprintf(buf, sizeof(buf), "%s/%d.txt", scratch, num_files);
+    storage_write_format(set, buf, STORAGE_FORMAT_TEXT);
+    text_files[num_files] = strdup(buf);
+    text_bytes += file_size(buf);
+
+    snprintf(buf, sizeof(buf), "%s/%d.bin", scratch, num_files);
+    storage_write_format(set, buf, STORAGE_FORMAT_BINARY);
+    bin_files[num_files] = strdup(buf);
+    bin_bytes += file_size(buf);
+
+    storage_close(set);
+    num_files++;
+  }
+}
+
+//
+// load every file in the list, rounds times. Returns how long it took, in ns
+double bench_load(char **files, int rounds) {
+  double start = bench_now();
+  int i, j;
+  for(i = 0; i < rounds; i++) {
+    for(j = 0; j < num_files; j++) {
+      STORAGE_SET *set = storage_read(files[j]);
+      if(set != NULL)
+	storage_close(set);
+    }
+  }
+  return bench_now() - start;
+}
+
+//
+// read each binary file and write it back out as text. It should come out
+// the same as the text file
+int bench_verify(const char *scratch) {
+  char buf[MAX_BUFFER];
+  int  bad = 0, i;
+  snprintf(buf, sizeof(buf), "%s/verify", scratch);
+  for(i = 0; i < num_files; i++) {
+    STORAGE_SET *set = storage_read(bin_files[i]);
+    if(set == NULL)
+      bad++;
+    else {
+      storage_write_format(set, buf, STORAGE_FORMAT_TEXT);
+      storage_close(set);
+      if(!same_file(buf, text_files[i]))
+	bad++;
+    }
+  }
+  unlink(buf);
+  return bad;
+}
+
+
+
+//*****************************************************************************
+// the benchmark itself
+//*****************************************************************************
+int main(int argc, char **argv) {
+  char scratch[] = "/tmp/storage_bench.XXXXXX";
+  int   rounds = (argc > 2 ? atoi(argv[2]) : 20), bad, i;
+
+  if(argc < 2) {
+    fprintf(stderr, "usage: %s <directory> [rounds]\n", argv[0]);
+    return 1;
+  }
+  if(rounds < 1)
+    rounds = 1;
+  if(mkdtemp(scratch) == NULL) {
+    perror("could not make a scratch directory");
+    return 1;
+  }
+
+  bench_collect(argv[1], scratch);
+  bad = bench_verify(scratch);
+  double text_ns = bench_load(text_files, rounds);
+  double  bin_ns = bench_load(bin_files,  rounds);
+
+  printf("%d files loaded %d times; %d binary files differ from text\n",
+	 num_files, rounds, bad);
+  printf("%-24s %12s %12s %9s\n", "", "text", "binary", "speedup");
+  printf("%-24s %12ld %12ld %8.2fx\n", "bytes on disk",
+	 text_bytes, bin_bytes,
+	 (double)text_bytes / (bin_bytes > 0 ? bin_bytes : 1));
+  printf("%-24s %12.2f %12.2f %8.2fx\n", "ms per load of all files",
+	 text_ns / rounds / 1e6, bin_ns / rounds / 1e6, text_ns / bin_ns);
+  printf("%-24s %12.2f %12.2f\n", "us per file",
+	 text_ns / rounds / (num_files > 0 ? num_files : 1) / 1e3,
+	 bin_ns / rounds / (num_files > 0 ? num_files : 1) / 1e3);
+
+  // clean up our scratch files
+  for(i = 0; i < num_files; i++) {
+    unlink(text_files[i]);
+    unlink(bin_files[i]);
+    free(text_files[i]);
+    free(bin_files[i]);
+  }
+  rmdir(scratch);
+  return (bad > 0);
+}
@@ -37,6 +37,7 @@
 //
 //*****************************************************************************
 
+#include <limits.h>
 #include "mud.h"
 #include "utils.h"
 
@@ -51,6 +52,9 @@
 // data assocciated with them (i.e. bit:value mappings)
 HASHTABLE *bitvector_table = NULL;
 
+// goes up each time a bit is added to any bitvector
+int      bitvector_version = 0;
+
 typedef struct bitvector_data {
   HASHTABLE *bitmap; // a mapping from bit name to bit number
   char        *name; // which bitvector is this?
@@ -59,6 +63,8 @@ typedef struct bitvector_data {
 struct bitvector {
   BITVECTOR_DATA *data; // the data corresponding to this bitvector
   char           *bits; // the bits we have set/unset
+  int              len; // how many bytes bits holds. Bits added to our
+                        // bitvector after we were made may not fit
 };
 
 BITVECTOR_DATA *newBitvectorData(const char *name) {
@@ -68,6 +74,18 @@ BITVECTOR_DATA *newBitvectorData(const char *name) {
   return data;
 }
 
+//
+// make sure the instance has room for bit number val, growing it if bits were
+// added to its bitvector after it was made
+void bitvectorFit(BITVECTOR *v, int val) {
+  if(val/8 >= v->len) {
+    int len = hashSize(v->data->bitmap)/8 + 1;
+    v->bits = realloc(v->bits, len);
+    memset(v->bits + v->len, 0, len - v->len);
+    v->len  = len;
+  }
+}
+
 
 
 
@@ -99,8 +117,10 @@ void init_bitvectors() {
 
 void bitvectorAddBit(const char *name, const char *bit) {
   BITVECTOR_DATA *data = hashGet(bitvector_table, name);
-  if(data != NULL)
+  if(data != NULL) {
     hashPut(data->bitmap, bit, (void *)(hashSize(data->bitmap) + 1));
+    bitvector_version++;
+  }
 }
 
 void bitvectorCreate(const char *name) {
@@ -121,6 +141,7 @@ BITVECTOR   *bitvectorInstanceOf(const char *name) {
     vector = newBitvector();
     vector->data = data;
     vector->bits = calloc(vector_len, sizeof(char));
+    vector->len  = vector_len;
   }
   return vector;
 }
@@ -134,8 +155,9 @@ void         bitvectorCopyTo(BITVECTOR *from, BITVECTOR *to) {
   int bit_len = 1 + hashSize(from->data->bitmap)/8;
   to->data = from->data;
   if(to->bits) free(to->bits);
-  to->bits = malloc(sizeof(char) * bit_len);
-  to->bits = memcpy(to->bits, from->bits, bit_len);
+  to->bits = calloc(bit_len, sizeof(char));
+  to->bits = memcpy(to->bits, from->bits, MIN(bit_len, from->len));
+  to->len  = bit_len;
 }
 
 BITVECTOR   *bitvectorCopy(BITVECTOR *v) {
@@ -178,7 +200,7 @@ bool bitIsAllSet(BITVECTOR *v, const char *bit) {
 
 bool bitIsOneSet(BITVECTOR *v, const char *bit) {
   int val = (int)hashGet(v->data->bitmap, bit);
-  return IS_SET(v->bits[val/8], (1 << (val % 8)));
+  return (val/8 < v->len && IS_SET(v->bits[val/8], (1 << (val % 8))));
 }
 
 void bitSet(BITVECTOR *v, const char *name) {
@@ -191,6 +213,7 @@ void bitSet(BITVECTOR *v, const char *name) {
     free(one_bit);
     // 0 is a filler meaning 'this is not an actual name for a bit'
     if(val == 0) continue;
+    bitvectorFit(v, val);
     SET_BIT(v->bits[val/8], (1 << (val % 8)));
   }
 
@@ -199,9 +222,7 @@ void bitSet(BITVECTOR *v, const char *name) {
 }
 
 void bitClear(BITVECTOR *v) {
-  int i;
-  for(i = 1; i <= hashSize(v->data->bitmap); i++)
-    REMOVE_BIT(v->bits[i/8], (1 << (i % 8)));
+  memset(v->bits, 0, v->len);
 }
 
 void bitRemove(BITVECTOR *v, const char *name) {
@@ -211,7 +232,8 @@ void bitRemove(BITVECTOR *v, const char *name) {
   // remove each one
   while( (one_bit = listPop(bits)) != NULL) {
     int val = (int)hashGet(v->data->bitmap, one_bit);
-    REMOVE_BIT(v->bits[val/8], (1 << (val % 8)));
+    if(val/8 < v->len)
+      REMOVE_BIT(v->bits[val/8], (1 << (val % 8)));
     free(one_bit);
   }
 
@@ -229,6 +251,7 @@ void bitToggle(BITVECTOR *v, const char *name) {
     free(one_bit);
     // 0 is a filler meaning 'this is not an actual name for a bit'
     if(val == 0) continue;
+    bitvectorFit(v, val);
     TOGGLE_BIT(v->bits[val/8], (1 << (val % 8)));
   }
 
@@ -255,6 +278,29 @@ const char *bitvectorGetBits(BITVECTOR *v) {
   return bits;
 }
 
+bitvector_t bitvectorGetMask(BITVECTOR *v) {
+  int          len = v->len, i;
+  unsigned long mask = 0;
+  if(len > sizeof(bitvector_t))
+    len = sizeof(bitvector_t);
+  for(i = 0; i < len; i++)
+    mask |= (unsigned long)(unsigned char)v->bits[i] << (8 * i);
+  // bit numbers start at 1, and the top bit would make the mask negative
+  return (bitvector_t)(mask & LONG_MAX);
+}
+
+bitvector_t bitvectorMaskOf(const char *name, const char *bit) {
+  BITVECTOR_DATA *data = hashGet(bitvector_table, name);
+  int              val = (data ? (int)hashGet(data->bitmap, bit) : 0);
+  if(val <= 0 || val >= sizeof(bitvector_t) * 8 - 1)
+    return 0;
+  return (bitvector_t)1 << val;
+}
+
+int bitvectorVersion(void) {
+  return bitvector_version;
+}
+
 int bitvectorSize(BITVECTOR *v) {
   return hashSize(v->data->bitmap);
 }
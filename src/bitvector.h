@@ -101,6 +101,15 @@ void bitToggle(BITVECTOR *v, const char *name);
 // return a comma-separated list of the bits the vector has set
 const char *bitvectorGetBits(BITVECTOR *v);
 
+//
+// Bits can also be read as a mask, for checks that happen too often to look
+// them up by name. Only the first 63 bits of a bitvector fit in a mask. The
+// mask of a bit that doesn't exist, or doesn't fit, is 0. Masks can go stale
+// when bits are added; bitvectorVersion changes whenever that happens
+bitvector_t bitvectorGetMask(BITVECTOR *v);
+bitvector_t bitvectorMaskOf(const char *name, const char *bit);
+int bitvectorVersion(void);
+
 //
 // returns the number of possible bits that can be set on this bitvector
 int bitvectorSize(BITVECTOR *v);
@@ -113,13 +113,14 @@ BODYPART *bodypartCopy(BODYPART *P) {
 
 char *list_postypes(const BODY_DATA *B, const char *posnames) {
   LIST           *names = parse_keywords(posnames);
-  LIST_ITERATOR *name_i = newListIterator(names);
+  LIST_ITERATOR name_i;
+  listIteratorStart(&name_i, names);
   BUFFER           *buf = newBuffer(100);
   char            *name = NULL;
   char          *retval = NULL;
   int             found = 0;
 
-  ITERATE_LIST(name, name_i) {
+  ITERATE_LIST(name, &name_i) {
     int part = bodyGetPart(B, name);
     if(part != BODYPOS_NONE) {
       found++;
@@ -127,7 +128,7 @@ char *list_postypes(const BODY_DATA *B, const char *posnames) {
 	bufferCat(buf, ", ");
       bufferCat(buf, bodyposGetName(part));
     }
-  } deleteListIterator(name_i);
+  } listIteratorStop(&name_i);
   deleteListWith(names, free);
 
   retval = strdup(bufferString(buf));
@@ -194,13 +195,14 @@ void bodySetSize(BODY_DATA *B, int size) {
 // Find a bodypart on the body with the given name
 //
 BODYPART *findBodypart(const BODY_DATA *B, const char *pos) {
-  LIST_ITERATOR *part_i = newListIterator(B->parts);
+  LIST_ITERATOR part_i;
+  listIteratorStart(&part_i, B->parts);
   BODYPART *part = NULL;
 
-  ITERATE_LIST(part, part_i)
+  ITERATE_LIST(part, &part_i)
     if(!strcasecmp(part->name, pos))
       break;
-  deleteListIterator(part_i);
+  listIteratorStop(&part_i);
 
   return part;
 }
@@ -213,12 +215,13 @@ BODYPART *findFreeBodypart(BODY_DATA *B, const char *type) {
   int typenum = bodyposGetNum(type);
   if(typenum == BODYPOS_NONE) return NULL;
 
-  LIST_ITERATOR *part_i = newListIterator(B->parts);
+  LIST_ITERATOR part_i;
+  listIteratorStart(&part_i, B->parts);
   BODYPART *part = NULL;
-  ITERATE_LIST(part, part_i)
+  ITERATE_LIST(part, &part_i)
     if(part->type == typenum && part->equipment == NULL)
       break;
-  deleteListIterator(part_i);
+  listIteratorStop(&part_i);
 
   return part;
 }
@@ -255,18 +258,19 @@ int bodyGetPart(const BODY_DATA *B, const char *pos) {
 
 
 double bodyPartRatio(const BODY_DATA *B, const char *pos) {
-  LIST_ITERATOR *part_i = newListIterator(B->parts);
+  LIST_ITERATOR part_i;
+  listIteratorStart(&part_i, B->parts);
   BODYPART        *part = NULL;
   double      part_size = 0.0;
   double      body_size = 0.0;
 
   // add up all of the weights, and find the weight of our pos
-  ITERATE_LIST(part, part_i) {
+  ITERATE_LIST(part, &part_i) {
     body_size += part->size;
     if(is_keyword(pos, part->name, FALSE))
       part_size += part->size;
   }
-  deleteListIterator(part_i);
+  listIteratorStop(&part_i);
 
   // to prevent div0, albeit an unlikely event
   return (body_size == 0.0 ? 0 : (part_size / body_size));
@@ -316,26 +320,27 @@ const char **bodyGetParts(const BODY_DATA *B, bool sort, int *num_pos) {
   *num_pos = listSize(B->parts);
 
   const char **parts = malloc(sizeof(char *) * *num_pos);
-  LIST_ITERATOR *part_i = newListIterator(B->parts);
+  LIST_ITERATOR part_i;
+  listIteratorStart(&part_i, B->parts);
   BODYPART *part = NULL;
   int i = 0;
 
   // if we don't need to sort, this should be fine ...
   if(!sort) {
-    ITERATE_LIST(part, part_i)
+    ITERATE_LIST(part, &part_i)
       parts[i] = part->name;
-    deleteListIterator(part_i);
+    listIteratorStop(&part_i);
   }
   // take some extra steps to make sure everything is sorted
   else {
     int pos[*num_pos];
 
     i = 0;
-    ITERATE_LIST(part, part_i) {
+    ITERATE_LIST(part, &part_i) {
       parts[i] = part->name;
       pos[i]   = part->type;
       i++;
-    } deleteListIterator(part_i);
+    } listIteratorStop(&part_i);
 
     // now sort everything in the array
     for(i = 0; i < *num_pos; i++) {
@@ -384,16 +389,17 @@ bool bodyEquipPostypes(BODY_DATA *B, OBJ_DATA *obj, const char *types) {
   // equip them as we go along, incase we more than one of a piece.
   // if we don't do it this way, findFreeBodypart might find the same
   // piece multiple times (e.g. the same ear when it's looking for two ears)
-  LIST_ITERATOR *pos_i = newListIterator(pos_list);
+  LIST_ITERATOR pos_i;
+  listIteratorStart(&pos_i, pos_list);
   char            *pos = NULL;
 
-  ITERATE_LIST(pos, pos_i) {
+  ITERATE_LIST(pos, &pos_i) {
     part = findFreeBodypart(B, pos);
     if(part && !part->equipment) {
       part->equipment = obj;
       listPut(parts, part);
     }
-  } deleteListIterator(pos_i);
+  } listIteratorStop(&pos_i);
 
   // make sure we supplied a valid number of empty positions
   if(listSize(pos_list) != listSize(parts)) {
@@ -427,13 +433,14 @@ bool bodyEquipPosnames(BODY_DATA *B, OBJ_DATA *obj, const char *positions) {
   parts = newList();
 
   // get a list of all open slots in the list provided
-  LIST_ITERATOR *pos_i = newListIterator(pos_list);
+  LIST_ITERATOR pos_i;
+  listIteratorStart(&pos_i, pos_list);
   char            *pos = NULL;
-  ITERATE_LIST(pos, pos_i) {
+  ITERATE_LIST(pos, &pos_i) {
     part = findBodypart(B, pos);
     if(part && !part->equipment && !listIn(parts, part))
       listPut(parts, part);
-  } deleteListIterator(pos_i);
+  } listIteratorStop(&pos_i);
 
   // make sure we found the right amount of parts
   if(listSize(parts) != listSize(pos_list) || listSize(parts) == 0)
@@ -454,18 +461,19 @@ const char *bodyEquippedWhere(BODY_DATA *B, OBJ_DATA *obj) {
   static char buf[SMALL_BUFFER];
   *buf = '\0';
 
-  LIST_ITERATOR *part_i = newListIterator(B->parts);
+  LIST_ITERATOR part_i;
+  listIteratorStart(&part_i, B->parts);
   BODYPART *part = NULL;
   // go through the list of all parts, and print the name of any one
   // with the piece of equipment on it, onto the buf
-  ITERATE_LIST(part, part_i) {
+  ITERATE_LIST(part, &part_i) {
     if(part->equipment == obj) {
       // if we've already printed something, add a comma
       if(*buf)
 	strcat(buf, ", ");
       strcat(buf, part->name);
     }
-  } deleteListIterator(part_i);
+  } listIteratorStop(&part_i);
   return buf;
 }
 
@@ -475,43 +483,46 @@ OBJ_DATA *bodyGetEquipment(BODY_DATA *B, const char *pos) {
 }
 
 bool bodyUnequip(BODY_DATA *B, const OBJ_DATA *obj) {
-  LIST_ITERATOR *part_i = newListIterator(B->parts);
+  LIST_ITERATOR part_i;
+  listIteratorStart(&part_i, B->parts);
   BODYPART      *part   = NULL;
   bool           found  = FALSE;
 
-  ITERATE_LIST(part, part_i) {
+  ITERATE_LIST(part, &part_i) {
     if(part->equipment == obj) {
       part->equipment = NULL;
       found = TRUE;
     }
-  } deleteListIterator(part_i);
+  } listIteratorStop(&part_i);
 
   return found;
 }
 
 LIST *bodyGetAllEq(BODY_DATA *B) {
   LIST *equipment = newList();
-  LIST_ITERATOR *part_i = newListIterator(B->parts);
+  LIST_ITERATOR part_i;
+  listIteratorStart(&part_i, B->parts);
   BODYPART *part = NULL;
 
-  ITERATE_LIST(part, part_i) {
+  ITERATE_LIST(part, &part_i) {
     if(part->equipment && !listIn(equipment, part->equipment))
       listPut(equipment, part->equipment);
-  } deleteListIterator(part_i);
+  } listIteratorStop(&part_i);
   return equipment;
 }
 
 LIST *bodyUnequipAll(BODY_DATA *B) {
   LIST *equipment = newList();
-  LIST_ITERATOR *part_i = newListIterator(B->parts);
+  LIST_ITERATOR part_i;
+  listIteratorStart(&part_i, B->parts);
   BODYPART *part = NULL;
 
-  ITERATE_LIST(part, part_i) {
+  ITERATE_LIST(part, &part_i) {
     if(part->equipment && !listIn(equipment, part->equipment)) {
       listPut(equipment, part->equipment);
       part->equipment = NULL;
     }
-  } deleteListIterator(part_i);
+  } listIteratorStop(&part_i);
   return equipment;
 }
 
@@ -56,6 +56,16 @@ void        bufferCat   (BUFFER *buf, const char *txt) {
   buf->len += txtlen;
 }
 
+void        bufferCatLength(BUFFER *buf, const char *txt, int len) {
+  // see if we need to expand the size of the buffer
+  if(len + buf->len >= buf->maxlen)
+    bufferExpand(buf, ((len + buf->len) * 5) / 4 + 20); 
+  // copy the new text over
+  memcpy(buf->data+buf->len, txt, len);
+  buf->len += len;
+  buf->data[buf->len] = '\0';
+}
+
 void        bufferCatCh (BUFFER *buf, const char ch) {
   static char tmp[2];
   tmp[0] = ch; tmp[1] = '\0';
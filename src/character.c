@@ -17,6 +17,7 @@
 #include "races.h"
 #include "auxiliary.h"
 #include "storage.h"
+#include "strpool.h"
 #include "character.h"
 
 const char *sex_names[NUM_SEXES] = {
@@ -90,16 +91,17 @@ struct char_data {
 
   BODY_DATA            * body;
   char                 * race;
-  char                 * prototypes;
-  char                 * class;
+  const char           * prototypes; // pooled. See strpool.h
+  const char           * class;       // pooled
 
   SOCKET_DATA          * socket;
   ROOM_DATA            * room;
   ROOM_DATA            * last_room;
   OBJ_DATA             * furniture;
-  BUFFER               * desc;
+  const char           * desc;        // pooled, unless we have desc_buf
+  BUFFER               * desc_buf;    // our own copy of desc, if asked for
   BUFFER               * look_buf;
-  char                 * name;
+  const char           * name;        // pooled
   int                    sex;
   int                    position;
   int                    hidden;
@@ -109,12 +111,13 @@ struct char_data {
   AUX_TABLE            * auxiliary_data;
   BITVECTOR            * prfs;
   BITVECTOR            * user_groups;
+  void                 * actions;     // what we're doing. See action.c
 
   // data for NPCs only
-  char                 * rdesc;
-  char                 * multi_name;
-  char                 * multi_rdesc;
-  char                 * keywords;
+  const char           * rdesc;       // pooled
+  const char           * multi_name;  // pooled
+  const char           * multi_rdesc; // pooled
+  const char           * keywords;    // pooled
 };
 
 
@@ -131,19 +134,19 @@ CHAR_DATA *newChar() {
   ch->last_room     = NULL;
   ch->furniture     = NULL;
   ch->socket        = NULL;
-  ch->desc          = newBuffer(1);
+  ch->desc          = strpoolGet("");
   ch->look_buf      = newBuffer(1);
-  ch->name          = strdup("");
+  ch->name          = strpoolGet("");
   ch->sex           = SEX_NEUTRAL;
   ch->position      = POS_STANDING;
   ch->inventory     = newList();
 
-  ch->class         = strdup("");
-  ch->prototypes    = strdup("");
-  ch->rdesc         = strdup("");
-  ch->keywords      = strdup("");
-  ch->multi_rdesc   = strdup("");
-  ch->multi_name    = strdup("");
+  ch->class         = strpoolGet("");
+  ch->prototypes    = strpoolGet("");
+  ch->rdesc         = strpoolGet("");
+  ch->keywords      = strpoolGet("");
+  ch->multi_rdesc   = strpoolGet("");
+  ch->multi_name    = strpoolGet("");
   ch->prfs          = bitvectorInstanceOf("char_prfs");
   ch->user_groups   = bitvectorInstanceOf("user_groups");
   bitSet(ch->user_groups, DFLT_USER_GROUP);
@@ -159,18 +162,15 @@ CHAR_DATA *newChar() {
 // utility functions
 //*****************************************************************************
 void charSetRdesc(CHAR_DATA *ch, const char *rdesc) {
-  if(ch->rdesc) free(ch->rdesc);
-  ch->rdesc =   strdupsafe(rdesc);
+  strpoolSet(&ch->rdesc, rdesc);
 }
 
 void charSetMultiRdesc(CHAR_DATA *ch, const char *multi_rdesc) {
-  if(ch->multi_rdesc) free(ch->multi_rdesc);
-  ch->multi_rdesc =   strdupsafe(multi_rdesc);
+  strpoolSet(&ch->multi_rdesc, multi_rdesc);
 }
 
 void charSetMultiName(CHAR_DATA *ch, const char *multi_name) {
-  if(ch->multi_name) free(ch->multi_name);
-  ch->multi_name =   strdupsafe(multi_name);
+  strpoolSet(&ch->multi_name, multi_name);
 }
 
 bool charIsInstance(CHAR_DATA *ch, const char *prototype) {
@@ -221,11 +221,18 @@ const char  *charGetName      ( CHAR_DATA *ch) {
 }
 
 const char  *charGetDesc      ( CHAR_DATA *ch) {
-  return bufferString(ch->desc);
+  return (ch->desc_buf ? bufferString(ch->desc_buf) : ch->desc);
 }
 
 BUFFER      *charGetDescBuffer( CHAR_DATA *ch) {
-  return ch->desc;
+  // whoever wants the buffer may change it in place, so we need our own copy
+  if(ch->desc_buf == NULL) {
+    ch->desc_buf = newBuffer(1);
+    bufferCat(ch->desc_buf, ch->desc);
+    strpoolRelease(ch->desc);
+    ch->desc = NULL;
+  }
+  return ch->desc_buf;
 }
 
 BUFFER      *charGetLookBuffer( CHAR_DATA *ch) {
@@ -296,10 +303,18 @@ BITVECTOR *charGetUserGroups(CHAR_DATA *ch) {
   return ch->user_groups;
 }
 
+void *charGetActions(const CHAR_DATA *ch) {
+  return ch->actions;
+}
+
 void         charSetSocket    ( CHAR_DATA *ch, SOCKET_DATA *socket) {
   ch->socket = socket;
 }
 
+void charSetActions(CHAR_DATA *ch, void *actions) {
+  ch->actions = actions;
+}
+
 void         charSetRoom      ( CHAR_DATA *ch, ROOM_DATA *room) {
   ch->room   = room;
 }
@@ -309,22 +324,24 @@ void charSetLastRoom(CHAR_DATA *ch, ROOM_DATA *room) {
 }
 
 void charSetClass(CHAR_DATA *ch, const char *prototype) {
-  if(ch->class) free(ch->class);
-  ch->class = strdupsafe(prototype);
+  strpoolSet(&ch->class, prototype);
 }
 
 void charSetPrototypes(CHAR_DATA *ch, const char *prototypes) {
-  if(ch->prototypes) free(ch->prototypes);
-  ch->prototypes = strdupsafe(prototypes);
+  strpoolSet(&ch->prototypes, prototypes);
 }
 
 void charAddPrototype(CHAR_DATA *ch, const char *prototype) {
-  add_keyword(&ch->prototypes, prototype);
+  if(!is_keyword(ch->prototypes, prototype, FALSE)) {
+    char *prototypes = strdup(ch->prototypes);
+    add_keyword(&prototypes, prototype);
+    strpoolSet(&ch->prototypes, prototypes);
+    free(prototypes);
+  }
 }
 
 void         charSetName      ( CHAR_DATA *ch, const char *name) {
-  if(ch->name) free(ch->name);
-  ch->name = strdupsafe(name);
+  strpoolSet(&ch->name, name);
 }
 
 void         charSetSex       ( CHAR_DATA *ch, int sex) {
@@ -344,8 +361,12 @@ void charSetWeight(CHAR_DATA *ch, double amnt) {
 }
 
 void         charSetDesc      ( CHAR_DATA *ch, const char *desc) {
-  bufferClear(ch->desc);
-  bufferCat(ch->desc, (desc ? desc : ""));
+  if(ch->desc_buf == NULL)
+    strpoolSet(&ch->desc, desc);
+  else {
+    bufferClear(ch->desc_buf);
+    bufferCat(ch->desc_buf, (desc ? desc : ""));
+  }
 }
 
 void         charSetBody      ( CHAR_DATA *ch, BODY_DATA *body) {
@@ -397,15 +418,16 @@ void deleteChar( CHAR_DATA *mob) {
   // it's also assumed we've extracted our inventory
   deleteList(mob->inventory);
 
-  if(mob->class)       free(mob->class);
-  if(mob->prototypes)  free(mob->prototypes);
-  if(mob->name)        free(mob->name);
-  if(mob->desc)        deleteBuffer(mob->desc);
+  strpoolRelease(mob->class);
+  strpoolRelease(mob->prototypes);
+  strpoolRelease(mob->name);
+  strpoolRelease(mob->desc);
+  if(mob->desc_buf)    deleteBuffer(mob->desc_buf);
   if(mob->look_buf)    deleteBuffer(mob->look_buf);
-  if(mob->rdesc)       free(mob->rdesc);
-  if(mob->multi_rdesc) free(mob->multi_rdesc);
-  if(mob->multi_name)  free(mob->multi_name);
-  if(mob->keywords)    free(mob->keywords);
+  strpoolRelease(mob->rdesc);
+  strpoolRelease(mob->multi_rdesc);
+  strpoolRelease(mob->multi_name);
+  strpoolRelease(mob->keywords);
   if(mob->loadroom)    free(mob->loadroom);
   if(mob->race)        free(mob->race);
   if(mob->prfs)        deleteBitvector(mob->prfs);
@@ -469,7 +491,7 @@ STORAGE_SET *charStore(CHAR_DATA *mob) {
   store_string(set, "name",       mob->name);
   store_string(set, "keywords",   mob->keywords);
   store_string(set, "rdesc",      mob->rdesc);
-  store_string(set, "desc",       bufferString(mob->desc));
+  store_string(set, "desc",       charGetDesc(mob));
   store_string(set, "multirdesc", mob->multi_rdesc);
   store_string(set, "multiname",  mob->multi_name);
   store_int   (set, "sex",        mob->sex);
@@ -527,8 +549,7 @@ CHAR_DATA *charCopy( CHAR_DATA *mob) {
 // mob set and get functions
 //*****************************************************************************
 void charSetKeywords(CHAR_DATA *ch, const char *keywords) {
-  if(ch->keywords) free(ch->keywords);
-  ch->keywords = strdupsafe(keywords);
+  strpoolSet(&ch->keywords, keywords);
 }
 
 const char  *charGetKeywords   ( CHAR_DATA *ch) {
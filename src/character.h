@@ -96,6 +96,8 @@ double       charGetWeight    (const CHAR_DATA *ch);
 void        *charGetAuxiliaryData(const CHAR_DATA *ch, const char *name);
 BITVECTOR   *charGetPrfs      (CHAR_DATA *ch);
 BITVECTOR   *charGetUserGroups(CHAR_DATA *ch);
+// only for use by the action handler
+void        *charGetActions   (const CHAR_DATA *ch);
 
 void         charSetClass     (CHAR_DATA *ch, const char *prototype);
 void         charAddPrototype (CHAR_DATA *ch, const char *prototype);
@@ -117,6 +119,7 @@ void         charSetFurniture (CHAR_DATA *ch, OBJ_DATA *furniture);
 void         charSetPos       (CHAR_DATA *ch, int pos);
 void         charSetHidden    (CHAR_DATA *ch, int amnt);
 void         charSetWeight    (CHAR_DATA *ch, double amnt);
+void         charSetActions   (CHAR_DATA *ch, void *actions);
 
 
 
@@ -0,0 +1,107 @@
+//*****************************************************************************
+//
+// colour.c
+//
+// Processing of colour codes in outbound text. See colour.h for documentation.
+//
+// Codes are looked up in a table indexed by the character after the marker.
+// Finding the markers themselves is left to memchr, which is much faster at
+// skipping over long stretches of text without any than a loop over each
+// character would be. Text with no markers in it isn't copied at all.
+//
+//*****************************************************************************
+
+#include "mud.h"
+#include "utils.h"
+#include "colour.h"
+
+
+
+//*****************************************************************************
+// local datastructures, functions, and defines
+//*****************************************************************************
+
+// what starts a colour code
+#define COLOUR_MARKER         '{'
+
+// the ANSI escape sequence each code is replaced by. NULL if it is not a code
+char *colour_codes[256];
+int   colour_lens [256];
+
+// the base colours, and their ANSI colour numbers. Lower case is the dark
+// shade of the colour, upper case the bright one
+const char *base_colours[][2] = {
+  { "n", "0"  },
+  { "d", "30" },
+  { "r", "31" },
+  { "g", "32" },
+  { "y", "33" },
+  { "b", "34" },
+  { "p", "35" },
+  { "c", "36" },
+  { "w", "37" },
+  { NULL, NULL }
+};
+
+
+
+//*****************************************************************************
+// implementation of colour.h
+//*****************************************************************************
+void init_colour(void) {
+  char seq[SMALL_BUFFER];
+  int i;
+  for(i = 0; base_colours[i][0] != NULL; i++) {
+    char code = *base_colours[i][0];
+    sprintf(seq, "\033[0;%sm", base_colours[i][1]);
+    colourAddCode(tolower(code), seq);
+    sprintf(seq, "\033[1;%sm", base_colours[i][1]);
+    colourAddCode(toupper(code), seq);
+  }
+}
+
+void colourAddCode(char code, const char *sequence) {
+  unsigned char c = (unsigned char)code;
+  if(colour_codes[c] != NULL)
+    free(colour_codes[c]);
+  if(sequence == NULL || !*sequence || c == COLOUR_MARKER || c == '\0') {
+    colour_codes[c] = NULL;
+    colour_lens[c]  = 0;
+  }
+  else {
+    colour_codes[c] = strdup(sequence);
+    colour_lens[c]  = strlen(sequence);
+  }
+}
+
+bool colourRender(const char *text, BUFFER *buf, bool colour) {
+  const char    *end = text + strlen(text);
+  const char *marker = memchr(text, COLOUR_MARKER, end - text);
+  if(marker == NULL)
+    return FALSE;
+
+  while(marker != NULL) {
+    unsigned char code = (unsigned char)marker[1];
+
+    // everything up to the marker goes in as it is
+    bufferCatLength(buf, text, marker - text);
+
+    // a code. Replace it, or take it out if we're not colouring
+    if(colour_codes[code] != NULL) {
+      if(colour)
+	bufferCatLength(buf, colour_codes[code], colour_lens[code]);
+      text = marker + 2;
+    }
+    // {{ is a literal marker. Anything else after a marker is left alone
+    else {
+      bufferCatLength(buf, marker, 1);
+      text = marker + (code == COLOUR_MARKER ? 2 : 1);
+    }
+
+    marker = memchr(text, COLOUR_MARKER, end - text);
+  }
+
+  // and whatever's left after the last marker
+  bufferCatLength(buf, text, end - text);
+  return TRUE;
+}
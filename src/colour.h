@@ -0,0 +1,34 @@
+#ifndef COLOUR_H
+#define COLOUR_H
+//*****************************************************************************
+//
+// colour.h
+//
+// Turns the colour codes in outbound text (e.g. {r for dark red, {R for
+// bright red, {n to go back to normal) into ANSI escape sequences. This used
+// to be done by colour.py, from a process_outbound_text hook. It is now done
+// by flush_output, for every socket, after the process_outbound_text and
+// process_outbound_prompt hooks have run and before the finalize ones do.
+//
+// A code is a { followed by one character. {{ is a literal {. A { followed by
+// anything that is not a code is left alone. Sockets that have colour turned
+// off still have their codes processed, but the codes are simply removed.
+//
+//*****************************************************************************
+
+//
+// set up the table of base colour codes
+void init_colour(void);
+
+//
+// make {<code> turn into sequence. Replaces whatever the code did before.
+// A NULL or empty sequence makes the code stop being a code
+void colourAddCode(char code, const char *sequence);
+
+//
+// write text into buf with all of its colour codes processed. If colour is
+// FALSE, codes are removed instead of replaced. Returns FALSE, and leaves buf
+// untouched, if the text had nothing in it that needed processing
+bool colourRender(const char *text, BUFFER *buf, bool colour);
+
+#endif // COLOUR_H
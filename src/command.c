@@ -37,6 +37,8 @@ struct cmd_data {
   char *user_group;
   bool  interrupts;
   LIST     *checks;
+  bitvector_t group_mask; // our user group, as a mask of user_groups bits
+  int  mask_version;      // the bitvector version group_mask was worked out at
 };
 
 typedef struct cmd_check_data {
@@ -113,6 +115,7 @@ void cmdUpdate(CMD_DATA *cmd, COMMAND(func), const char *user_group,
   cmd->func       = func;
   cmd->user_group = strdupsafe(user_group);
   cmd->interrupts = interrupts;
+  cmd->mask_version = -1;
 }
 
 void cmdPyUpdate(CMD_DATA *cmd, void *pyfunc, const char *user_group,
@@ -123,6 +126,7 @@ void cmdPyUpdate(CMD_DATA *cmd, void *pyfunc, const char *user_group,
   cmd->user_group = strdupsafe(user_group);
   cmd->interrupts = interrupts;
   cmd->pyfunc     = pyfunc;
+  cmd->mask_version = -1;
   Py_XINCREF(cmd->pyfunc);
 }
 
@@ -157,6 +161,7 @@ void cmdCopyTo(CMD_DATA *from, CMD_DATA *to) {
   if(to->pyfunc)     { Py_INCREF(to->pyfunc); }
   to->func         = from->func;
   to->interrupts   = from->interrupts;
+  to->mask_version = -1;
   if(to->checks)     { deleteListWith(to->checks, deleteCmdCheck); }
   to->checks       = listCopyWith(from->checks, cmdCheckCopy);
 }
@@ -169,6 +174,15 @@ const char *cmdGetUserGroup(CMD_DATA *cmd) {
   return cmd->user_group;
 }
 
+bitvector_t cmdGetUserGroupMask(CMD_DATA *cmd) {
+  // work our mask out again if user groups have been added since we last did
+  if(cmd->mask_version != bitvectorVersion()) {
+    cmd->group_mask   = bitvectorMaskOf("user_groups", cmd->user_group);
+    cmd->mask_version = bitvectorVersion();
+  }
+  return cmd->group_mask;
+}
+
 bool cmdGetInterrupts(CMD_DATA *cmd) {
   return cmd->interrupts;
 }
@@ -254,9 +268,10 @@ bool max_pos_ok(CHAR_DATA *ch, int minpos) {
 bool cmdTryChecks(CHAR_DATA *ch, CMD_DATA *cmd) {
   bool cmd_ok = TRUE;
   if(listSize(cmd->checks) > 0) {
-    LIST_ITERATOR *chk_i = newListIterator(cmd->checks);
+    LIST_ITERATOR chk_i;
+    listIteratorStart(&chk_i, cmd->checks);
     CMD_CHK_DATA    *chk = NULL;
-    ITERATE_LIST(chk, chk_i) {
+    ITERATE_LIST(chk, &chk_i) {
       if(chk->func)
 	cmd_ok = (chk->func)(ch, cmd->name);
       else {
@@ -276,7 +291,7 @@ bool cmdTryChecks(CHAR_DATA *ch, CMD_DATA *cmd) {
 
       if(cmd_ok == FALSE)
 	break;
-    } deleteListIterator(chk_i);
+    } listIteratorStop(&chk_i);
   }
   return cmd_ok;
 }
@@ -51,6 +51,11 @@ bool       cmdGetInterrupts(CMD_DATA *cmd);
 void            cmdAddCheck(CMD_DATA *cmd, CMD_CHK(func));
 void          cmdAddPyCheck(CMD_DATA *cmd, void *pyfunc);
 
+//
+// our user group, as a mask of user_groups bits. 0 if the group isn't one that
+// fits in a mask (see bitvectorGetMask)
+bitvector_t cmdGetUserGroupMask(CMD_DATA *cmd);
+
 //
 // do we have an associated function, or are we just a list of command checks?
 bool cmdHasFunc(CMD_DATA *cmd);
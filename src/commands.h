@@ -14,6 +14,7 @@ COMMAND(cmd_compress);
 COMMAND(cmd_look);
 COMMAND(cmd_groupcmds);
 COMMAND(cmd_more);
+COMMAND(cmd_outqueue);
 COMMAND(cmd_back);
 COMMAND(cmd_who);
 #endif // __COMMANDS_H
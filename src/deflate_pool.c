@@ -0,0 +1,322 @@
+//*****************************************************************************
+//
+// deflate_pool.c
+//
+// Compression streams for MCCP, and the workers that can flush them. See
+// deflate_pool.h for documentation.
+//
+// Each stream keeps three buffers: the text waiting for the next flush, the
+// text being flushed, and the compressed output waiting to be collected. A
+// flush swaps the first two, so text can keep being added while a worker is
+// compressing the last lot. Only one flush of a stream is ever running, and
+// the game thread waits for it before it touches the zlib stream or the
+// output itself. Streams waiting for a worker are kept in a first-in,
+// first-out queue. Workers never log anything, since logging talks to sockets.
+//
+//*****************************************************************************
+
+#include <pthread.h>
+#include <time.h>
+#include <zlib.h>
+#include "mud.h"
+#include "utils.h"
+#include "outqueue.h"
+#include "deflate_pool.h"
+
+
+
+//*****************************************************************************
+// local datastructures, functions, and defines
+//*****************************************************************************
+
+// the most workers the pool will run
+#define MAX_DEFLATE_WORKERS          16
+
+// a buffer that has grown bigger than this after a big burst of output is
+// given back once it has been emptied, so idle streams stay small
+#define DEFLATE_BUF_KEEP      (16 * 1024)
+
+// room we leave on the end of the output for a sync flush, or for the end of
+// the stream; zlib needs a few bytes more than deflateBound says for them
+#define DEFLATE_SLACK                64
+
+typedef struct {
+  unsigned char *data;
+  int             len;
+  int             cap;
+} DEFLATE_BUF;
+
+struct deflate_stream {
+  z_stream           z;
+  DEFLATE_BUF       in; // text waiting for the next flush
+  DEFLATE_BUF     work; // text being flushed
+  DEFLATE_BUF      out; // compressed output waiting to be collected
+  bool            busy; // is a worker flushing us, or are we waiting for one?
+  bool          failed; // did deflate ever fail on us?
+  bool        finished; // has the stream been ended?
+
+  // stats for what has been flushed since we were last collected, and for
+  // everything we've ever had collected
+  long      flushed_in;
+  long     flushed_out;
+  double    flushed_ms;
+  long        bytes_in;
+  long       bytes_out;
+  double            ms;
+
+  struct deflate_stream *next; // the next stream waiting for a worker
+};
+
+pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t  pool_work = PTHREAD_COND_INITIALIZER; // a stream needs a flush
+pthread_cond_t  pool_done = PTHREAD_COND_INITIALIZER; // a flush was finished
+int          pool_workers = 0;
+
+DEFLATE_STREAM *pool_head = NULL;
+DEFLATE_STREAM *pool_tail = NULL;
+
+double deflate_now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+//
+// make sure the buffer has room for at least extra more bytes
+void deflate_buf_reserve(DEFLATE_BUF *buf, int extra) {
+  if(buf->cap - buf->len >= extra)
+    return;
+  buf->cap  = MAX(buf->len + extra, buf->cap * 2);
+  buf->data = realloc(buf->data, buf->cap);
+}
+
+//
+// empty the buffer, and give back its memory if it grew big
+void deflate_buf_clear(DEFLATE_BUF *buf) {
+  buf->len = 0;
+  if(buf->cap > DEFLATE_BUF_KEEP) {
+    free(buf->data);
+    buf->data = NULL;
+    buf->cap  = 0;
+  }
+}
+
+//
+// zlib's memory hooks. calloc and free are safe to call from the workers
+void *deflate_zalloc(void *opaque, unsigned int items, unsigned int size) {
+  return calloc(items, size);
+}
+
+void deflate_zfree(void *opaque, void *address) {
+  free(address);
+}
+
+//
+// compress the text being flushed onto the end of our output. Runs on a
+// worker when it is flushing in the background
+void deflate_stream_run(DEFLATE_STREAM *stream, int flush) {
+  double start = deflate_now_ms();
+  int   before = stream->out.len;
+  z_stream  *z = &stream->z;
+  z->next_in   = stream->work.data;
+  z->avail_in  = stream->work.len;
+
+  // make room for all of it up front, so one call to deflate usually does it
+  deflate_buf_reserve(&stream->out,
+		      deflateBound(z, stream->work.len) + DEFLATE_SLACK);
+  do {
+    deflate_buf_reserve(&stream->out, DEFLATE_SLACK);
+    z->next_out  = stream->out.data + stream->out.len;
+    z->avail_out = stream->out.cap  - stream->out.len;
+    int status   = deflate(z, flush);
+    stream->out.len = stream->out.cap - z->avail_out;
+    // no progress means there was nothing left for it to give us
+    if(status == Z_BUF_ERROR || status == Z_STREAM_END)
+      break;
+    if(status != Z_OK) {
+      stream->failed = TRUE;
+      break;
+    }
+  } while(z->avail_in > 0 || z->avail_out == 0);
+
+  stream->flushed_in  += stream->work.len;
+  stream->flushed_out += stream->out.len - before;
+  stream->flushed_ms  += deflate_now_ms() - start;
+  deflate_buf_clear(&stream->work);
+}
+
+//
+// wait until no worker is flushing the stream
+void deflate_stream_wait(DEFLATE_STREAM *stream) {
+  if(pool_workers == 0)
+    return;
+  pthread_mutex_lock(&pool_lock);
+  while(stream->busy)
+    pthread_cond_wait(&pool_done, &pool_lock);
+  pthread_mutex_unlock(&pool_lock);
+}
+
+//
+// a worker. Takes streams off the front of the queue and flushes them, forever
+void *deflate_worker_thread(void *unused) {
+  pthread_mutex_lock(&pool_lock);
+  for(;;) {
+    while(pool_head == NULL)
+      pthread_cond_wait(&pool_work, &pool_lock);
+
+    DEFLATE_STREAM *stream = pool_head;
+    pool_head = stream->next;
+    if(pool_head == NULL)
+      pool_tail = NULL;
+    stream->next = NULL;
+    pthread_mutex_unlock(&pool_lock);
+
+    deflate_stream_run(stream, Z_SYNC_FLUSH);
+
+    pthread_mutex_lock(&pool_lock);
+    stream->busy = FALSE;
+    pthread_cond_broadcast(&pool_done);
+  }
+  return NULL;
+}
+
+
+
+//*****************************************************************************
+// implementation of deflate_pool.h
+//*****************************************************************************
+void init_deflate_pool(int workers) {
+  pthread_attr_t attr;
+  pthread_t    thread;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  workers = MIN(workers, MAX_DEFLATE_WORKERS);
+  while(pool_workers < workers) {
+    if(pthread_create(&thread, &attr, deflate_worker_thread, NULL) != 0) {
+      log_string("ERROR: could only start %d of %d compression workers",
+		 pool_workers, workers);
+      break;
+    }
+    pool_workers++;
+  }
+  pthread_attr_destroy(&attr);
+}
+
+int deflatePoolWorkers(void) {
+  return pool_workers;
+}
+
+DEFLATE_STREAM *newDeflateStream(int level, int mem_level) {
+  DEFLATE_STREAM *stream = calloc(1, sizeof(DEFLATE_STREAM));
+  stream->z.zalloc = deflate_zalloc;
+  stream->z.zfree  = deflate_zfree;
+  stream->z.opaque = NULL;
+  if(deflateInit2(&stream->z, level, Z_DEFLATED, MAX_WBITS, mem_level,
+		  Z_DEFAULT_STRATEGY) != Z_OK) {
+    free(stream);
+    return NULL;
+  }
+  return stream;
+}
+
+void deleteDeflateStream(DEFLATE_STREAM *stream) {
+  deflate_stream_wait(stream);
+  deflateEnd(&stream->z);
+  if(stream->in.data)   free(stream->in.data);
+  if(stream->work.data) free(stream->work.data);
+  if(stream->out.data)  free(stream->out.data);
+  free(stream);
+}
+
+bool deflateStreamSetLevel(DEFLATE_STREAM *stream, int level) {
+  deflate_stream_wait(stream);
+  if(stream->finished)
+    return FALSE;
+  // zlib may need to finish off the block it was working on
+  deflate_buf_reserve(&stream->out, DEFLATE_SLACK);
+  stream->z.next_out  = stream->out.data + stream->out.len;
+  stream->z.avail_out = stream->out.cap  - stream->out.len;
+  int status = deflateParams(&stream->z, level, Z_DEFAULT_STRATEGY);
+  stream->out.len = stream->out.cap - stream->z.avail_out;
+  return (status == Z_OK);
+}
+
+void deflateStreamCat(DEFLATE_STREAM *stream, const char *txt, int len) {
+  if(len <= 0)
+    return;
+  deflate_buf_reserve(&stream->in, len);
+  memcpy(stream->in.data + stream->in.len, txt, len);
+  stream->in.len += len;
+}
+
+int deflateStreamPending(DEFLATE_STREAM *stream) {
+  return stream->in.len;
+}
+
+void deflateStreamFlush(DEFLATE_STREAM *stream, bool background) {
+  deflate_stream_wait(stream);
+  // everything before was flushed already. Nothing new, nothing to do
+  if(stream->finished || stream->in.len == 0)
+    return;
+
+  DEFLATE_BUF work = stream->work;
+  stream->work     = stream->in;
+  stream->in       = work;
+
+  if(!background || pool_workers == 0)
+    deflate_stream_run(stream, Z_SYNC_FLUSH);
+  else {
+    pthread_mutex_lock(&pool_lock);
+    stream->busy = TRUE;
+    if(pool_tail != NULL)
+      pool_tail->next = stream;
+    else
+      pool_head = stream;
+    pool_tail = stream;
+    pthread_cond_signal(&pool_work);
+    pthread_mutex_unlock(&pool_lock);
+  }
+}
+
+bool deflateStreamFinish(DEFLATE_STREAM *stream) {
+  deflate_stream_wait(stream);
+  if(stream->finished)
+    return !stream->failed;
+
+  DEFLATE_BUF work = stream->work;
+  stream->work     = stream->in;
+  stream->in       = work;
+  deflate_stream_run(stream, Z_FINISH);
+  stream->finished = TRUE;
+  return !stream->failed;
+}
+
+int deflateStreamCollect(DEFLATE_STREAM *stream, OUT_QUEUE *queue) {
+  deflate_stream_wait(stream);
+  if(stream->failed)
+    return -1;
+
+  stream->bytes_in   += stream->flushed_in;
+  stream->bytes_out  += stream->flushed_out;
+  stream->ms         += stream->flushed_ms;
+  stream->flushed_in  = stream->flushed_out = 0;
+  stream->flushed_ms  = 0;
+
+  int len = stream->out.len;
+  if(len > 0)
+    outQueueCat(queue, (char *)stream->out.data, len);
+  deflate_buf_clear(&stream->out);
+  return len;
+}
+
+long deflateStreamBytesIn(DEFLATE_STREAM *stream) {
+  return stream->bytes_in;
+}
+
+long deflateStreamBytesOut(DEFLATE_STREAM *stream) {
+  return stream->bytes_out;
+}
+
+double deflateStreamMs(DEFLATE_STREAM *stream) {
+  return stream->ms;
+}
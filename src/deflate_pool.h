@@ -0,0 +1,83 @@
+#ifndef DEFLATE_POOL_H
+#define DEFLATE_POOL_H
+//*****************************************************************************
+//
+// deflate_pool.h
+//
+// Compression streams for MCCP, and a small pool of worker threads that can
+// run them off of the game thread.
+//
+// Text put in a stream is not compressed straight away. It waits until the
+// stream is flushed, and is then deflated all at once, ending with a sync
+// flush so the client can decompress everything it has been sent. A socket's
+// output only needs flushing once per pulse, so each pulse costs one call to
+// deflate, however many pieces the output came in.
+//
+// Flushes can be done right away, or handed to the pool. Text added to a
+// stream while a flush is running on a worker waits for the next flush, and
+// compressed output always comes out in the order the text went in. Workers
+// never touch anything but the stream they are flushing; collecting the
+// output into an output queue is done by the game thread.
+//
+//*****************************************************************************
+
+typedef struct deflate_stream             DEFLATE_STREAM;
+
+//
+// start up the pool. workers is how many threads to run deflate on. If it is
+// zero (or the threads can't be started) every flush is done right away
+void init_deflate_pool(int workers);
+
+//
+// how many workers the pool is running
+int deflatePoolWorkers(void);
+
+//
+// make a new stream, compressing with the given zlib level (0 to 9) and
+// memLevel (1 to 9). Returns NULL if zlib could not set it up
+DEFLATE_STREAM *newDeflateStream(int level, int mem_level);
+
+//
+// delete the stream, and any output that was never collected. Waits for any
+// flush running on a worker to finish first
+void deleteDeflateStream(DEFLATE_STREAM *stream);
+
+//
+// change how hard the stream compresses. Takes effect for text that is
+// flushed after the change. Returns FALSE if zlib would not change it
+bool deflateStreamSetLevel(DEFLATE_STREAM *stream, int level);
+
+//
+// add len bytes of text to what is compressed on the next flush
+void deflateStreamCat(DEFLATE_STREAM *stream, const char *txt, int len);
+
+//
+// how many bytes of text are waiting for the next flush?
+int deflateStreamPending(DEFLATE_STREAM *stream);
+
+//
+// compress everything that has been added since the last flush. If background
+// is TRUE and the pool has workers, it is done by one of them, and this returns
+// right away; otherwise it is done before returning
+void deflateStreamFlush(DEFLATE_STREAM *stream, bool background);
+
+//
+// compress everything that has been added, and end the stream. Nothing can be
+// added to it afterwards. Returns FALSE if zlib could not end it
+bool deflateStreamFinish(DEFLATE_STREAM *stream);
+
+//
+// put whatever the stream has compressed so far on the end of queue. Waits
+// for any flush running on a worker to finish first. Returns how many bytes
+// were queued, or -1 if compressing failed
+int deflateStreamCollect(DEFLATE_STREAM *stream, OUT_QUEUE *queue);
+
+//
+// stats about the stream: bytes of text compressed, bytes of compressed output
+// made from them, and time spent in deflate, in milliseconds. Only what has
+// been collected is counted
+long   deflateStreamBytesIn (DEFLATE_STREAM *stream);
+long   deflateStreamBytesOut(DEFLATE_STREAM *stream);
+double deflateStreamMs      (DEFLATE_STREAM *stream);
+
+#endif // DEFLATE_POOL_H
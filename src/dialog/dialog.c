@@ -450,19 +450,19 @@ void stop_dialogs_with(CHAR_DATA *ch) {
 
 //
 // a hook that tries to stop all the dialogs with a character
-void stop_dialogs_hook(const char *info) {
+void stop_dialogs_hook(HOOK_ARGS *args) {
   CHAR_DATA *ch = NULL;
-  hookParseInfo(info, &ch);
+  hookArgsParse(args, &ch);
   stop_dialogs_with(ch);
 }
 
 //
 // whenever we move, stop any dialog we have going on
-void stop_dialogs_move_hook(const char *info) {
+void stop_dialogs_move_hook(HOOK_ARGS *args) {
   CHAR_DATA   *ch = NULL;
   ROOM_DATA *room = NULL;
   EXIT_DATA *exit = NULL;
-  hookParseInfo(info, &ch, &room, &exit);
+  hookArgsParse(args, &ch, &room, &exit);
   stop_dialogs_with(ch);
 }
 
@@ -511,10 +511,10 @@ void try_start_dialog(CHAR_DATA *ch, CHAR_DATA *other) {
 
 //
 // a greet hook that tries to start a dialog between two persons
-void try_start_dialog_hook(const char *info) {
+void try_start_dialog_hook(HOOK_ARGS *args) {
   CHAR_DATA    *ch = NULL;
   CHAR_DATA *other = NULL;
-  hookParseInfo(info, &ch, &other);
+  hookArgsParse(args, &ch, &other);
   try_start_dialog(ch, other);
 }
 
@@ -937,9 +937,9 @@ void init_dialogs(void) {
   	       dialogSetKey);
 
   // set up our hooks
-  hookAdd("char_from_game", stop_dialogs_hook);
-  hookAdd("exit",           stop_dialogs_move_hook);
-  hookAdd("greet",          try_start_dialog_hook);
+  hookAddTyped("char_from_game", stop_dialogs_hook);
+  hookAddTyped("exit",           stop_dialogs_move_hook);
+  hookAddTyped("greet",          try_start_dialog_hook);
 
   // set up our Python extensions
   PyChar_addGetSetter("dialog",       PyChar_GetDialog, PyChar_SetDialog, NULL);
@@ -19,20 +19,34 @@
 #include "utils.h"
 #include "character.h"
 #include "hooks.h"
+#include "timer_wheel.h"
 #include "event.h"
 
 typedef struct event_data EVENT_DATA;
-LIST    *events = NULL;
+
+// all of our pending events, ordered by when they go off
+TIMER_WHEEL  *events = NULL;
+
+// a mapping from owner to the first of its events. An owner's events are
+// chained together, so interrupting them never looks at anyone else's
+MAP     *event_owners = NULL;
+
+// events that have a check_involvement function; these have to be asked
+// whether they involve something whenever we interrupt events
+LIST *involved_events = NULL;
 
 struct event_data {
   void *owner;   // who is the lucky person who owns this event?
   void (*  on_complete)(void *owner, void *data, char *arg);
   bool (*  check_involvement)(void *thing, void *data);
-  int   delay;   // how much longer until the event is complete?
   int   tot_time;// what is the total delay before the event fires?
   void *data;    // data for the event
   char *arg;     // an argument supplied to an event
   bool  requeue; // is the event requeue'd after it goes off?
+
+  TIMER_NODE     timer; // our place in the event wheel
+  EVENT_DATA *prev_own; // the other events sharing our owner
+  EVENT_DATA *next_own; //
 };
 
 
@@ -51,11 +65,13 @@ EVENT_DATA *newEvent(void *owner,
   event->owner             = owner;
   event->on_complete       = on_complete;
   event->check_involvement = check_involvement;
-  event->delay             = delay;
   event->tot_time          = delay;
   event->data              = data;
   event->arg               = strdupsafe(arg);
   event->requeue           = requeue;
+  event->prev_own          = NULL;
+  event->next_own          = NULL;
+  timerNodeInit(&event->timer, event);
   return event;
 }
 
@@ -69,21 +85,54 @@ void run_event(EVENT_DATA *event) {
     event->on_complete(event->owner, event->data, event->arg);
 }
 
-void interrupt_events_obj_hook(const char *info) {
+//
+// schedule an event in the wheel, and index it by its owner and involvement
+void event_schedule(EVENT_DATA *event, int delay) {
+  EVENT_DATA *first = mapGet(event_owners, event->owner);
+  event->prev_own   = NULL;
+  event->next_own   = first;
+  if(first != NULL)
+    first->prev_own = event;
+  mapPut(event_owners, event->owner, event);
+
+  if(event->check_involvement != NULL)
+    listPut(involved_events, event);
+  timerWheelAdd(events, &event->timer, delay);
+}
+
+//
+// take an event out of the wheel and all of our indexes
+void event_unschedule(EVENT_DATA *event) {
+  if(event->prev_own != NULL)
+    event->prev_own->next_own = event->next_own;
+  else if(event->next_own != NULL)
+    mapPut(event_owners, event->owner, event->next_own);
+  else
+    mapRemove(event_owners, event->owner);
+  if(event->next_own != NULL)
+    event->next_own->prev_own = event->prev_own;
+  event->prev_own = event->next_own = NULL;
+
+  if(event->check_involvement != NULL)
+    listRemove(involved_events, event);
+  timerWheelRemove(events, &event->timer);
+}
+
+void interrupt_events_obj_hook(HOOK_ARGS *args) {
   OBJ_DATA *obj = NULL;
-  hookParseInfo(info, &obj);
+  hookArgsParse(args, &obj);
   interrupt_events_involving(obj);
 }
 
-void interrupt_events_char_hook(const char *info) {
+void interrupt_events_char_hook(HOOK_ARGS *args) {
   CHAR_DATA *ch = NULL;
-  hookParseInfo(info, &ch);
+  hookArgsParse(args, &ch);
   interrupt_events_involving(ch);
 }
 
-void interrupt_events_room_hook(const char *info) {
+void interrupt_events_room_hook(HOOK_ARGS *args) {
   ROOM_DATA *room = NULL;
-  hookParseInfo(info, &room);
+  hookArgsParse(args, &room);
   interrupt_events_involving(room);
 }
 
@@ -93,33 +142,39 @@ void interrupt_events_room_hook(const char *info) {
 // event list handling
 //*****************************************************************************
 void init_events() {
-  events = newList();
+  events          = newTimerWheel();
+  event_owners    = newMap(NULL, NULL);
+  involved_events = newList();
 
   // make sure all events involving the object/char are cancelled when
   // either is extracted from the game
-  hookAdd("obj_from_game",  interrupt_events_obj_hook);
-  hookAdd("char_from_game", interrupt_events_char_hook);
-  hookAdd("room_from_game", interrupt_events_room_hook);
+  hookAddTyped("obj_from_game",  interrupt_events_obj_hook);
+  hookAddTyped("char_from_game", interrupt_events_char_hook);
+  hookAddTyped("room_from_game", interrupt_events_room_hook);
 }
 
 void interrupt_event(EVENT_DATA *event) {
+  event_unschedule(event);
   deleteEvent(event);
 }
 
 void interrupt_events_involving(void *thing) {
-  LIST_ITERATOR *ev_i = newListIterator(events);
-  EVENT_DATA   *event = NULL;
-
-  ITERATE_LIST(event, ev_i) {
-    // if we've found involvement, pop it on out
-    if(event->owner == thing ||
-       (event->check_involvement != NULL && 
-	event->check_involvement(thing, event->data))) {
-      listRemove(events, event);
-      deleteEvent(event);
-    }
+  EVENT_DATA *event = NULL;
+
+  // first, everything the thing owns
+  while((event = mapGet(event_owners, thing)) != NULL)
+    interrupt_event(event);
+
+  // then, anything that says it involves the thing some other way
+  if(listSize(involved_events) > 0) {
+    LIST_ITERATOR ev_i;
+    listIteratorStart(&ev_i, involved_events);
+    ITERATE_LIST(event, &ev_i) {
+      // if we've found involvement, pop it on out
+      if(event->check_involvement(thing, event->data))
+	interrupt_event(event);
+    } listIteratorStop(&ev_i);
   }
-  deleteListIterator(ev_i);
 }
 
 void start_event(void *owner, 
@@ -129,14 +184,11 @@ void start_event(void *owner,
 		 void *data,
 		 const char *arg) {
   // some events might cause other events to activate. This is signaled by
-  // providing a delay of 0. In this case, we queue events to the back of the
-  // event list instead of push them on to the front
+  // providing a delay of 0. If we are in the middle of pulsing events, these
+  // go off on the same pulse, after everything else that is going off
   EVENT_DATA *event = newEvent(owner, delay, on_complete, check_involvement,
 			       data, arg, FALSE);
-  if(delay == 0)
-    listQueue(events, event);
-  else
-    listPut(events, event);
+  event_schedule(event, delay);
 }
 
 void start_update(void *owner, 
@@ -145,38 +197,32 @@ void start_update(void *owner,
 		  void *check_involvement,
 		  void *data,
 		  const char *arg) {
-  // some events might cause other events to activate. This is signaled by
-  // providing a delay of 0. In this case, we queue events to the back of the
-  // event list instead of push them on to the front
   EVENT_DATA *event = newEvent(owner, delay, on_complete, check_involvement,
 			       data, arg, TRUE);
-  if(delay == 0)
-    listQueue(events, event);
-  else
-    listPut(events, event);
+  event_schedule(event, delay);
 }
 
 void pulse_events(int time) {
-  LIST_ITERATOR *ev_i = newListIterator(events);
-  EVENT_DATA   *event = NULL;
-
-  // go over all of the events
-  ITERATE_LIST(event, ev_i) {
-    // decrement the delay
-    event->delay -= time;
-    // pop the character from the list, and run the event
-    if(event->delay <= 0) {
-      listRemove(events, event);
+  TIMER_NODE *timer = NULL;
+
+  for(; time > 0; time--) {
+    timerWheelAdvance(events);
+
+    // go over all of the events that have come due
+    while((timer = timerWheelPop(events)) != NULL) {
+      EVENT_DATA *event = timerNodeElem(timer);
+
+      // take us out of the indexes while we run. We can't be interrupted
+      event_unschedule(event);
       run_event(event);
-      // if we need to requeue, reset the timer 
-      // and put us back in the list
-      if(event->requeue) {
-	event->delay = event->tot_time;
-	listPut(events, event);
-      }
+
+      // if we need to requeue, put us back in for our total time. We always
+      // wait at least one pulse, or we'd keep going off on this one
+      if(event->requeue)
+	event_schedule(event, MAX(1, event->tot_time));
       // otherwise, just delete the event
       else
 	deleteEvent(event);
     }
-  } deleteListIterator(ev_i);
+  }
 }
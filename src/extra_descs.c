@@ -54,11 +54,12 @@ EDESC_SET *edescSetRead(STORAGE_SET *set) {
     STORAGE_SET_LIST *list = read_list(set, "list");
     // deleteList(edescs->edescs);
     edescs->edescs = gen_read_list(list, edescRead);
-    LIST_ITERATOR *list_i = newListIterator(edescs->edescs);
+    LIST_ITERATOR list_i;
+    listIteratorStart(&list_i, edescs->edescs);
     EDESC_DATA     *edesc = NULL;
-    ITERATE_LIST(edesc, list_i) {
+    ITERATE_LIST(edesc, &list_i) {
       edesc->set = edescs;
-    } deleteListIterator(list_i);
+    } listIteratorStop(&list_i);
   }
   return edescs;
 }
@@ -79,11 +80,12 @@ void edescSetCopyTo(EDESC_SET *from, EDESC_SET *to) {
   }
   if(from->edescs != NULL) {
     to->edescs = listCopyWith(from->edescs, edescCopy);
-    LIST_ITERATOR *list_i = newListIterator(to->edescs);
+    LIST_ITERATOR list_i;
+    listIteratorStart(&list_i, to->edescs);
     EDESC_DATA     *edesc = NULL;
-    ITERATE_LIST(edesc, list_i) {
+    ITERATE_LIST(edesc, &list_i) {
       edesc->set = to;
-    } deleteListIterator(list_i);
+    } listIteratorStop(&list_i);
   }
 }
 
@@ -97,13 +99,14 @@ EDESC_DATA *edescSetGet(EDESC_SET *set, const char *keyword) {
   if(set->edescs == NULL)
     return NULL;
 
-  LIST_ITERATOR *edesc_i = newListIterator(set->edescs);
+  LIST_ITERATOR edesc_i;
+  listIteratorStart(&edesc_i, set->edescs);
   EDESC_DATA       *desc = NULL;
 
-  ITERATE_LIST(desc, edesc_i) {
+  ITERATE_LIST(desc, &edesc_i) {
     if(edescIsKeyword(desc, keyword))
       break;
-  } deleteListIterator(edesc_i);
+  } listIteratorStop(&edesc_i);
   return desc;
 }
 
@@ -165,13 +168,14 @@ void edescTagDesc(BUFFER *buf, EDESC_SET *set,
   if(set->edescs == NULL)
     return;
 
-  LIST_ITERATOR *list_i = newListIterator(set->edescs);
+  LIST_ITERATOR list_i;
+  listIteratorStart(&list_i, set->edescs);
   EDESC_DATA    *edesc  = NULL;
 
   // go through, and apply colors for each extra desc we have
-  ITERATE_LIST(edesc, list_i) {
+  ITERATE_LIST(edesc, &list_i) {
     buf_tag_keywords(buf, edesc->keywords, start_tag, end_tag);
-  } deleteListIterator(list_i);
+  } listIteratorStop(&list_i);
 }
 
 
@@ -75,11 +75,14 @@ FILEBUF *fbopen(const char *fname, const char *mode) {
 
 //
 // close, flush, and delete the buffered file reader
-void fbclose(FILEBUF *fb) {
+bool fbclose(FILEBUF *fb) {
   fbflush(fb);
-  fclose(fb->fl);
+  bool ok = !ferror(fb->fl);
+  if(fclose(fb->fl) != 0)
+    ok = FALSE;
   deleteBuffer(fb->buf);
   free(fb);
+  return ok;
 }
 
 //
@@ -16,8 +16,9 @@ typedef struct buffered_file FILEBUF;
 FILEBUF *fbopen(const char *fname, const char *mode);
 
 //
-// close, flush, and delete the buffered file reader
-void fbclose(FILEBUF *buf);
+// close, flush, and delete the buffered file reader. Returns FALSE if anything
+// that was written could not make it to the file
+bool fbclose(FILEBUF *buf);
 
 //
 // flush the buffered file reader
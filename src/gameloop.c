@@ -6,6 +6,7 @@
 //
 //*****************************************************************************
 #include <sys/time.h>
+#include <fcntl.h>
 
 #include "mud.h"
 #include "utils.h"
@@ -25,6 +26,12 @@
 #include "races.h"
 #include "inform.h"
 #include "hooks.h"
+#include "io_poll.h"
+#include "colour.h"
+#include "strpool.h"
+#include "storage_writer.h"
+#include "outqueue.h"
+#include "deflate_pool.h"
 
 
 //*****************************************************************************
@@ -61,6 +68,7 @@
 
 // local procedures
 void game_loop    ( int control );
+void accept_new_connections(int fd, void *data);
 bool gameloop_end = FALSE;
 
 // intialize shutdown state
@@ -87,21 +95,27 @@ LIST       *objs_to_delete = NULL; // objs pending final extraction
 LIST      *rooms_to_delete = NULL; // rooms pending final extraction
 LIST       *strs_to_delete = NULL; // strings waiting to be freed
 LIST       *bufs_to_delete = NULL; // buffers waiting to be freed
-PROPERTY_TABLE  *mob_table = NULL; // a table of mobs by UID, for quick lookup
-PROPERTY_TABLE  *obj_table = NULL; // a table of objs by UID, for quick lookup
-PROPERTY_TABLE *room_table = NULL; // a table of rooms by UID, for quick lookup
-PROPERTY_TABLE *exit_table = NULL; // a table of exits by UID, for quick lookup
-PROPERTY_TABLE *sock_table = NULL; // a table of socks by UID, for quick lookup
+UID_TABLE  *mob_table = NULL; // a table of mobs by UID, for quick lookup
+UID_TABLE  *obj_table = NULL; // a table of objs by UID, for quick lookup
+UID_TABLE *room_table = NULL; // a table of rooms by UID, for quick lookup
+UID_TABLE *exit_table = NULL; // a table of exits by UID, for quick lookup
+UID_TABLE *sock_table = NULL; // a table of socks by UID, for quick lookup
 BUFFER           *greeting = NULL; // message seen when a socket connects
 BUFFER               *motd = NULL; // what characters see when they log on
 
+//
+// mccp_workers was changed. The pool can take on more workers while we run,
+// but it can't let any go until the mud is rebooted
+void mccp_workers_changed(const char *key) {
+  init_deflate_pool(mudsettingGetInt(key));
+}
+
 
 
 //
 // This is where it all starts, nothing special.
 int main(int argc, char **argv)
 {
-  extern fd_set fSet;
   int i;
   bool fCopyOver = FALSE;
 
@@ -160,15 +174,13 @@ int main(int argc, char **argv)
   strs_to_delete  = newList();
   bufs_to_delete  = newList();
 
-  // tables for quick lookup of mobiles and objects by UID.
-  // For optimal speed, the table sizes should be roughly
-  // 25% larger than the number of mobs/objs you intend to have
-  // loaded into the game at any given time.
-  mob_table   = newPropertyTable(charGetUID,  3000);
-  obj_table   = newPropertyTable(objGetUID,   3000);
-  room_table  = newPropertyTable(roomGetUID,  3000);
-  exit_table  = newPropertyTable(exitGetUID,  9000);
-  sock_table  = newPropertyTable(socketGetUID,1000);
+  // tables for quick lookup of mobiles and objects by UID. They grow as
+  // more things are loaded into the game
+  mob_table   = newUIDTable(charGetUID);
+  obj_table   = newUIDTable(objGetUID);
+  room_table  = newUIDTable(roomGetUID);
+  exit_table  = newUIDTable(exitGetUID);
+  sock_table  = newUIDTable(socketGetUID);
 
   // make a new world
   gameworld = newWorld();
@@ -186,6 +198,13 @@ int main(int argc, char **argv)
   log_string("Initializing hooks.");
   init_hooks();
 
+  log_string("Initializing socket polling (%s).", ioPollBackend());
+  init_io_poll();
+  init_socket_handler();
+
+  log_string("Initializing colour codes.");
+  init_colour();
+
   log_string("Initializing bitvectors.");
   init_bitvectors();
 
@@ -216,6 +235,16 @@ int main(int argc, char **argv)
   log_string("Initializing logging system.");
   init_logs();
 
+  log_string("Initializing shared string pool.");
+  init_strpool();
+
+  log_string("Initializing background writer.");
+  init_storage_writer();
+
+  log_string("Initializing MCCP compression workers.");
+  init_deflate_pool(mudsettingGetInt("mccp_workers"));
+  mudsettingAddListener("mccp_workers", mccp_workers_changed);
+
   log_string("Initializing account and player database.");
   init_save();
 
@@ -305,11 +334,11 @@ int main(int argc, char **argv)
     control = init_socket();
   }
 
-  /* clear out the file socket set */
-  FD_ZERO(&fSet);
+  /* we accept until there's nothing left, so control must not block */
+  fcntl(control, F_SETFL, fcntl(control, F_GETFL, 0) | O_NONBLOCK);
 
-  /* add control to the set */
-  FD_SET(control, &fSet);
+  /* have the backend tell us about new connections */
+  ioPollAdd(control, accept_new_connections, NULL);
 
   // attach our old sockets
   if(fCopyOver)
@@ -325,7 +354,10 @@ int main(int argc, char **argv)
   game_loop(control);
 
   // run our finalize hooks
-  hookRun("shutdown", "");
+  hookRunTyped("shutdown", "");
+
+  // make sure everything we've saved has made it to disk
+  storage_writer_sync(NULL);
 
   // close down the socket
   close(control);
@@ -378,12 +410,30 @@ void update_handler()
 
 
 
+//
+// called by our readiness backend when the control socket is readable. Since
+// the backend may be edge-triggered, take everyone who is waiting to connect
+void accept_new_connections(int fd, void *data) {
+  struct sockaddr_in sock;
+  socklen_t socksize;
+  int newConnection;
+
+  for(;;) {
+    socksize = sizeof(sock);
+    if((newConnection = accept(fd, (struct sockaddr*) &sock, &socksize)) < 0)
+      break;
+
+    SOCKET_DATA *newsock = new_socket(newConnection);
+    if(newsock != NULL) {
+      hookRunTyped("receive_connection", "sk", newsock);
+      socketBustPrompt(newsock);
+    }
+  }
+}
+
 void game_loop(int control)   
 {
-  static struct timeval tv;
   struct timeval last_time, new_time;
-  extern fd_set fSet;
-  extern fd_set rFd;
   long secs, usecs;
 
   /* set this for the first loop */
@@ -394,31 +444,11 @@ void game_loop(int control)
     /* set current_time */
     current_time = time(NULL);
 
-    /* copy the socket set */
-    memcpy(&rFd, &fSet, sizeof(fd_set));
-
-    /* wait for something to happen */
-    if (select(FD_SETSIZE, &rFd, NULL, NULL, &tv) < 0)
+    /* check for new connections and readable sockets. Don't wait */
+    if (ioPollWait(0) < 0)
       continue;
 
-    /* check for new connections */
-    if (FD_ISSET(control, &rFd)) {
-      struct sockaddr_in sock;
-      unsigned int socksize;
-      int newConnection;
-
-      socksize = sizeof(sock);
-      if ((newConnection = accept(control, (struct sockaddr*) &sock, &socksize)) >=0) {
-        SOCKET_DATA *newsock = new_socket(newConnection);
-	if(newsock != NULL) {
-	  hookRun("receive_connection", hookBuildInfo("sk", newsock));
-	  socketBustPrompt(newsock);
-	}
-      }
-    }
-
-
-    /* check all of the sockets for input */
+    /* check all of the sockets with pending input */
     input_handler();
 
     /* call the top-level update handler for events and actions */
@@ -34,19 +34,74 @@
 
 
 
+//*****************************************************************************
+// prototype instance counts
+//*****************************************************************************
+
+// how many objects and mobiles in the game are instances of each prototype,
+// so resets checking their max don't have to count up everything in the game.
+// Things in the game are assumed not to pick up new prototypes
+HASHTABLE *obj_instances = NULL;
+HASHTABLE *mob_instances = NULL;
+
+//
+// add amount to the count of every prototype in a list of them. Prototypes
+// are split up the same way is_keyword splits them
+void count_instances(HASHTABLE **table, const char *prototypes, int amount) {
+  char key[SMALL_BUFFER];
+
+  if(*table == NULL)
+    *table = newHashtableSize(1000);
+
+  while(*prototypes != '\0') {
+    // skip all spaces and commas
+    while(isspace(*prototypes) || *prototypes == ',')
+      prototypes++;
+    int len = next_letter_in(prototypes, ',');
+    if(len == -1)
+      len = strlen(prototypes);
+    if(len > 0) {
+      int count;
+      len = MIN(len, SMALL_BUFFER - 1);
+      strncpy(key, prototypes, len);
+      key[len] = '\0';
+      count = (int)(long)hashGet(*table, key) + amount;
+      if(count > 0)
+	hashPut(*table, key, (void *)(long)count);
+      else
+	hashRemove(*table, key);
+    }
+    prototypes += len;
+  }
+}
+
+int count_obj_instances(const char *prototype) {
+  if(obj_instances == NULL)
+    return 0;
+  return (int)(long)hashGet(obj_instances, prototype);
+}
+
+int count_char_instances(const char *prototype) {
+  if(mob_instances == NULL)
+    return 0;
+  return (int)(long)hashGet(mob_instances, prototype);
+}
+
+
+
 //*****************************************************************************
 // obj/char from/to functions
 //*****************************************************************************
 void exit_exist(EXIT_DATA *exit) {
-  propertyTablePut(exit_table, exit);
+  uidTablePut(exit_table, exit);
 }
 
 void exit_unexist(EXIT_DATA *exit) {
-  propertyTableRemove(exit_table, exitGetUID(exit));
+  uidTableRemove(exit_table, exitGetUID(exit));
 }
 
 bool exit_exists(EXIT_DATA *exit) {
-  return propertyTableIn(exit_table, exitGetUID(exit));
+  return uidTableIn(exit_table, exitGetUID(exit));
 }
 
 void exit_to_game(EXIT_DATA *exit) {
@@ -55,33 +110,35 @@ void exit_to_game(EXIT_DATA *exit) {
 }
 
 void obj_exist(OBJ_DATA *obj) {
-  propertyTablePut(obj_table, obj);
+  uidTablePut(obj_table, obj);
 
   // also add all contents
   if(listSize(objGetContents(obj)) > 0) {
-    LIST_ITERATOR *cont_i = newListIterator(objGetContents(obj));
+    LIST_ITERATOR cont_i;
+    listIteratorStart(&cont_i, objGetContents(obj));
     OBJ_DATA *cont = NULL;
-    ITERATE_LIST(cont, cont_i)
+    ITERATE_LIST(cont, &cont_i)
       obj_exist(cont);
-    deleteListIterator(cont_i);
+    listIteratorStop(&cont_i);
   }
 }
 
 void obj_unexist(OBJ_DATA *obj) {
   // also unexist all contents
   if(listSize(objGetContents(obj)) > 0) {
-    LIST_ITERATOR *cont_i = newListIterator(objGetContents(obj));
+    LIST_ITERATOR cont_i;
+    listIteratorStart(&cont_i, objGetContents(obj));
     OBJ_DATA *cont = NULL;
-    ITERATE_LIST(cont, cont_i)
+    ITERATE_LIST(cont, &cont_i)
       obj_unexist(cont);
-    deleteListIterator(cont_i);
+    listIteratorStop(&cont_i);
   }
 
-  propertyTableRemove(obj_table, objGetUID(obj));
+  uidTableRemove(obj_table, objGetUID(obj));
 }
 
 bool obj_exists(OBJ_DATA *obj) {
-  return propertyTableIn(obj_table, objGetUID(obj));
+  return uidTableIn(obj_table, objGetUID(obj));
 }
 
 void obj_to_game(OBJ_DATA *obj) {
@@ -95,84 +152,92 @@ void obj_to_game(OBJ_DATA *obj) {
   // set and list storage, for objects physically 'in' the game
   listPut(object_list, obj);
   setPut(object_set, obj);
+  count_instances(&obj_instances, objGetPrototypes(obj), 1);
 
   // execute all of our to_game hooks
-  hookRun("obj_to_game", hookBuildInfo("obj", obj));
+  hookRunTyped("obj_to_game", "obj", obj);
 
   // also add all contents
   if(listSize(objGetContents(obj)) > 0) {
-    LIST_ITERATOR *cont_i = newListIterator(objGetContents(obj));
+    LIST_ITERATOR cont_i;
+    listIteratorStart(&cont_i, objGetContents(obj));
     OBJ_DATA *cont = NULL;
-    ITERATE_LIST(cont, cont_i)
+    ITERATE_LIST(cont, &cont_i)
       obj_to_game(cont);
-    deleteListIterator(cont_i);
+    listIteratorStop(&cont_i);
   }
 }
 
 void room_exist(ROOM_DATA *room) {
-  propertyTablePut(room_table, room);
+  uidTablePut(room_table, room);
 
   // add contents
   if(listSize(roomGetContents(room)) > 0) {
-    LIST_ITERATOR *cont_i = newListIterator(roomGetContents(room));
+    LIST_ITERATOR cont_i;
+    listIteratorStart(&cont_i, roomGetContents(room));
     OBJ_DATA        *cont = NULL;
-    ITERATE_LIST(cont, cont_i)
+    ITERATE_LIST(cont, &cont_i)
       obj_exist(cont);
-    deleteListIterator(cont_i);
+    listIteratorStop(&cont_i);
   }
 
   // add its people
   if(listSize(roomGetCharacters(room)) > 0) {
-    LIST_ITERATOR *ch_i = newListIterator(roomGetCharacters(room));
+    LIST_ITERATOR ch_i;
+    listIteratorStart(&ch_i, roomGetCharacters(room));
     CHAR_DATA       *ch = NULL;
-    ITERATE_LIST(ch, ch_i)
+    ITERATE_LIST(ch, &ch_i)
       char_exist(ch);
-    deleteListIterator(ch_i);
+    listIteratorStop(&ch_i);
   }
 
   // add its exits
   LIST       *ex_list = roomGetExitNames(room);
-  LIST_ITERATOR *ex_i = newListIterator(ex_list);
+  LIST_ITERATOR ex_i;
+  listIteratorStart(&ex_i, ex_list);
   char           *dir = NULL;
-  ITERATE_LIST(dir, ex_i) {
+  ITERATE_LIST(dir, &ex_i) {
     exit_exist(roomGetExit(room, dir));
-  } deleteListIterator(ex_i);
+  } listIteratorStop(&ex_i);
   deleteListWith(ex_list, free);
 }
 
 void room_unexist(ROOM_DATA *room) {
   // add contents
   if(listSize(roomGetContents(room)) > 0) {
-    LIST_ITERATOR *cont_i = newListIterator(roomGetContents(room));
+    LIST_ITERATOR cont_i;
+    listIteratorStart(&cont_i, roomGetContents(room));
     OBJ_DATA        *cont = NULL;
-    ITERATE_LIST(cont, cont_i)
+    ITERATE_LIST(cont, &cont_i)
       obj_unexist(cont);
-    deleteListIterator(cont_i);
+    listIteratorStop(&cont_i);
   }
 
   // add its people
   if(listSize(roomGetCharacters(room)) > 0) {
-    LIST_ITERATOR *ch_i = newListIterator(roomGetCharacters(room));
+    LIST_ITERATOR ch_i;
+    listIteratorStart(&ch_i, roomGetCharacters(room));
     CHAR_DATA       *ch = NULL;
-    ITERATE_LIST(ch, ch_i)
+    ITERATE_LIST(ch, &ch_i)
       char_unexist(ch);
-    deleteListIterator(ch_i);
+    listIteratorStop(&ch_i);
   }
 
   // add its exits
   LIST       *ex_list = roomGetExitNames(room);
-  LIST_ITERATOR *ex_i = newListIterator(ex_list);
+  LIST_ITERATOR ex_i;
+  listIteratorStart(&ex_i, ex_list);
   char           *dir = NULL;
-  ITERATE_LIST(dir, ex_i) {
+  ITERATE_LIST(dir, &ex_i) {
     exit_unexist(roomGetExit(room, dir));
-  } deleteListIterator(ex_i);
+  } listIteratorStop(&ex_i);
   deleteListWith(ex_list, free);
 
-  propertyTableRemove(room_table, roomGetUID(room));
+  uidTableRemove(room_table, roomGetUID(room));
 }
 
 bool room_exists(ROOM_DATA *room) {
-  return propertyTableIn(room_table, roomGetUID(room));
+  return uidTableIn(room_table, roomGetUID(room));
 }
 
 void room_to_game(ROOM_DATA *room) {
@@ -186,31 +251,34 @@ void room_to_game(ROOM_DATA *room) {
   listPut(room_list, room);
 
   // execute all of our to_game hooks
-  hookRun("room_to_game", hookBuildInfo("rm", room));
+  hookRunTyped("room_to_game", "rm", room);
 
   // add contents
   if(listSize(roomGetContents(room)) > 0) {
-    LIST_ITERATOR *cont_i = newListIterator(roomGetContents(room));
+    LIST_ITERATOR cont_i;
+    listIteratorStart(&cont_i, roomGetContents(room));
     OBJ_DATA        *cont = NULL;
-    ITERATE_LIST(cont, cont_i)
+    ITERATE_LIST(cont, &cont_i)
       obj_to_game(cont);
-    deleteListIterator(cont_i);
+    listIteratorStop(&cont_i);
   }
 
   // add its people
   if(listSize(roomGetCharacters(room)) > 0) {
-    LIST_ITERATOR *ch_i = newListIterator(roomGetCharacters(room));
+    LIST_ITERATOR ch_i;
+    listIteratorStart(&ch_i, roomGetCharacters(room));
     CHAR_DATA       *ch = NULL;
-    ITERATE_LIST(ch, ch_i)
+    ITERATE_LIST(ch, &ch_i)
       char_to_game(ch);
-    deleteListIterator(ch_i);
+    listIteratorStop(&ch_i);
   }
 
   // add its exits, and their room table commands as neccessary
   LIST       *ex_list = roomGetExitNames(room);
-  LIST_ITERATOR *ex_i = newListIterator(ex_list);
+  LIST_ITERATOR ex_i;
+  listIteratorStart(&ex_i, ex_list);
   char           *dir = NULL;
-  ITERATE_LIST(dir, ex_i) {
+  ITERATE_LIST(dir, &ex_i) {
     exit_to_game(roomGetExit(room, dir));
     // if we already have a command for this direction in place, ignore
     if(roomHasCmd(room, dir))
@@ -221,39 +289,42 @@ void room_to_game(ROOM_DATA *room) {
       CMD_DATA *cmd = newPyCmd(dir, get_cmd_move(), "player", TRUE);
 
       // add all of our movement checks
-      LIST_ITERATOR *chk_i = newListIterator(get_move_checks());
+      LIST_ITERATOR chk_i;
+      listIteratorStart(&chk_i, get_move_checks());
       PyObject        *chk = NULL;
-      ITERATE_LIST(chk, chk_i) {
+      ITERATE_LIST(chk, &chk_i) {
 	cmdAddPyCheck(cmd, chk);
-      } deleteListIterator(chk_i);
+      } listIteratorStop(&chk_i);
 
       //cmdAddCheck(cmd, chk_can_move);
       roomAddCmd(room, dir, NULL, cmd);
     }
-  } deleteListIterator(ex_i);
+  } listIteratorStop(&ex_i);
   deleteListWith(ex_list, free);
 }
 
 void char_exist(CHAR_DATA *ch) {
-  propertyTablePut(mob_table, ch);
+  uidTablePut(mob_table, ch);
 
   // also add inventory
   if(listSize(charGetInventory(ch)) > 0) {
-    LIST_ITERATOR *inv_i = newListIterator(charGetInventory(ch));
+    LIST_ITERATOR inv_i;
+    listIteratorStart(&inv_i, charGetInventory(ch));
     OBJ_DATA *obj = NULL;
-    ITERATE_LIST(obj, inv_i)
+    ITERATE_LIST(obj, &inv_i)
       obj_exist(obj);
-    deleteListIterator(inv_i);
+    listIteratorStop(&inv_i);
   }
 
   // and equipped items
   LIST *eq = bodyGetAllEq(charGetBody(ch));
   if(listSize(eq) > 0) {
-    LIST_ITERATOR *eq_i = newListIterator(eq);
+    LIST_ITERATOR eq_i;
+    listIteratorStart(&eq_i, eq);
     OBJ_DATA *obj = NULL;
-    ITERATE_LIST(obj, eq_i)
+    ITERATE_LIST(obj, &eq_i)
       obj_exist(obj);
-    deleteListIterator(eq_i);
+    listIteratorStop(&eq_i);
   }
   deleteList(eq);
 }
@@ -261,30 +332,32 @@ void char_exist(CHAR_DATA *ch) {
 void char_unexist(CHAR_DATA *ch) {
   // also unexist inventory
   if(listSize(charGetInventory(ch)) > 0) {
-    LIST_ITERATOR *inv_i = newListIterator(charGetInventory(ch));
+    LIST_ITERATOR inv_i;
+    listIteratorStart(&inv_i, charGetInventory(ch));
     OBJ_DATA *obj = NULL;
-    ITERATE_LIST(obj, inv_i)
+    ITERATE_LIST(obj, &inv_i)
       obj_unexist(obj);
-    deleteListIterator(inv_i);
+    listIteratorStop(&inv_i);
   }
 
   // and equipped items
   LIST *eq = bodyGetAllEq(charGetBody(ch));
   if(listSize(eq) > 0) {
-    LIST_ITERATOR *eq_i = newListIterator(eq);
+    LIST_ITERATOR eq_i;
+    listIteratorStart(&eq_i, eq);
     OBJ_DATA *obj = NULL;
-    ITERATE_LIST(obj, eq_i)
+    ITERATE_LIST(obj, &eq_i)
       obj_unexist(obj);
-    deleteListIterator(eq_i);
+    listIteratorStop(&eq_i);
   }
   deleteList(eq);
 
   // take us out of the lookup table
-  propertyTableRemove(mob_table, charGetUID(ch));
+  uidTableRemove(mob_table, charGetUID(ch));
 }
 
 bool char_exists(CHAR_DATA *ch) {
-  return propertyTableIn(mob_table, charGetUID(ch));
+  return uidTableIn(mob_table, charGetUID(ch));
 }
 
 void char_to_game(CHAR_DATA *ch) {
@@ -296,116 +369,129 @@ void char_to_game(CHAR_DATA *ch) {
   
   setPut(mobile_set, ch);
   listPut(mobile_list, ch);
+  count_instances(&mob_instances, charGetPrototypes(ch), 1);
 
   // execute all of our to_game hooks
-  hookRun("char_to_game", hookBuildInfo("ch", ch));
+  hookRunTyped("char_to_game", "ch", ch);
 
   // also add inventory
   if(listSize(charGetInventory(ch)) > 0) {
-    LIST_ITERATOR *inv_i = newListIterator(charGetInventory(ch));
+    LIST_ITERATOR inv_i;
+    listIteratorStart(&inv_i, charGetInventory(ch));
     OBJ_DATA *obj = NULL;
-    ITERATE_LIST(obj, inv_i)
+    ITERATE_LIST(obj, &inv_i)
       obj_to_game(obj);
-    deleteListIterator(inv_i);
+    listIteratorStop(&inv_i);
   }
 
   // and equipped items
   LIST *eq = bodyGetAllEq(charGetBody(ch));
   if(listSize(eq) > 0) {
-    LIST_ITERATOR *eq_i = newListIterator(eq);
+    LIST_ITERATOR eq_i;
+    listIteratorStart(&eq_i, eq);
     OBJ_DATA *obj = NULL;
-    ITERATE_LIST(obj, eq_i)
+    ITERATE_LIST(obj, &eq_i)
       obj_to_game(obj);
-    deleteListIterator(eq_i);
+    listIteratorStop(&eq_i);
   }
   deleteList(eq);
 }
 
 void exit_from_game(EXIT_DATA *exit) {
-  propertyTableRemove(exit_table, exitGetUID(exit));
+  uidTableRemove(exit_table, exitGetUID(exit));
 }
 
 void obj_from_game(OBJ_DATA *obj) {
   // go through all of our fromgame hooks
-  hookRun("obj_from_game", hookBuildInfo("obj", obj));
+  hookRunTyped("obj_from_game", "obj", obj);
 
   // also remove everything that is contained within the object
   if(listSize(objGetContents(obj)) > 0) {
-    LIST_ITERATOR *cont_i = newListIterator(objGetContents(obj));
+    LIST_ITERATOR cont_i;
+    listIteratorStart(&cont_i, objGetContents(obj));
     OBJ_DATA *cont = NULL;
-    ITERATE_LIST(cont, cont_i)
+    ITERATE_LIST(cont, &cont_i)
       obj_from_game(cont);
-    deleteListIterator(cont_i);
+    listIteratorStop(&cont_i);
   }
 
-  if(setRemove(object_set, obj))
+  if(setRemove(object_set, obj)) {
     listRemove(object_list, obj);
-  propertyTableRemove(obj_table, objGetUID(obj));
+    count_instances(&obj_instances, objGetPrototypes(obj), -1);
+  }
+  uidTableRemove(obj_table, objGetUID(obj));
 }
 
 void room_from_game(ROOM_DATA *room) {
   // go through all of our fromgame hooks
-  hookRun("room_from_game", hookBuildInfo("rm", room));
+  hookRunTyped("room_from_game", "rm", room);
 
   // also remove all the objects contained within the room
   if(listSize(roomGetContents(room)) > 0) {
-    LIST_ITERATOR *cont_i = newListIterator(roomGetContents(room));
+    LIST_ITERATOR cont_i;
+    listIteratorStart(&cont_i, roomGetContents(room));
     OBJ_DATA        *cont = NULL;
-    ITERATE_LIST(cont, cont_i)
+    ITERATE_LIST(cont, &cont_i)
       obj_from_game(cont);
-    deleteListIterator(cont_i);
+    listIteratorStop(&cont_i);
   }
 
   // and now all of the characters
   if(listSize(roomGetCharacters(room)) > 0) {
-    LIST_ITERATOR *ch_i = newListIterator(roomGetCharacters(room));
+    LIST_ITERATOR ch_i;
+    listIteratorStart(&ch_i, roomGetCharacters(room));
     CHAR_DATA       *ch = NULL;
-    ITERATE_LIST(ch, ch_i)
+    ITERATE_LIST(ch, &ch_i)
       char_from_game(ch);
-    deleteListIterator(ch_i);
+    listIteratorStop(&ch_i);
   }
 
   // remove its exits
   LIST       *ex_list = roomGetExitNames(room);
-  LIST_ITERATOR *ex_i = newListIterator(ex_list);
+  LIST_ITERATOR ex_i;
+  listIteratorStart(&ex_i, ex_list);
   char           *dir = NULL;
-  ITERATE_LIST(dir, ex_i)
+  ITERATE_LIST(dir, &ex_i)
     exit_from_game(roomGetExit(room, dir));
-  deleteListIterator(ex_i);
+  listIteratorStop(&ex_i);
   deleteListWith(ex_list, free);
 
   if(setRemove(room_set, room))
     listRemove(room_list, room);
-  propertyTableRemove(room_table, roomGetUID(room));
+  uidTableRemove(room_table, roomGetUID(room));
 }
 
 void char_from_game(CHAR_DATA *ch) {
   // go through all of our fromgame hooks, then remove us from the mobile list
-  hookRun("char_from_game", hookBuildInfo("ch", ch));
+  hookRunTyped("char_from_game", "ch", ch);
 
   // also remove inventory
   if(listSize(charGetInventory(ch)) > 0) {
-    LIST_ITERATOR *inv_i = newListIterator(charGetInventory(ch));
+    LIST_ITERATOR inv_i;
+    listIteratorStart(&inv_i, charGetInventory(ch));
     OBJ_DATA *obj = NULL;
-    ITERATE_LIST(obj, inv_i)
+    ITERATE_LIST(obj, &inv_i)
       obj_from_game(obj);
-    deleteListIterator(inv_i);
+    listIteratorStop(&inv_i);
   }
 
   // and equipped items
   LIST *eq = bodyGetAllEq(charGetBody(ch));
   if(listSize(eq) > 0) {
-    LIST_ITERATOR *eq_i = newListIterator(eq);
+    LIST_ITERATOR eq_i;
+    listIteratorStart(&eq_i, eq);
     OBJ_DATA *obj = NULL;
-    ITERATE_LIST(obj, eq_i)
+    ITERATE_LIST(obj, &eq_i)
       obj_from_game(obj);
-    deleteListIterator(eq_i);
+    listIteratorStop(&eq_i);
   }
   deleteList(eq);
 
-  if(setRemove(mobile_set, ch))
+  if(setRemove(mobile_set, ch)) {
     listRemove(mobile_list, ch);
-  propertyTableRemove(mob_table, charGetUID(ch));
+    count_instances(&mob_instances, charGetPrototypes(ch), -1);
+  }
+  uidTableRemove(mob_table, charGetUID(ch));
 }
 
 void obj_from_char(OBJ_DATA *obj) {
@@ -413,7 +499,7 @@ void obj_from_char(OBJ_DATA *obj) {
     CHAR_DATA *ch = objGetCarrier(obj);
     listRemove(charGetInventory(objGetCarrier(obj)), obj);
     objSetCarrier(obj, NULL);
-    hookRun("obj_from_char", hookBuildInfo("obj ch", obj, ch));
+    hookRunTyped("obj_from_char", "obj ch", obj, ch);
   }
 }
 
@@ -422,7 +508,7 @@ void obj_from_obj(OBJ_DATA *obj) {
     OBJ_DATA *container = objGetContainer(obj);
     listRemove(objGetContents(objGetContainer(obj)), obj);
     objSetContainer(obj, NULL);
-    hookRun("obj_from_obj", hookBuildInfo("obj obj", obj, container));
+    hookRunTyped("obj_from_obj", "obj obj", obj, container);
   }
 }
 
@@ -431,32 +517,32 @@ void obj_from_room(OBJ_DATA *obj) {
     ROOM_DATA *room = objGetRoom(obj);
     listRemove(roomGetContents(objGetRoom(obj)), obj);
     objSetRoom(obj, NULL);
-    hookRun("obj_from_room", hookBuildInfo("obj rm", obj, room));
+    hookRunTyped("obj_from_room", "obj rm", obj, room);
   }
 }
 
 void obj_to_char(OBJ_DATA *obj, CHAR_DATA *ch) {
   listPut(charGetInventory(ch), obj);
   objSetCarrier(obj, ch);
-  hookRun("obj_to_char", hookBuildInfo("obj ch", obj, ch));
+  hookRunTyped("obj_to_char", "obj ch", obj, ch);
 }
 
 void obj_to_obj(OBJ_DATA *obj, OBJ_DATA *to) {
   listPut(objGetContents(to), obj);
   objSetContainer(obj, to);
-  hookRun("obj_to_obj", hookBuildInfo("obj obj", obj, to));
+  hookRunTyped("obj_to_obj", "obj obj", obj, to);
 }
 
 void obj_to_room(OBJ_DATA *obj, ROOM_DATA *room) {
   listPut(roomGetContents(room), obj);
   objSetRoom(obj, room);
-  hookRun("obj_to_room", hookBuildInfo("obj rm", obj, room));
+  hookRunTyped("obj_to_room", "obj rm", obj, room);
 }
 
 void char_from_room(CHAR_DATA *ch) {
   if(charGetRoom(ch) != NULL) {
     ROOM_DATA *room = charGetRoom(ch);
-    hookRun("char_from_room", hookBuildInfo("ch rm", ch, room));
+    hookRunTyped("char_from_room", "ch rm", ch, room);
     charSetLastRoom(ch, charGetRoom(ch));
     roomRemoveChar(charGetRoom(ch), ch);
     charSetRoom(ch, NULL);
@@ -468,7 +554,7 @@ void char_to_room(CHAR_DATA *ch, ROOM_DATA *room) {
     char_from_room(ch);
   roomAddChar(room, ch);
   charSetRoom(ch, room);
-  hookRun("char_to_room", hookBuildInfo("ch rm", ch, room));
+  hookRunTyped("char_to_room", "ch rm", ch, room);
 }
 
 void char_from_furniture(CHAR_DATA *ch) {
@@ -528,18 +614,19 @@ bool try_equip(CHAR_DATA *ch, OBJ_DATA *obj, const char *wanted_pos,
     if(listSize(want_types) != listSize(need_types))
       match = FALSE;
     else {
-      LIST_ITERATOR *need_i = newListIterator(need_types);
+      LIST_ITERATOR need_i;
+      listIteratorStart(&need_i, need_types);
       char        *one_need = NULL;
 
       // now, make sure that each our our needed positions is represented
-      ITERATE_LIST(one_need, need_i) {
+      ITERATE_LIST(one_need, &need_i) {
 	char *found = listRemoveWith(want_types, one_need, strcasecmp);
 	// if we found it, free the memory. Otherwise, break out and fail
 	if(found == NULL)
 	  break;
 	else
 	  free(found);
-      } deleteListIterator(need_i);
+      } listIteratorStop(&need_i);
 
       // make sure we accounted for all of our needed positions
       match = (listSize(want_types) == 0);
@@ -556,7 +643,7 @@ bool try_equip(CHAR_DATA *ch, OBJ_DATA *obj, const char *wanted_pos,
   }
 
   if(success == TRUE)
-    hookRun("equip", hookBuildInfo("ch obj", ch, obj));
+    hookRunTyped("equip", "ch obj", ch, obj);
 
   return success;
 }
@@ -571,13 +658,13 @@ bool do_unequip(CHAR_DATA *ch, OBJ_DATA *obj) {
 
 bool try_unequip(CHAR_DATA *ch, OBJ_DATA *obj) {
   if(objGetWearer(obj) == ch) {
-    hookRun("pre_unequip", hookBuildInfo("ch obj", ch, obj));
+    hookRunTyped("pre_unequip", "ch obj", ch, obj);
 
     // if wearer == ch, this should never fail
     bool success = do_unequip(ch, obj);
 
     if(success == TRUE)
-      hookRun("unequip", hookBuildInfo("ch obj", ch, obj));
+      hookRunTyped("unequip", "ch obj", ch, obj);
     else
       log_string("ERROR: failed to unequip obj when wearer == ch");
     return success;
@@ -1041,10 +1128,11 @@ void *find_one(CHAR_DATA *looker,
     }
 
     LIST       *ex_list = roomGetExitNames(charGetRoom(looker));
-    LIST_ITERATOR *ex_i = newListIterator(ex_list);
+    LIST_ITERATOR ex_i;
+    listIteratorStart(&ex_i, ex_list);
     char           *dir = NULL;
 
-    ITERATE_LIST(dir, ex_i) {
+    ITERATE_LIST(dir, &ex_i) {
       exit = roomGetExit(charGetRoom(looker), dir);
       if(exitIsName(exit, at)) {
 	if(!IS_SET(find_scope,FIND_SCOPE_VISIBLE) || can_see_exit(looker,exit)){
@@ -1056,7 +1144,7 @@ void *find_one(CHAR_DATA *looker,
 	  }
 	}
       }
-    } deleteListIterator(ex_i);
+    } listIteratorStop(&ex_i);
     deleteListWith(ex_list, free);
 
     // we found one
@@ -43,6 +43,14 @@ bool      exit_exists       (EXIT_DATA *exit);
 void      exit_to_game      (EXIT_DATA *exit);
 void      exit_from_game    (EXIT_DATA *exit);
 
+//
+// how many objects or mobiles in the game are instances of the prototype
+// (e.g. because they were loaded from it, or from something that inherits
+// from it)? The prototype must be a full key. Unlike count_objs and
+// count_chars, this does not have to go over everything in the game
+int       count_obj_instances (const char *prototype);
+int       count_char_instances(const char *prototype);
+
 
 // all of these things require that the character(s) and object(s) have
 // the right spatial relations to eachtoher (e.g. do_give requires the
@@ -5,6 +5,21 @@
 // Your friendly neighbourhood hashtable. Maps a <key> to a <value>. *sigh*
 // why am I not writing this MUD in C++, again?
 //
+// Oct 16/26:
+//   Hashtables used to keep a LIST of malloc'd entries per bucket, and
+// allocated an iterator every time something was looked up. They are now flat
+// and open-addressed. Entries live in one dense array, in the order they were
+// added. Beside it is an index of slots, each holding an entry's position and
+// its cached hash, probed Robin Hood style: an entry being placed steals the
+// slot of any entry that is closer to its home slot than it is. That keeps
+// probe lengths short and even, and lets a lookup stop as soon as it passes
+// the point where its key would have been. Removals shift the following slots
+// back instead of leaving tombstones in the index. In the entry array, the
+// removed entry is only blanked out, so iterators running over the table skip
+// it without losing their place. Blanked entries are squeezed out the next
+// time the table needs room, unless an iterator is still running over it.
+// Looking things up never allocates anything.
+//
 //*****************************************************************************
 
 #include <stdlib.h>
@@ -20,70 +35,159 @@
 // how big of a size do our hashtables start out at?
 #define DEFAULT_HASH_SIZE        5
 
+// the smallest index we'll make, once something is put in a table. Must be a
+// power of two
+#define MIN_INDEX_SIZE           8
+
+// an index slot that has no entry in it
+#define EMPTY_SLOT              -1
+
 struct hashtable_iterator {
-  unsigned int curr_bucket;
-  HASHTABLE *table;
-  LIST_ITERATOR *bucket_i;
+  int            curr; // the position in the entry array we're on
+  HASHTABLE    *table;
 };
 
 typedef struct hashtable_entry {
-  char *key;
-  void *val;
+  char          *key; // NULL if the entry has been removed
+  void          *val;
+  unsigned int  hash;
 } HASH_ENTRY;
 
+typedef struct hashtable_slot {
+  unsigned int  hash; // the hash of the entry, so we rarely touch the key
+  int          entry; // the entry's position in the array, or EMPTY_SLOT
+} HASH_SLOT;
+
 struct hashtable {
-  int size;
-  int num_buckets;
-  LIST **buckets;
+  int               size; // how many keys are in the table
+  HASH_ENTRY    *entries; // dense, in the order they were added
+  int        num_entries; // how much of entries is used, removed ones too
+  int        max_entries; // how many entries before we need to make room
+  HASH_SLOT       *slots; // the open-addressed index into entries
+  unsigned int slot_mask; // number of slots - 1. Slots is a power of two
+  int          iterators; // how many iterators are running over us
+  int          init_size; // how much room to make on the first put
 };
 
 
 //
-// an internal form of hashGet that returns the entire entry (key and val)
-HASH_ENTRY *hashGetEntry(HASHTABLE *table, const char *key){
-  unsigned int bucket = string_hash(key) % table->num_buckets;
-
-  if(table->buckets[bucket] == NULL)
-    return NULL;
-  else {
-    LIST_ITERATOR *list_i = newListIterator(table->buckets[bucket]);
-    HASH_ENTRY      *elem = NULL;
+// a one-pass, case-insensitive FNV-1a hash. Keys are compared with
+// strcasecmp, so KEY and key have to hash to the same place
+unsigned int hash_key(const char *key) {
+  unsigned int h = 2166136261U;
+  for(; *key; key++)
+    h = (h ^ (unsigned char)tolower(*key)) * 16777619U;
+  return h;
+}
 
-    for(;(elem = listIteratorCurrent(list_i)) != NULL; listIteratorNext(list_i))
-      if(!strcasecmp(key, elem->key))
-	break;
-    deleteListIterator(list_i);
+//
+// how far is a slot from the slot its hash would ideally have put it in?
+unsigned int hash_probe_dist(HASHTABLE *table, unsigned int hash,
+			     unsigned int slot) {
+  return (slot - hash) & table->slot_mask;
+}
 
-    return elem;
+//
+// find the slot that holds the key. Returns EMPTY_SLOT if it's not there
+int hash_find_slot(HASHTABLE *table, const char *key, unsigned int hash) {
+  unsigned int slot, dist;
+
+  if(table->size == 0)
+    return EMPTY_SLOT;
+
+  for(slot = hash & table->slot_mask, dist = 0; ;
+      slot = (slot + 1) & table->slot_mask, dist++) {
+    HASH_SLOT *s = &table->slots[slot];
+    // we've hit an empty slot, or passed where our key would have been
+    if(s->entry == EMPTY_SLOT || hash_probe_dist(table, s->hash, slot) < dist)
+      return EMPTY_SLOT;
+    if(s->hash == hash && !strcasecmp(key, table->entries[s->entry].key))
+      return slot;
   }
 }
 
-HASH_ENTRY *newHashtableEntry(const char *key, void *val) {
-  HASH_ENTRY *entry = malloc(sizeof(HASH_ENTRY));
-  entry->key = strdup(key);
-  entry->val = val;
-  return entry;
+//
+// put an entry into the index. The key must not already be in it
+void hash_index_entry(HASHTABLE *table, int entry, unsigned int hash) {
+  unsigned int slot = hash & table->slot_mask, dist = 0;
+  HASH_SLOT    next = { hash, entry };
+
+  for(;; slot = (slot + 1) & table->slot_mask, dist++) {
+    HASH_SLOT *s = &table->slots[slot];
+    if(s->entry == EMPTY_SLOT) {
+      *s = next;
+      return;
+    }
+    // the current occupant is better off than us. Take its slot, and
+    // carry on placing it instead
+    else {
+      unsigned int s_dist = hash_probe_dist(table, s->hash, slot);
+      if(s_dist < dist) {
+	HASH_SLOT tmp = *s;
+	*s   = next;
+	next = tmp;
+	dist = s_dist;
+      }
+    }
+  }
 }
 
-void deleteHashtableEntry(HASH_ENTRY *entry) {
-  if(entry->key) free(entry->key);
-  free(entry);
+//
+// take a slot out of the index, shifting everything after it that isn't in
+// its home slot back by one
+void hash_unindex_slot(HASHTABLE *table, unsigned int slot) {
+  unsigned int next = (slot + 1) & table->slot_mask;
+  while(table->slots[next].entry != EMPTY_SLOT &&
+	hash_probe_dist(table, table->slots[next].hash, next) > 0) {
+    table->slots[slot] = table->slots[next];
+    slot = next;
+    next = (next + 1) & table->slot_mask;
+  }
+  table->slots[slot].entry = EMPTY_SLOT;
 }
 
 //
-// Collect all of the HASH_ENTRYs in a hashtable into a single list
-LIST *hashCollectEntries(HASHTABLE *table) {
-  LIST *list = newList();
-  int i;
-  for(i = 0; i < table->num_buckets; i++) {
-    if(table->buckets[i] == NULL) continue;
-    LIST_ITERATOR *list_i = newListIterator(table->buckets[i]);
-    HASH_ENTRY      *elem = NULL;
-    for(;(elem=listIteratorCurrent(list_i)) != NULL;listIteratorNext(list_i))
-      listPut(list, elem);
-    deleteListIterator(list_i);
+// rebuild the table so it has room for at least the given number of keys.
+// Removed entries are squeezed out, unless an iterator is running over us
+// and would lose its place
+void hash_resize(HASHTABLE *table, int size) {
+  unsigned int num_slots = MIN_INDEX_SIZE, i;
+  int from, to;
+
+  // keep the index no more than 3/4 full
+  if(size < table->size)
+    size = table->size;
+  if(table->iterators > 0 && size <= table->num_entries)
+    size = table->num_entries + 1;
+  while(num_slots - num_slots/4 < (unsigned int)size)
+    num_slots *= 2;
+
+  // squeeze out the removed entries
+  if(table->iterators == 0) {
+    for(from = to = 0; from < table->num_entries; from++)
+      if(table->entries[from].key != NULL)
+	table->entries[to++] = table->entries[from];
+    table->num_entries = to;
   }
-  return list;
+
+  table->max_entries = num_slots - num_slots/4;
+  table->entries     = realloc(table->entries,
+			       sizeof(HASH_ENTRY) * table->max_entries);
+  table->slot_mask   = num_slots - 1;
+  table->slots       = realloc(table->slots, sizeof(HASH_SLOT) * num_slots);
+  for(i = 0; i < num_slots; i++)
+    table->slots[i].entry = EMPTY_SLOT;
+  for(from = 0; from < table->num_entries; from++)
+    if(table->entries[from].key != NULL)
+      hash_index_entry(table, from, table->entries[from].hash);
+}
+
+//
+// advance an iterator past any entries that have been removed from under it
+void hash_iterator_settle(HASH_ITERATOR *I) {
+  while(I->curr < I->table->num_entries &&
+	I->table->entries[I->curr].key == NULL)
+    I->curr++;
 }
 
 
@@ -93,13 +197,10 @@ LIST *hashCollectEntries(HASHTABLE *table) {
 // documentation in hashtable.h
 //*****************************************************************************
 HASHTABLE *newHashtableSize(int num_buckets) {
-  int i;
-  HASHTABLE *table   = malloc(sizeof(HASHTABLE));
-  table->num_buckets = num_buckets;
-  table->size        = 0;
-  table->buckets = malloc(sizeof(LIST *) * num_buckets);
-  for(i = 0; i < num_buckets; i++)
-    table->buckets[i] = NULL;
+  HASHTABLE *table = calloc(1, sizeof(HASHTABLE));
+  // small tables are very common (auxiliary data, storage sets), so nothing
+  // is allocated for the entries until something is actually put in
+  table->init_size = num_buckets;
   return table;
 }
 
@@ -110,12 +211,11 @@ HASHTABLE *newHashtable(void) {
 
 void  deleteHashtable(HASHTABLE *table) {
   int i;
-  for(i = 0; i < table->num_buckets; i++) {
-    if(table->buckets[i])
-      deleteListWith(table->buckets[i], deleteHashtableEntry);
-  }
-
-  free(table->buckets);
+  for(i = 0; i < table->num_entries; i++)
+    if(table->entries[i].key)
+      free(table->entries[i].key);
+  if(table->entries) free(table->entries);
+  if(table->slots)   free(table->slots);
   free(table);
 }
 
@@ -127,94 +227,70 @@ void deleteHashtableWith(HASHTABLE *table, void *func) {
 //
 // expand a hashtable to the new size
 void hashExpand(HASHTABLE *table, int size) {
-  // collect all of the key:value pairs
-  LIST     *entries = hashCollectEntries(table);
-  HASH_ENTRY *entry = NULL;
-  int i;
-
-  // delete all of the current buckets
-  for(i = 0; i < table->num_buckets; i++) {
-    if(table->buckets[i] == NULL) continue;
-    deleteList(table->buckets[i]);
-  }
-  free(table->buckets);
-
-  // now, make new buckets and set them to NULL
-  table->buckets = calloc(size, sizeof(LIST *));
-  table->num_buckets = size;
-
-  // now, we put all of our entries back into the new buckets
-  while((entry = listPop(entries)) != NULL) {
-    unsigned int bucket = string_hash(entry->key) % table->num_buckets;
-    if(table->buckets[bucket] == NULL) table->buckets[bucket] = newList();
-    listPut(table->buckets[bucket], entry);
-  }
-  deleteList(entries);
+  if(size > table->max_entries)
+    hash_resize(table, size);
 }
 
 
 int hashPut(HASHTABLE *table, const char *key, void *val) {
-  HASH_ENTRY *elem = hashGetEntry(table, key);
+  unsigned int hash = hash_key(key);
+  int          slot = hash_find_slot(table, key, hash);
 
   // if it's already in, update the value
-  if(elem) {
-    elem->val = val;
+  if(slot != EMPTY_SLOT) {
+    table->entries[table->slots[slot].entry].val = val;
     return 1;
   }
   else {
-    // first, see if we'll need to expand the table
-    if((table->size * 80)/100 > table->num_buckets)
-      hashExpand(table, (table->num_buckets * 150)/100);
-
-    unsigned int bucket = string_hash(key) % table->num_buckets;
-
-    // if the bucket doesn't exist yet, create it
-    if(table->buckets[bucket] == NULL)
-      table->buckets[bucket] = newList();
-
-    HASH_ENTRY *entry = newHashtableEntry(key, val);
-    listPut(table->buckets[bucket], entry);
+    // first, see if we'll need to make room
+    if(table->slots == NULL)
+      hash_resize(table, MAX(1, table->init_size));
+    else if(table->num_entries >= table->max_entries)
+      hash_resize(table, (table->size + 1) * 2);
+
+    HASH_ENTRY *entry = &table->entries[table->num_entries];
+    entry->key  = strdup(key);
+    entry->val  = val;
+    entry->hash = hash;
+    hash_index_entry(table, table->num_entries, hash);
+    table->num_entries++;
     table->size++;
     return 1;
   }
 }
 
 void *hashGet(HASHTABLE *table, const char *key) {
-  HASH_ENTRY *elem = hashGetEntry(table, key);
-  if(elem != NULL)
-    return elem->val;
+  int slot = hash_find_slot(table, key, hash_key(key));
+  if(slot != EMPTY_SLOT)
+    return table->entries[table->slots[slot].entry].val;
   else
     return NULL;
 }
 
 void *hashRemove(HASHTABLE *table, const char *key) {
-  unsigned int bucket = string_hash(key) % table->num_buckets;
+  int slot = hash_find_slot(table, key, hash_key(key));
 
-  if(table->buckets[bucket] == NULL)
+  if(slot == EMPTY_SLOT)
     return NULL;
   else {
-    LIST_ITERATOR *list_i = newListIterator(table->buckets[bucket]);
-    HASH_ENTRY *elem = NULL;
-
-    for(;(elem = listIteratorCurrent(list_i)) != NULL; listIteratorNext(list_i))
-      if(!strcasecmp(key, elem->key))
-	break;
-    deleteListIterator(list_i);
-
-    if(elem) {
-      void *val = elem->val;
-      listRemove(table->buckets[bucket], elem);
-      deleteHashtableEntry(elem);
-      table->size--;
-      return val;
-    }
-    else
-      return NULL;
+    HASH_ENTRY *entry = &table->entries[table->slots[slot].entry];
+    void         *val = entry->val;
+    hash_unindex_slot(table, slot);
+    free(entry->key);
+    entry->key = NULL;
+    entry->val = NULL;
+    table->size--;
+
+    // if it was the last entry, we can reuse its space right away
+    while(table->iterators == 0 && table->num_entries > 0 &&
+	  table->entries[table->num_entries - 1].key == NULL)
+      table->num_entries--;
+    return val;
   }
 }
 
 int   hashIn     (HASHTABLE *table, const char *key) {
-  return (hashGetEntry(table, key) != NULL);
+  return (hash_find_slot(table, key, hash_key(key)) != EMPTY_SLOT);
 }
 
 int   hashSize   (HASHTABLE *table) {
@@ -224,15 +300,9 @@ int   hashSize   (HASHTABLE *table) {
 LIST *hashCollect(HASHTABLE *table) {
   LIST *list = newList();
   int i;
-
-  for(i = 0; i < table->num_buckets; i++) {
-    if(table->buckets[i] == NULL) continue;
-    LIST_ITERATOR *list_i = newListIterator(table->buckets[i]);
-    HASH_ENTRY      *elem = NULL;
-    for(;(elem=listIteratorCurrent(list_i)) != NULL;listIteratorNext(list_i))
-      listPut(list, strdup(elem->key));
-    deleteListIterator(list_i);
-  }
+  for(i = 0; i < table->num_entries; i++)
+    if(table->entries[i].key != NULL)
+      listPut(list, strdup(table->entries[i].key));
   return list;
 }
 
@@ -242,17 +312,24 @@ void hashClear(HASHTABLE *table) {
 
 void hashClearWith(HASHTABLE *table, void *func) {
   void (* free_func)(void *) = func;
-  int i;
-
-  for(i = 0; i < table->num_buckets; i++) {
-    if(table->buckets[i] == NULL) continue;
-    HASH_ENTRY *elem = NULL;
-    while( (elem = listPop(table->buckets[i])) != NULL) {
-      if(free_func && elem->val)
-	free_func(elem->val);
-      deleteHashtableEntry(elem);
-    }
+  unsigned int i;
+
+  for(i = 0; i < (unsigned int)table->num_entries; i++) {
+    HASH_ENTRY *entry = &table->entries[i];
+    if(entry->key == NULL) continue;
+    if(free_func && entry->val)
+      free_func(entry->val);
+    free(entry->key);
+    entry->key = NULL;
+    entry->val = NULL;
   }
+
+  if(table->slots != NULL)
+    for(i = 0; i <= table->slot_mask; i++)
+      table->slots[i].entry = EMPTY_SLOT;
+  if(table->iterators == 0)
+    table->num_entries = 0;
+  table->size = 0;
 }
 
 
@@ -264,78 +341,42 @@ void hashClearWith(HASHTABLE *table, void *func) {
 HASH_ITERATOR *newHashIterator(HASHTABLE *table) {
   HASH_ITERATOR *I = malloc(sizeof(HASH_ITERATOR));
   I->table = table;
-  I->bucket_i = NULL;
+  I->table->iterators++;
   hashIteratorReset(I);
-
   return I;
 }
 
 void        deleteHashIterator     (HASH_ITERATOR *I) {
-  if(I->bucket_i) deleteListIterator(I->bucket_i);
+  I->table->iterators--;
   free(I);
 }
 
 void        hashIteratorReset      (HASH_ITERATOR *I) {
-  int i;
-
-  if(I->bucket_i) deleteListIterator(I->bucket_i);
-  I->bucket_i = NULL;
-  I->curr_bucket = 0;
-
-  // bucket_i will be NULL if there are no elements
-  for(i = 0; i < I->table->num_buckets; i++) {
-    if(I->table->buckets[i] != NULL &&
-       listSize(I->table->buckets[i]) > 0) {
-      I->curr_bucket = i;
-      I->bucket_i = newListIterator(I->table->buckets[i]);
-      break;
-    }
-  }
+  I->curr = 0;
+  hash_iterator_settle(I);
 }
 
 
 void        hashIteratorNext       (HASH_ITERATOR *I) {
-  // no elements in the hashtable
-  if(I->bucket_i == NULL) 
-    return;
-  // we're at the end of our list
-  else if(listIteratorNext(I->bucket_i) == NULL) {
-    deleteListIterator(I->bucket_i);
-    I->bucket_i = NULL;
-    I->curr_bucket++;
-    
-    for(; I->curr_bucket < I->table->num_buckets; I->curr_bucket++) {
-      if(I->table->buckets[I->curr_bucket] != NULL &&
-	 listSize(I->table->buckets[I->curr_bucket]) > 0) {
-	I->bucket_i = newListIterator(I->table->buckets[I->curr_bucket]);
-	break;
-      }
-    }
-  }
+  if(I->curr < I->table->num_entries)
+    I->curr++;
+  hash_iterator_settle(I);
 }
 
 
 const char *hashIteratorCurrentKey (HASH_ITERATOR *I) {
-  if(!I->bucket_i) 
+  hash_iterator_settle(I);
+  if(I->curr < I->table->num_entries)
+    return I->table->entries[I->curr].key;
+  else
     return NULL;
-  else {
-    HASH_ENTRY *entry = listIteratorCurrent(I->bucket_i);
-    if(entry)
-      return entry->key;
-    else
-      return NULL;
-  }
 }
 
 
 void       *hashIteratorCurrentVal (HASH_ITERATOR *I) {
-  if(!I->bucket_i) 
+  hash_iterator_settle(I);
+  if(I->curr < I->table->num_entries)
+    return I->table->entries[I->curr].val;
+  else
     return NULL;
-  else {
-    HASH_ENTRY *entry = listIteratorCurrent(I->bucket_i);
-    if(entry)
-      return entry->val;
-    else
-      return NULL;
-  }
 }
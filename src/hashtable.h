@@ -13,7 +13,8 @@ typedef struct hashtable                  HASHTABLE;
 typedef struct hashtable_iterator         HASH_ITERATOR;
 
 //
-// create a new hashtable with the specified number of buckets in it
+// create a new hashtable with room for the specified number of keys in it.
+// No room is actually made until the first key is put in
 HASHTABLE *newHashtableSize(int num_buckets);
 
 //
@@ -37,7 +38,7 @@ int   hashIn     (HASHTABLE *table, const char *key);
 int   hashSize   (HASHTABLE *table);
 
 //
-// expand a hashtable to the new size. Hashtables will automagically expand
+// expand a hashtable to hold size keys. Hashtables will automagically expand
 // themselves as needed, but if you know that you are going to need a rather
 // large hashtable apriori, you may wish to call this function after the table
 // is created, to prevent unneccessary deallocations and reallocations of memory
@@ -63,7 +64,8 @@ void hashClearWith(HASHTABLE *table, void *func);
 // prototypes for the hashtable iterator
 //*****************************************************************************
 
-// iterate across all the elements in a hashtable
+// iterate across all the elements in a hashtable, in the order they were
+// added. Elements may be removed while iterating
 #define ITERATE_HASH(key, val, it) \
   for(key = hashIteratorCurrentKey(it), val = hashIteratorCurrentVal(it); \
       key != NULL; \
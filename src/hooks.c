@@ -42,6 +42,172 @@ LIST *monitors = NULL;
 // a buffer for building hook info on
 BUFFER      *info_buf = NULL;
 
+// the table of all our installed typed hooks, and the functions that are
+// called with the arguments of every hook that is run
+HASHTABLE *typed_hook_table = NULL;
+LIST        *typed_monitors = NULL;
+
+
+//
+// are there any listeners for the hook type in the table?
+bool hook_has_listeners(HASHTABLE *table, const char *type) {
+  LIST *list = hashGet(table, type);
+  return (list != NULL && listSize(list) > 0);
+}
+
+//
+// prepare a set of hook arguments for use
+void hook_args_init(HOOK_ARGS *args) {
+  args->num     = 0;
+  args->info    = NULL;
+  args->scratch = NULL;
+}
+
+//
+// free up anything hook arguments built along the way
+void hook_args_clear(HOOK_ARGS *args) {
+  if(args->info)    free(args->info);
+  if(args->scratch) free(args->scratch);
+}
+
+//
+// returns the argument type a format token describes, or -1 if it does not
+// describe one. Tokens are not NUL-terminated; len is how long the token is
+int hook_arg_type(const char *token, int len) {
+  if(len == 2 && !strncasecmp(token, "ch", 2))
+    return HOOK_ARG_CH;
+  if(len == 3 && !strncasecmp(token, "obj", 3))
+    return HOOK_ARG_OBJ;
+  if((len == 2 && !strncasecmp(token, "rm", 2)) ||
+     (len == 4 && !strncasecmp(token, "room", 4)))
+    return HOOK_ARG_ROOM;
+  if((len == 2 && !strncasecmp(token, "ex", 2)) ||
+     (len == 4 && !strncasecmp(token, "exit", 4)))
+    return HOOK_ARG_EXIT;
+  if((len == 2 && !strncasecmp(token, "sk", 2)) ||
+     (len == 4 && !strncasecmp(token, "sock", 4)))
+    return HOOK_ARG_SOCK;
+  if(len == 3 && !strncasecmp(token, "str", 3))
+    return HOOK_ARG_STR;
+  if(len == 3 && !strncasecmp(token, "int", 3))
+    return HOOK_ARG_INT;
+  if(len == 3 && !strncasecmp(token, "dbl", 3))
+    return HOOK_ARG_DBL;
+  return -1;
+}
+
+//
+// if the token starts with the prefix and a dot, look up the thing with the
+// UID that follows in the table and add it to the arguments
+bool hook_args_lookup(HOOK_ARGS *args, const char *token, const char *prefix,
+		      int type, UID_TABLE *table) {
+  int len = strlen(prefix);
+  if(strncasecmp(token, prefix, len) || token[len] != '.')
+    return FALSE;
+  args->arg[args->num].type    = type;
+  args->arg[args->num].val.ptr = uidTableGet(table, atoi(token + len + 1));
+  args->num++;
+  return TRUE;
+}
+
+//
+// pull the arguments out of an info string, for typed listeners of hooks that
+// were run with hookRun. Parsed the same way hookParseInfo does
+void hook_args_from_info(HOOK_ARGS *args, const char *info) {
+  char *token = args->scratch = strdup(info);
+
+  while(*token && args->num < HOOK_MAX_ARGS) {
+    // skip leading spaces
+    while(isspace(*token))
+      token++;
+    if(*token == '\0')
+      break;
+
+    // strings run to their end marker, everything else to the next space
+    char marker = ' ', *end = NULL;
+    if(*token == HOOK_STR_MARKER) {
+      marker = HOOK_STR_MARKER;
+      token++;
+    }
+    for(end = token; *end && *end != marker; end++)
+      ;
+    char *next = (*end ? end + 1 : end);
+    *end = '\0';
+
+    if(marker == HOOK_STR_MARKER) {
+      args->arg[args->num].type    = HOOK_ARG_STR;
+      args->arg[args->num].val.str = token;
+      args->num++;
+    }
+    else if(hook_args_lookup(args, token, "ch",   HOOK_ARG_CH,   mob_table)  ||
+	    hook_args_lookup(args, token, "obj",  HOOK_ARG_OBJ,  obj_table)  ||
+	    hook_args_lookup(args, token, "rm",   HOOK_ARG_ROOM, room_table) ||
+	    hook_args_lookup(args, token, "room", HOOK_ARG_ROOM, room_table) ||
+	    hook_args_lookup(args, token, "ex",   HOOK_ARG_EXIT, exit_table) ||
+	    hook_args_lookup(args, token, "exit", HOOK_ARG_EXIT, exit_table) ||
+	    hook_args_lookup(args, token, "sk",   HOOK_ARG_SOCK, sock_table) ||
+	    hook_args_lookup(args, token, "sock", HOOK_ARG_SOCK, sock_table))
+      ;
+    else if(isdigit(*token)) {
+      // integer or double?
+      if(next_letter_in(token, '.') > -1) {
+	args->arg[args->num].type    = HOOK_ARG_DBL;
+	args->arg[args->num].val.dbl = atof(token);
+      }
+      else {
+	args->arg[args->num].type    = HOOK_ARG_INT;
+	args->arg[args->num].val.num = atoi(token);
+      }
+      args->num++;
+    }
+    token = next;
+  }
+}
+
+//
+// run all of the listeners and monitors for a hook
+void hook_dispatch(const char *type, HOOK_ARGS *args) {
+  LIST *typed = hashGet(typed_hook_table, type);
+  LIST  *list = hashGet(hook_table, type);
+
+  if(typed != NULL && listSize(typed) > 0) {
+    LIST_ITERATOR typed_i;
+    listIteratorStart(&typed_i, typed);
+    void (* func)(HOOK_ARGS *) = NULL;
+    ITERATE_LIST(func, &typed_i) {
+      func(args);
+    } listIteratorStop(&typed_i);
+  }
+
+  // the old-style listeners only get told about things with the info string
+  if(list != NULL && listSize(list) > 0) {
+    LIST_ITERATOR list_i;
+    listIteratorStart(&list_i, list);
+    void (* func)(const char *) = NULL;
+    ITERATE_LIST(func, &list_i) {
+      func(hookArgsInfo(args));
+    } listIteratorStop(&list_i);
+  }
+
+  // run our monitors
+  if(listSize(typed_monitors) > 0) {
+    LIST_ITERATOR mon_i;
+    listIteratorStart(&mon_i, typed_monitors);
+    void (* mon)(const char *, HOOK_ARGS *) = NULL;
+    ITERATE_LIST(mon, &mon_i) {
+      mon(type, args);
+    } listIteratorStop(&mon_i);
+  }
+  if(listSize(monitors) > 0) {
+    LIST_ITERATOR mon_i;
+    listIteratorStart(&mon_i, monitors);
+    void (* mon)(const char *, const char *) = NULL;
+    ITERATE_LIST(mon, &mon_i) {
+      mon(type, hookArgsInfo(args));
+    } listIteratorStop(&mon_i);
+  }
+}
+
 
 
 //*****************************************************************************
@@ -52,6 +218,8 @@ void init_hooks(void) {
   hook_table = newHashtable();
   info_buf   = newBuffer(1);
   monitors   = newList();
+  typed_hook_table = newHashtable();
+  typed_monitors   = newList();
 }
 
 void hookRemove(const char *type, void (* func)(const char *)) {
@@ -73,23 +241,14 @@ void hookAddMonitor(void (* func)(const char *, const char *)) {
 }
 
 void hookRun(const char *type, const char *info) {
-  LIST *list = hashGet(hook_table, type);
-  char *info_dup = strdup(info);
-  if(list != NULL) {
-    LIST_ITERATOR *list_i = newListIterator(list);
-    void (* func)(const char *) = NULL;
-    ITERATE_LIST(func, list_i) {
-      func(info_dup);
-    } deleteListIterator(list_i);
-  }
-
-  // run our monitors
-  LIST_ITERATOR *mon_i = newListIterator(monitors);
-  void (* mon)(const char *, const char *) = NULL;
-  ITERATE_LIST(mon, mon_i) {
-    mon(type, info_dup);
-  } deleteListIterator(mon_i);
-  free(info_dup);
+  HOOK_ARGS args;
+  hook_args_init(&args);
+  args.info = strdup(info);
+  // only pull the arguments out if someone is going to look at them
+  if(listSize(typed_monitors) > 0 || hook_has_listeners(typed_hook_table, type))
+    hook_args_from_info(&args, info);
+  hook_dispatch(type, &args);
+  hook_args_clear(&args);
 }
 
 const char *hookBuildInfo(const char *format, ...) {
@@ -98,7 +257,8 @@ const char *hookBuildInfo(const char *format, ...) {
 
   // parse out all of our tokens
   LIST *tokens           = parse_strings(format, ' ');
-  LIST_ITERATOR *token_i = newListIterator(tokens);
+  LIST_ITERATOR token_i;
+  listIteratorStart(&token_i, tokens);
   char *token            = NULL;
   int   len              = listSize(tokens);
   int   count            = 0;
@@ -106,7 +266,7 @@ const char *hookBuildInfo(const char *format, ...) {
   // go through all of our tokens
   va_list vargs;
   va_start(vargs, format);
-  ITERATE_LIST(token, token_i) {
+  ITERATE_LIST(token, &token_i) {
     if(!strcasecmp(token, "ch"))
       bprintf(info_buf, "ch.%d", charGetUID(va_arg(vargs, CHAR_DATA *)));
     else if(!strcasecmp(token, "obj"))
@@ -131,7 +291,7 @@ const char *hookBuildInfo(const char *format, ...) {
     if(count < len - 1)
       bprintf(info_buf, " ");
     count++;
-  } deleteListIterator(token_i);
+  } listIteratorStop(&token_i);
   deleteListWith(tokens, free);
   va_end(vargs);
   return bufferString(info_buf);
@@ -178,7 +338,8 @@ LIST *parse_hook_info_tokens(const char *info) {
 void hookParseInfo(const char *info, ...) {
   // parse out all of our tokens
   LIST *tokens           = parse_hook_info_tokens(info);
-  LIST_ITERATOR *token_i = newListIterator(tokens);
+  LIST_ITERATOR token_i;
+  listIteratorStart(&token_i, tokens);
   char *token            = NULL;
 
   // id number we'll need for parsing some values
@@ -187,38 +348,38 @@ void hookParseInfo(const char *info, ...) {
   // go through all of our tokens
   va_list vargs;
   va_start(vargs, info);
-  ITERATE_LIST(token, token_i) {
+  ITERATE_LIST(token, &token_i) {
     if(startswith(token, "ch")) {
       sscanf(token, "ch.%d", &id);
-      *va_arg(vargs, CHAR_DATA **) = propertyTableGet(mob_table, id);
+      *va_arg(vargs, CHAR_DATA **) = uidTableGet(mob_table, id);
     }
     else if(startswith(token, "obj")) {
       sscanf(token, "obj.%d", &id);
-      *va_arg(vargs, OBJ_DATA **) = propertyTableGet(obj_table, id);
+      *va_arg(vargs, OBJ_DATA **) = uidTableGet(obj_table, id);
     }
     else if(startswith(token, "rm")) {
       sscanf(token, "rm.%d", &id);
-      *va_arg(vargs, ROOM_DATA **) = propertyTableGet(room_table, id);
+      *va_arg(vargs, ROOM_DATA **) = uidTableGet(room_table, id);
     }
     else if(startswith(token, "room")) {
       sscanf(token, "room.%d", &id);
-      *va_arg(vargs, ROOM_DATA **) = propertyTableGet(room_table, id);
+      *va_arg(vargs, ROOM_DATA **) = uidTableGet(room_table, id);
     }
     else if(startswith(token, "ex")) {
       sscanf(token, "ex.%d", &id);
-      *va_arg(vargs, EXIT_DATA **) = propertyTableGet(exit_table, id);
+      *va_arg(vargs, EXIT_DATA **) = uidTableGet(exit_table, id);
     }
     else if(startswith(token, "exit")) {
       sscanf(token, "exit.%d", &id);
-      *va_arg(vargs, EXIT_DATA **) = propertyTableGet(exit_table, id);
+      *va_arg(vargs, EXIT_DATA **) = uidTableGet(exit_table, id);
     }
     else if(startswith(token, "sk")) {
       sscanf(token, "sk.%d", &id);
-      *va_arg(vargs, SOCKET_DATA **) = propertyTableGet(sock_table, id);
+      *va_arg(vargs, SOCKET_DATA **) = uidTableGet(sock_table, id);
     }
     else if(startswith(token, "sock")) {
       sscanf(token, "sk.%d", &id);
-      *va_arg(vargs, SOCKET_DATA **) = propertyTableGet(sock_table, id);
+      *va_arg(vargs, SOCKET_DATA **) = uidTableGet(sock_table, id);
     }
     else if(*token == HOOK_STR_MARKER) {
       char *str = strdup(token + 1);
@@ -232,7 +393,130 @@ void hookParseInfo(const char *info, ...) {
       else
 	*va_arg(vargs, int *) = atoi(token);
     }
-  } deleteListIterator(token_i);
+  } listIteratorStop(&token_i);
   deleteListWith(tokens, free);
   va_end(vargs);
 }
+
+
+
+//*****************************************************************************
+// implementation of typed hooks
+//*****************************************************************************
+void hookAddTyped(const char *type, void (* func)(HOOK_ARGS *args)) {
+  LIST *list = hashGet(typed_hook_table, type);
+  if(list == NULL) {
+    list = newList();
+    hashPut(typed_hook_table, type, list);
+  }
+  listQueue(list, func);
+}
+
+void hookRemoveTyped(const char *type, void (* func)(HOOK_ARGS *args)) {
+  LIST *list = hashGet(typed_hook_table, type);
+  if(list != NULL) listRemove(list, func);
+}
+
+void hookAddTypedMonitor(void (* func)(const char *type, HOOK_ARGS *args)) {
+  listQueue(typed_monitors, func);
+}
+
+void hookRunTyped(const char *type, const char *format, ...) {
+  HOOK_ARGS args;
+  hook_args_init(&args);
+
+  // go through each token in our format, and pull out its argument
+  va_list vargs;
+  va_start(vargs, format);
+  while(*format && args.num < HOOK_MAX_ARGS) {
+    const char *token = format;
+    int len = 0, arg_type;
+    while(isspace(*token))
+      token++;
+    for(len = 0; token[len] && !isspace(token[len]); len++)
+      ;
+    if(len == 0)
+      break;
+    format = token + len;
+
+    // unknown type -- abort!
+    if((arg_type = hook_arg_type(token, len)) < 0)
+      break;
+
+    HOOK_ARG *arg = &args.arg[args.num++];
+    arg->type = arg_type;
+    if(arg_type == HOOK_ARG_STR)
+      arg->val.str = va_arg(vargs, const char *);
+    else if(arg_type == HOOK_ARG_INT)
+      arg->val.num = va_arg(vargs, int);
+    else if(arg_type == HOOK_ARG_DBL)
+      arg->val.dbl = va_arg(vargs, double);
+    else
+      arg->val.ptr = va_arg(vargs, void *);
+  }
+  va_end(vargs);
+
+  hook_dispatch(type, &args);
+  hook_args_clear(&args);
+}
+
+void hookArgsParse(HOOK_ARGS *args, ...) {
+  va_list vargs;
+  int i;
+  va_start(vargs, args);
+  for(i = 0; i < args->num; i++) {
+    HOOK_ARG *arg = &args->arg[i];
+    if(arg->type == HOOK_ARG_STR)
+      *va_arg(vargs, const char **) = arg->val.str;
+    else if(arg->type == HOOK_ARG_INT)
+      *va_arg(vargs, int *) = arg->val.num;
+    else if(arg->type == HOOK_ARG_DBL)
+      *va_arg(vargs, double *) = arg->val.dbl;
+    else
+      *va_arg(vargs, void **) = arg->val.ptr;
+  }
+  va_end(vargs);
+}
+
+const char *hookArgsInfo(HOOK_ARGS *args) {
+  int i;
+  if(args->info != NULL)
+    return args->info;
+
+  bufferClear(info_buf);
+  for(i = 0; i < args->num; i++) {
+    HOOK_ARG *arg = &args->arg[i];
+    void     *ptr = arg->val.ptr;
+    if(i > 0)
+      bprintf(info_buf, " ");
+    switch(arg->type) {
+    case HOOK_ARG_CH:
+      bprintf(info_buf, "ch.%d",  (ptr ? charGetUID(ptr)   : NOTHING));
+      break;
+    case HOOK_ARG_OBJ:
+      bprintf(info_buf, "obj.%d", (ptr ? objGetUID(ptr)    : NOTHING));
+      break;
+    case HOOK_ARG_ROOM:
+      bprintf(info_buf, "rm.%d",  (ptr ? roomGetUID(ptr)   : NOTHING));
+      break;
+    case HOOK_ARG_EXIT:
+      bprintf(info_buf, "ex.%d",  (ptr ? exitGetUID(ptr)   : NOTHING));
+      break;
+    case HOOK_ARG_SOCK:
+      bprintf(info_buf, "sk.%d",  (ptr ? socketGetUID(ptr) : NOTHING));
+      break;
+    case HOOK_ARG_STR:
+      bprintf(info_buf, "%c%s%c", HOOK_STR_MARKER, arg->val.str,
+	      HOOK_STR_MARKER);
+      break;
+    case HOOK_ARG_INT:
+      bprintf(info_buf, "%d", arg->val.num);
+      break;
+    case HOOK_ARG_DBL:
+      bprintf(info_buf, "%lf", arg->val.dbl);
+      break;
+    }
+  }
+  args->info = strdup(bufferString(info_buf));
+  return args->info;
+}
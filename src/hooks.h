@@ -18,6 +18,13 @@
 // make it easy to handle these cases. These 3 arguments do not need to be used
 // for all hooks, however.
 //
+// Hooks come in two flavours. The original ones pass their arguments around as
+// an info string (e.g., "ch.12 rm.40") that listeners have to parse apart and
+// look back up. Typed hooks pass the arguments themselves, in a HOOK_ARGS, and
+// nothing is written out or parsed unless a listener asks for the string form.
+// Either kind of listener hears about hooks run either way; hookRun and
+// hookParseInfo are kept for code that still works with info strings.
+//
 //*****************************************************************************
 
 //
@@ -39,4 +46,71 @@ void hookParseInfo(const char *info, ...);
 const char *hookBuildInfo(const char *format, ...);
 LIST *parse_hook_info_tokens(const char *info);
 
+
+
+//*****************************************************************************
+// typed hooks
+//*****************************************************************************
+
+// the most arguments a hook can be run with
+#define HOOK_MAX_ARGS           8
+
+// the types of arguments hooks can take
+#define HOOK_ARG_CH             0
+#define HOOK_ARG_OBJ            1
+#define HOOK_ARG_ROOM           2
+#define HOOK_ARG_EXIT           3
+#define HOOK_ARG_SOCK           4
+#define HOOK_ARG_STR            5
+#define HOOK_ARG_INT            6
+#define HOOK_ARG_DBL            7
+
+typedef struct hook_arg {
+  int              type; // one of the HOOK_ARG_ types
+  union {
+    void           *ptr; // characters, objects, rooms, exits, and sockets
+    const char     *str;
+    int             num;
+    double          dbl;
+  } val;
+} HOOK_ARG;
+
+//
+// the arguments a hook was run with. Listeners may read num and arg, but
+// should leave the rest alone. Everything in here, strings included, is only
+// good until the listener returns
+typedef struct hook_args {
+  int               num; // how many arguments there are
+  HOOK_ARG          arg[HOOK_MAX_ARGS];
+  char            *info; // the info string form, once someone has asked for it
+  char        *scratch; // storage for strings parsed out of an info string
+} HOOK_ARGS;
+
+//
+// run a hook, with arguments described by a format like hookBuildInfo's:
+// a space-separated list of ch, obj, rm, ex, sk, str, int, or dbl. e.g.,
+//   hookRunTyped("char_to_room", "ch rm", ch, room);
+void hookRunTyped(const char *type, const char *format, ...);
+
+//
+// add or remove a listener for a hook that takes its arguments directly
+void hookAddTyped(const char *type, void (* func)(HOOK_ARGS *args));
+void hookRemoveTyped(const char *type, void (* func)(HOOK_ARGS *args));
+
+//
+// add a function that is called with the type and arguments of every hook
+// that is run. Used to pass hooks on to whatever else wants to listen for
+// them (e.g., Python)
+void hookAddTypedMonitor(void (* func)(const char *type, HOOK_ARGS *args));
+
+//
+// pull a hook's arguments out into the supplied pointers, like hookParseInfo.
+// Unlike hookParseInfo, strings are not copied and must not be freed
+void hookArgsParse(HOOK_ARGS *args, ...);
+
+//
+// returns the info string form of a hook's arguments, for listeners that
+// need it. It is only written out the first time it is asked for
+const char *hookArgsInfo(HOOK_ARGS *args);
+
 #endif // HOOKS_H
@@ -64,12 +64,13 @@ void list_one_furniture(CHAR_DATA *ch, OBJ_DATA *furniture) {
 //
 void list_used_furniture(CHAR_DATA *ch, LIST *furniture) {
   OBJ_DATA *obj;
-  LIST_ITERATOR *obj_i = newListIterator(furniture);
+  LIST_ITERATOR obj_i;
+  listIteratorStart(&obj_i, furniture);
 
-  ITERATE_LIST(obj, obj_i)
+  ITERATE_LIST(obj, &obj_i)
     // hmmm... how should we handle invisible furniture?
     list_one_furniture(ch, obj);
-  deleteListIterator(obj_i);
+  listIteratorStop(&obj_i);
 }
 
 
@@ -80,10 +81,11 @@ void list_used_furniture(CHAR_DATA *ch, LIST *furniture) {
 LIST *get_nofurniture_chars(CHAR_DATA *ch, LIST *list, 
 			    bool invis_ok, bool include_self) {
   LIST *newlist = newList();
-  LIST_ITERATOR *char_i = newListIterator(list);
+  LIST_ITERATOR char_i;
+  listIteratorStart(&char_i, list);
   CHAR_DATA *i = NULL;
 
-  ITERATE_LIST(i, char_i) {
+  ITERATE_LIST(i, &char_i) {
     // don't show ourself
     if(i == ch && !include_self) continue;
     // check for invis and hidden ...
@@ -94,7 +96,7 @@ LIST *get_nofurniture_chars(CHAR_DATA *ch, LIST *list,
       continue;
     listPut(newlist, i);
   };
-  deleteListIterator(char_i);
+  listIteratorStop(&char_i);
   return newlist;
 }
 
@@ -134,10 +136,10 @@ void look_at_obj(CHAR_DATA *ch, OBJ_DATA *obj) {
   bufferCat(charGetLookBuffer(ch), objGetDesc(obj));
 
   // do all of the preprocessing on the new descriptions
-  hookRun("preprocess_obj_desc", hookBuildInfo("obj ch", obj, ch));
+  hookRunTyped("preprocess_obj_desc", "obj ch", obj, ch);
 
   // append anything that might also go onto it
-  hookRun("append_obj_desc", hookBuildInfo("obj ch", obj, ch));
+  hookRunTyped("append_obj_desc", "obj ch", obj, ch);
 
   // colorize all of the edescs
   edescTagDesc(charGetLookBuffer(ch), objGetEdescs(obj), "{c", "{n");
@@ -150,7 +152,7 @@ void look_at_obj(CHAR_DATA *ch, OBJ_DATA *obj) {
   else
     send_to_char(ch, "{n%s", bufferString(charGetLookBuffer(ch)));
 
-  hookRun("look_at_obj", hookBuildInfo("obj ch", obj, ch));
+  hookRunTyped("look_at_obj", "obj ch", obj, ch);
   send_to_char(ch, "{n");
 }
 
@@ -161,10 +163,10 @@ void look_at_exit(CHAR_DATA *ch, EXIT_DATA *exit) {
   bufferCat(charGetLookBuffer(ch), exitGetDesc(exit));
 
   // do all of our preprocessing of the description before we show it
-  hookRun("preprocess_exit_desc", hookBuildInfo("ex ch", exit, ch));
+  hookRunTyped("preprocess_exit_desc", "ex ch", exit, ch);
 
   // append anything that might also go onto it
-  hookRun("append_exit_desc", hookBuildInfo("ex ch", exit, ch));
+  hookRunTyped("append_exit_desc", "ex ch", exit, ch);
 
   // colorize all of the edescs
   edescTagDesc(charGetLookBuffer(ch), roomGetEdescs(exitGetRoom(exit)), 
@@ -179,7 +181,7 @@ void look_at_exit(CHAR_DATA *ch, EXIT_DATA *exit) {
   else
     send_to_char(ch, "{n%s", bufferString(charGetLookBuffer(ch)));
 
-  hookRun("look_at_exit", hookBuildInfo("ex ch", exit, ch));
+  hookRunTyped("look_at_exit", "ex ch", exit, ch);
   send_to_char(ch, "{n");
 }
 
@@ -206,7 +208,8 @@ void list_room_exits(CHAR_DATA *ch, ROOM_DATA *room) {
   ROOM_DATA       *to = NULL;
   int               i = 0;
   LIST       *ex_list = roomGetExitNames(room);
-  LIST_ITERATOR *ex_i = newListIterator(ex_list);
+  LIST_ITERATOR ex_i;
+  listIteratorStart(&ex_i, ex_list);
   char           *dir = NULL;
 
   // first, we list all of the normal exit
@@ -222,7 +225,7 @@ void list_room_exits(CHAR_DATA *ch, ROOM_DATA *room) {
   }
 
   // next, we list all of the special exits
-  ITERATE_LIST(dir, ex_i) {
+  ITERATE_LIST(dir, &ex_i) {
     if(dirGetNum(dir) == DIR_NONE) {
       exit = roomGetExit(room, dir);
       // make sure the destination exists
@@ -232,7 +235,7 @@ void list_room_exits(CHAR_DATA *ch, ROOM_DATA *room) {
       else if(can_see_exit(ch, exit))
 	list_one_exit(ch, exit, dir);
     }
-  } deleteListIterator(ex_i);
+  } listIteratorStop(&ex_i);
   deleteListWith(ex_list, free);
 }
 
@@ -242,10 +245,10 @@ void look_at_char(CHAR_DATA *ch, CHAR_DATA *vict) {
   bufferCat(charGetLookBuffer(ch), charGetDesc(vict));
 
   // preprocess our desc before it it sent to the person
-  hookRun("preprocess_char_desc", hookBuildInfo("ch ch", vict, ch));
+  hookRunTyped("preprocess_char_desc", "ch ch", vict, ch);
 
   // append anything that might also go onto it
-  hookRun("append_char_desc", hookBuildInfo("ch ch", vict, ch));
+  hookRunTyped("append_char_desc", "ch ch", vict, ch);
 
   // format and send it
   bufferFormat(charGetLookBuffer(ch), SCREEN_WIDTH, PARA_INDENT);
@@ -255,7 +258,7 @@ void look_at_char(CHAR_DATA *ch, CHAR_DATA *vict) {
   else
     send_to_char(ch, "{n%s{n", bufferString(charGetLookBuffer(ch)));
 
-  hookRun("look_at_char", hookBuildInfo("ch ch", vict, ch));
+  hookRunTyped("look_at_char", "ch ch", vict, ch);
 }
 
 
@@ -271,10 +274,10 @@ void look_at_room(CHAR_DATA *ch, ROOM_DATA *room) {
   bufferCat(charGetLookBuffer(ch), roomGetDesc(room));
 
   // do all of our preprocessing of the description before we show it
-  hookRun("preprocess_room_desc", hookBuildInfo("rm ch", room, ch));
+  hookRunTyped("preprocess_room_desc", "rm ch", room, ch);
 
   // append anything that might also go onto it
-  hookRun("append_room_desc", hookBuildInfo("rm ch", room, ch));
+  hookRunTyped("append_room_desc", "rm ch", room, ch);
 
   // colorize all of the edescs
   edescTagDesc(charGetLookBuffer(ch), roomGetEdescs(room), "{c", "{n");
@@ -283,14 +286,14 @@ void look_at_room(CHAR_DATA *ch, ROOM_DATA *room) {
   bufferFormat(charGetLookBuffer(ch), SCREEN_WIDTH, PARA_INDENT);
 
   // do any post-processing we might have
-  hookRun("postprocess_room_desc", hookBuildInfo("rm ch", room, ch));
+  hookRunTyped("postprocess_room_desc", "rm ch", room, ch);
 
   if(bufferLength(charGetLookBuffer(ch)) == 0)
     send_to_char(ch, "{n%s\r\n", NOTHING_SPECIAL);
   else
     send_to_char(ch, "{n%s", bufferString(charGetLookBuffer(ch)));
 
-  hookRun("look_at_room", hookBuildInfo("rm ch", room, ch));
+  hookRunTyped("look_at_room", "rm ch", room, ch);
   send_to_char(ch, "{n");
 }
 
@@ -312,14 +315,15 @@ void send_outdoors(const char *format, ...) {
     va_end(args);
 
     // send it out to everyone
-    LIST_ITERATOR *list_i = newListIterator(mobile_list);
+    LIST_ITERATOR list_i;
+    listIteratorStart(&list_i, mobile_list);
     CHAR_DATA *ch = NULL;
-    ITERATE_LIST(ch, list_i)
+    ITERATE_LIST(ch, &list_i)
       if(charGetRoom(ch) != NULL &&
 	 roomGetTerrain(charGetRoom(ch)) != TERRAIN_INDOORS &&
 	 roomGetTerrain(charGetRoom(ch)) != TERRAIN_CAVERN)
 	text_to_char(ch, buf);
-    deleteListIterator(list_i);
+    listIteratorStop(&list_i);
   }
 }
 
@@ -347,7 +351,7 @@ void send_to_char(CHAR_DATA *ch, const char *format, ...) {
     vsnprintf(buf, MAX_BUFFER, format, args);
     va_end(args);
     text_to_char(ch, buf);
-    hookRun("char_receive_text", hookBuildInfo("ch str", ch, buf));
+    hookRunTyped("char_receive_text", "ch str", ch, buf);
     return;
   }
 }
@@ -360,17 +364,18 @@ void send_around_char(CHAR_DATA *ch, bool hide_nosee, const char *format, ...) {
   vsnprintf(buf, MAX_BUFFER, format, args);
   va_end(args);
 
-  LIST_ITERATOR *room_i = newListIterator(roomGetCharacters(charGetRoom(ch)));
+  LIST_ITERATOR room_i;
+  listIteratorStart(&room_i, roomGetCharacters(charGetRoom(ch)));
   CHAR_DATA       *vict = NULL;
 
-  ITERATE_LIST(vict, room_i) {
+  ITERATE_LIST(vict, &room_i) {
     if(ch == vict)
       continue;
     if(hide_nosee && !can_see_char(vict, ch))
       continue;
     text_to_char(vict, buf);
   }
-  deleteListIterator(room_i);
+  listIteratorStop(&room_i);
   return;
 }
 
@@ -382,14 +387,15 @@ void send_to_groups(const char *groups, const char *format, ...) {
   vsnprintf(buf, MAX_BUFFER, format, args);
   va_end(args);
 
-  LIST_ITERATOR *ch_i = newListIterator(mobile_list);
+  LIST_ITERATOR ch_i;
+  listIteratorStart(&ch_i, mobile_list);
   CHAR_DATA       *ch = NULL;
 
-  ITERATE_LIST(ch, ch_i) {
+  ITERATE_LIST(ch, &ch_i) {
     if(!charGetSocket(ch) || !bitIsSet(charGetUserGroups(ch), groups))
       continue;
     text_to_char(ch, buf);
-  } deleteListIterator(ch_i);
+  } listIteratorStop(&ch_i);
 }
 
 
@@ -403,11 +409,12 @@ void send_to_list(LIST *list, const char *format, ...) {
     va_end(args);
 
     // send it out to everyone
-    LIST_ITERATOR *list_i = newListIterator(list);
+    LIST_ITERATOR list_i;
+    listIteratorStart(&list_i, list);
     CHAR_DATA *ch = NULL;
-    ITERATE_LIST(ch, list_i)
+    ITERATE_LIST(ch, &list_i)
       text_to_char(ch, buf);
-    deleteListIterator(list_i);
+    listIteratorStop(&list_i);
   }
 };
 
@@ -523,7 +530,8 @@ BUFFER *build_who(void) {
   CHAR_DATA *plr;
   SOCKET_DATA *dsock;
   BUFFER *buf = newBuffer(MAX_BUFFER);
-  LIST_ITERATOR *sock_i = newListIterator(socket_list);
+  LIST_ITERATOR sock_i;
+  listIteratorStart(&sock_i, socket_list);
   int socket_count = 0, playing_count = 0;
 
   bprintf(buf,
@@ -532,7 +540,7 @@ BUFFER *build_who(void) {
           );
 
   // build our list of people online
-  ITERATE_LIST(dsock, sock_i) {
+  ITERATE_LIST(dsock, &sock_i) {
     socket_count++;
     if ((plr = socketGetChar(dsock)) == NULL) continue;
     playing_count++;
@@ -544,7 +552,7 @@ BUFFER *build_who(void) {
                 "noone!")))),
             raceGetAbbrev(charGetRace(plr)),
             charGetName(plr), socketGetHostname(dsock));
-  } deleteListIterator(sock_i);
+  } listIteratorStop(&sock_i);
 
   // send out info about the number of sockets and players logged on
   bprintf(buf, "\r\n{g%d socket%s connected. %d playing.\r\n",
@@ -563,194 +571,6 @@ COMMAND(cmd_who) {
 
 
 
-//*****************************************************************************
-// below this line are all of the subfunctions related to the message() 
-// function
-//*****************************************************************************
-
-//
-// Send a message out
-//
-// Converts the following symbols:
-//  $n = ch name
-//  $N = vict name
-//  $m = him/her of char
-//  $M = him/her of vict
-//  $s = his/hers of char
-//  $S = his/hers of vict
-//  $e = he/she of char
-//  $E = he/she of vict
-//
-//  $o = obj name
-//  $O = vobj name
-//  $a = a/an of obj
-//  $A = a/an of vobj
-void send_message(CHAR_DATA *to, 
-		  const char *str,
-		  CHAR_DATA *ch, CHAR_DATA *vict,
-		  OBJ_DATA *obj, OBJ_DATA *vobj) {
-  static char buf[MAX_BUFFER];
-  int i, j;
-  *buf = '\0';
-
-  // if there's nothing to send the message to, don't go through all
-  // the work it takes to parse the string
-  if(charGetSocket(to) == NULL)
-    return;
-
-  for(i = 0, j = 0; str[i] != '\0'; i++) {
-    if(str[i] != '$') {
-      buf[j] = str[i];
-      j++;
-    }
-    else {
-      i++;
-
-      switch(str[i]) {
-      case 'n':
-	if(!ch) break;
-	sprintf(buf+j, see_char_as(to, ch));
-	while(buf[j] != '\0') j++;
-	break;
-      case 'N':
-	if(!vict) break;
-	sprintf(buf+j, see_char_as(to, vict));
-	while(buf[j] != '\0') j++;
-	break;
-      case 'm':
-	if(!ch) break;
-	sprintf(buf+j, (can_see_char(to, ch) ? HIMHER(ch) : SOMEONE));
-	while(buf[j] != '\0') j++;
-	break;
-      case 'M':
-	if(!vict) break;
-	sprintf(buf+j, (can_see_char(to, vict) ? HIMHER(vict) : SOMEONE));
-	while(buf[j] != '\0') j++;
-	break;
-      case 's':
-	if(!ch) break;
-	sprintf(buf+j, (can_see_char(to, ch) ? HISHER(ch) :SOMEONE"'s"));
-	while(buf[j] != '\0') j++;
-	break;
-      case 'S':
-	if(!vict) break;
-	sprintf(buf+j, (can_see_char(to, vict) ? HISHER(vict) :SOMEONE"'s"));
-	while(buf[j] != '\0') j++;
-	break;
-      case 'e':
-	if(!ch) break;
-	sprintf(buf+j, (can_see_char(to, ch) ? HESHE(ch) : SOMEONE));
-	while(buf[j] != '\0') j++;
-	break;
-      case 'E':
-	if(!vict) break;
-	sprintf(buf+j, (can_see_char(to, vict) ? HESHE(vict) : SOMEONE));
-	while(buf[j] != '\0') j++;
-	break;
-      case 'o':
-	if(!obj) break;
-	sprintf(buf+j, see_obj_as(to, obj));
-	while(buf[j] != '\0') j++;
-	break;
-      case 'O':
-	if(!vobj) break;
-	sprintf(buf+j, see_obj_as(to, vobj));
-	while(buf[j] != '\0') j++;
-	break;
-      case 'a':
-	if(!obj) break;
-	sprintf(buf+j, AN(see_obj_as(to, obj)));
-	while(buf[j] != '\0') j++;
-	break;
-      case 'A':
-	if(!vobj) break;
-	sprintf(buf+j, AN(see_obj_as(to, vobj)));
-	while(buf[j] != '\0') j++;
-	break;
-      case '$':
-	buf[j] = '$';
-	j++;
-	break;
-      default:
-	// do nothing
-	break;
-      }
-    }
-  }
-
-  //  buf[0] = toupper(buf[0]);
-  sprintf(buf+j, "{n\r\n");
-  text_to_char(to, buf);
-}
-
-
-void message(CHAR_DATA *ch,  CHAR_DATA *vict,
-	     OBJ_DATA  *obj, OBJ_DATA  *vobj,
-	     int hide_nosee, bitvector_t range, 
-	     const char *mssg) {
-  if(!mssg || !*mssg)
-    return;
-
-  // what's our scope?
-  if(IS_SET(range, TO_VICT) && vict &&
-     (!hide_nosee ||
-      // make sure the vict can the character, or the
-      // object if there is no character
-      ((!ch || can_see_char(vict, ch)) &&
-       (ch  || (!obj || can_see_obj(vict, obj))))))
-    send_message(vict, mssg, ch, vict, obj, vobj);
-
-  // characters can always see themselves. No need to do checks here
-  if(IS_SET(range, TO_CHAR) && ch)
-    send_message(ch, mssg, ch, vict, obj, vobj);
-
-  LIST *recipients = NULL;
-  // check if the scope of this message is everyone in the world
-  if(IS_SET(range, TO_WORLD))
-    recipients = mobile_list;
-  else if(IS_SET(range, TO_ROOM) && charGetRoom(ch) != NULL)
-    recipients = roomGetCharacters(charGetRoom(ch));
-
-  // if we have a list to send the message to, do it
-  if(recipients != NULL) {
-    LIST_ITERATOR *rec_i = newListIterator(recipients);
-    CHAR_DATA *rec = NULL;
-
-    // go through everyone in the list
-    ITERATE_LIST(rec, rec_i) {
-      // if we wanted to send to ch or vict, we would have already...
-      if(rec == vict || rec == ch)
-	continue;
-      // skip by people who are in the game but not in the world yet
-      if(charGetRoom(rec) == NULL)
-	continue;
-      if(rec == ch ||
-	 (!hide_nosee ||
-	  // make sure the vict can see the character, or the
-	  // object if there is no character
-	  ((!ch || can_see_char(rec, ch)) &&
-	   (ch  || (!obj || can_see_obj(rec, obj))))))
-      send_message(rec, mssg, ch, vict, obj, vobj);
-    } deleteListIterator(rec_i);
-  }
-}
-
-void mssgprintf(CHAR_DATA *ch, CHAR_DATA *vict, 
-		OBJ_DATA *obj, OBJ_DATA  *vobj,
-		int hide_nosee, bitvector_t range, const char *fmt, ...) {
-  if(fmt && *fmt) {
-    // form the message
-    static char buf[MAX_BUFFER];
-    va_list args;
-    va_start(args, fmt);
-    vsnprintf(buf, MAX_BUFFER, fmt, args);
-    va_end(args);
-    message(ch, vict, obj, vobj, hide_nosee, range, buf);
-  }
-}
-
-
-
 //*****************************************************************************
 // hooks
 //*****************************************************************************
@@ -819,27 +639,28 @@ void exit_append_room_hook(BUFFER *buf, ROOM_DATA *room, CHAR_DATA *ch) {
   deleteListWith(exnames, free);
 }
 
-void exit_append_hook(const char *info) {
+void exit_append_hook(HOOK_ARGS *args) {
   // before anything, figure out some basic information like our dir and dest
   EXIT_DATA     *exit = NULL;
   CHAR_DATA       *ch = NULL;
-  hookParseInfo(info, &exit, &ch);
+  hookArgsParse(args, &exit, &ch);
 
   BUFFER         *buf = charGetLookBuffer(ch);
   ROOM_DATA     *room = exitGetRoom(exit);
   ROOM_DATA     *dest = worldGetRoom(gameworld, exitGetToFull(exit));
   LIST       *exnames = roomGetExitNames(room);
-  LIST_ITERATOR *ex_i = newListIterator(exnames);
+  LIST_ITERATOR ex_i;
+  listIteratorStart(&ex_i, exnames);
   char            *ex = NULL;
   char           *dir = NULL;
 
   // figure out which direction we came from
-  ITERATE_LIST(ex, ex_i) {
+  ITERATE_LIST(ex, &ex_i) {
     if(roomGetExit(room, ex) == exit) {
       dir = strdup(ex);
       break;
     }
-  } deleteListIterator(ex_i);
+  } listIteratorStop(&ex_i);
   deleteListWith(exnames, free);
 
   // tell us where it would take us
@@ -863,10 +684,10 @@ void exit_append_hook(const char *info) {
   if(dir) free(dir);
 }
 
-void exit_look_hook(const char *info) {
+void exit_look_hook(HOOK_ARGS *args) {
   EXIT_DATA *exit = NULL;
   CHAR_DATA   *ch = NULL;
-  hookParseInfo(info, &exit, &ch);
+  hookArgsParse(args, &exit, &ch);
   // the door is not closed, list off the people we can see as well
   if(!exitIsClosed(exit)) {
     ROOM_DATA *room = worldGetRoom(gameworld, exitGetToFull(exit));
@@ -875,10 +696,10 @@ void exit_look_hook(const char *info) {
   }
 }
 
-void room_look_hook(const char *info) {
+void room_look_hook(HOOK_ARGS *args) {
   ROOM_DATA *room = NULL;
   CHAR_DATA   *ch = NULL;
-  hookParseInfo(info, &room, &ch);
+  hookArgsParse(args, &room, &ch);
   list_room_exits(ch, room);
   list_room_contents(ch, room);
 }
@@ -890,9 +711,9 @@ void room_look_hook(const char *info) {
 //*****************************************************************************
 void init_inform(void) {
   // attach hooks
-  hookAdd("append_exit_desc", exit_append_hook);
+  hookAddTyped("append_exit_desc", exit_append_hook);
   // enable if you want exits to append to the end of room descs
-  //  hookAdd("append_room_desc", exit_append_room_hook);
-  //  hookAdd("look_at_exit", exit_look_hook);
-  //  hookAdd("look_at_room", room_look_hook);
+  //  hookAddTyped("append_room_desc", exit_append_room_hook);
+  //  hookAddTyped("look_at_exit", exit_look_hook);
+  //  hookAddTyped("look_at_room", room_look_hook);
 }
@@ -40,6 +40,9 @@
 //*****************************************************************************
 NEAR_MAP *cmd_table = NULL;
 
+// the most command tables a command is looked for in (room, and game)
+#define MAX_CMD_TABLES          2
+
 void init_commands() {
   cmd_table = newNearMap();
 
@@ -54,6 +57,7 @@ void init_commands() {
   //add_cmd("groupcmds",  NULL, cmd_groupcmds,   "player", FALSE);
   add_cmd("look",       "l",  cmd_look,        "player", FALSE);
   add_cmd("more",       NULL, cmd_more,        "player", FALSE);
+  add_cmd("outqueue",   NULL, cmd_outqueue,    "admin",  FALSE);
   add_cmd_check("look",        chk_conscious);
   add_cmd("who",        NULL, cmd_who,  "player", FALSE);
 }
@@ -165,14 +169,37 @@ void show_commands(CHAR_DATA *ch, const char *user_groups) {
   deleteBuffer(buf);
 }
 
+//
+// return whether the character is in the command's user group. Checks have
+// no user group, and anyone can run them
+bool in_cmd_user_group(CHAR_DATA *ch, CMD_DATA *cmd) {
+  bitvector_t mask = cmdGetUserGroupMask(cmd);
+  if(*cmdGetUserGroup(cmd) == '\0')
+    return TRUE;
+  else if(mask != 0)
+    return (bitvectorGetMask(charGetUserGroups(ch)) & mask) != 0;
+  // a group that doesn't fit in a mask
+  else
+    return bitIsOneSet(charGetUserGroups(ch), cmdGetUserGroup(cmd));
+}
+
 //
 // return whether the command is usable by the character
 bool is_usable_cmd(CHAR_DATA *ch, CMD_DATA *cmd) {
   // this is a check, not a command
   if(*cmdGetUserGroup(cmd) == '\0')
     return FALSE;
-  return is_keyword(bitvectorGetBits(charGetUserGroups(ch)),
-		    cmdGetUserGroup(cmd), FALSE);
+  return in_cmd_user_group(ch, cmd);
+}
+
+//
+// is_usable_cmd and in_cmd_user_group, in the form nearMapGetWith wants
+bool near_usable_cmd(void *cmd, void *ch) {
+  return is_usable_cmd(ch, cmd);
+}
+
+bool near_in_cmd_user_group(void *cmd, void *ch) {
+  return in_cmd_user_group(ch, cmd);
 }
 
 //
@@ -193,73 +220,16 @@ CMD_DATA *find_check(CHAR_DATA *ch, NEAR_MAP *table, const char *name) {
 // tries to find the relevant command, usable by the character
 CMD_DATA *find_cmd(CHAR_DATA *ch, NEAR_MAP *table, const char *name, 
 		   bool abbrev_ok) {
-  if(abbrev_ok == FALSE) {
-    CMD_DATA *cmd = nearMapGet(table, name, FALSE);
-    // no command exists
-    if(cmd == NULL || !is_usable_cmd(ch, cmd))
-      return NULL;
-    return cmd;
-  }
-  else {
-    // try to look up the possible commands
-    LIST *cmdname_list = nearMapGetAllMatches(table, name);
-    CMD_DATA  *cmd = NULL;
-    if(cmdname_list != NULL) {
-      LIST_ITERATOR *cmdname_i = newListIterator(cmdname_list);
-      const char      *cmdname = NULL;
-      ITERATE_LIST(cmdname, cmdname_i) {
-	cmd = nearMapGet(table, cmdname, FALSE);
-	if(is_usable_cmd(ch, cmd))
-	  break;
-	else
-	  cmd = NULL;
-      } deleteListIterator(cmdname_i);
-      deleteListWith(cmdname_list, free);
-    }
-    return cmd;
-  }
+  return nearMapGetWith(table, name, abbrev_ok, near_usable_cmd, ch);
 }
 
 // tries to pull a usable command from the near-table and use it. Returns
 // TRUE if a usable command was found (even if it failed) and false otherwise.
 bool try_use_cmd_table(CHAR_DATA *ch, NEAR_MAP *table, const char *command, 
 		       char *arg, bool abbrev_ok) {
-  if(abbrev_ok == FALSE) {
-    CMD_DATA *cmd = nearMapGet(table, command, FALSE);
-    if(cmd == NULL)
-      return FALSE;
-    else if(!*cmdGetUserGroup(cmd) || 
-	    is_keyword(bitvectorGetBits(charGetUserGroups(ch)),
-		       cmdGetUserGroup(cmd), FALSE)) {
-      if(charTryCmd(ch, cmd, arg) == -1)
-	return FALSE;
-      return TRUE;
-    }
-    else
-      return FALSE;
-  }
-  else {
-    // try to look up the possible commands
-    LIST *cmdname_list = nearMapGetAllMatches(table, command);
-    bool           ret = FALSE;
-    if(cmdname_list != NULL) {
-      LIST_ITERATOR *cmdname_i = newListIterator(cmdname_list);
-      CMD_DATA            *cmd = NULL;
-      const char      *cmdname = NULL;
-      ITERATE_LIST(cmdname, cmdname_i) {
-	cmd = nearMapGet(table, cmdname, FALSE);
-	if(!*cmdGetUserGroup(cmd) ||
-	   is_keyword(bitvectorGetBits(charGetUserGroups(ch)), 
-		      cmdGetUserGroup(cmd), FALSE)) {
-	  if(charTryCmd(ch, cmd, arg) != -1)
-	    ret = TRUE;
-	  break;
-	}
-      } deleteListIterator(cmdname_i);
-      deleteListWith(cmdname_list, free);
-    }
-    return ret;
-  }
+  CMD_DATA *cmd = nearMapGetWith(table, command, abbrev_ok, 
+				 near_in_cmd_user_group, ch);
+  return (cmd != NULL && charTryCmd(ch, cmd, arg) != -1);
 }
 
 void handle_cmd_input(SOCKET_DATA *dsock, char *arg) {
@@ -302,13 +272,14 @@ void do_cmd(CHAR_DATA *ch, char *arg, bool aliases_ok)  {
 #endif
 
   // figure out what tables we need to look over
-  LIST *cmd_tables = newList();
+  NEAR_MAP *cmd_tables[MAX_CMD_TABLES];
+  int   num_tables = 0;
   // item-specific commands here? <---
   // character-specific commands here? <---
   if(charGetRoom(ch) && roomHasCmds(charGetRoom(ch)))
-    listQueue(cmd_tables, roomGetCmdTable(charGetRoom(ch)));
+    cmd_tables[num_tables++] = roomGetCmdTable(charGetRoom(ch));
   // zone-specific commands here? <---
-  listQueue(cmd_tables, cmd_table);
+  cmd_tables[num_tables++] = cmd_table;
 
   // go through each table in the list, in order. Check if the command exists
   // in any of the tables. Only allow abbreviations in the last table (the
@@ -316,20 +287,20 @@ void do_cmd(CHAR_DATA *ch, char *arg, bool aliases_ok)  {
   // included on any of the previous tables
   int  i, j, ret;
   bool found = FALSE;
-  for(i = 0; i < listSize(cmd_tables); i++) {
-    NEAR_MAP *table = listGet(cmd_tables, i);
+  for(i = 0; i < num_tables; i++) {
+    NEAR_MAP *table = cmd_tables[i];
     CMD_DATA   *cmd = find_cmd(ch, table, command, 
-			       (i == listSize(cmd_tables)-1 ? TRUE : FALSE));
+			       (i == num_tables-1 ? TRUE : FALSE));
     if(cmd != NULL) {
       // first, run checks on all our previous tables
       for(j = 0; j < i; j++) {
-	CMD_DATA *check = find_check(ch,listGet(cmd_tables,j),cmdGetName(cmd));
+	CMD_DATA *check = find_check(ch, cmd_tables[j], cmdGetName(cmd));
 	if(check != NULL) {
 	  // run the check
 	  if((ret = charTryCmd(ch, check, arg)) != -1) {
 	    if(ret == TRUE)
-	      hookRun("command", hookBuildInfo("ch str str",
-					       ch,cmdGetName(cmd),arg));
+	      hookRunTyped("command", "ch str str",
+			   ch, cmdGetName(cmd), arg);
  	    found = TRUE;
 	    break;
 	  }
@@ -343,7 +314,7 @@ void do_cmd(CHAR_DATA *ch, char *arg, bool aliases_ok)  {
       // execute the command
       if((ret = charTryCmd(ch, cmd, arg)) != -1) {
 	if(ret == TRUE)
-	  hookRun("command",hookBuildInfo("ch str str",ch,cmdGetName(cmd),arg));
+	  hookRunTyped("command","ch str str",ch,cmdGetName(cmd),arg);
 	found = TRUE;
 	break;
       }
@@ -354,9 +325,6 @@ void do_cmd(CHAR_DATA *ch, char *arg, bool aliases_ok)  {
   if(found == FALSE)
     text_to_char(ch, "No such command.\r\n");
 
-  // garbage collection
-  deleteList(cmd_tables);
-
   /*
   // try the command
   if(!charGetRoom(ch) || 
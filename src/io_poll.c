@@ -0,0 +1,229 @@
+//*****************************************************************************
+//
+// io_poll.c
+//
+// The readiness backend for the game loop. See io_poll.h for documentation.
+// Watches are kept in a table indexed by descriptor, which grows as larger
+// descriptors are added. The epoll backend hands the kernel our descriptors
+// once and only hears back about the ones that have become ready. The
+// poll() backend keeps a dense array of pollfds alongside, and has to scan it
+// every time we wait; it's still not limited to FD_SETSIZE, though.
+// Descriptors are only watched for writability while someone has asked for
+// it, so ones with nothing to write never wake us up.
+//
+//*****************************************************************************
+
+#include <poll.h>
+#include <fcntl.h>
+#include "mud.h"
+#include "io_poll.h"
+
+#if defined(__linux__) && !defined(NO_EPOLL)
+#define IO_POLL_EPOLL
+#include <sys/epoll.h>
+#endif
+
+
+
+//*****************************************************************************
+// local datastructures, functions, and defines
+//*****************************************************************************
+
+// how many ready descriptors we will handle in one wait. Any more than this
+// are kept ready by the kernel, and handled next time we wait
+#define MAX_READY_EVENTS        256
+
+typedef struct io_watch_data {
+  void (* func)(int fd, void *data); // what do we call when fd is readable?
+  void (* write_func)(int fd, void *data); // and when it's writable, if we
+                                           // are watching for that
+  void   *data;                      // what do we pass them?
+  int     index;                     // our place in the pollfd array, or -1
+} IO_WATCH;
+
+IO_WATCH      *watches = NULL; // watches indexed by descriptor
+int         watches_cap = 0;   // how many descriptors watches can hold
+int         num_watched = 0;   // how many descriptors we are watching
+
+#ifdef IO_POLL_EPOLL
+int             poll_fd = -1;  // our epoll instance
+struct epoll_event ready_events[MAX_READY_EVENTS];
+#else
+struct pollfd    *pfds = NULL; // a dense array of what we're watching
+#endif
+
+
+//
+// make sure our watch table can hold the given descriptor
+void io_poll_grow(int fd) {
+  int i, new_cap = (watches_cap > 0 ? watches_cap : 64);
+  while(new_cap <= fd)
+    new_cap *= 2;
+  if(new_cap == watches_cap)
+    return;
+
+  watches = realloc(watches, sizeof(IO_WATCH) * new_cap);
+  for(i = watches_cap; i < new_cap; i++) {
+    watches[i].func       = NULL;
+    watches[i].write_func = NULL;
+    watches[i].data       = NULL;
+    watches[i].index      = -1;
+  }
+#ifndef IO_POLL_EPOLL
+  pfds = realloc(pfds, sizeof(struct pollfd) * new_cap);
+#endif
+  watches_cap = new_cap;
+}
+
+//
+// call the functions for a descriptor that has become ready. The watch may
+// have been removed by an earlier function in the same wait, so check first
+void io_poll_dispatch(int fd, bool readable, bool writable) {
+  if(readable && fd >= 0 && fd < watches_cap && watches[fd].func != NULL)
+    watches[fd].func(fd, watches[fd].data);
+  if(writable && fd >= 0 && fd < watches_cap && watches[fd].write_func!=NULL)
+    watches[fd].write_func(fd, watches[fd].data);
+}
+
+
+
+//*****************************************************************************
+// implementation of io_poll.h
+//*****************************************************************************
+void init_io_poll(void) {
+  io_poll_grow(0);
+#ifdef IO_POLL_EPOLL
+  // we don't want the instance surviving a copyover; sockets are re-added
+  if((poll_fd = epoll_create(MAX_READY_EVENTS)) < 0) {
+    perror("init_io_poll: epoll_create");
+    exit(1);
+  }
+  fcntl(poll_fd, F_SETFD, FD_CLOEXEC);
+#endif
+}
+
+bool ioPollAdd(int fd, void (* func)(int fd, void *data), void *data) {
+  if(fd < 0 || func == NULL)
+    return FALSE;
+  io_poll_grow(fd);
+
+  // are we just changing what an existing watch does?
+  if(watches[fd].func != NULL) {
+    watches[fd].func = func;
+    watches[fd].data = data;
+    return TRUE;
+  }
+
+#ifdef IO_POLL_EPOLL
+  struct epoll_event ev;
+  ev.events  = EPOLLIN | EPOLLET;
+  ev.data.fd = fd;
+  if(epoll_ctl(poll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+    bug("ioPollAdd: could not watch descriptor %d", fd);
+    return FALSE;
+  }
+#else
+  pfds[num_watched].fd      = fd;
+  pfds[num_watched].events  = POLLIN;
+  pfds[num_watched].revents = 0;
+  watches[fd].index         = num_watched;
+#endif
+
+  watches[fd].func = func;
+  watches[fd].data = data;
+  num_watched++;
+  return TRUE;
+}
+
+void ioPollRemove(int fd) {
+  if(fd < 0 || fd >= watches_cap || watches[fd].func == NULL)
+    return;
+
+#ifdef IO_POLL_EPOLL
+  struct epoll_event ev; // pre-2.6.9 kernels want a non-NULL event
+  epoll_ctl(poll_fd, EPOLL_CTL_DEL, fd, &ev);
+#else
+  // move the last pollfd into our slot to keep the array dense
+  int last = num_watched - 1, index = watches[fd].index;
+  if(index != last) {
+    pfds[index] = pfds[last];
+    watches[pfds[index].fd].index = index;
+  }
+#endif
+
+  watches[fd].func       = NULL;
+  watches[fd].write_func = NULL;
+  watches[fd].data       = NULL;
+  watches[fd].index      = -1;
+  num_watched--;
+}
+
+bool ioPollWatchWrite(int fd, void (* func)(int fd, void *data)) {
+  if(fd < 0 || fd >= watches_cap || watches[fd].func == NULL)
+    return FALSE;
+
+  // only bother the kernel if we're starting or stopping
+  if((watches[fd].write_func == NULL) != (func == NULL)) {
+#ifdef IO_POLL_EPOLL
+    struct epoll_event ev;
+    ev.events  = EPOLLIN | EPOLLET | (func != NULL ? EPOLLOUT : 0);
+    ev.data.fd = fd;
+    if(epoll_ctl(poll_fd, EPOLL_CTL_MOD, fd, &ev) < 0) {
+      bug("ioPollWatchWrite: could not watch descriptor %d", fd);
+      return FALSE;
+    }
+#else
+    pfds[watches[fd].index].events = POLLIN | (func != NULL ? POLLOUT : 0);
+#endif
+  }
+
+  watches[fd].write_func = func;
+  return TRUE;
+}
+
+int ioPollWait(int timeout) {
+  int i, num_ready;
+
+#ifdef IO_POLL_EPOLL
+  num_ready = epoll_wait(poll_fd, ready_events, MAX_READY_EVENTS, timeout);
+  if(num_ready < 0)
+    return (errno == EINTR ? 0 : -1);
+  for(i = 0; i < num_ready; i++) {
+    int events = ready_events[i].events;
+    io_poll_dispatch(ready_events[i].data.fd,
+		     (events & ~EPOLLOUT) != 0,
+		     (events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) != 0);
+  }
+#else
+  int found = 0, to_check = num_watched;
+  num_ready = poll(pfds, num_watched, timeout);
+  if(num_ready < 0)
+    return (errno == EINTR ? 0 : -1);
+
+  // functions may add or remove watches as we go, which shuffles the array
+  // around. Go from the back so a removal only moves things we've checked
+  for(i = to_check - 1; i >= 0 && found < num_ready; i--) {
+    if(i >= num_watched || pfds[i].revents == 0)
+      continue;
+    int events = pfds[i].revents;
+    pfds[i].revents = 0;
+    found++;
+    io_poll_dispatch(pfds[i].fd, (events & ~POLLOUT) != 0,
+		     (events & (POLLOUT | POLLERR | POLLHUP)) != 0);
+  }
+#endif
+
+  return num_ready;
+}
+
+int ioPollCount(void) {
+  return num_watched;
+}
+
+const char *ioPollBackend(void) {
+#ifdef IO_POLL_EPOLL
+  return "epoll";
+#else
+  return "poll";
+#endif
+}
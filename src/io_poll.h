@@ -0,0 +1,63 @@
+#ifndef IO_POLL_H
+#define IO_POLL_H
+//*****************************************************************************
+//
+// io_poll.h
+//
+// The readiness backend for the game loop. Descriptors (the control socket,
+// player sockets, the webserver's sockets) are registered along with a
+// function to call and some data to pass it. Once per pulse, the game loop
+// asks the backend which descriptors have become readable, and only those have
+// their functions called. An idle descriptor costs us nothing per pulse, and
+// we are not limited to FD_SETSIZE descriptors like select() is.
+//
+// On Linux, this is built on top of edge-triggered epoll. Everywhere else (or
+// if NO_EPOLL is defined at compile time) it falls back on poll(). Because
+// epoll is run edge-triggered, a descriptor's function is only called when
+// new data arrives. Functions must either read until they get EAGAIN, or keep
+// track of the fact that there is still unread data themselves.
+//
+// A descriptor can also be watched for writability, while it has output that
+// could not be written. Write watches work the same way: the function is
+// called when the descriptor has room for more, and it must write until it
+// fills up again or runs out of things to write.
+//
+//*****************************************************************************
+
+//
+// prepare the backend for use. Must be called before anything is added
+void init_io_poll(void);
+
+//
+// start watching a descriptor for readability. When it becomes readable,
+// func is called with the descriptor and the data supplied here. Returns
+// FALSE if the descriptor could not be watched.
+bool ioPollAdd(int fd, void (* func)(int fd, void *data), void *data);
+
+//
+// stop watching a descriptor. Should be done before it is closed
+void ioPollRemove(int fd);
+
+//
+// start (or, if func is NULL, stop) watching a descriptor that is already
+// being watched for readability, for when it becomes writable. func is called
+// with the same data that was supplied to ioPollAdd. Returns FALSE if the
+// descriptor could not be watched.
+bool ioPollWatchWrite(int fd, void (* func)(int fd, void *data));
+
+//
+// wait up to timeout milliseconds (0 = don't wait at all) for something to
+// become readable or writable, and then call the functions for all
+// descriptors that did.
+// Returns how many descriptors were ready, or -1 on an error
+int ioPollWait(int timeout);
+
+//
+// how many descriptors are we watching?
+int ioPollCount(void);
+
+//
+// returns the name of the backend in use ("epoll" or "poll")
+const char *ioPollBackend(void);
+
+#endif // IO_POLL_H
@@ -473,10 +473,10 @@ void container_to_proto(CONTAINER_DATA *data, BUFFER *buf) {
 //*****************************************************************************
 // hooks
 //*****************************************************************************
-void container_append_hook(const char *info) {
+void container_append_hook(HOOK_ARGS *args) {
   OBJ_DATA *obj = NULL;
   CHAR_DATA *ch = NULL;
-  hookParseInfo(info, &obj, &ch);
+  hookArgsParse(args, &obj, &ch);
 
   if(objIsType(obj, "container")) {
     bprintf(charGetLookBuffer(ch), " It is %s%s.", 
@@ -485,10 +485,10 @@ void container_append_hook(const char *info) {
   }
 }
 
-void container_look_hook(const char *info) {
+void container_look_hook(HOOK_ARGS *args) {
   OBJ_DATA *obj = NULL;
   CHAR_DATA *ch = NULL;
-  hookParseInfo(info, &obj, &ch);
+  hookArgsParse(args, &obj, &ch);
 
   if(objIsType(obj, "container") && !containerIsClosed(obj)) {
     LIST *vis_contents = find_all_objs(ch, objGetContents(obj), "", 
@@ -517,8 +517,8 @@ void init_container(void) {
   		containerDataStore, containerDataRead);
 
   // add our hooks
-  hookAdd("append_obj_desc", container_append_hook);
-  hookAdd("look_at_obj",     container_look_hook);
+  hookAddTyped("append_obj_desc", container_append_hook);
+  hookAddTyped("look_at_obj",     container_look_hook);
 
   // set up the container OLC too
   item_add_olc("container", iedit_container_menu, iedit_container_chooser, 
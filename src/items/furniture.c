@@ -257,10 +257,10 @@ int PyObj_setfurntype(PyObject *self, PyObject *value, void *closure) {
 //*****************************************************************************
 // hooks
 //*****************************************************************************
-void furniture_append_hook(const char *info) {
+void furniture_append_hook(HOOK_ARGS *args) {
   OBJ_DATA *obj = NULL;
   CHAR_DATA *ch = NULL;
-  hookParseInfo(info, &obj, &ch);
+  hookArgsParse(args, &obj, &ch);
 
   if(objIsType(obj, "furniture")) {
     int num_sitters = listSize(objGetUsers(obj));
@@ -304,7 +304,7 @@ void init_furniture(void) {
   		furnitureDataStore, furnitureDataRead);
 
   // add our hooks
-  hookAdd("append_obj_desc", furniture_append_hook);
+  hookAddTyped("append_obj_desc", furniture_append_hook);
 
   // set up the furniture OLC too
   item_add_olc("furniture", iedit_furniture_menu, iedit_furniture_chooser, 
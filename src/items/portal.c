@@ -173,8 +173,8 @@ COMMAND(cmd_enter) {
       else
 	message(ch, NULL, obj, NULL, TRUE, TO_ROOM,
 		"$n arrives after travelling through $o.");
-      hookRun("enter_portal", hookBuildInfo("ch obj", ch, obj));
-      hookRun("enter", hookBuildInfo("ch rm", ch, dest));
+      hookRunTyped("enter_portal", "ch obj", ch, obj);
+      hookRunTyped("enter", "ch rm", ch, dest);
     }
   }
 }
@@ -361,10 +361,10 @@ int PyObj_setportalentermssg(PyObject *self, PyObject *value, void *closure) {
 //*****************************************************************************
 // add our hookds
 //*****************************************************************************
-void portal_look_hook(const char *info) {
+void portal_look_hook(HOOK_ARGS *args) {
   OBJ_DATA *obj = NULL;
   CHAR_DATA *ch = NULL;
-  hookParseInfo(info, &obj, &ch);
+  hookArgsParse(args, &obj, &ch);
 
   if(objIsType(obj, "portal")) {
     ROOM_DATA *dest = worldGetRoom(gameworld, portalGetSmartDest(obj));
@@ -391,7 +391,7 @@ void init_portal(void) {
 		portalDataStore, portalDataRead);
 
   // set up our hooks
-  hookAdd("look_at_obj", portal_look_hook);
+  hookAddTyped("look_at_obj", portal_look_hook);
 
   // set up the portal OLC too
   item_add_olc("portal", iedit_portal_menu, iedit_portal_chooser, 
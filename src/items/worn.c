@@ -77,10 +77,10 @@ const char *wornTypeGetPositions(const char *type) {
 
 //
 // append information about where the item can be worn
-void append_worn_hook(const char *info) {
+void append_worn_hook(HOOK_ARGS *args) {
   OBJ_DATA *obj = NULL;
   CHAR_DATA *ch = NULL;
-  hookParseInfo(info, &obj, &ch);
+  hookArgsParse(args, &obj, &ch);
 
   if(objIsType(obj, "worn")) {
     bprintf(charGetLookBuffer(ch),"When worn, this item covers bodyparts: %s.",
@@ -326,7 +326,7 @@ void init_worn(void) {
 	       NULL, worn_to_proto);
 
   // attach our hooks to display worn info on look
-  hookAdd("append_obj_desc", append_worn_hook);
+  hookAddTyped("append_obj_desc", append_worn_hook);
 
   // add our new python get/setters
   PyObj_addGetSetter("worn_locs", PyObj_getwornlocs, NULL,
@@ -11,6 +11,14 @@
 // the list until the iterator count goes down to 0; until then, the items are
 // flagged as removed so they are not touched.
 //
+// Oct 16/26:
+//   Lists are everywhere, and every node used to be its own malloc. Nodes now
+// come out of a pool that is carved out of big slabs, and go back into it when
+// they are deleted. Iterators can also be started on the stack (see
+// listIteratorStart), so going over a list does not have to allocate anything
+// either. Deleting a list used to recurse once per node; it is now a loop.
+// Neither lists nor the node pool are thread-safe.
+//
 //*****************************************************************************
 
 #include <stdlib.h>
@@ -29,10 +37,8 @@ typedef struct list_node {
                            // char == bool
 } LIST_NODE;
 
-struct list_iterator {
-  struct list      *L;     // the list we're iterating over
-  LIST_NODE *curr;         // the current element we're iterating on
-};
+// how many nodes do we carve out of each slab we add to the pool?
+#define LIST_NODE_SLAB_SIZE    512
 
 struct list {
   LIST_NODE *head;         // first element in the list
@@ -43,30 +49,54 @@ struct list {
 };
 
 
+// nodes that are not in any list, waiting to be handed out again. They are
+// chained together through their next pointers
+LIST_NODE *free_nodes = NULL;
+
+//
+// carve a new slab of nodes up, and add them to the pool. Slabs are never
+// given back; the pool only grows as large as the most nodes ever in use
+void list_node_pool_grow(void) {
+  LIST_NODE *slab = malloc(sizeof(LIST_NODE) * LIST_NODE_SLAB_SIZE);
+  int i;
+  for(i = 0; i < LIST_NODE_SLAB_SIZE; i++) {
+    slab[i].next = free_nodes;
+    free_nodes   = &slab[i];
+  }
+}
+
 //
 // Delete a list node, and all nodes attached to it
 //
 void deleteListNode(LIST_NODE *N) {
-  if(N->next) deleteListNode(N->next);
-  free(N);
+  LIST_NODE *last = N;
+  // the whole chain goes back into the pool in one go
+  while(last->next != NULL)
+    last = last->next;
+  last->next = free_nodes;
+  free_nodes = N;
 };
 
 //
 // delete the list node, plus it's element using the supplied function
 //
 void deleteListNodeWith(LIST_NODE *N, void (*delete_func)(void *)) {
-  if(N->next) deleteListNodeWith(N->next, delete_func);
-  // we only want to delete elements that are actually in the list
-  if(!N->removed)
-    delete_func(N->elem);
-  free(N);
+  LIST_NODE *node = N;
+  for(; node != NULL; node = node->next)
+    // we only want to delete elements that are actually in the list
+    if(!node->removed)
+      delete_func(node->elem);
+  deleteListNode(N);
 }
 
 //
 // Create a new list node containing the given element
 //
 LIST_NODE *newListNode(void *elem) {
-  LIST_NODE *N = malloc(sizeof(LIST_NODE));
+  if(free_nodes == NULL)
+    list_node_pool_grow();
+  LIST_NODE *N = free_nodes;
+  free_nodes = N->next;
   N->elem    = elem;
   N->next    = NULL;
   N->removed = FALSE;
@@ -456,19 +486,27 @@ void listParse(LIST *L, int n, ...) {
 //*****************************************************************************
 LIST_ITERATOR *newListIterator(LIST *L) {
   LIST_ITERATOR *I = malloc(sizeof(LIST_ITERATOR));
-  I->L    = L;
-  I->curr = I->L->head;
-  L->iterators++;
+  listIteratorStart(I, L);
   return I;
 };
 
 void deleteListIterator(LIST_ITERATOR *I) {
+  listIteratorStop(I);
+  free(I);
+};
+
+void listIteratorStart(LIST_ITERATOR *I, LIST *L) {
+  I->L    = L;
+  I->curr = I->L->head;
+  L->iterators++;
+}
+
+void listIteratorStop(LIST_ITERATOR *I) {
   I->L->iterators--;
   // if we're at 0 iterators, clean the list of all removed elements
   if(I->L->iterators == 0)
     listCleanRemoved(I->L);
-  free(I);
-};
+}
 
 void *listIteratorNext(LIST_ITERATOR *I) {
   if(I->curr)
@@ -16,6 +16,16 @@
 typedef struct list                       LIST;
 typedef struct list_iterator              LIST_ITERATOR;
 
+//
+// iterators can be made with newListIterator, or declared on the stack and
+// started with listIteratorStart, which does not have to allocate anything.
+// The fields are private to list.c; they are only here so the compiler knows
+// how big an iterator is
+struct list_iterator {
+  LIST                *L; // the list we're iterating over
+  struct list_node *curr; // the current element we're iterating on
+};
+
 //
 // Create a new list
 //
@@ -175,6 +185,27 @@ LIST_ITERATOR *newListIterator(LIST *L);
 void deleteListIterator(LIST_ITERATOR *I);
 
 
+//
+// Start an iterator that lives somewhere else (usually the stack) going over
+// the list. Every started iterator must be stopped, like every new iterator
+// must be deleted; elements removed from the list while iterators are on it
+// are only cleaned out once they all have stopped. e.g.,
+//
+//   LIST_ITERATOR ch_i;
+//   listIteratorStart(&ch_i, list);
+//   ITERATE_LIST(ch, &ch_i) {
+//     ...
+//   } listIteratorStop(&ch_i);
+//
+void listIteratorStart(LIST_ITERATOR *I, LIST *L);
+
+
+//
+// Stop an iterator that was started with listIteratorStart
+//
+void listIteratorStop(LIST_ITERATOR *I);
+
+
 //
 // Point the list iterator back at the head of the list
 //
@@ -56,13 +56,14 @@ MAP_ENTRY *mapGetEntry(MAP *map, const void *key) {
   if(map->buckets[bucket] == NULL)
     return NULL;
   else {
-    LIST_ITERATOR *list_i = newListIterator(map->buckets[bucket]);
+    LIST_ITERATOR list_i;
+    listIteratorStart(&list_i, map->buckets[bucket]);
     MAP_ENTRY     *elem   = NULL;
 
-    ITERATE_LIST(elem, list_i) {
+    ITERATE_LIST(elem, &list_i) {
       if(!map->compares(key, elem->key))
 	break;
-    } deleteListIterator(list_i);
+    } listIteratorStop(&list_i);
 
     return elem;
   }
@@ -88,11 +89,12 @@ LIST *mapCollectEntries(MAP *map) {
   int i;
   for(i = 0; i < map->num_buckets; i++) {
     if(map->buckets[i] == NULL) continue;
-    LIST_ITERATOR *list_i = newListIterator(map->buckets[i]);
+    LIST_ITERATOR list_i;
+    listIteratorStart(&list_i, map->buckets[i]);
     MAP_ENTRY       *elem = NULL;
-    ITERATE_LIST(elem, list_i) {
+    ITERATE_LIST(elem, &list_i) {
       listPut(list, elem);
-    } deleteListIterator(list_i);
+    } listIteratorStop(&list_i);
   }
   return list;
 }
@@ -197,13 +199,14 @@ void *mapRemove(MAP *map, const void *key) {
   if(map->buckets[bucket] == NULL)
     return NULL;
   else {
-    LIST_ITERATOR *list_i = newListIterator(map->buckets[bucket]);
+    LIST_ITERATOR list_i;
+    listIteratorStart(&list_i, map->buckets[bucket]);
     MAP_ENTRY       *elem = NULL;
 
-    ITERATE_LIST(elem, list_i) {
+    ITERATE_LIST(elem, &list_i) {
       if(!map->compares(key, elem->key))
 	break;
-    } deleteListIterator(list_i);
+    } listIteratorStop(&list_i);
 
     if(elem == NULL)
       return NULL;
@@ -0,0 +1,351 @@
+//*****************************************************************************
+//
+// message.c
+//
+// message() and mssgprintf(), from inform.h. A message's format is compiled
+// into a template: the runs of plain text in it, and the $ codes between
+// them. Templates are kept in a small cache by format, so formats that are
+// sent over and over again (e.g. combat messages) are only compiled once.
+//
+// How a message reads to someone only depends on which of ch, vict, obj, and
+// vobj they can see. Each way of seeing them is rendered once per message,
+// and the rendering is appended to the output of everyone who sees things
+// that way. A message to a crowded room is usually rendered once or twice,
+// instead of once for every person in the room.
+//
+//*****************************************************************************
+
+#include "mud.h"
+#include "utils.h"
+#include "character.h"
+#include "object.h"
+#include "room.h"
+#include "inform.h"
+
+
+
+//*****************************************************************************
+// local datastructures, functions, and defines
+//*****************************************************************************
+
+// how many compiled formats we keep around. Must be a power of two
+#define MSSG_CACHE_SIZE      256
+
+// which of the things a message talks about the recipient can see
+#define MSSG_SEES_CH      (1 << 0)
+#define MSSG_SEES_VICT    (1 << 1)
+#define MSSG_SEES_OBJ     (1 << 2)
+#define MSSG_SEES_VOBJ    (1 << 3)
+#define MSSG_VIEWS        (1 << 4) // every mix of the above
+
+//
+// one piece of a template
+typedef struct {
+  char     code; // the $ code, or '\0' for a run of plain text
+  int     start; // where the text is in our template's format
+  int       len;
+} MSSG_TOKEN;
+
+typedef struct {
+  char       *format;
+  MSSG_TOKEN *tokens;
+  int     num_tokens;
+  int          about; // MSSG_SEES_xxx, for each thing the format mentions
+} MSSG_TEMPLATE;
+
+MSSG_TEMPLATE *mssg_cache[MSSG_CACHE_SIZE];
+
+// the ways the message being sent has been rendered so far, one per view
+BUFFER *mssg_views[MSSG_VIEWS];
+
+// how many messages are being sent right now. Seeing things can run Python,
+// which can send messages of its own. Those must not take the cache slot of
+// the message they're sent from, or render over its views, so they compile
+// their format and render their views privately if they have to
+int mssg_depth = 0;
+
+void mssg_add_token(MSSG_TEMPLATE *tmpl, char code, int start, int len) {
+  if(code == '\0' && len == 0)
+    return;
+  tmpl->tokens[tmpl->num_tokens].code  = code;
+  tmpl->tokens[tmpl->num_tokens].start = start;
+  tmpl->tokens[tmpl->num_tokens].len   = len;
+  tmpl->num_tokens++;
+}
+
+//
+// break a format down into its runs of text and $ codes
+MSSG_TEMPLATE *newMssgTemplate(const char *format) {
+  MSSG_TEMPLATE *tmpl = calloc(1, sizeof(MSSG_TEMPLATE));
+  int            flen = strlen(format), start = 0, i;
+  tmpl->format = strdup(format);
+  // each $ code ends at most one run of text
+  tmpl->tokens = malloc(sizeof(MSSG_TOKEN) * (flen + 1));
+
+  for(i = 0; format[i] != '\0'; i++) {
+    if(format[i] != '$')
+      continue;
+    mssg_add_token(tmpl, '\0', start, i - start);
+    start = i + 2;
+    switch(format[++i]) {
+    case 'n': case 'm': case 's': case 'e':
+      tmpl->about |= MSSG_SEES_CH;
+      break;
+    case 'N': case 'M': case 'S': case 'E':
+      tmpl->about |= MSSG_SEES_VICT;
+      break;
+    case 'o': case 'a':
+      tmpl->about |= MSSG_SEES_OBJ;
+      break;
+    case 'O': case 'A':
+      tmpl->about |= MSSG_SEES_VOBJ;
+      break;
+    // $$ is a $. It starts the next run of text
+    case '$':
+      start = i;
+      continue;
+    // a $ on the end of the format is dropped
+    case '\0':
+      start = i;
+      i--;
+      continue;
+    // as is any code we don't know
+    default:
+      continue;
+    }
+    mssg_add_token(tmpl, format[i], 0, 0);
+  }
+  mssg_add_token(tmpl, '\0', start, flen - start);
+  return tmpl;
+}
+
+void deleteMssgTemplate(MSSG_TEMPLATE *tmpl) {
+  free(tmpl->format);
+  free(tmpl->tokens);
+  free(tmpl);
+}
+
+//
+// return the template for a format, compiling it if it's not cached. Each
+// format only has one place it can go in the cache, and takes it over from
+// whatever was there before, unless a message is being sent with that
+// template right now. Then the new one is not cached, and *cached is set to
+// FALSE; the caller must delete it when done with it
+MSSG_TEMPLATE *get_mssg_template(const char *format, bool *cached) {
+  unsigned int h = 2166136261U;
+  const char *ch = format;
+  for(; *ch; ch++)
+    h = (h ^ (unsigned char)*ch) * 16777619U;
+  h &= MSSG_CACHE_SIZE - 1;
+
+  *cached = TRUE;
+  if(mssg_cache[h] != NULL && !strcmp(mssg_cache[h]->format, format))
+    return mssg_cache[h];
+  if(mssg_depth > 0) {
+    *cached = FALSE;
+    return newMssgTemplate(format);
+  }
+  if(mssg_cache[h] != NULL)
+    deleteMssgTemplate(mssg_cache[h]);
+  mssg_cache[h] = newMssgTemplate(format);
+  return mssg_cache[h];
+}
+
+//
+// work out which of the things we're asked about the character can see
+int mssg_view(CHAR_DATA *to, int about, CHAR_DATA *ch, CHAR_DATA *vict,
+	      OBJ_DATA *obj, OBJ_DATA *vobj) {
+  int view = 0;
+  if((about & MSSG_SEES_CH)   && ch   && can_see_char(to, ch))
+    view |= MSSG_SEES_CH;
+  if((about & MSSG_SEES_VICT) && vict && can_see_char(to, vict))
+    view |= MSSG_SEES_VICT;
+  if((about & MSSG_SEES_OBJ)  && obj  && can_see_obj(to, obj))
+    view |= MSSG_SEES_OBJ;
+  if((about & MSSG_SEES_VOBJ) && vobj && can_see_obj(to, vobj))
+    view |= MSSG_SEES_VOBJ;
+  return view;
+}
+
+//
+// write out the template, as someone who sees things the way view says
+void mssg_render(BUFFER *buf, MSSG_TEMPLATE *tmpl, int view,
+		 CHAR_DATA *ch, CHAR_DATA *vict, OBJ_DATA *obj, OBJ_DATA *vobj){
+  bool   sees_ch = (view & MSSG_SEES_CH)   != 0;
+  bool sees_vict = (view & MSSG_SEES_VICT) != 0;
+  const char *on = (obj  ? (view & MSSG_SEES_OBJ  ? objGetName(obj)  :
+			    SOMETHING) : NULL);
+  const char *vn = (vobj ? (view & MSSG_SEES_VOBJ ? objGetName(vobj) :
+			    SOMETHING) : NULL);
+  int i;
+
+  for(i = 0; i < tmpl->num_tokens; i++) {
+    MSSG_TOKEN *tok = &tmpl->tokens[i];
+    switch(tok->code) {
+    case '\0':
+      bufferCatLength(buf, tmpl->format + tok->start, tok->len);
+      break;
+    case 'n':
+      if(ch)   bufferCat(buf, sees_ch   ? charGetName(ch)   : SOMEONE);
+      break;
+    case 'N':
+      if(vict) bufferCat(buf, sees_vict ? charGetName(vict) : SOMEONE);
+      break;
+    case 'm':
+      if(ch)   bufferCat(buf, sees_ch   ? HIMHER(ch)        : SOMEONE);
+      break;
+    case 'M':
+      if(vict) bufferCat(buf, sees_vict ? HIMHER(vict)      : SOMEONE);
+      break;
+    case 's':
+      if(ch)   bufferCat(buf, sees_ch   ? HISHER(ch)   : SOMEONE"'s");
+      break;
+    case 'S':
+      if(vict) bufferCat(buf, sees_vict ? HISHER(vict) : SOMEONE"'s");
+      break;
+    case 'e':
+      if(ch)   bufferCat(buf, sees_ch   ? HESHE(ch)         : SOMEONE);
+      break;
+    case 'E':
+      if(vict) bufferCat(buf, sees_vict ? HESHE(vict)       : SOMEONE);
+      break;
+    case 'o':
+      if(on)   bufferCat(buf, on);
+      break;
+    case 'O':
+      if(vn)   bufferCat(buf, vn);
+      break;
+    case 'a':
+      if(on)   bufferCat(buf, AN(on));
+      break;
+    case 'A':
+      if(vn)   bufferCat(buf, AN(vn));
+      break;
+    }
+  }
+  bufferCat(buf, "{n\r\n");
+}
+
+//
+// send the message to one person. view is what they can see, of the things
+// the message is about. views holds the ways it has been rendered so far,
+// and rendered tracks which of them have been rendered for this message
+void mssg_send(CHAR_DATA *to, MSSG_TEMPLATE *tmpl, int view,
+	       BUFFER **views, int *rendered,
+	       CHAR_DATA *ch, CHAR_DATA *vict, OBJ_DATA *obj, OBJ_DATA *vobj) {
+  // if there's nobody to read the message, don't render it
+  if(charGetSocket(to) == NULL)
+    return;
+
+  if(!(*rendered & (1 << view))) {
+    if(views[view] == NULL)
+      views[view] = newBuffer(MAX_BUFFER);
+    bufferClear(views[view]);
+    mssg_render(views[view], tmpl, view, ch, vict, obj, vobj);
+    *rendered |= (1 << view);
+  }
+  text_to_char(to, bufferString(views[view]));
+}
+
+
+
+//*****************************************************************************
+// implementation of message() and mssgprintf() from inform.h
+//*****************************************************************************
+void message(CHAR_DATA *ch,  CHAR_DATA *vict,
+	     OBJ_DATA  *obj, OBJ_DATA  *vobj,
+	     int hide_nosee, bitvector_t range,
+	     const char *mssg) {
+  if(!mssg || !*mssg)
+    return;
+
+  bool         cached = TRUE;
+  MSSG_TEMPLATE *tmpl = get_mssg_template(mssg, &cached);
+  int        rendered = 0;
+  int            view = 0;
+  // a message sent while seeing things for another renders into its own views
+  BUFFER  *own_views[MSSG_VIEWS] = { NULL };
+  BUFFER       **views = (mssg_depth == 0 ? mssg_views : own_views);
+  // if we're hiding the message from people who can't see who (or what) is
+  // doing it, we need to know whether they can see them
+  int             ask = tmpl->about;
+  if(hide_nosee)
+    ask |= (ch ? MSSG_SEES_CH : MSSG_SEES_OBJ);
+  mssg_depth++;
+
+  // what's our scope?
+  if(IS_SET(range, TO_VICT) && vict) {
+    view = mssg_view(vict, ask, ch, vict, obj, vobj);
+    // make sure the vict can the character, or the
+    // object if there is no character
+    if(!hide_nosee ||
+       ((!ch || (view & MSSG_SEES_CH)) &&
+	(ch  || (!obj || (view & MSSG_SEES_OBJ)))))
+      mssg_send(vict, tmpl, view & tmpl->about, views, &rendered,
+		ch, vict, obj, vobj);
+  }
+
+  // characters can always see themselves. No need to do checks here
+  if(IS_SET(range, TO_CHAR) && ch) {
+    view = mssg_view(ch, tmpl->about, ch, vict, obj, vobj);
+    mssg_send(ch, tmpl, view, views, &rendered, ch, vict, obj, vobj);
+  }
+
+  LIST *recipients = NULL;
+  // check if the scope of this message is everyone in the world
+  if(IS_SET(range, TO_WORLD))
+    recipients = mobile_list;
+  else if(IS_SET(range, TO_ROOM) && charGetRoom(ch) != NULL)
+    recipients = roomGetCharacters(charGetRoom(ch));
+
+  // if we have a list to send the message to, do it
+  if(recipients != NULL) {
+    LIST_ITERATOR rec_i;
+    listIteratorStart(&rec_i, recipients);
+    CHAR_DATA *rec = NULL;
+
+    // go through everyone in the list
+    ITERATE_LIST(rec, &rec_i) {
+      // if we wanted to send to ch or vict, we would have already...
+      if(rec == vict || rec == ch)
+	continue;
+      // skip by people who are in the game but not in the world yet, or
+      // who aren't around to read it
+      if(charGetRoom(rec) == NULL || charGetSocket(rec) == NULL)
+	continue;
+      view = mssg_view(rec, ask, ch, vict, obj, vobj);
+      // make sure the vict can see the character, or the
+      // object if there is no character
+      if(!hide_nosee ||
+	 ((!ch || (view & MSSG_SEES_CH)) &&
+	  (ch  || (!obj || (view & MSSG_SEES_OBJ)))))
+	mssg_send(rec, tmpl, view & tmpl->about, views, &rendered,
+		ch, vict, obj, vobj);
+    } listIteratorStop(&rec_i);
+  }
+
+  // clean up after ourself, if we were sent while seeing things for another
+  mssg_depth--;
+  if(views == own_views) {
+    int i;
+    for(i = 0; i < MSSG_VIEWS; i++)
+      if(own_views[i] != NULL)
+	deleteBuffer(own_views[i]);
+  }
+  if(!cached)
+    deleteMssgTemplate(tmpl);
+}
+
+void mssgprintf(CHAR_DATA *ch, CHAR_DATA *vict,
+		OBJ_DATA *obj, OBJ_DATA  *vobj,
+		int hide_nosee, bitvector_t range, const char *fmt, ...) {
+  if(fmt && *fmt) {
+    // form the message
+    static char buf[MAX_BUFFER];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, MAX_BUFFER, fmt, args);
+    va_end(args);
+    message(ch, vict, obj, vobj, hide_nosee, range, buf);
+  }
+}
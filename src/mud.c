@@ -24,6 +24,59 @@
 // our storage set of mud settings
 STORAGE_SET *settings = NULL;
 
+//
+// a setting whose values have been looked up ahead of time, so it can be read
+// without a lookup
+struct mud_setting {
+  char             *key;
+  const char    *string; // points into settings. Refreshed whenever we're set
+  double            dbl;
+  int               num;
+  long            l_num;
+  bool          boolean;
+  LIST       *listeners; // functions to call when we're set
+};
+
+//
+// all of the handles we've made, by key
+HASHTABLE *setting_handles = NULL;
+
+MUD_SETTING *pulses_per_second_setting = NULL;
+MUD_SETTING        *start_room_setting = NULL;
+
+//
+// look up our values again, after the setting has changed or the settings
+// have been loaded
+void mudsetting_refresh(MUD_SETTING *setting) {
+  if(settings == NULL)
+    return;
+  setting->string  = read_string(settings, setting->key);
+  setting->dbl     = read_double(settings, setting->key);
+  setting->num     = read_int   (settings, setting->key);
+  setting->l_num   = read_long  (settings, setting->key);
+  setting->boolean = read_bool  (settings, setting->key);
+}
+
+//
+// a setting has been set. Save the settings, update the setting's handle if
+// it has one, and let its listeners know
+void mudsetting_changed(const char *key) {
+  MUD_SETTING *setting = NULL;
+  storage_write(settings, MUD_DATA);
+  if(setting_handles != NULL &&
+     (setting = hashGet(setting_handles, key)) != NULL) {
+    mudsetting_refresh(setting);
+    if(setting->listeners != NULL) {
+      LIST_ITERATOR func_i;
+      void (* func)(const char *) = NULL;
+      listIteratorStart(&func_i, setting->listeners);
+      ITERATE_LIST(func, &func_i)
+	func(key);
+      listIteratorStop(&func_i);
+    }
+  }
+}
+
 //
 // for generating unique IDs to characters, rooms, objects, exits, etc
 int next_available_uid = START_UID;
@@ -45,6 +98,19 @@ int top_uid(void) {
 void init_mud_settings() {
   settings = storage_read(MUD_DATA);
 
+  // pick up the values of any handles that were made before we loaded
+  if(setting_handles != NULL) {
+    HASH_ITERATOR *handle_i = newHashIterator(setting_handles);
+    const char        *key = NULL;
+    MUD_SETTING   *setting = NULL;
+    ITERATE_HASH(key, setting, handle_i)
+      mudsetting_refresh(setting);
+    deleteHashIterator(handle_i);
+  }
+
+  pulses_per_second_setting = mudsettingGetHandle("pulses_per_second");
+  start_room_setting        = mudsettingGetHandle("start_room");
+
   // make sure we have initial values for some stuff
   if(!*mudsettingGetString("start_room"))
     mudsettingSetString("start_room", DFLT_START_ROOM);
@@ -54,27 +120,27 @@ void init_mud_settings() {
 
 void mudsettingSetString(const char *key, const char *val) {
   store_string(settings,  key, val);
-  storage_write(settings, MUD_DATA);  
+  mudsetting_changed(key);
 }
 
 void mudsettingSetDouble(const char *key, double val) {
   store_double(settings, key, val);
-  storage_write(settings, MUD_DATA);
+  mudsetting_changed(key);
 }
 
 void mudsettingSetInt(const char *key, int val) {
   store_int(settings, key, val);
-  storage_write(settings, MUD_DATA);
+  mudsetting_changed(key);
 }
 
 void mudsettingSetLong(const char *key, long val) {
   store_long(settings, key, val);
-  storage_write(settings, MUD_DATA);
+  mudsetting_changed(key);
 }
 
 void mudsettingSetBool(const char *key, bool val) {
   store_bool(settings, key, val);
-  storage_write(settings, MUD_DATA);
+  mudsetting_changed(key);
 }
 
 const char *mudsettingGetString(const char *key) {
@@ -96,3 +162,45 @@ long mudsettingGetLong(const char *key) {
 bool mudsettingGetBool(const char *key) {
   return read_bool(settings, key);
 }
+
+MUD_SETTING *mudsettingGetHandle(const char *key) {
+  MUD_SETTING *setting = NULL;
+  if(setting_handles == NULL)
+    setting_handles = newHashtable();
+  else if((setting = hashGet(setting_handles, key)) != NULL)
+    return setting;
+
+  setting         = calloc(1, sizeof(MUD_SETTING));
+  setting->key    = strdup(key);
+  setting->string = "";
+  hashPut(setting_handles, key, setting);
+  mudsetting_refresh(setting);
+  return setting;
+}
+
+const char *mudsettingHandleString(MUD_SETTING *setting) {
+  return setting->string;
+}
+
+double mudsettingHandleDouble(MUD_SETTING *setting) {
+  return setting->dbl;
+}
+
+int mudsettingHandleInt(MUD_SETTING *setting) {
+  return setting->num;
+}
+
+long mudsettingHandleLong(MUD_SETTING *setting) {
+  return setting->l_num;
+}
+
+bool mudsettingHandleBool(MUD_SETTING *setting) {
+  return setting->boolean;
+}
+
+void mudsettingAddListener(const char *key, void *func) {
+  MUD_SETTING *setting = mudsettingGetHandle(key);
+  if(setting->listeners == NULL)
+    setting->listeners = newList();
+  listQueue(setting->listeners, func);
+}
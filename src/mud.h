@@ -73,7 +73,7 @@ typedef unsigned char                     bool;
 // have to include them after all of our typedefs so the header files can use
 // the typedefs.
 #include "numbers.h"
-#include "property_table.h"
+#include "uid_table.h"
 #include "list.h"
 #include "map.h"
 #include "near_map.h"
@@ -104,7 +104,7 @@ typedef unsigned char                     bool;
 
 /* A few globals */
 #define DFLT_PULSES_PER_SECOND 10
-#define PULSES_PER_SECOND   mudsettingGetInt("pulses_per_second")
+#define PULSES_PER_SECOND   mudsettingHandleInt(pulses_per_second_setting)
 #define SECOND              * PULSES_PER_SECOND   /* used for figuring out how many pulses in a second*/
 #define SECONDS             SECOND                /* same as above */
 #define MINUTE              * 60 SECONDS          /* one minute */
@@ -141,7 +141,7 @@ typedef unsigned char                     bool;
 #define NOTHING_SPECIAL "you see nothing special."
 
 // the room that new characters are dropped into
-#define START_ROOM      mudsettingGetString("start_room")
+#define START_ROOM      mudsettingHandleString(start_room_setting)
 #define DFLT_START_ROOM "tavern_entrance@examples"
 
 #define WORLD_PATH     "../lib/world"
@@ -189,6 +189,30 @@ int         mudsettingGetInt   (const char *key);
 long        mudsettingGetLong  (const char *key);
 bool        mudsettingGetBool  (const char *key);
 
+//
+// Settings that are read often (e.g. every pulse) should be read through a
+// handle. A handle is looked up by key once, and afterwards reading from it is
+// just reading a field; its values are kept up to date whenever the setting is
+// set. Handles last as long as the mud does, and can be gotten before the
+// settings have been loaded; they pick up their values when the settings are
+typedef struct mud_setting                MUD_SETTING;
+MUD_SETTING *mudsettingGetHandle   (const char *key);
+const char  *mudsettingHandleString(MUD_SETTING *setting);
+double       mudsettingHandleDouble(MUD_SETTING *setting);
+int          mudsettingHandleInt   (MUD_SETTING *setting);
+long         mudsettingHandleLong  (MUD_SETTING *setting);
+bool         mudsettingHandleBool  (MUD_SETTING *setting);
+
+//
+// call func whenever the setting with the given key is set, after its new
+// value has been stored. func should take the form: void func(const char *key)
+void mudsettingAddListener(const char *key, void *func);
+
+//
+// handles for the settings the mud itself uses all the time
+extern MUD_SETTING *pulses_per_second_setting;
+extern MUD_SETTING        *start_room_setting;
+
 //
 // returns the next available UID for mobs, objs, room, exits
 #define START_UID      1000000
@@ -217,11 +241,11 @@ extern  LIST          *strs_to_delete; // strings we didn't want deleted at
                                        // get_fullkey and see_xxx_as
 extern  LIST          *bufs_to_delete; // same for buffers
 
-extern  PROPERTY_TABLE     *mob_table; // a mapping between uid and mob
-extern  PROPERTY_TABLE     *obj_table; // a mapping between uid and obj
-extern  PROPERTY_TABLE    *room_table; // a mapping between uid and room
-extern  PROPERTY_TABLE    *exit_table; // a mapping between uid and exit
-extern  PROPERTY_TABLE    *sock_table; // a mapping between uid and socket
+extern  UID_TABLE     *mob_table; // a mapping between uid and mob
+extern  UID_TABLE     *obj_table; // a mapping between uid and obj
+extern  UID_TABLE    *room_table; // a mapping between uid and room
+extern  UID_TABLE    *exit_table; // a mapping between uid and exit
+extern  UID_TABLE    *sock_table; // a mapping between uid and socket
 
 extern  bool                shut_down; // used for shutdown
 extern  int                   mudport; // What port are we running on?
@@ -242,7 +266,14 @@ extern const unsigned char compress_will2[];
 
 #define TELOPT_COMPRESS       85
 #define TELOPT_COMPRESS2      86
-#define COMPRESS_BUF_SIZE   8192
+
+// how hard MCCP compresses, unless the mccp_level (0 to 9) and mccp_mem_level
+// (1 to 9) mud settings say otherwise; unset or out of range ones are ignored.
+// The mccp_workers setting is how many threads compress output off of the
+// game thread; by default, none do. Raising it starts more right away, but
+// lowering it only takes effect at the next reboot
+#define DFLT_MCCP_LEVEL        6
+#define DFLT_MCCP_MEM_LEVEL    8
 
 
 
@@ -21,28 +21,54 @@
 //*****************************************************************************
 // local datastructures, functions, and defines
 //*****************************************************************************
-#define NUM_NEAR_MAP_BUCKETS   27 // 26 for letters, 1 for non-alpha
+
+//
+// Keys are kept in a compressed radix trie: each node holds a run of
+// (lowercased) letters, and a key is the letters along the path down to its
+// node. Every node also remembers the highest-priority entry at or below it,
+// so looking up an abbreviation is just a walk down the trie.
+//
+// An entry's priority is its place in the order the old bucketed map kept
+// things in: by the first letter of its key (anything that isn't a letter
+// comes first), then by its min_abbrev, then by its key. All the entries are
+// also kept in a list in that order, for iterating over.
+typedef struct near_map_elem {
+  char                  *key;
+  char           *min_abbrev;
+  void                 *data;
+  struct near_map_elem *prev;
+  struct near_map_elem *next;
+} NEAR_MAP_ELEM;
+
+typedef struct near_node {
+  char               *label; // our letters, lowercased. "" for the root
+  int                   len;
+  NEAR_MAP_ELEM       *elem; // the entry whose key ends here, if any
+  NEAR_MAP_ELEM       *best; // highest-priority entry at or below us
+  struct near_node   *child; // sorted by the first letter of their labels
+  struct near_node *sibling;
+} NEAR_NODE;
 
 struct near_map {
-  LIST *bucket[NUM_NEAR_MAP_BUCKETS];
+  NEAR_NODE       root;
+  NEAR_MAP_ELEM  *head; // every entry, highest priority first
+  NEAR_ITERATOR *iters; // the iterators going over us, so that removing an
+                        // entry can move them off of it
+  int             size;
 };
 
 struct near_iterator {
-  NEAR_MAP         *map;
-  LIST_ITERATOR *curr_i;
-  int         curr_buck;
+  NEAR_MAP              *map;
+  NEAR_MAP_ELEM        *curr;
+  NEAR_MAP_ELEM        *next; // taken before curr is handed out, so curr can
+                              // be removed from the map while we're on it
+  struct near_iterator *link; // the next iterator going over our map
 };
 
-typedef struct {
-  char        *key;
-  char *min_abbrev;
-  void       *data;
-} NEAR_MAP_ELEM;
-
 
 NEAR_MAP_ELEM *newNearMapElem(void *data, const char *key, 
 			      const char *min_abbrev) {
-  NEAR_MAP_ELEM *elem = malloc(sizeof(NEAR_MAP_ELEM));
+  NEAR_MAP_ELEM *elem = calloc(1, sizeof(NEAR_MAP_ELEM));
   elem->data          = data;
   elem->key           = strdupsafe(key);
   elem->min_abbrev    = strdupsafe(min_abbrev ? min_abbrev : key);
@@ -55,8 +81,31 @@ void deleteNearMapElem(NEAR_MAP_ELEM *elem) {
   free(elem);
 }
 
+NEAR_NODE *newNearNode(const char *label, int len) {
+  NEAR_NODE *node = calloc(1, sizeof(NEAR_NODE));
+  int i;
+  node->label = malloc(len + 1);
+  node->len   = len;
+  for(i = 0; i < len; i++)
+    node->label[i] = tolower(label[i]);
+  node->label[len] = '\0';
+  return node;
+}
+
 //
-// returns the bucket that the key should map into
+// delete a node and everything below it. Entries are deleted by the map
+void deleteNearNode(NEAR_NODE *node) {
+  NEAR_NODE *child = node->child, *next = NULL;
+  for(; child != NULL; child = next) {
+    next = child->sibling;
+    deleteNearNode(child);
+  }
+  free(node->label);
+  free(node);
+}
+
+//
+// returns the bucket the old map would have put the key in
 int get_nearmap_bucket(const char *key) {
   if(isalpha(*key))
     return 1 + tolower(*key) - 'a';
@@ -64,16 +113,125 @@ int get_nearmap_bucket(const char *key) {
     return 0;
 }
 
+//
+// which of the two entries is looked at first for an abbreviation?
 int nearmapsortbycmp(NEAR_MAP_ELEM *elem1, NEAR_MAP_ELEM *elem2) {
-  return strcasecmp(elem1->min_abbrev, elem2->min_abbrev);
+  int cmp = get_nearmap_bucket(elem1->key) - get_nearmap_bucket(elem2->key);
+  if(cmp == 0)
+    cmp = strcasecmp(elem1->min_abbrev, elem2->min_abbrev);
+  if(cmp == 0)
+    cmp = strcasecmp(elem1->key, elem2->key);
+  return cmp;
 }
 
-int is_near_map_abbrev(const char *abbrev, NEAR_MAP_ELEM *elem) {
-  return strncasecmp(abbrev, elem->key, strlen(abbrev));
+//
+// find our child whose label starts with the letter
+NEAR_NODE *near_node_child(NEAR_NODE *node, char letter, NEAR_NODE **prev) {
+  NEAR_NODE *child = node->child;
+  letter = tolower(letter);
+  if(prev) *prev = NULL;
+  for(; child != NULL && *child->label < letter; child = child->sibling)
+    if(prev) *prev = child;
+  return (child != NULL && *child->label == letter ? child : NULL);
 }
 
-int is_near_map_elem(const char *key, NEAR_MAP_ELEM *elem) {
-  return strcasecmp(key, elem->key);
+//
+// Find the node for key. If abbrev_ok, key can end part way through a node's
+// label; everything at or below the node we return starts with key
+NEAR_NODE *near_node_find(NEAR_MAP *map, const char *key, bool abbrev_ok) {
+  NEAR_NODE *node = &map->root;
+  while(*key != '\0') {
+    NEAR_NODE *child = near_node_child(node, *key, NULL);
+    int i = 1;
+    if(child == NULL)
+      return NULL;
+    while(i < child->len && key[i] != '\0' && tolower(key[i]) == child->label[i])
+      i++;
+    if(key[i] == '\0')
+      return (i == child->len || abbrev_ok ? child : NULL);
+    else if(i < child->len)
+      return NULL;
+    key += i;
+    node  = child;
+  }
+  return node;
+}
+
+//
+// work out the highest-priority entry at or below the node again
+void near_node_rebest(NEAR_NODE *node) {
+  NEAR_NODE *child = NULL;
+  node->best = node->elem;
+  for(child = node->child; child != NULL; child = child->sibling)
+    if(node->best == NULL ||
+       (child->best != NULL && nearmapsortbycmp(child->best, node->best) < 0))
+      node->best = child->best;
+}
+
+//
+// the highest-priority entry at or below the node that ok() accepts, if there
+// is one that beats best. Subtrees that can't beat best are skipped
+NEAR_MAP_ELEM *near_node_best_with(NEAR_NODE *node, NEAR_MAP_ELEM *best,
+				   bool (* ok)(void *data, void *arg),
+				   void *arg) {
+  NEAR_NODE *child = NULL;
+  if(node->best == NULL ||
+     (best != NULL && nearmapsortbycmp(node->best, best) >= 0))
+    return best;
+  if(node->elem != NULL && ok(node->elem->data, arg) &&
+     (best == NULL || nearmapsortbycmp(node->elem, best) < 0))
+    best = node->elem;
+  for(child = node->child; child != NULL; child = child->sibling)
+    best = near_node_best_with(child, best, ok, arg);
+  return best;
+}
+
+//
+// after an entry below the child is removed, drop the child if nothing is
+// left below it, or fold it into its only child if it no longer holds an
+// entry, so the trie stays compressed
+void near_node_tidy(NEAR_NODE *node, NEAR_NODE *child, NEAR_NODE *prev) {
+  if(child->elem != NULL)
+    return;
+  else if(child->child == NULL) {
+    if(prev != NULL)
+      prev->sibling = child->sibling;
+    else
+      node->child   = child->sibling;
+    deleteNearNode(child);
+  }
+  else if(child->child->sibling == NULL) {
+    NEAR_NODE *only = child->child;
+    char     *label = malloc(child->len + only->len + 1);
+    sprintf(label, "%s%s", child->label, only->label);
+    free(child->label);
+    child->label = label;
+    child->len  += only->len;
+    child->elem  = only->elem;
+    child->best  = only->best;
+    child->child = only->child;
+    only->child  = NULL;
+    deleteNearNode(only);
+  }
+}
+
+//
+// take the entry for key out of the trie below node, and return it
+NEAR_MAP_ELEM *near_node_remove(NEAR_NODE *node, const char *key) {
+  NEAR_MAP_ELEM *elem = NULL;
+  if(*key == '\0') {
+    elem       = node->elem;
+    node->elem = NULL;
+  }
+  else {
+    NEAR_NODE *prev = NULL, *child = near_node_child(node, *key, &prev);
+    if(child != NULL && !strncasecmp(key, child->label, child->len) &&
+       (elem = near_node_remove(child, key + child->len)) != NULL)
+      near_node_tidy(node, child, prev);
+  }
+  if(elem != NULL && node->best == elem)
+    near_node_rebest(node);
+  return elem;
 }
 
 
@@ -83,42 +241,104 @@ int is_near_map_elem(const char *key, NEAR_MAP_ELEM *elem) {
 //*****************************************************************************
 NEAR_MAP *newNearMap(void) {
   NEAR_MAP *map = calloc(1, sizeof(NEAR_MAP));
+  map->root.label = strdup("");
   return map;
 }
 
 void deleteNearMap(NEAR_MAP *map) {
-  int i;
-  for(i = 0; i < NUM_NEAR_MAP_BUCKETS; i++)
-    if(map->bucket[i] != NULL)
-      deleteListWith(map->bucket[i], deleteNearMapElem);
+  NEAR_MAP_ELEM *elem = map->head, *next = NULL;
+  NEAR_NODE    *child = map->root.child, *sibling = NULL;
+  for(; elem != NULL; elem = next) {
+    next = elem->next;
+    deleteNearMapElem(elem);
+  }
+  for(; child != NULL; child = sibling) {
+    sibling = child->sibling;
+    deleteNearNode(child);
+  }
+  free(map->root.label);
   free(map);
 }
 
 void *nearMapGet(NEAR_MAP *map, const char *key, bool abbrev_ok) {
-  // find the bucket
-  LIST *buck = map->bucket[get_nearmap_bucket(key)];
-  if(buck == NULL)
+  NEAR_NODE     *node = near_node_find(map, key, abbrev_ok);
+  NEAR_MAP_ELEM *elem = NULL;
+  if(node != NULL)
+    elem = (abbrev_ok ? node->best : node->elem);
+  return (elem ? elem->data : NULL);
+}
+
+void *nearMapGetWith(NEAR_MAP *map, const char *key, bool abbrev_ok,
+		     bool (* ok)(void *data, void *arg), void *arg) {
+  NEAR_NODE     *node = near_node_find(map, key, abbrev_ok);
+  NEAR_MAP_ELEM *elem = NULL;
+  if(node == NULL)
     return NULL;
-  else {
-    NEAR_MAP_ELEM *elem = NULL;
-    if(abbrev_ok)
-      elem = listGetWith(buck, key, is_near_map_abbrev);
-    else
-      elem = listGetWith(buck, key, is_near_map_elem);
-    return (elem ? elem->data : NULL);
-  }
+  else if(!abbrev_ok)
+    elem = node->elem;
+  // usually, the best match is the one we want. If not, go looking
+  else if(node->best != NULL && !ok(node->best->data, arg))
+    elem = near_node_best_with(node, NULL, ok, arg);
+  else
+    elem = node->best;
+  return (elem != NULL && ok(elem->data, arg) ? elem->data : NULL);
 }
 
 void nearMapPut(NEAR_MAP *map, const char *key, const char *min_abbrev, 
-		void *elem) {
-  // find the bucket
-  int buck_num = get_nearmap_bucket(key);
-  LIST   *buck = map->bucket[buck_num];
-  if(buck == NULL)
-    map->bucket[buck_num] = buck = newList();
-
-  NEAR_MAP_ELEM *e = newNearMapElem(elem, key, min_abbrev);
-  listPutWith(buck, e, nearmapsortbycmp);
+		void *data) {
+  NEAR_MAP_ELEM *elem = NULL, *before = NULL;
+  NEAR_NODE     *node = &map->root;
+  const char       *k = key;
+
+  // a key is only ever in the map once
+  nearMapRemove(map, key);
+  elem = newNearMapElem(data, key, min_abbrev);
+
+  // find our place in line
+  for(before = map->head; before != NULL; before = before->next) {
+    if(nearmapsortbycmp(elem, before) < 0)
+      break;
+    elem->prev = before;
+  }
+  elem->next = before;
+  if(before != NULL)     before->prev = elem;
+  if(elem->prev != NULL) elem->prev->next = elem;
+  else                   map->head = elem;
+  map->size++;
+
+  // and walk down the trie to our node, making it if we have to
+  if(node->best == NULL || nearmapsortbycmp(elem, node->best) < 0)
+    node->best = elem;
+  while(*k != '\0') {
+    NEAR_NODE *prev = NULL, *child = near_node_child(node, *k, &prev);
+    int i = 1;
+    if(child == NULL) {
+      child = newNearNode(k, strlen(k));
+      child->sibling = (prev ? prev->sibling : node->child);
+      if(prev != NULL) prev->sibling = child;
+      else             node->child   = child;
+    }
+    while(i < child->len && k[i] != '\0' && tolower(k[i]) == child->label[i])
+      i++;
+
+    // we only share the start of the child's label. Split it in two
+    if(i < child->len) {
+      NEAR_NODE *rest = newNearNode(child->label + i, child->len - i);
+      rest->elem  = child->elem;
+      rest->best  = child->best;
+      rest->child = child->child;
+      child->label[i] = '\0';
+      child->len   = i;
+      child->elem  = NULL;
+      child->child = rest;
+    }
+
+    if(child->best == NULL || nearmapsortbycmp(elem, child->best) < 0)
+      child->best = elem;
+    node = child;
+    k   += i;
+  }
+  node->elem = elem;
 }
 
 bool nearMapKeyExists(NEAR_MAP *map, const char *key) {
@@ -126,54 +346,44 @@ bool nearMapKeyExists(NEAR_MAP *map, const char *key) {
 }
 
 void *nearMapRemove(NEAR_MAP *map, const char *key) {
-  LIST *buck = map->bucket[get_nearmap_bucket(key)];
-  if(buck == NULL)
-    return NULL;
-  else {
-    NEAR_MAP_ELEM *elem = listRemoveWith(buck, key, is_near_map_elem);
-    void          *data = NULL;
-    if(elem != NULL) {
-      data = elem->data;
-      deleteNearMapElem(elem);
-    }
-    return data;
+  NEAR_MAP_ELEM *elem = near_node_remove(&map->root, key);
+  void          *data = NULL;
+  if(elem != NULL) {
+    if(elem->prev != NULL) elem->prev->next = elem->next;
+    else                   map->head = elem->next;
+    if(elem->next != NULL) elem->next->prev = elem->prev;
+    // any iterator that was going to go to us next goes past us instead
+    NEAR_ITERATOR *iter = map->iters;
+    for(; iter != NULL; iter = iter->link)
+      if(iter->next == elem)
+	iter->next = elem->next;
+    map->size--;
+    data = elem->data;
+    deleteNearMapElem(elem);
   }
+  return data;
 }
 
 LIST *nearMapGetAllMatches(NEAR_MAP *map, const char *key) {
-  // find the bucket
-  LIST    *buck = map->bucket[get_nearmap_bucket(key)];
-  if(buck == NULL)
+  NEAR_NODE     *node = near_node_find(map, key, TRUE);
+  NEAR_MAP_ELEM *elem = NULL;
+  LIST       *matches = NULL;
+  if(node == NULL || node->best == NULL)
     return NULL;
-  else {
-    LIST         *matches = newList();
-    LIST_ITERATOR *elem_i = newListIterator(buck);
-    NEAR_MAP_ELEM   *elem = NULL;
-    ITERATE_LIST(elem, elem_i) {
-      if(startswith(elem->key, key))
-	// changed to return keys instead of vals, 
-	// so this is a little more intuitive (if not a little slower)
-	listQueue(matches, strdup(elem->key)); // elem->data);
-    } deleteListIterator(elem_i);
-
-    // did we not find anything?
-    if(listSize(matches) == 0) {
-      deleteList(matches);
-      matches = NULL;
-    }
 
-    return matches;
-  }
+  // nothing that comes before our best match can match
+  matches = newList();
+  for(elem = node->best; elem != NULL; elem = elem->next)
+    if(startswith(elem->key, key))
+      // changed to return keys instead of vals, 
+      // so this is a little more intuitive (if not a little slower)
+      listQueue(matches, strdup(elem->key)); // elem->data);
+  return matches;
 }
 
 // how big are we?
 int nearMapSize(NEAR_MAP *map) {
-  int size = 0, i;
-  for(i = 0; i < NUM_NEAR_MAP_BUCKETS; i++) {
-    if(map->bucket[i] != NULL)
-      size += listSize(map->bucket[i]);
-  }
-  return size;
+  return map->size;
 }
 
 
@@ -184,77 +394,38 @@ int nearMapSize(NEAR_MAP *map) {
 NEAR_ITERATOR *newNearIterator(NEAR_MAP *map) {
   NEAR_ITERATOR *iter = calloc(1, sizeof(NEAR_ITERATOR));
   iter->map           = map;
+  iter->link          = map->iters;
+  map->iters          = iter;
   nearIteratorReset(iter);
   return iter;
 }
 
 void deleteNearIterator(NEAR_ITERATOR *iter) {
-  if(iter->curr_i)
-    deleteListIterator(iter->curr_i);
+  NEAR_ITERATOR **link = &iter->map->iters;
+  while(*link != iter)
+    link = &(*link)->link;
+  *link = iter->link;
   free(iter);
 }
 
 void nearIteratorReset(NEAR_ITERATOR *iter) {
-  int i;
-
-  if(iter->curr_i)
-    deleteListIterator(iter->curr_i);
-  iter->curr_i = NULL;
-  iter->curr_buck = 0;
-
-  // curr_i will be NULL if there are no elems
-  for(i = 0; i < NUM_NEAR_MAP_BUCKETS; i++) {
-    if(iter->map->bucket[i] != NULL && listSize(iter->map->bucket[i]) > 0) {
-      iter->curr_i = newListIterator(iter->map->bucket[i]);
-      iter->curr_buck = i;
-      break;
-    }
-  }
+  iter->curr = iter->map->head;
+  iter->next = (iter->curr ? iter->curr->next : NULL);
 }
 
 void nearIteratorNext(NEAR_ITERATOR *iter) {
-  // no more elements left
-  if(iter->curr_i == NULL)
-    return;
-  // we're at the end of our list
-  else if(listIteratorNext(iter->curr_i) == NULL) {
-    deleteListIterator(iter->curr_i);
-    iter->curr_i = NULL;
-    iter->curr_buck++;
-
-    for(; iter->curr_buck < NUM_NEAR_MAP_BUCKETS; iter->curr_buck++) {
-      if(iter->map->bucket[iter->curr_buck] != NULL &&
-	 listSize(iter->map->bucket[iter->curr_buck]) > 0) {
-	iter->curr_i = newListIterator(iter->map->bucket[iter->curr_buck]);
-	break;
-      }
-    }
-  }
+  iter->curr = iter->next;
+  iter->next = (iter->curr ? iter->curr->next : NULL);
 }
 
 const char *nearIteratorCurrentKey(NEAR_ITERATOR *iter) {
-  if(iter->curr_i == NULL)
-    return NULL;
-  else {
-    NEAR_MAP_ELEM *elem = listIteratorCurrent(iter->curr_i);
-    return (elem ? elem->key : NULL);
-  }
+  return (iter->curr ? iter->curr->key : NULL);
 }
 
 const char *nearIteratorCurrentAbbrev(NEAR_ITERATOR *iter) {
-  if(iter->curr_i == NULL)
-    return NULL;
-  else {
-    NEAR_MAP_ELEM *elem = listIteratorCurrent(iter->curr_i);
-    return (elem ? elem->min_abbrev : NULL);
-  }
+  return (iter->curr ? iter->curr->min_abbrev : NULL);
 }
 
 void *nearIteratorCurrentVal(NEAR_ITERATOR *iter) {
-  if(iter->curr_i == NULL)
-    return NULL;
-  else {
-    NEAR_MAP_ELEM *elem = listIteratorCurrent(iter->curr_i);
-    return (elem ? elem->data : NULL);
-  }
+  return (iter->curr ? iter->curr->data : NULL);
 }
@@ -12,6 +12,12 @@
 // "north" to all be viable commands. This is what a near-map tries to
 // accomplish.
 //
+// When an abbreviation matches more than one key, entries with a lower
+// min_abbrev win (e.g. "look", put in with "l", beats "laugh"). nearMapGetWith
+// is the same, but skips over any entry that ok() does not accept. Lookups
+// never allocate anything. Putting in a key that is already in the map
+// replaces it.
+//
 //*****************************************************************************
 
 typedef struct near_map           NEAR_MAP;
@@ -20,6 +26,8 @@ typedef struct near_iterator NEAR_ITERATOR;
 NEAR_MAP        *newNearMap(void);
 void          deleteNearMap(NEAR_MAP *map);
 void            *nearMapGet(NEAR_MAP *map, const char *key, bool abbrev_ok);
+void        *nearMapGetWith(NEAR_MAP *map, const char *key, bool abbrev_ok,
+			    bool (* ok)(void *data, void *arg), void *arg);
 void             nearMapPut(NEAR_MAP *map, const char *key, 
 			    const char *min_abbrev, void *data);
 bool       nearMapKeyExists(NEAR_MAP *map, const char *key);
@@ -40,6 +48,8 @@ int             nearMapSize(NEAR_MAP *map);
       nearIteratorNext(it), \
       abbrev = nearIteratorCurrentAbbrev(it), val = nearIteratorCurrentVal(it))
 
+// entries can be removed from the map while iterating, including the one
+// being looked at. Iterators must be deleted before their map is
 NEAR_ITERATOR        *newNearIterator(NEAR_MAP *map);
 void               deleteNearIterator(NEAR_ITERATOR *I);
 void                nearIteratorReset(NEAR_ITERATOR *I);
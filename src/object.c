@@ -17,6 +17,7 @@
 #include "handler.h"
 #include "storage.h"
 #include "auxiliary.h"
+#include "strpool.h"
 #include "object.h"
 
 struct object_data {
@@ -25,14 +26,18 @@ struct object_data {
   int      hidden;               // how hard is it to see this object?
   time_t   birth;                // the time at which we were created
   
-  char *name;                    // our name - e.g. "a shirt"
-  char *prototypes;              // a list of the types we're instances of
-  char *class;                   // the prototype we most directly inherit from
-  char *keywords;                // words to reference us by
-  char *rdesc;                   // our room description
-  char *multi_name;              // our name when more than 1 appears
-  char *multi_rdesc;             // our rdesc when more than 1 appears
-  BUFFER *desc;                  // the description when we are looked at
+  // our strings are shared with other objects through the string pool (see
+  // strpool.h). Our description only gets a buffer of its own if something
+  // asks to edit it in place
+  const char *name;              // our name - e.g. "a shirt"
+  const char *prototypes;        // a list of the types we're instances of
+  const char *class;             // the prototype we most directly inherit from
+  const char *keywords;          // words to reference us by
+  const char *rdesc;             // our room description
+  const char *multi_name;        // our name when more than 1 appears
+  const char *multi_rdesc;       // our rdesc when more than 1 appears
+  const char *desc;              // the description when we are looked at
+  BUFFER *desc_buf;              // or, our own copy of it. NULL if unused
   BITVECTOR *bits;               // the object bits we have turned on
 
   // only one of these should be set at a time
@@ -57,14 +62,14 @@ OBJ_DATA *newObj() {
   obj->weight         = 0.1;
 
   obj->bits           = bitvectorInstanceOf("obj_bits");
-  obj->prototypes     = strdup("");
-  obj->class          = strdup("");
-  obj->name           = strdup("");
-  obj->keywords       = strdup("");
-  obj->rdesc          = strdup("");
-  obj->multi_name     = strdup("");
-  obj->multi_rdesc    = strdup("");
-  obj->desc           = newBuffer(1);
+  obj->prototypes     = strpoolGet("");
+  obj->class          = strpoolGet("");
+  obj->name           = strpoolGet("");
+  obj->keywords       = strpoolGet("");
+  obj->rdesc          = strpoolGet("");
+  obj->multi_name     = strpoolGet("");
+  obj->multi_rdesc    = strpoolGet("");
+  obj->desc           = strpoolGet("");
 
   obj->contents       = newList();
   obj->users          = newList();
@@ -83,14 +88,15 @@ void deleteObj(OBJ_DATA *obj) {
   // same goes for users
   deleteList(obj->users);
 
-  if(obj->class)      free(obj->class);
-  if(obj->prototypes) free(obj->prototypes);
-  if(obj->name)       free(obj->name);
-  if(obj->keywords)   free(obj->keywords);
-  if(obj->rdesc)      free(obj->rdesc);
-  if(obj->desc)       deleteBuffer(obj->desc);
-  if(obj->multi_name) free(obj->multi_name);
-  if(obj->multi_rdesc)free(obj->multi_rdesc);
+  strpoolRelease(obj->class);
+  strpoolRelease(obj->prototypes);
+  strpoolRelease(obj->name);
+  strpoolRelease(obj->keywords);
+  strpoolRelease(obj->rdesc);
+  strpoolRelease(obj->desc);
+  strpoolRelease(obj->multi_name);
+  strpoolRelease(obj->multi_rdesc);
+  if(obj->desc_buf)   deleteBuffer(obj->desc_buf);
   if(obj->bits)     deleteBitvector(obj->bits);
   if(obj->edescs)   deleteEdescSet(obj->edescs);
   deleteAuxiliaryData(obj->auxiliary_data);
@@ -141,7 +147,7 @@ STORAGE_SET *objStore(OBJ_DATA *obj) {
   store_string(set, "name",      obj->name);
   store_string(set, "keywords",  obj->keywords);
   store_string(set, "rdesc",     obj->rdesc);
-  store_string(set, "desc",      bufferString(obj->desc));
+  store_string(set, "desc",      objGetDesc(obj));
   store_string(set, "multiname", obj->multi_name);
   store_string(set, "multirdesc",obj->multi_rdesc);
   store_set   (set, "edescs",    edescSetStore(obj->edescs));
@@ -230,7 +236,7 @@ const char  *objGetRdesc   (OBJ_DATA *obj) {
 }
 
 const char  *objGetDesc    (OBJ_DATA *obj) {
-  return bufferString(obj->desc);
+  return (obj->desc_buf ? bufferString(obj->desc_buf) : obj->desc);
 }
 
 const char  *objGetMultiName(OBJ_DATA *obj) {
@@ -238,7 +244,14 @@ const char  *objGetMultiName(OBJ_DATA *obj) {
 }
 
 BUFFER *objGetDescBuffer(OBJ_DATA *obj) {
-  return obj->desc;
+  // whoever wants the buffer may change it in place, so we need our own copy
+  if(obj->desc_buf == NULL) {
+    obj->desc_buf = newBuffer(1);
+    bufferCat(obj->desc_buf, obj->desc);
+    strpoolRelease(obj->desc);
+    obj->desc = NULL;
+  }
+  return obj->desc_buf;
 }
 
 const char  *objGetMultiRdesc(OBJ_DATA *obj) {
@@ -286,12 +299,13 @@ double objGetWeightRaw(OBJ_DATA *obj) {
 double objGetWeight(OBJ_DATA *obj) {
   double tot_weight = obj->weight;
   if(listSize(obj->contents) > 0) {
-    LIST_ITERATOR *cont_i = newListIterator(obj->contents);
+    LIST_ITERATOR cont_i;
+    listIteratorStart(&cont_i, obj->contents);
     OBJ_DATA *cont = NULL;
 
-    ITERATE_LIST(cont, cont_i)
+    ITERATE_LIST(cont, &cont_i)
       tot_weight += objGetWeight(cont);
-    deleteListIterator(cont_i);
+    listIteratorStop(&cont_i);
   }
   return tot_weight;
 }
@@ -309,47 +323,49 @@ void *objGetAuxiliaryData(const OBJ_DATA *obj, const char *name) {
 }
 
 void objSetKeywords(OBJ_DATA *obj, const char *keywords) {
-  if(obj->keywords) free(obj->keywords);
-  obj->keywords = strdupsafe(keywords);
+  strpoolSet(&obj->keywords, keywords);
 }
 
 void objSetRdesc(OBJ_DATA *obj, const char *rdesc) {
-  if(obj->rdesc) free(obj->rdesc);
-  obj->rdesc = strdupsafe(rdesc);
+  strpoolSet(&obj->rdesc, rdesc);
 }
 
 void objSetClass(OBJ_DATA *obj, const char *prototype) {
-  if(obj->class) free(obj->class);
-  obj->class = strdupsafe(prototype);
+  strpoolSet(&obj->class, prototype);
 }
 
 void objSetPrototypes(OBJ_DATA *obj, const char *prototypes) {
-  if(obj->prototypes) free(obj->prototypes);
-  obj->prototypes = strdupsafe(prototypes);
+  strpoolSet(&obj->prototypes, prototypes);
 }
 
 void objAddPrototype(OBJ_DATA *obj, const char *prototype) {
-  add_keyword(&obj->prototypes, prototype);
+  if(!is_keyword(obj->prototypes, prototype, FALSE)) {
+    char *prototypes = strdup(obj->prototypes);
+    add_keyword(&prototypes, prototype);
+    strpoolSet(&obj->prototypes, prototypes);
+    free(prototypes);
+  }
 }
 
 void objSetName(OBJ_DATA *obj, const char *name) {
-  if(obj->name) free(obj->name);
-  obj->name = strdupsafe(name);
+  strpoolSet(&obj->name, name);
 }
 
 void objSetDesc(OBJ_DATA *obj, const char *desc) {
-  bufferClear(obj->desc);
-  bufferCat(obj->desc, (desc ? desc : ""));
+  if(obj->desc_buf == NULL)
+    strpoolSet(&obj->desc, desc);
+  else {
+    bufferClear(obj->desc_buf);
+    bufferCat(obj->desc_buf, (desc ? desc : ""));
+  }
 }
 
 void objSetMultiName(OBJ_DATA *obj, const char *multi_name) {
-  if(obj->multi_name) free(obj->multi_name);
-  obj->multi_name = strdupsafe(multi_name);
+  strpoolSet(&obj->multi_name, multi_name);
 }
 
 void objSetMultiRdesc(OBJ_DATA *obj, const char *multi_rdesc) {
-  if(obj->multi_rdesc) free(obj->multi_rdesc);
-  obj->multi_rdesc = strdupsafe(multi_rdesc);
+  strpoolSet(&obj->multi_rdesc, multi_rdesc);
 }
 
 void objSetEdescs(OBJ_DATA *obj, EDESC_SET *edescs) {
@@ -1128,7 +1128,7 @@ bool redit_parser(SOCKET_DATA *sock, ROOM_OLC *data, int choice,
     // delete the exit...
     if(old_exit != NULL) {
       // is our room in the game? do we need to remove the exit from game?
-      if(propertyTableIn(room_table, roomGetUID(roomOLCGetRoom(data))))
+      if(uidTableIn(room_table, roomGetUID(roomOLCGetRoom(data))))
 	exit_from_game(old_exit);
       deleteExit(old_exit);
     }
@@ -1152,7 +1152,7 @@ bool redit_parser(SOCKET_DATA *sock, ROOM_OLC *data, int choice,
       if(exit == NULL) {
 	exit = newExit();
 	// are we editing a room in game? If so, add this exit to the game
-	if(propertyTableIn(room_table, roomGetUID(roomOLCGetRoom(data))))
+	if(uidTableIn(room_table, roomGetUID(roomOLCGetRoom(data))))
 	  exit_to_game(exit);
 	roomSetExit(roomOLCGetRoom(data), dir, exit);
       }
@@ -0,0 +1,221 @@
+//*****************************************************************************
+//
+// outqueue.c
+//
+// Queues of output waiting to be written to a descriptor. See outqueue.h for
+// documentation.
+//
+// A queue is a chain of links, each of which points at the part of a segment
+// that is still waiting to be written. Segments and links that are no longer
+// needed are kept on free lists, and handed out again before anything new is
+// allocated.
+//
+//*****************************************************************************
+
+#include <sys/uio.h>
+#include "mud.h"
+#include "utils.h"
+#include "outqueue.h"
+
+
+
+//*****************************************************************************
+// local datastructures, functions, and defines
+//*****************************************************************************
+
+// how big the segments text is copied into are. Anything bigger gets a
+// segment to itself, just big enough to hold it
+#define OUT_SEGMENT_SIZE        4096
+
+// the most empty segments we keep around for reuse
+#define MAX_FREE_SEGMENTS        256
+
+// the most segments handed to one writev
+#define MAX_FLUSH_IOVECS          64
+
+typedef struct out_segment {
+  int                  len; // how much of data is in use
+  int                  cap; // and how much there is
+  struct out_segment *next; // the next free segment, when we're not in use
+  char              data[];
+} OUT_SEGMENT;
+
+typedef struct out_link {
+  OUT_SEGMENT     *seg;
+  int            start; // where the part of seg left to write starts
+  int              end; // and ends
+  struct out_link *next;
+} OUT_LINK;
+
+struct out_queue {
+  OUT_LINK *head;
+  OUT_LINK *tail;
+  int     length; // bytes waiting to be written
+};
+
+OUT_SEGMENT *free_segments = NULL;
+int      num_free_segments = 0;
+OUT_LINK       *free_links = NULL;
+
+//
+// get a segment that can hold at least cap bytes
+OUT_SEGMENT *out_segment_get(int cap) {
+  OUT_SEGMENT *seg = NULL;
+  if(cap <= OUT_SEGMENT_SIZE && free_segments != NULL) {
+    seg           = free_segments;
+    free_segments = seg->next;
+    num_free_segments--;
+  }
+  else {
+    cap      = MAX(cap, OUT_SEGMENT_SIZE);
+    seg      = malloc(sizeof(OUT_SEGMENT) + cap);
+    seg->cap = cap;
+  }
+  seg->len      = 0;
+  seg->next     = NULL;
+  return seg;
+}
+
+//
+// put the segment on the free list, or free it if the list is full or it's
+// not the usual size
+void out_segment_release(OUT_SEGMENT *seg) {
+  if(seg->cap == OUT_SEGMENT_SIZE && num_free_segments < MAX_FREE_SEGMENTS) {
+    seg->next     = free_segments;
+    free_segments = seg;
+    num_free_segments++;
+  }
+  else
+    free(seg);
+}
+
+//
+// put a link to the segment on the end of the queue. The queue owns it now
+void out_queue_link(OUT_QUEUE *queue, OUT_SEGMENT *seg) {
+  OUT_LINK *link = free_links;
+  if(link != NULL)
+    free_links = link->next;
+  else
+    link = malloc(sizeof(OUT_LINK));
+  link->seg   = seg;
+  link->start = 0;
+  link->end   = seg->len;
+  link->next  = NULL;
+  if(queue->tail != NULL)
+    queue->tail->next = link;
+  else
+    queue->head = link;
+  queue->tail    = link;
+  queue->length += seg->len;
+}
+
+//
+// take the link off the front of the queue, and release its segment
+void out_queue_unlink_head(OUT_QUEUE *queue) {
+  OUT_LINK *link = queue->head;
+  queue->head    = link->next;
+  if(queue->head == NULL)
+    queue->tail = NULL;
+  queue->length -= link->end - link->start;
+  out_segment_release(link->seg);
+  link->next = free_links;
+  free_links = link;
+}
+
+//
+// drop the first len bytes of the queue, which have been written
+void out_queue_consume(OUT_QUEUE *queue, int len) {
+  while(len > 0) {
+    OUT_LINK *link = queue->head;
+    int       left = link->end - link->start;
+    if(len < left) {
+      link->start   += len;
+      queue->length -= len;
+      return;
+    }
+    len -= left;
+    out_queue_unlink_head(queue);
+  }
+}
+
+
+
+//*****************************************************************************
+// implementation of outqueue.h
+//*****************************************************************************
+OUT_QUEUE *newOutQueue(void) {
+  return calloc(1, sizeof(OUT_QUEUE));
+}
+
+void deleteOutQueue(OUT_QUEUE *queue) {
+  outQueueClear(queue);
+  free(queue);
+}
+
+void outQueueCat(OUT_QUEUE *queue, const char *txt, int len) {
+  while(len > 0) {
+    OUT_LINK     *tail = queue->tail;
+    OUT_SEGMENT   *seg = (tail ? tail->seg : NULL);
+
+    // is there room on the end of our last segment?
+    if(seg != NULL && seg->len < seg->cap) {
+      int amnt = MIN(len, seg->cap - seg->len);
+      memcpy(seg->data + seg->len, txt, amnt);
+      seg->len      += amnt;
+      tail->end     += amnt;
+      queue->length += amnt;
+      txt           += amnt;
+      len           -= amnt;
+    }
+    else
+      out_queue_link(queue, out_segment_get(len));
+  }
+}
+
+int outQueueFlush(OUT_QUEUE *queue, int fd, bool *blocked) {
+  struct iovec iov[MAX_FLUSH_IOVECS];
+  int      written = 0;
+  *blocked = FALSE;
+
+  while(queue->head != NULL) {
+    OUT_LINK *link = queue->head;
+    int   num_iovs = 0, wanted = 0;
+    for(; link != NULL && num_iovs < MAX_FLUSH_IOVECS; link = link->next) {
+      iov[num_iovs].iov_base = link->seg->data + link->start;
+      iov[num_iovs].iov_len  = link->end - link->start;
+      wanted += link->end - link->start;
+      num_iovs++;
+    }
+
+    int wrote = writev(fd, iov, num_iovs);
+    if(wrote < 0) {
+      if(errno == EINTR)
+	continue;
+      if(errno == EAGAIN || errno == EWOULDBLOCK) {
+	*blocked = TRUE;
+	break;
+      }
+      return -1;
+    }
+
+    written += wrote;
+    out_queue_consume(queue, wrote);
+    // if it didn't take everything, it's full
+    if(wrote < wanted) {
+      *blocked = TRUE;
+      break;
+    }
+  }
+  return written;
+}
+
+int outQueueClear(OUT_QUEUE *queue) {
+  int dropped = queue->length;
+  while(queue->head != NULL)
+    out_queue_unlink_head(queue);
+  return dropped;
+}
+
+int outQueueLength(OUT_QUEUE *queue) {
+  return queue->length;
+}
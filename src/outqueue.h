@@ -0,0 +1,43 @@
+#ifndef OUTQUEUE_H
+#define OUTQUEUE_H
+//*****************************************************************************
+//
+// outqueue.h
+//
+// A queue of output waiting to be written to a descriptor. Output is held in a
+// chain of segments, and written out with writev(), as much at a time as the
+// descriptor will take; nothing here ever blocks. Whatever can't be written
+// yet stays queued, for the next time the descriptor is writable.
+//
+// Text added to a queue goes on the end of its last segment if there is room
+// for it. Emptied segments are kept around and reused, so a busy queue does
+// not have to allocate memory.
+//
+//*****************************************************************************
+
+typedef struct out_queue                  OUT_QUEUE;
+
+//
+// create and delete queues. Deleting a queue drops whatever is still in it
+OUT_QUEUE *newOutQueue(void);
+void    deleteOutQueue(OUT_QUEUE *queue);
+
+//
+// copy len bytes of txt onto the end of the queue
+void outQueueCat(OUT_QUEUE *queue, const char *txt, int len);
+
+//
+// write as much of the queue to fd as it will take. Returns how many bytes
+// were written, or -1 if fd could not be written to for any reason other than
+// it being full. If it was full, *blocked is set to TRUE
+int outQueueFlush(OUT_QUEUE *queue, int fd, bool *blocked);
+
+//
+// empty the queue without writing it. Returns how many bytes were dropped
+int outQueueClear(OUT_QUEUE *queue);
+
+//
+// how many bytes are waiting to be written?
+int outQueueLength(OUT_QUEUE *queue);
+
+#endif // OUTQUEUE_H
@@ -121,20 +121,35 @@ typedef struct {
 
 
 //
-// create a new parse var of the specified type
-PARSE_VAR *newParseVar(int type) {
-  PARSE_VAR          *var = calloc(1, sizeof(PARSE_VAR));
+// set up a parse var of the specified type. Vars live in an array on the
+// stack of whoever is parsing, so nothing is allocated for them
+void parseVarInit(PARSE_VAR *var, int type) {
+  memset(var, 0, sizeof(PARSE_VAR));
   var->disambiguated_type = PARSE_NONE;
   var->type               = type;
-  return var;
-}  
+}
+
 
 
 //
-// delete a parse var
-void deleteParseVar(PARSE_VAR *var) {
-  free(var);
-}
+// a format, compiled down into the tokens it is made of. Each distinct format
+// is compiled once, the first time it is used, and its program never changes
+// after that
+typedef struct parse_program {
+  char                *format; // the format we were compiled from
+  PARSE_TOKEN         *tokens; // NULL if the format has a syntax error
+  int              num_tokens;
+  int                 py_args; // how many values Py_parse_args returns
+  bool                 cached; // are we kept in the program cache?
+  struct parse_program  *next; // a format that only differs from ours by case
+} PARSE_PROGRAM;
+
+// compiled formats, by format. Formats are almost always static strings, so
+// there are only ever a few hundred of them. Just in case something keeps
+// making up new ones, we stop caching after this many
+HASHTABLE *parse_programs = NULL;
+int    num_parse_programs = 0;
+#define MAX_PARSE_PROGRAMS   1024
 
 
 
@@ -497,6 +512,77 @@ LIST *decompose_parse_format(const char *format) {
   return token_list;
 }
 
+//
+// compile a format into a program
+PARSE_PROGRAM *newParseProgram(const char *format) {
+  PARSE_PROGRAM *prog = calloc(1, sizeof(PARSE_PROGRAM));
+  LIST        *tokens = decompose_parse_format(format);
+  PARSE_TOKEN    *tok = NULL;
+  prog->format = strdup(format);
+
+  if(tokens != NULL) {
+    // move the tokens into one array. The array takes over their contents
+    prog->tokens = calloc(listSize(tokens) + 1, sizeof(PARSE_TOKEN));
+    while((tok = listPop(tokens)) != NULL) {
+      prog->tokens[prog->num_tokens++] = *tok;
+      free(tok);
+
+      // count up how many values Python gets back from us
+      tok = &prog->tokens[prog->num_tokens - 1];
+      if(tok->type == PARSE_TOKEN_FLAVOR || tok->type == PARSE_TOKEN_OPTIONAL)
+	continue;
+      // one for a returnable type, one to denote what kind in an ambiguous
+      // case, and one to denote if we had multiples
+      prog->py_args++;
+      if(tok->type == PARSE_TOKEN_MULTI)
+	prog->py_args++;
+      if(tok->all_ok)
+	prog->py_args++;
+    }
+    deleteList(tokens);
+  }
+  return prog;
+}
+
+void deleteParseProgram(PARSE_PROGRAM *prog) {
+  int i;
+  for(i = 0; i < prog->num_tokens; i++) {
+    if(prog->tokens[i].token_list)
+      deleteListWith(prog->tokens[i].token_list, deleteParseToken);
+    if(prog->tokens[i].flavor)
+      free(prog->tokens[i].flavor);
+  }
+  if(prog->tokens) free(prog->tokens);
+  free(prog->format);
+  free(prog);
+}
+
+//
+// return the compiled program for a format, compiling it if this is the
+// first time we've seen it. If the program's cached flag is not set, it
+// must be deleted when the caller is done with it
+PARSE_PROGRAM *get_parse_program(const char *format) {
+  PARSE_PROGRAM *head = NULL, *prog = NULL;
+  if(parse_programs == NULL)
+    parse_programs = newHashtable();
+
+  // the hashtable doesn't care about case, but flavor text shows up in
+  // syntax error messages as it is written
+  head = hashGet(parse_programs, format);
+  for(prog = head; prog != NULL; prog = prog->next)
+    if(!strcmp(prog->format, format))
+      return prog;
+
+  prog = newParseProgram(format);
+  if(num_parse_programs < MAX_PARSE_PROGRAMS) {
+    prog->cached = TRUE;
+    prog->next   = head;
+    hashPut(parse_programs, format, prog);
+    num_parse_programs++;
+  }
+  return prog;
+}
+
 //
 // turns a string into a boolean
 bool string_to_bool(const char *string) {
@@ -555,224 +641,153 @@ bool string_is_int(const char *string) {
 
 //
 // tries to make an int parse var
-PARSE_VAR *use_one_parse_token_int(const char *buf) {
-  PARSE_VAR *var = NULL;
-  if(string_is_int(buf)) {
-    var = newParseVar(PARSE_VAR_INT);
-    var->int_val = atoi(buf);
-  }
-  return var;
+bool use_one_parse_token_int(const char *buf, PARSE_VAR *var) {
+  if(!string_is_int(buf))
+    return FALSE;
+  parseVarInit(var, PARSE_VAR_INT);
+  var->int_val = atoi(buf);
+  return TRUE;
 }
 
 
 //
 // tries to make a double parse var
-PARSE_VAR *use_one_parse_token_double(const char *buf) {
-  PARSE_VAR *var = NULL;
-  if(string_is_double(buf)) {
-    var = newParseVar(PARSE_VAR_DOUBLE);
-    var->dbl_val = atof(buf);
-  }
-  return var;
+bool use_one_parse_token_double(const char *buf, PARSE_VAR *var) {
+  if(!string_is_double(buf))
+    return FALSE;
+  parseVarInit(var, PARSE_VAR_DOUBLE);
+  var->dbl_val = atof(buf);
+  return TRUE;
 }
 
 
 //
 // tries to make a boolean parse var
-PARSE_VAR *use_one_parse_token_bool(const char *buf) {
-  PARSE_VAR *var = NULL;
-  if(string_is_bool(buf)) {
-    var = newParseVar(PARSE_VAR_BOOL);
-    var->bool_val = string_to_bool(buf);
+bool use_one_parse_token_bool(const char *buf, PARSE_VAR *var) {
+  if(!string_is_bool(buf))
+    return FALSE;
+  parseVarInit(var, PARSE_VAR_BOOL);
+  var->bool_val = string_to_bool(buf);
+  return TRUE;
+}
+
+
+//
+// fill in a char, obj, or exit var with whatever find_specific found. A list
+// of one thing is turned into just the thing. Returns FALSE, and cleans up,
+// if nothing was found
+bool parse_var_found(PARSE_VAR *var, int var_type, PARSE_TOKEN *tok,
+		     void *found, int type, int found_one_type) {
+  parseVarInit(var, var_type);
+
+  // if multiple vals were possible, flag it
+  var->multiple_possible = tok->all_ok;
+
+  // Is it a single thing?
+  if(type == found_one_type)
+    var->ptr_val = found;
+
+  // or is it multiple things?
+  else if(type == FOUND_LIST) {
+    if(listSize(found) > 1) {
+      var->ptr_val = found;
+      var->multiple = TRUE;
+    }
+    else if(listSize(found) == 1) {
+      var->ptr_val = listPop(found);
+      deleteList(found);
+    }
+    else {
+      deleteList(found);
+      return FALSE;
+    }
   }
-  return var;
+
+  // We should never reach this case
+  else
+    return FALSE;
+  return TRUE;
 }
 
 
 //
 // tries to make a char parse var
-PARSE_VAR *use_one_parse_token_char(CHAR_DATA *looker, PARSE_TOKEN *tok,
-				    const char *name) {
+bool use_one_parse_token_char(CHAR_DATA *looker, PARSE_TOKEN *tok,
+			      const char *name, PARSE_VAR *var) {
   int    type = FOUND_NONE;
   void *found = find_specific(looker, name, "", "", FIND_TYPE_CHAR, tok->scope,
 			      tok->all_ok, &type);
 
   // make sure we found something...
   if(found == NULL)
-    return NULL;
-  else {
-    PARSE_VAR *var = newParseVar(PARSE_VAR_CHAR);
-
-    // if multiple vals were possible, flag it
-    var->multiple_possible = tok->all_ok;
-
-    // make sure it's not us if that's not allowed
-    if(type == FOUND_CHAR) {
-      if(tok->self_ok || looker != found)
-	var->ptr_val = found;
-      else {
-	deleteParseVar(var);
-	var = NULL;
-      }
-    }
-    // if we got a list, make sure we remove ourself as neccessary
-    else if(type == FOUND_LIST) {
-      if(!tok->self_ok)
-	listRemove(found, looker);
-      // make sure we're not empty...
-      if(listSize(found) > 1) {
-	var->ptr_val  = found;
-	var->multiple = TRUE;
-      }
-      else if(listSize(found) == 1) {
-	var->ptr_val = listPop(found);
-	deleteList(found);
-      }
-      else {
-	deleteList(found);
-	deleteParseVar(var);
-	var = NULL;
-      }
-    }
-    // this shouldn't happen...
-    else {
-      deleteParseVar(var);
-      var = NULL;
-    }
-
-    // return what we found, if anything
-    return var;
-  }
+    return FALSE;
+  // make sure it's not us if that's not allowed
+  else if(type == FOUND_CHAR && !tok->self_ok && looker == found)
+    return FALSE;
+  // if we got a list, make sure we remove ourself as neccessary
+  else if(type == FOUND_LIST && !tok->self_ok)
+    listRemove(found, looker);
+  return parse_var_found(var, PARSE_VAR_CHAR, tok, found, type, FOUND_CHAR);
 }
 
 
 //
 // tries to make an obj parse var
-PARSE_VAR *use_one_parse_token_obj(CHAR_DATA *looker, PARSE_TOKEN *tok,
-				   const char *name) {
+bool use_one_parse_token_obj(CHAR_DATA *looker, PARSE_TOKEN *tok,
+			     const char *name, PARSE_VAR *var) {
   int    type = FOUND_NONE;
   void *found = find_specific(looker, name, "", "", FIND_TYPE_OBJ, tok->scope,
 			      tok->all_ok, &type);
 
   // make sure we found something
   if(found == NULL)
-    return NULL;
-  else {
-    PARSE_VAR *var = newParseVar(PARSE_VAR_OBJ);
-
-    // if multiple vals were possible, flag it
-    var->multiple_possible = tok->all_ok;
-
-    // Is it a single item?
-    if(type == FOUND_OBJ)
-      var->ptr_val = found;
-
-    // or is it multiple items?
-    else if(type == FOUND_LIST) {
-      if(listSize(found) > 1) {
-	var->ptr_val = found;
-	var->multiple = TRUE;
-      }
-      else if(listSize(found) == 1) {
-	var->ptr_val = listPop(found);
-	deleteList(found);
-      }
-      else {
-	deleteList(found);
-	deleteParseVar(var);
-	var = NULL;
-      }
-    }
-
-    // We should never reach this case
-    else {
-      deleteParseVar(var);
-      var = NULL;
-    }
-
-    // return whatever we found
-    return var;
-  }
+    return FALSE;
+  return parse_var_found(var, PARSE_VAR_OBJ, tok, found, type, FOUND_OBJ);
 }
 
 
 //
 // tries to make an exit parse var
-PARSE_VAR *use_one_parse_token_exit(CHAR_DATA *looker, PARSE_TOKEN *tok, 
-				    const char *name) {
+bool use_one_parse_token_exit(CHAR_DATA *looker, PARSE_TOKEN *tok, 
+			      const char *name, PARSE_VAR *var) {
   int    type = FOUND_NONE;
   void *found = find_specific(looker, name, "", "", FIND_TYPE_EXIT, tok->scope,
 			      tok->all_ok, &type);
 
   // make sure we found something
   if(found == NULL)
-    return NULL;
-  else {
-    PARSE_VAR *var = newParseVar(PARSE_VAR_EXIT);
-
-    // if multiple vals were possible, flag it
-    var->multiple_possible = tok->all_ok;
-
-    // Is it a single exit?
-    if(type == FOUND_EXIT)
-      var->ptr_val = found;
-
-    // or is it multiple exits?
-    else if(type == FOUND_LIST) {
-      if(listSize(found) > 1) {
-	var->ptr_val = found;
-	var->multiple = TRUE;
-      }
-      else if(listSize(found) == 1) {
-	var->ptr_val = listPop(found);
-	deleteList(found);
-      }
-      else {
-	deleteList(found);
-	deleteParseVar(var);
-	var = NULL;
-      }
-    }
-
-    // We should never reach this case
-    else {
-      deleteParseVar(var);
-      var = NULL;
-    }
-
-    // return whatever we found
-    return var;
-  }
+    return FALSE;
+  return parse_var_found(var, PARSE_VAR_EXIT, tok, found, type, FOUND_EXIT);
 }
 
 
 //
 // tries to make a room parse var
-PARSE_VAR *use_one_parse_token_room(CHAR_DATA *looker, PARSE_TOKEN *tok,
-				    const char *name) {
+bool use_one_parse_token_room(CHAR_DATA *looker, PARSE_TOKEN *tok,
+			      const char *name, PARSE_VAR *var) {
   ROOM_DATA *room = find_specific(looker, name, "", "", FIND_TYPE_ROOM, 
 				  FIND_SCOPE_WORLD, FALSE, NULL);
 
   // did we find something?
   if(room == NULL)
-    return NULL;
-  else {
-    PARSE_VAR *var = newParseVar(PARSE_VAR_ROOM);
-    var->ptr_val   = room;
-    return var;
-  }
+    return FALSE;
+  parseVarInit(var, PARSE_VAR_ROOM);
+  var->ptr_val = room;
+  return TRUE;
 }
 
 
 //
-// Tries to apply a token to args, to parse something out. Returns a PARSE_VAR
-// if the token's usage resulted in the creation of a variable. If an error was
-// encountered, make this apparent by setting the value of the variable at error
-PARSE_VAR *use_one_parse_token(CHAR_DATA *looker, PARSE_TOKEN *tok, 
-			       char **args, bool *error, char *err_buf) {
+// Tries to apply a token to args, to parse something out. Returns TRUE, and
+// fills in var, if the token's usage resulted in the creation of a variable.
+// If an error was encountered, make this apparent by setting the value of
+// the variable at error
+bool use_one_parse_token(CHAR_DATA *looker, PARSE_TOKEN *tok, 
+			 char **args, bool *error, char *err_buf,
+			 PARSE_VAR *var) {
   char buf[SMALL_BUFFER];
-  PARSE_VAR  *var = NULL;
-  char       *arg = *args;
+  bool    made = FALSE;
+  char    *arg = *args;
 
   // skip over any leading spaces we might have
   while(isspace(*arg))
@@ -786,15 +801,17 @@ PARSE_VAR *use_one_parse_token(CHAR_DATA *looker, PARSE_TOKEN *tok,
     char multi_err_buf[SMALL_BUFFER] = "";
 
     // go through all of our possible types until we find something
-    LIST_ITERATOR *multi_i = newListIterator(tok->token_list);
+    LIST_ITERATOR multi_i;
+    listIteratorStart(&multi_i, tok->token_list);
     PARSE_TOKEN      *mtok = NULL;
     bool multiple_possible = FALSE;
-    ITERATE_LIST(mtok, multi_i) {
+    ITERATE_LIST(mtok, &multi_i) {
       if(mtok->all_ok)
 	multiple_possible = TRUE;
-      var = use_one_parse_token(looker, mtok, &arg, &multi_err, multi_err_buf);
+      made = use_one_parse_token(looker, mtok, &arg, &multi_err, multi_err_buf,
+				 var);
       // reset our error value for the next pass at it...
-      if(var == NULL)
+      if(!made)
 	multi_err = FALSE;
       // found something! Disambiguate the type
       else {
@@ -812,10 +829,10 @@ PARSE_VAR *use_one_parse_token(CHAR_DATA *looker, PARSE_TOKEN *tok,
 	// break out of the loop... we found something
 	break;
       }
-    } deleteListIterator(multi_i);
+    } listIteratorStop(&multi_i);
 
     // did we manage not to find something?
-    if(var != NULL)
+    if(made)
       var->multiple_possible = multiple_possible;
     else {
       one_arg(arg, buf); // get the first arg, for reporting...
@@ -841,8 +858,8 @@ PARSE_VAR *use_one_parse_token(CHAR_DATA *looker, PARSE_TOKEN *tok,
     // parse out a char value
   case PARSE_TOKEN_CHAR:
     arg = one_arg(arg, buf);
-    var = use_one_parse_token_char(looker, tok, buf);
-    if(var == NULL) {
+    made = use_one_parse_token_char(looker, tok, buf, var);
+    if(!made) {
       sprintf(err_buf, "The person, %s, could not be found.", buf);
       *error = TRUE;
     }
@@ -851,8 +868,8 @@ PARSE_VAR *use_one_parse_token(CHAR_DATA *looker, PARSE_TOKEN *tok,
     // parse out an obj value
   case PARSE_TOKEN_OBJ:
     arg = one_arg(arg, buf);
-    var = use_one_parse_token_obj(looker, tok, buf);
-    if(var == NULL) {
+    made = use_one_parse_token_obj(looker, tok, buf, var);
+    if(!made) {
       sprintf(err_buf, "The object, %s, could not be found.", buf);
       *error = TRUE;
     }
@@ -861,8 +878,8 @@ PARSE_VAR *use_one_parse_token(CHAR_DATA *looker, PARSE_TOKEN *tok,
     // parse out a room value
   case PARSE_TOKEN_ROOM:
     arg = one_arg(arg, buf);
-    var = use_one_parse_token_room(looker, tok, buf);
-    if(var == NULL) {
+    made = use_one_parse_token_room(looker, tok, buf, var);
+    if(!made) {
       sprintf(err_buf, "The room, %s, could not be found.", buf);
       *error = TRUE;
     }
@@ -871,8 +888,8 @@ PARSE_VAR *use_one_parse_token(CHAR_DATA *looker, PARSE_TOKEN *tok,
     // parse out an exit value
   case PARSE_TOKEN_EXIT:
     arg = one_arg(arg, buf);
-    var = use_one_parse_token_exit(looker, tok, buf);
-    if(var == NULL) {
+    made = use_one_parse_token_exit(looker, tok, buf, var);
+    if(!made) {
       sprintf(err_buf, "The direction, %s, could not be found.", buf);
       *error = TRUE;
     }
@@ -881,8 +898,8 @@ PARSE_VAR *use_one_parse_token(CHAR_DATA *looker, PARSE_TOKEN *tok,
     // try to parse out a double value
   case PARSE_TOKEN_DOUBLE:
     arg = one_arg(arg, buf);
-    var = use_one_parse_token_double(buf);
-    if(var == NULL) {
+    made = use_one_parse_token_double(buf, var);
+    if(!made) {
       sprintf(err_buf, "'%s' is not a decimal value.", buf);
       *error = TRUE;
     }
@@ -891,8 +908,8 @@ PARSE_VAR *use_one_parse_token(CHAR_DATA *looker, PARSE_TOKEN *tok,
     // try to parse out an integer value
   case PARSE_TOKEN_INT:
     arg = one_arg(arg, buf);
-    var = use_one_parse_token_int(buf);
-    if(var == NULL) {
+    made = use_one_parse_token_int(buf, var);
+    if(!made) {
       sprintf(err_buf, "'%s' is not a%s number.", buf,
 	      (string_is_double(buf) ? "n acceptable" : ""));
       *error = TRUE;
@@ -902,8 +919,8 @@ PARSE_VAR *use_one_parse_token(CHAR_DATA *looker, PARSE_TOKEN *tok,
     // try to parse out a boolean value
   case PARSE_TOKEN_BOOL:
     arg = one_arg(arg, buf);
-    var = use_one_parse_token_bool(buf);
-    if(var == NULL) {
+    made = use_one_parse_token_bool(buf, var);
+    if(!made) {
       sprintf(err_buf, "'%s' is not a yes/no value.", buf);
       *error = TRUE;
     }
@@ -911,7 +928,8 @@ PARSE_VAR *use_one_parse_token(CHAR_DATA *looker, PARSE_TOKEN *tok,
 
     // parse out a single word
   case PARSE_TOKEN_WORD: {
-    var = newParseVar(PARSE_VAR_STRING);
+    parseVarInit(var, PARSE_VAR_STRING);
+    made            = TRUE;
     var->ptr_val    = arg;
     bool multi_word = FALSE;
     char multi_mark = '"';
@@ -937,7 +955,8 @@ PARSE_VAR *use_one_parse_token(CHAR_DATA *looker, PARSE_TOKEN *tok,
 
     // copies whatever is left
   case PARSE_TOKEN_STRING:
-    var = newParseVar(PARSE_VAR_STRING);
+    parseVarInit(var, PARSE_VAR_STRING);
+    made         = TRUE;
     var->ptr_val = arg;
     // skip up the place of the arg...
     while(*arg != '\0')
@@ -953,7 +972,7 @@ PARSE_VAR *use_one_parse_token(CHAR_DATA *looker, PARSE_TOKEN *tok,
   if(!*error)
     *args = arg;
 
-  return var;
+  return made;
 }
 
 
@@ -989,17 +1008,18 @@ const char *get_datatype_format_error_mssg(PARSE_TOKEN *tok) {
 
 
 //
-// Takes a list of tokens, and builds the proper syntax for the command and
+// Takes a compiled format, and builds the proper syntax for the command and
 // then sends it to the character.
-void show_parse_syntax_error(CHAR_DATA *ch, const char *cmd, LIST *tokens) {
+void show_parse_syntax_error(CHAR_DATA *ch, const char *cmd,
+			     PARSE_PROGRAM *prog) {
   BUFFER            *buf = newBuffer(1);
-  LIST_ITERATOR   *tok_i = newListIterator(tokens);
   PARSE_TOKEN       *tok = NULL;
   bool    optional_found = FALSE;
-  int              count = 0;
+  int              count = 0, i;
 
   // go through all of our tokens, and append their syntax to the buf
-  ITERATE_LIST(tok, tok_i) {
+  for(i = 0; i < prog->num_tokens; i++) {
+    tok = &prog->tokens[i];
     // make sure we add a space before anything else...
     if(count > 0)
       bprintf(buf, " ");
@@ -1018,15 +1038,16 @@ void show_parse_syntax_error(CHAR_DATA *ch, const char *cmd, LIST *tokens) {
     switch(tok->type) {
     case PARSE_TOKEN_MULTI: {
       bprintf(buf, "<");
-      LIST_ITERATOR *multi_i = newListIterator(tok->token_list);
+      LIST_ITERATOR multi_i;
+      listIteratorStart(&multi_i, tok->token_list);
       PARSE_TOKEN      *mtok = NULL;
       int            m_count = 0;
-      ITERATE_LIST(mtok, multi_i) {
+      ITERATE_LIST(mtok, &multi_i) {
 	if(m_count > 0)
 	  bprintf(buf, ", ");
 	m_count++;
 	bprintf(buf, "%s", get_datatype_format_error_mssg(mtok));
-      } deleteListIterator(multi_i);
+      } listIteratorStop(&multi_i);
       bprintf(buf, ">");
       break;
     }
@@ -1040,7 +1061,7 @@ void show_parse_syntax_error(CHAR_DATA *ch, const char *cmd, LIST *tokens) {
       bprintf(buf, "<%s>", get_datatype_format_error_mssg(tok));
       break;
     }
-  } deleteListIterator(tok_i);
+  }
 
   // send the message
   send_to_char(ch, "Proper syntax is: %s %s%s\r\n", cmd, bufferString(buf),
@@ -1050,19 +1071,20 @@ void show_parse_syntax_error(CHAR_DATA *ch, const char *cmd, LIST *tokens) {
 
 
 //
-// builds up a list of variables out of the token list, and arguments. If we
-// encounter an error and we need to show it to the looker, do so.
-LIST *compose_variable_list(CHAR_DATA *looker, LIST *tokens, char *args,
-			    char *err_buf) {
-  LIST      *variables = newList();
-  LIST_ITERATOR *tok_i = newListIterator(tokens);
+// runs a compiled format over the arguments, filling in vars (which must have
+// room for one var per token). Returns how many vars were filled in, or
+// NOTHING if we encountered an error
+int compose_variable_list(CHAR_DATA *looker, PARSE_PROGRAM *prog, char *args,
+			  char *err_buf, PARSE_VAR *vars) {
   PARSE_TOKEN     *tok = NULL;
   bool           error = FALSE;
   bool  optional_found = FALSE;
+  int         num_vars = 0, i;
 
-  // go through our list of tokens, and try dealing with the args
-  ITERATE_LIST(tok, tok_i) {
-    PARSE_VAR *var = NULL;
+  // go through our tokens, and try dealing with the args
+  for(i = 0; i < prog->num_tokens; i++) {
+    bool made = FALSE;
+    tok = &prog->tokens[i];
 
     // did we just encounter an optional value?
     if(tok->type == PARSE_TOKEN_OPTIONAL) {
@@ -1072,7 +1094,8 @@ LIST *compose_variable_list(CHAR_DATA *looker, LIST *tokens, char *args,
     
     // can we still use tokens to process stuff?
     if(*args != '\0')
-      var = use_one_parse_token(looker, tok, &args, &error, err_buf);
+      made = use_one_parse_token(looker, tok, &args, &error, err_buf,
+				 &vars[num_vars]);
     // we haven't found an "optional" marker yet - this isn't allowed
     else if(optional_found == FALSE)
       error = TRUE;
@@ -1080,29 +1103,27 @@ LIST *compose_variable_list(CHAR_DATA *looker, LIST *tokens, char *args,
     else 
       break;
 
-    // if use of the token returned a new variable, append it
-    if(var != NULL)
-      listQueue(variables, var);
+    // if use of the token made a new variable, keep it
+    if(made)
+      num_vars++;
     // if we enountered an error, tell the person if neccessary
-    else if(error == TRUE) {
-      deleteListWith(variables, deleteParseVar);
-      variables = NULL;
-      break;
-    }
-  } deleteListIterator(tok_i);
+    else if(error == TRUE)
+      return NOTHING;
+  }
 
-  return variables;
+  return num_vars;
 }
 
 
 //
-// Goes through the list of variables and fills up vargs with them as needed
-void parse_assign_vars(LIST *variables, va_list vargs) {
-  LIST_ITERATOR *var_i = newListIterator(variables);
+// Goes through the variables and fills up vargs with them as needed
+void parse_assign_vars(PARSE_VAR *vars, int num_vars, va_list vargs) {
   PARSE_VAR   *one_var = NULL;
+  int i;
 
   // go through each variable and assign to vargs as needed
-  ITERATE_LIST(one_var, var_i) {
+  for(i = 0; i < num_vars; i++) {
+    one_var = &vars[i];
     // first, do our basic type
     switch(one_var->type) {
     case PARSE_VAR_BOOL:
@@ -1133,20 +1154,21 @@ void parse_assign_vars(LIST *variables, va_list vargs) {
     // and if we parsed multiple occurences
     if(one_var->multiple_possible == TRUE)
       *va_arg(vargs, bool *) = one_var->multiple;
-  } deleteListIterator(var_i);
+  }
 }
 
 
 //
-// Goes through the list of variables and make a python list with them
-PyObject *parse_create_py_vars(LIST *variables) {
-  LIST_ITERATOR *var_i = newListIterator(variables);
+// Goes through the variables and make a python list with them
+PyObject *parse_create_py_vars(PARSE_VAR *vars, int num_vars) {
   PARSE_VAR   *one_var = NULL;
   PyObject       *list = PyList_New(0);
   PyObject      *pyval = NULL;
+  int i;
 
   // go through each variable and assign to vargs as needed
-  ITERATE_LIST(one_var, var_i) {
+  for(i = 0; i < num_vars; i++) {
+    one_var = &vars[i];
     // first, do our basic type
     switch(one_var->type) {
     case PARSE_VAR_BOOL:
@@ -1218,7 +1240,7 @@ PyObject *parse_create_py_vars(LIST *variables) {
       PyList_Append(list, pyval);
       Py_DECREF(pyval);
     }
-  } deleteListIterator(var_i);
+  }
 
   return list;
 }
@@ -1229,74 +1251,48 @@ PyObject *parse_create_py_vars(LIST *variables) {
 // implementation of parse.h
 //*****************************************************************************
 int parse_expected_py_args(const char *syntax) {
-  LIST *tokens = NULL;
-  if((tokens = decompose_parse_format(syntax)) == NULL)
-    return -1;
-  int count = 0;
-  LIST_ITERATOR *token_i = newListIterator(tokens);
-  PARSE_TOKEN     *token = NULL;
-  ITERATE_LIST(token, token_i) {
-    if(token->type == PARSE_TOKEN_FLAVOR || token->type == PARSE_TOKEN_OPTIONAL)
-      continue;
-
-    // one for a returnable type
-    count++;
-
-    // one to denote what kind in an ambiguous case
-    if(token->type == PARSE_TOKEN_MULTI)
-      count++;
-
-    // one to denote if we had multiples
-    if(token->all_ok)
-      count++;
-  } deleteListIterator(token_i);
-  deleteListWith(tokens, deleteParseToken);
-
+  PARSE_PROGRAM *prog = get_parse_program(syntax);
+  int           count = (prog->tokens == NULL ? -1 : prog->py_args);
+  if(!prog->cached)
+    deleteParseProgram(prog);
   return count;
 }
 
 void *Py_parse_args(CHAR_DATA *looker, bool show_errors, const char *cmd, 
 		    char *args, const char *syntax) {
   char err_buf[SMALL_BUFFER] = "";
-  bool       parse_ok = TRUE;
-  LIST        *tokens = NULL;
-  LIST     *variables = NULL;
+  PARSE_PROGRAM *prog = get_parse_program(syntax);
+  PARSE_VAR      vars[prog->num_tokens + 1];
+  int        num_vars = NOTHING;
   PyObject      *list = NULL;
 
-  // get our list of tokens
-  if((tokens = decompose_parse_format(syntax)) == NULL) {
+  // make sure our format compiled
+  if(prog->tokens == NULL)
     log_string("Command '%s', format error in argument parsing: %s",cmd,syntax);
-    parse_ok = FALSE;
-  }
-  // try to use our tokens to compose a variable list
-  else if((variables = compose_variable_list(looker, tokens, args, err_buf))
-	  == NULL)
-    parse_ok = FALSE;
-  else {
+  // try to use our program to compose our variables
+  else if((num_vars = compose_variable_list(looker, prog, args, err_buf, vars))
+	  != NOTHING) {
     // go through all of our vars and make python forms for them
-    list = parse_create_py_vars(variables);
+    list = parse_create_py_vars(vars, num_vars);
 
     // fill up optional spots at the end we didn't parse args for
-    int expected = parse_expected_py_args(syntax);
-    while(PyList_Size(list) < expected)
+    while(PyList_Size(list) < prog->py_args)
       PyList_Append(list, Py_None);
   }
 
   // did we encounter an error with the arguments and need to mssg someone?
-  if(tokens != NULL && !parse_ok && show_errors) {
+  if(prog->tokens != NULL && num_vars == NOTHING && show_errors) {
     // do we have a specific error message?
     if(*err_buf)
       send_to_char(looker, "%s\r\n", err_buf);
     // assume a syntax error
     else
-      show_parse_syntax_error(looker, cmd, tokens);
+      show_parse_syntax_error(looker, cmd, prog);
   }
 
   // clean up our mess
-  if(tokens != NULL)
-    deleteListWith(tokens, deleteParseToken);
-  if(variables != NULL)
-    deleteListWith(variables, deleteParseVar);
+  if(!prog->cached)
+    deleteParseProgram(prog);
 
   // return our parse status
   return list;
@@ -1305,43 +1301,37 @@ void *Py_parse_args(CHAR_DATA *looker, bool show_errors, const char *cmd,
 bool parse_args(CHAR_DATA *looker, bool show_errors, const char *cmd,
 		char *args, const char *syntax, ...) {
   char err_buf[SMALL_BUFFER] = "";
-  bool       parse_ok = TRUE;
-  LIST       *tokens  = NULL;
-  LIST     *variables = NULL;
+  PARSE_PROGRAM *prog = get_parse_program(syntax);
+  PARSE_VAR      vars[prog->num_tokens + 1];
+  int        num_vars = NOTHING;
 
-  // get our list of tokens
-  if((tokens = decompose_parse_format(syntax)) == NULL) {
+  // make sure our format compiled
+  if(prog->tokens == NULL)
     log_string("Command '%s', format error in argument parsing: %s",cmd,syntax);
-    parse_ok = FALSE;
-  }
-  // try to use our tokens to compose a variable list
-  else if((variables = compose_variable_list(looker, tokens, args, err_buf))
-	  == NULL)
-    parse_ok = FALSE;
-  else {
+  // try to use our program to compose our variables
+  else if((num_vars = compose_variable_list(looker, prog, args, err_buf, vars))
+	  != NOTHING) {
     // go through all of our vars and assign them to the proper args
     va_list vargs;
     va_start(vargs, syntax);
-    parse_assign_vars(variables, vargs);
+    parse_assign_vars(vars, num_vars, vargs);
     va_end(vargs);
   }
 
   // did we encounter an error with the arguments and need to mssg someone?
-  if(tokens != NULL && !parse_ok && show_errors) {
+  if(prog->tokens != NULL && num_vars == NOTHING && show_errors) {
     // do we have a specific error message?
     if(*err_buf)
       send_to_char(looker, "%s\r\n", err_buf);
     // assume a syntax error
     else
-      show_parse_syntax_error(looker, cmd, tokens);
+      show_parse_syntax_error(looker, cmd, prog);
   }
 
   // clean up our mess
-  if(tokens != NULL)
-    deleteListWith(tokens, deleteParseToken);
-  if(variables != NULL)
-    deleteListWith(variables, deleteParseVar);
+  if(!prog->cached)
+    deleteParseProgram(prog);
 
   // return our parse status
-  return parse_ok;
+  return (num_vars != NOTHING);
 }
@@ -7,6 +7,13 @@
 // run the rproto as usual. When a persistent room's state changes, make sure
 // it is saved to disk. When persistent rooms need to be loaded back up after
 // a copyover or reboot, make sure that happens.
+//
+// Loaded persistent rooms are kept in a list, most recently used first. When
+// more of them are loaded than the persistent_room_budget mud setting allows,
+// the ones that have gone unused longest are saved and unloaded. A budget of
+// 0 means there is no limit, and rooms are never unloaded to make room. The
+// persistent_room_idle setting is how many seconds a room has to go unused
+// before it can be unloaded.
 // 
 //*****************************************************************************
 
@@ -15,11 +22,13 @@
 #include "../world.h"
 #include "../auxiliary.h"
 #include "../storage.h"
+#include "../storage_writer.h"
 #include "../room.h"
 #include "../handler.h"
 #include "../hooks.h"
 #include "../event.h"
 #include "../character.h"
+#include "persistent.h"
 
 
 
@@ -34,29 +43,45 @@
 //*****************************************************************************
 // auxiliary data
 //*****************************************************************************
-typedef struct {
+typedef struct persistent_data {
   bool      dirty; // do we need to be saved?
   bool persistent; // are we persistent or not?
   int    activity; // how many 'things' are going on in us? If activity is
                    // > 0, we have to make sure we force-load at startup
   time_t last_use; // the last time someone entered our room
+
+  // our place in the list of loaded persistent rooms. room is NULL if we are
+  // not in the list
+  ROOM_DATA                 *room;
+  struct persistent_data *lru_prev;
+  struct persistent_data *lru_next;
 } PERSISTENT_DATA;
 
+void persistent_lru_unlink(PERSISTENT_DATA *data);
+
 PERSISTENT_DATA *newPersistentData(void) {
   PERSISTENT_DATA *data = malloc(sizeof(PERSISTENT_DATA));
   data->persistent      = FALSE;
   data->activity        = 0;
   data->last_use        = current_time;
   data->dirty           = FALSE;
+  data->room            = NULL;
+  data->lru_prev        = NULL;
+  data->lru_next        = NULL;
   return data;
 }
 
 void deletePersistentData(PERSISTENT_DATA *data) {
+  persistent_lru_unlink(data);
   free(data);
 }
 
 void persistentDataCopyTo(PERSISTENT_DATA *from, PERSISTENT_DATA *to) {
-  *to = *from;
+  // our place in the list belongs to our room, not to whatever we copy
+  to->dirty      = from->dirty;
+  to->persistent = from->persistent;
+  to->activity   = from->activity;
+  to->last_use   = from->last_use;
 }
 
 PERSISTENT_DATA *persistentDataCopy(PERSISTENT_DATA *data) {
@@ -89,6 +114,50 @@ LIST *p_to_save = NULL; // our list of persistent rooms to save to disk
 // at 1 million rooms, this should mean 1000000 / (64 * 64) = 244 files/folder
 #define WORLD_BINS 64
 
+// loaded persistent rooms, most recently used first
+PERSISTENT_DATA *lru_head = NULL;
+PERSISTENT_DATA *lru_tail = NULL;
+int              lru_size = 0;
+
+// how many persistent rooms we try to keep loaded at most, and how many
+// seconds a room must go unused before it can be unloaded to stay under that
+MUD_SETTING *room_budget_setting = NULL;
+MUD_SETTING   *room_idle_setting = NULL;
+#define DFLT_PERSISTENT_ROOM_BUDGET   10000
+#define DFLT_PERSISTENT_ROOM_IDLE        60
+
+// the most rooms we'll look at for unloading each pulse, so a big drop in the
+// budget doesn't stall the game
+#define PERSISTENT_UNLOADS_PER_PULSE     20
+
+//
+// take a room's persistent data out of the list of loaded rooms
+void persistent_lru_unlink(PERSISTENT_DATA *data) {
+  if(data->room == NULL)
+    return;
+  if(data->lru_prev) data->lru_prev->lru_next = data->lru_next;
+  else               lru_head                 = data->lru_next;
+  if(data->lru_next) data->lru_next->lru_prev = data->lru_prev;
+  else               lru_tail                 = data->lru_prev;
+  data->lru_prev = data->lru_next = NULL;
+  data->room     = NULL;
+  lru_size--;
+}
+
+//
+// put a room at the front of the list of loaded rooms, adding it if it is
+// not there already
+void persistent_lru_push(ROOM_DATA *room, PERSISTENT_DATA *data) {
+  persistent_lru_unlink(data);
+  data->room     = room;
+  data->lru_prev = NULL;
+  data->lru_next = lru_head;
+  if(lru_head) lru_head->lru_prev = data;
+  else         lru_tail           = data;
+  lru_head = data;
+  lru_size++;
+}
+
 
 
 //*****************************************************************************
@@ -106,6 +175,7 @@ bool persistentRoomExists(WORLD_DATA *world, const char *key) {
 	  pearson_hash8_2(key) % WORLD_BINS,
 	  key);
 
+  storage_writer_sync(fname);
   return file_exists(fname);
 }
 
@@ -124,8 +194,7 @@ void worldClearPersistentRoom(WORLD_DATA *world, const char *key) {
 	  key);
   // log_string("Clearing persistent room, %s", key);
 
-  if(file_exists(fname))
-    unlink(fname);
+  storage_remove_later(fname);
 }
 
 //
@@ -133,35 +202,19 @@ void worldClearPersistentRoom(WORLD_DATA *world, const char *key) {
 void worldStorePersistentRoom(WORLD_DATA *world, const char *key,
 			      ROOM_DATA *room) {
   static char fname[MAX_BUFFER];
-  static char  dir1[SMALL_BUFFER];
-  static char  dir2[SMALL_BUFFER];
   if(!*key)
     return;
 
-  unsigned long hash1 = pearson_hash8_1(key) % WORLD_BINS;
-  unsigned long hash2 = pearson_hash8_2(key) % WORLD_BINS;
   *fname = '\0';
-  *dir1  = '\0';
-  *dir2  = '\0';
-
-  // make sure our hash bins exist
-  sprintf(dir1, "%s/persistent/%lu", 
-	  worldGetPath(world), hash1);
-  if(!dir_exists(dir1))
-    mkdir(dir1, S_IRWXU | S_IRWXG);
-
-  // and the second one as well
-  sprintf(dir2, "%s/persistent/%lu/%lu", 
-	  worldGetPath(world), hash1, hash2);
-  if(!dir_exists(dir2))
-    mkdir(dir2, S_IRWXU | S_IRWXG);
-
-  // now, store the room
   sprintf(fname, "%s/persistent/%lu/%lu/%s", 
-	  worldGetPath(world), hash1, hash2, key);
-  STORAGE_SET *set = roomStore(room);
-  storage_write(set, fname);
-  storage_close(set);
+	  worldGetPath(world),
+	  pearson_hash8_1(key) % WORLD_BINS, 
+	  pearson_hash8_2(key) % WORLD_BINS,
+	  key);
+
+  // take a snapshot of the room now, and let the background writer put it on
+  // disk. It makes our hash bins if they don't exist yet
+  storage_write_later(roomStore(room), fname);
 
   // log_string("stored persistent room :: %s", fname);
 }
@@ -185,6 +238,7 @@ ROOM_DATA *worldGetPersistentRoom(WORLD_DATA *world, const char *key) {
 	  pearson_hash8_2(key) % WORLD_BINS,
 	  key);
 
+  storage_writer_sync(fname);
   if(!file_exists(fname))
     return NULL;
   else {
@@ -206,6 +260,8 @@ ROOM_DATA *worldGetPersistentRoom(WORLD_DATA *world, const char *key) {
 void roomUpdateLastUse(ROOM_DATA *room) {
   PERSISTENT_DATA *data = roomGetAuxiliaryData(room, "persistent_data");
   data->last_use = current_time;
+  if(data->room != NULL && lru_head != data)
+    persistent_lru_push(room, data);
 }
 
 time_t roomGetLastUse(ROOM_DATA *room) {
@@ -217,8 +273,16 @@ void roomSetPersistent(ROOM_DATA *room, bool val) {
   PERSISTENT_DATA *data = roomGetAuxiliaryData(room, "persistent_data");
 
   // if it was persistent before and not now, clear our database entry
-  if(data->persistent == TRUE && val == FALSE)
+  if(data->persistent == TRUE && val == FALSE) {
     worldClearPersistentRoom(gameworld, roomGetClass(room));
+    persistent_lru_unlink(data);
+  }
+  // if we're already in the game, we can be unloaded from now on. If not,
+  // we'll be added to the list when we enter it
+  else if(data->persistent == FALSE && val == TRUE && !roomIsExtracted(room) &&
+	  worldRoomLoaded(gameworld, roomGetClass(room)) &&
+	  worldGetRoom(gameworld, roomGetClass(room)) == room)
+    persistent_lru_push(room, data);
 
   data->persistent = val;
 }
@@ -257,6 +321,38 @@ void roomAddActivity(ROOM_DATA *room) {
   //***********
 }
 
+//
+// save a persistent room to disk and take it out of the game. Returns FALSE,
+// and does nothing, if the room is not persistent or a PC is in it
+bool persistentRoomUnload(ROOM_DATA *room) {
+  if(!roomIsPersistent(room))
+    return FALSE;
+
+  // does it contain a PC?
+  LIST_ITERATOR *ch_i = newListIterator(roomGetCharacters(room));
+  CHAR_DATA       *ch = NULL;
+  bool       pc_found = FALSE;
+  ITERATE_LIST(ch, ch_i) {
+    if(!charIsNPC(ch)) {
+      pc_found = TRUE;
+      break;
+    }
+  } deleteListIterator(ch_i);
+
+  if(pc_found)
+    return FALSE;
+
+  // we're being saved right now, so don't bother saving us again later
+  if(roomIsPersistentDirty(room)) {
+    listRemove(p_to_save, room);
+    roomClearPersistentDirty(room);
+  }
+  worldStorePersistentRoom(gameworld, roomGetClass(room), room);
+  persistent_lru_unlink(roomGetAuxiliaryData(room, "persistent_data"));
+  extract_room(room);
+  return TRUE;
+}
+
 void roomRemoveActivity(ROOM_DATA *room) {
   PERSISTENT_DATA *data = roomGetAuxiliaryData(room, "persistent_data");
   data->activity--;
@@ -303,25 +399,9 @@ PyObject *PyRoom_unloadPersistence(PyObject *pyroom) {
     return NULL;
   }
 
-  // it's not pesistent
-  if(!roomIsPersistent(room))
+  // it's not pesistent, or it contains a PC
+  if(!persistentRoomUnload(room))
     return Py_BuildValue("i", 0);
-
-  // does it contain a PC?
-  LIST_ITERATOR *ch_i = newListIterator(roomGetCharacters(room));
-  CHAR_DATA       *ch = NULL;
-  bool       pc_found = FALSE;
-  ITERATE_LIST(ch, ch_i) {
-    if(!charIsNPC(ch)) {
-      pc_found = TRUE;
-      break;
-    }
-  } deleteListIterator(ch_i);
-
-  if(pc_found)
-    return Py_BuildValue("i", 0);
-  worldStorePersistentRoom(gameworld, roomGetClass(room), room);
-  extract_room(room);
   return Py_BuildValue("");
 }
 
@@ -350,10 +430,10 @@ int PyRoom_setpersistent(PyObject *self, PyObject *arg) {
 //*****************************************************************************
 // hooks
 //*****************************************************************************
-void update_persistent_char_to_room(const char *info) {
+void update_persistent_char_to_room(HOOK_ARGS *args) {
   CHAR_DATA   *ch = NULL;
   ROOM_DATA *room = NULL;
-  hookParseInfo(info, &ch, &room);
+  hookArgsParse(args, &ch, &room);
   if(!charIsNPC(ch))
     roomUpdateLastUse(room);
   if(charIsNPC(ch) && roomIsPersistent(room) && !roomIsExtracted(room) &&
@@ -363,10 +443,10 @@ void update_persistent_char_to_room(const char *info) {
   }
 }
 
-void update_persistent_char_from_room(const char *info) {
+void update_persistent_char_from_room(HOOK_ARGS *args) {
   CHAR_DATA   *ch = NULL;
   ROOM_DATA *room = NULL;
-  hookParseInfo(info, &ch, &room);
+  hookArgsParse(args, &ch, &room);
   if(charIsNPC(ch) && roomIsPersistent(room) && !roomIsExtracted(room) && 
      !roomIsPersistentDirty(room)) {
     listPut(p_to_save, room);
@@ -374,10 +454,11 @@ void update_persistent_char_from_room(const char *info) {
   }
 }
 
-void update_persistent_obj_to_room(const char *info) {
+void update_persistent_obj_to_room(HOOK_ARGS *args) {
   OBJ_DATA   *obj = NULL;
   ROOM_DATA *room = NULL;
-  hookParseInfo(info, &obj, &room);
+  hookArgsParse(args, &obj, &room);
+  roomUpdateLastUse(room);
   if(roomIsPersistent(room) && !roomIsExtracted(room) &&
      !roomIsPersistentDirty(room)) {
     listPut(p_to_save, room);
@@ -385,10 +466,10 @@ void update_persistent_obj_to_room(const char *info) {
   }
 }
 
-void update_persistent_obj_from_room(const char *info) {
+void update_persistent_obj_from_room(HOOK_ARGS *args) {
   OBJ_DATA   *obj = NULL;
   ROOM_DATA *room = NULL;
-  hookParseInfo(info, &obj, &room);
+  hookArgsParse(args, &obj, &room);
   if(roomIsPersistent(room)&& !roomIsExtracted(room)&&
      !roomIsPersistentDirty(room)) {
     listPut(p_to_save, room);
@@ -396,11 +477,11 @@ void update_persistent_obj_from_room(const char *info) {
   }
 }
 
-void update_persistent_obj_from_obj(const char *info) {
+void update_persistent_obj_from_obj(HOOK_ARGS *args) {
   OBJ_DATA       *obj = NULL;
   OBJ_DATA *container = NULL;
   ROOM_DATA     *root = NULL;
-  hookParseInfo(info, &obj, &container);
+  hookArgsParse(args, &obj, &container);
   if(container == NULL || obj == NULL)
     return;
 
@@ -415,11 +496,11 @@ void update_persistent_obj_from_obj(const char *info) {
   }
 }
 
-void update_persistent_obj_to_obj(const char *info) {
+void update_persistent_obj_to_obj(HOOK_ARGS *args) {
   OBJ_DATA       *obj = NULL;
   OBJ_DATA *container = NULL;
   ROOM_DATA     *root = NULL;
-  hookParseInfo(info, &obj, &container);
+  hookArgsParse(args, &obj, &container);
   if(container == NULL || obj == NULL)
     return;
 
@@ -434,20 +515,32 @@ void update_persistent_obj_to_obj(const char *info) {
   }
 }
 
-void update_persistent_room_from_game(const char *info) {
+void update_persistent_room_to_game(HOOK_ARGS *args) {
   ROOM_DATA *room = NULL;
-  hookParseInfo(info, &room);
-  listRemove(p_to_save, room);
+  hookArgsParse(args, &room);
+  if(roomIsPersistent(room))
+    persistent_lru_push(room, roomGetAuxiliaryData(room, "persistent_data"));
+}
 
-  // have we been replaced by a non-persistent room?
-  ROOM_DATA *new_room = worldGetRoom(gameworld, roomGetClass(room));
+void update_persistent_room_from_game(HOOK_ARGS *args) {
+  ROOM_DATA *room = NULL;
+  hookArgsParse(args, &room);
+  listRemove(p_to_save, room);
+  persistent_lru_unlink(roomGetAuxiliaryData(room, "persistent_data"));
+
+  // have we been replaced by a non-persistent room? Only look at what's
+  // loaded; worldGetRoom would load us right back up off of disk if we were
+  // just unloaded
+  ROOM_DATA *new_room = NULL;
+  if(worldRoomLoaded(gameworld, roomGetClass(room)))
+    new_room = worldGetRoom(gameworld, roomGetClass(room));
   if(roomIsPersistent(room) && new_room != NULL && !roomIsPersistent(new_room))
     worldClearPersistentRoom(gameworld, roomGetClass(room));
 }
 
-void update_persistent_room_change(const char *info) {
+void update_persistent_room_change(HOOK_ARGS *args) {
   ROOM_DATA *room = NULL;
-  hookParseInfo(info, &room);
+  hookArgsParse(args, &room);
   if(roomIsPersistent(room) && !roomIsExtracted(room) &&
      !roomIsPersistentDirty(room)) {
     listPut(p_to_save, room);
@@ -466,39 +559,38 @@ void update_persistent_room_change(const char *info) {
 void flush_persistent_rooms_event(void *owner, void *data, const char *arg) {
   ROOM_DATA *room = NULL;
   while( (room = listPop(p_to_save)) != NULL) {
-    worldStorePersistentRoom(gameworld, roomGetClass(room), room);
+    // extracted rooms have already been emptied out. If they were unloaded,
+    // they were stored before that happened
+    if(!roomIsExtracted(room))
+      worldStorePersistentRoom(gameworld, roomGetClass(room), room);
     roomClearPersistentDirty(room);
   }
 }
 
 //
-// every pulse, randomly sample our room table. If we find a persistent
-// room that hasn't been active for awhile, unload it to disk so we aren't
-// hogging up memory usage with a ton of unused rooms. Notably, this function
-// kind of sucks because rooms get their UIDs from the same pool as objects
-// and characters. That means a randomly generated UID is not always a room
-// uid. It may also select room UIDs that have already been unloaded. What we
-// really want to do is just sample a room from a known set of existing rooms.
-// 
-// This function has been disabled until it is improved a little.
-//
+// every pulse, if we have more persistent rooms loaded than our budget
+// allows, unload the ones that have gone unused the longest so we aren't
+// hogging up memory with a ton of unused rooms. Rooms with activity going on
+// in them, or PCs in them, are kept around and count as just having been used
 void close_unused_rooms_event(void *owner, void *unused, const char *arg) {
-  int top = top_uid();
-  if(top == NOTHING)
-    return;
-
-  // randomly sample from the room table
-  int  uid_to_try = (rand() % (top - START_UID)) + START_UID;
-  ROOM_DATA *room = propertyTableGet(room_table, uid_to_try);
-  if(room == NULL)
-    return;
-
-  PERSISTENT_DATA *data = roomGetAuxiliaryData(room, "persistent_data");
-
-  // we've been inactive for more than 15 minutes, unload us
-  if(data->persistent && data->activity == 0 && 
-     difftime(current_time, roomGetLastUse(room)) > 60 * 15)
-    extract_room(room);
+  int budget = mudsettingHandleInt(room_budget_setting);
+  int   idle = mudsettingHandleInt(room_idle_setting);
+  int  tries = 0;
+
+  while(budget > 0 && lru_size > budget &&
+	tries++ < PERSISTENT_UNLOADS_PER_PULSE) {
+    PERSISTENT_DATA *data = lru_tail;
+    ROOM_DATA       *room = data->room;
+
+    // already on its way out
+    if(roomIsExtracted(room))
+      persistent_lru_unlink(data);
+    // everything else has been used even more recently than this
+    else if(difftime(current_time, data->last_use) < idle)
+      break;
+    else if(data->activity > 0 || !persistentRoomUnload(room))
+      roomUpdateLastUse(room);
+  }
 }
 
 
@@ -518,21 +610,29 @@ void init_persistent(void) {
   // start our flushing of persistent rooms that need to be saved
   start_update(NULL, 1, flush_persistent_rooms_event, NULL,NULL,NULL);
 
-  //
-  // disabled until a better implementation is written.
-  //
-  // start_update(NULL, 1, close_unused_rooms_event,     NULL,NULL,NULL);
+  // make sure we have a budget for how many persistent rooms can be loaded,
+  // if one hasn't been set. 0 is a budget too: it means there is no limit
+  room_budget_setting = mudsettingGetHandle("persistent_room_budget");
+  room_idle_setting   = mudsettingGetHandle("persistent_room_idle");
+  if(!*mudsettingGetString("persistent_room_budget"))
+    mudsettingSetInt("persistent_room_budget", DFLT_PERSISTENT_ROOM_BUDGET);
+  if(!*mudsettingGetString("persistent_room_idle"))
+    mudsettingSetInt("persistent_room_idle", DFLT_PERSISTENT_ROOM_IDLE);
+
+  // and unload the ones we haven't used in a while when we go over it
+  start_update(NULL, 1, close_unused_rooms_event,     NULL,NULL,NULL);
 
   // listen for objects and characters entering 
   // or leaving rooms. Update those rooms' statuses
-  hookAdd("char_to_room",   update_persistent_char_to_room);
-  hookAdd("char_from_room", update_persistent_char_from_room);
-  hookAdd("obj_to_room",    update_persistent_obj_to_room);
-  hookAdd("obj_from_room",  update_persistent_obj_from_room);
-  hookAdd("obj_from_obj",   update_persistent_obj_from_obj);
-  hookAdd("obj_to_obj",     update_persistent_obj_to_obj);
-  hookAdd("room_from_game", update_persistent_room_from_game);
-  hookAdd("room_change",    update_persistent_room_change);
+  hookAddTyped("char_to_room",   update_persistent_char_to_room);
+  hookAddTyped("char_from_room", update_persistent_char_from_room);
+  hookAddTyped("obj_to_room",    update_persistent_obj_to_room);
+  hookAddTyped("obj_from_room",  update_persistent_obj_from_room);
+  hookAddTyped("obj_from_obj",   update_persistent_obj_from_obj);
+  hookAddTyped("obj_to_obj",     update_persistent_obj_to_obj);
+  hookAddTyped("room_to_game",   update_persistent_room_to_game);
+  hookAddTyped("room_from_game", update_persistent_room_from_game);
+  hookAddTyped("room_change",    update_persistent_room_change);
   
   // add accessibility to Python
   /*
@@ -40,4 +40,9 @@ void worldStorePersistentRoom(WORLD_DATA *world, const char *key,
 // return whether a persistent room of the given name exists
 bool persistentRoomExists(WORLD_DATA *world, const char *key);
 
+//
+// save a persistent room to disk and take it out of the game. Returns FALSE,
+// and does nothing, if the room is not persistent or a PC is in it
+bool persistentRoomUnload(ROOM_DATA *room);
+
 #endif // PERSISTENT_H
@@ -143,12 +143,13 @@ bool protoRunAs(PROTO_DATA *proto, const char *type, const char *as,
 		void *me) {
   // parse and run all of our parents
   LIST           *parents = parse_keywords(proto->parents);
-  LIST_ITERATOR *parent_i = newListIterator(parents);
+  LIST_ITERATOR parent_i;
+  listIteratorStart(&parent_i, parents);
   char        *one_parent = NULL;
   bool         parents_ok = TRUE;
 
   // try to run each parent
-  ITERATE_LIST(one_parent, parent_i) {
+  ITERATE_LIST(one_parent, &parent_i) {
     PROTO_DATA *parent = NULL;
     // does our parent have a locale? If so, find it. If not, use ours
     int separator_pos = next_letter_in(one_parent, '@');
@@ -169,7 +170,7 @@ bool protoRunAs(PROTO_DATA *proto, const char *type, const char *as,
     // if we had a problem running the proto, report it
     if(parents_ok == FALSE)
       break;
-  } deleteListIterator(parent_i);
+  } listIteratorStop(&parent_i);
 
   // do garbage collection for our parent list
   deleteListWith(parents, free);
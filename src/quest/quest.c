@@ -734,7 +734,7 @@ void charAdvanceQuest(CHAR_DATA *ch, QUEST_DATA *quest) {
       listQueue(data->completed, strdupsafe(questGetKey(quest)));
       send_to_char(ch, "{pYou complete the quest, %s{n\r\n", 
 		   questGetName(quest));
-      hookRun("complete_quest", hookBuildInfo("ch str", ch,questGetKey(quest)));
+      hookRunTyped("complete_quest", "ch str", ch,questGetKey(quest));
     }
     else {
       QUEST_PROGRESS *newprog = newQuestProgress();
@@ -742,7 +742,7 @@ void charAdvanceQuest(CHAR_DATA *ch, QUEST_DATA *quest) {
       hashPut(data->quests, questGetKey(quest), newprog);
       send_to_char(ch, "{pYou advance on the quest, %s{n\r\n", 
 		   questGetName(quest));
-      hookRun("advance_quest", hookBuildInfo("ch str", ch, questGetKey(quest)));
+      hookRunTyped("advance_quest", "ch str", ch, questGetKey(quest));
     }
 
     // free up our old progress data
@@ -1179,10 +1179,10 @@ COMMAND(cmd_qcancel) {
 //
 // whenever we kill something, see if it increases our progress on one of
 // our current quests
-void quest_kill_hook(const char *info) {
+void quest_kill_hook(HOOK_ARGS *args) {
   CHAR_DATA   *ch = NULL;
   CHAR_DATA *vict = NULL;
-  hookParseInfo(info, &ch, &vict);
+  hookArgsParse(args, &ch, &vict);
 
   LIST           *obs = charGetQuestObjectives(ch);
   LIST_ITERATOR *ob_i = newListIterator(obs);
@@ -1215,10 +1215,10 @@ void quest_kill_hook(const char *info) {
 //
 // whenever we greet someone, see if it increases our progress on one of
 // our current quests
-void quest_greet_hook(const char *info) {
+void quest_greet_hook(HOOK_ARGS *args) {
   CHAR_DATA   *ch = NULL;
   CHAR_DATA  *tgt = NULL;
-  hookParseInfo(info, &ch, &tgt);
+  hookArgsParse(args, &ch, &tgt);
 
   LIST           *obs = charGetQuestObjectives(ch);
   LIST_ITERATOR *ob_i = newListIterator(obs);
@@ -1248,11 +1248,11 @@ void quest_greet_hook(const char *info) {
 
 //
 // whenever we give an object to someone, see if it advances any of our quests
-void quest_give_hook(const char *info) {
+void quest_give_hook(HOOK_ARGS *args) {
   CHAR_DATA   *ch = NULL;
   CHAR_DATA *recv = NULL;
   OBJ_DATA   *obj = NULL;
-  hookParseInfo(info, &ch, &recv, &obj);
+  hookArgsParse(args, &ch, &recv, &obj);
 
   LIST           *obs = charGetQuestObjectives(ch);
   LIST_ITERATOR *ob_i = newListIterator(obs);
@@ -1586,9 +1586,9 @@ void init_quests(void) {
   PyChar_addMethod("quest_fail",     PyChar_FailQuest,      METH_VARARGS, NULL);
 
   // attach hooks
-  hookAdd("post_death", quest_kill_hook);
-  hookAdd("give",       quest_give_hook);
-  hookAdd("greet",      quest_greet_hook);
+  hookAddTyped("post_death", quest_kill_hook);
+  hookAddTyped("give",       quest_give_hook);
+  hookAddTyped("greet",      quest_greet_hook);
 
   // add our functions for handling objective types
   hashPut(ob_type_table, "kill", 
@@ -169,13 +169,14 @@ STORAGE_SET *roomStore(ROOM_DATA *room) {
 
   // store all of our characters
   if(listSize(roomGetCharacters(room)) > 0) {
-    LIST_ITERATOR      *ch_i = newListIterator(roomGetCharacters(room));
+    LIST_ITERATOR ch_i;
+    listIteratorStart(&ch_i, roomGetCharacters(room));
     CHAR_DATA            *ch = NULL;
     STORAGE_SET_LIST *chlist = new_storage_list();
-    ITERATE_LIST(ch, ch_i) {
+    ITERATE_LIST(ch, &ch_i) {
       if(charIsNPC(ch))
 	storage_list_put(chlist, charStore(ch));
-    } deleteListIterator(ch_i);
+    } listIteratorStop(&ch_i);
     store_list(set, "chars", chlist);
   }
 
@@ -215,10 +216,11 @@ ROOM_DATA *roomRead(STORAGE_SET *set) {
     deleteList(room->characters);
     room->characters    = gen_read_list(read_list(set, "chars"), charRead);
     CHAR_DATA       *ch = NULL;
-    LIST_ITERATOR *ch_i = newListIterator(room->characters);
-    ITERATE_LIST(ch, ch_i) {
+    LIST_ITERATOR ch_i;
+    listIteratorStart(&ch_i, room->characters);
+    ITERATE_LIST(ch, &ch_i) {
       charSetRoom(ch, room);
-    } deleteListIterator(ch_i);
+    } listIteratorStop(&ch_i);
   }
 
   // and all of our objects
@@ -226,10 +228,11 @@ ROOM_DATA *roomRead(STORAGE_SET *set) {
     deleteList(room->contents);
     room->contents = gen_read_list(read_list(set, "objs"), objRead);
     OBJ_DATA        *obj = NULL;
-    LIST_ITERATOR *obj_i = newListIterator(room->contents);
-    ITERATE_LIST(obj, obj_i) {
+    LIST_ITERATOR obj_i;
+    listIteratorStart(&obj_i, room->contents);
+    ITERATE_LIST(obj, &obj_i) {
       objSetRoom(obj, room);
-    } deleteListIterator(obj_i);
+    } listIteratorStop(&obj_i);
   }
 
   return room;
@@ -320,11 +320,12 @@ bool resetRun(RESET_DATA *reset, void *initiator, int initiator_type,
 void resetRunOn(LIST *list, void *initiator, int initiator_type, 
 		const char *locale) {
   if(listSize(list) > 0) {
-    LIST_ITERATOR *list_i = newListIterator(list);
+    LIST_ITERATOR list_i;
+    listIteratorStart(&list_i, list);
     RESET_DATA     *reset = NULL;
-    ITERATE_LIST(reset, list_i)
+    ITERATE_LIST(reset, &list_i)
       resetRun(reset, initiator, initiator_type, locale);
-    deleteListIterator(list_i);
+    listIteratorStop(&list_i);
   }
 }
 
@@ -340,8 +341,7 @@ bool try_reset_load_object(RESET_DATA *reset, void *initiator,
 
   // see if we're already at our max
   if(resetGetMax(reset) != 0 && 
-     count_objs(NULL, object_list, NULL, fullkey, FALSE) >= 
-     resetGetMax(reset))
+     count_obj_instances(fullkey) >= resetGetMax(reset))
     return FALSE;
   if(initiator_type == INITIATOR_ROOM && resetGetRoomMax(reset) != 0 &&
      (count_objs(NULL, roomGetContents(initiator), NULL, fullkey,
@@ -422,7 +422,7 @@ bool try_reset_load_mobile(RESET_DATA *reset, void *initiator,
 
   // see if we're already at our max
   if(resetGetMax(reset) != 0 && 
-     count_chars(NULL, mobile_list, NULL, fullkey, FALSE) >= resetGetMax(reset))
+     count_char_instances(fullkey) >= resetGetMax(reset))
     return FALSE;
   if(initiator_type == INITIATOR_ROOM && resetGetRoomMax(reset) != 0 &&
      (count_chars(NULL, roomGetCharacters(initiator), NULL, fullkey,
@@ -758,24 +758,25 @@ bool resetRun(RESET_DATA *reset, void *initiator, int initiator_type,
 void do_resets(ROOM_DATA *room) {
   // first apply all of our prototype resets
   LIST            *protos = parse_keywords(roomGetPrototypes(room));
-  LIST_ITERATOR  *proto_i = newListIterator(protos);
+  LIST_ITERATOR proto_i;
+  listIteratorStart(&proto_i, protos);
   char             *proto = NULL;
   RESET_LIST        *list = NULL;
 
   // try to run each parent reset, and finally our own
-  ITERATE_LIST(proto, proto_i) {
+  ITERATE_LIST(proto, &proto_i) {
     if((list = worldGetType(gameworld, "reset", proto)) != NULL)
       resetRunOn(resetListGetResets(list), room, INITIATOR_ROOM, get_key_locale(proto));
-  } deleteListIterator(proto_i);
+  } listIteratorStop(&proto_i);
   deleteListWith(protos, free);
 }
 
 //
 // room reset hook. Whenever a room is reset, apply all of the reset rules for
 // it and its parent.
-void room_reset_hook(const char *info) {
+void room_reset_hook(HOOK_ARGS *args) {
   ROOM_DATA *room = NULL;
-  hookParseInfo(info, &room);
+  hookArgsParse(args, &room);
   if(room != NULL)
     do_resets(room);
 }
@@ -783,26 +784,24 @@ void room_reset_hook(const char *info) {
 //
 // zone reset hook. Whenever a zone is reset, apply all of its reset rules for
 // each room in the zone.
-void zone_reset_hook(const char *info) {
-  char  *zone_key = NULL;
-  hookParseInfo(info, &zone_key);
+void zone_reset_hook(HOOK_ARGS *args) {
+  const char *zone_key = NULL;
+  hookArgsParse(args, &zone_key);
   ZONE_DATA *zone = worldGetZone(gameworld, zone_key);
 
-  LIST_ITERATOR *res_i = newListIterator(zoneGetResettable(zone));
+  LIST_ITERATOR res_i;
+  listIteratorStart(&res_i, zoneGetResettable(zone));
   char           *name = NULL;
   const char   *locale = zone_key;
   ROOM_DATA      *room = NULL;
-  ITERATE_LIST(name, res_i) {
+  ITERATE_LIST(name, &res_i) {
     if((room = worldGetRoom(gameworld, get_fullkey(name, locale))) != NULL) {
       do_resets(room);
     }
-  } deleteListIterator(res_i);
-
-  // garbage collection
-  free(zone_key);
+  } listIteratorStop(&res_i);
 }
 
 void init_room_reset(void) {
-  hookAdd("reset_zone", zone_reset_hook);
-  hookAdd("reset_room", room_reset_hook);
+  hookAddTyped("reset_zone", zone_reset_hook);
+  hookAddTyped("reset_room", room_reset_hook);
 }
@@ -19,6 +19,7 @@
 #include "room.h"
 #include "storage.h"
 #include "save.h"
+#include "storage_writer.h"
 
 
 
@@ -128,23 +129,25 @@ bool player_exists(const char *name) {
   // a character with that name, or there is a character with that name in
   // storage. We'll check both of these.
   const char *fname = get_save_filename(name, FILETYPE_PFILE);
+  storage_writer_sync(fname);
   return file_exists(fname);
 }
 
 bool account_exists(const char *name) {
   const char *fname = get_save_filename(name, FILETYPE_ACCOUNT);
+  storage_writer_sync(fname);
   return file_exists(fname);
 }
 
 void save_pfile(CHAR_DATA *ch) {
   STORAGE_SET *set = charStore(ch);
-  storage_write(set, get_save_filename(charGetName(ch), FILETYPE_PFILE));
-  storage_close(set);
+  storage_write_later(set, get_save_filename(charGetName(ch), FILETYPE_PFILE));
 }
 
 void load_ofile(CHAR_DATA *ch) {
-  STORAGE_SET *set = storage_read(get_save_filename(charGetName(ch), 
-						    FILETYPE_OFILE));
+  const char *fname = get_save_filename(charGetName(ch), FILETYPE_OFILE);
+  storage_writer_sync(fname);
+  STORAGE_SET *set = storage_read(fname);
   if(set == NULL)
     return;
 
@@ -190,12 +193,13 @@ void save_objfile(CHAR_DATA *ch) {
   deleteList(eq_list);
 
   store_list(set, "equipment", list);
-  storage_write(set, get_save_filename(charGetName(ch), FILETYPE_OFILE));
-  storage_close(set);
+  storage_write_later(set, get_save_filename(charGetName(ch), FILETYPE_OFILE));
 }
 
 CHAR_DATA *load_player(const char *player) {
-  STORAGE_SET *set = storage_read(get_save_filename(player, FILETYPE_PFILE));
+  const char *fname = get_save_filename(player, FILETYPE_PFILE);
+  storage_writer_sync(fname);
+  STORAGE_SET *set = storage_read(fname);
   if(set == NULL)
     return NULL;
   else {
@@ -207,8 +211,9 @@ CHAR_DATA *load_player(const char *player) {
 }
 
 ACCOUNT_DATA *load_account(const char *account) {
-  STORAGE_SET   *set = storage_read(get_save_filename(account,
-						      FILETYPE_ACCOUNT));
+  const char  *fname = get_save_filename(account, FILETYPE_ACCOUNT);
+  storage_writer_sync(fname);
+  STORAGE_SET   *set = storage_read(fname);
   if(set == NULL)
     return NULL;
   else {
@@ -341,9 +346,8 @@ void register_player(CHAR_DATA *ch) {
 void save_account(ACCOUNT_DATA *account) {
   if(!account) return;
   STORAGE_SET *set = accountStore(account);
-  storage_write(set, get_save_filename(accountGetName(account),
-				       FILETYPE_ACCOUNT));
-  storage_close(set);
+  storage_write_later(set, get_save_filename(accountGetName(account),
+					     FILETYPE_ACCOUNT));
 }
 
 void save_player(CHAR_DATA *ch) {
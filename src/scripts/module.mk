@@ -111,6 +111,7 @@ SRC  += scripts/scripts.c       \
 	scripts/pyplugs.c       \
 	scripts/pyevent.c       \
 	scripts/pystorage.c     \
+	scripts/pylistview.c    \
 	scripts/pyauxiliary.c   \
 	scripts/triggers.c      \
 	scripts/trigedit.c      \
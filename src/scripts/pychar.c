@@ -34,6 +34,7 @@
 #include "pyaccount.h"
 #include "pyauxiliary.h"
 #include "pystorage.h"
+#include "pylistview.h"
 
 
 
@@ -58,6 +59,8 @@ LIST *pychar_methods = NULL;
 typedef struct {
   PyObject_HEAD
   int uid;
+  CHAR_DATA *ch; // what uid was when we last looked it up, or NULL.
+  int generation; // mob_table's generation then; if it changes, look it up again
 } PyChar;
 
 
@@ -88,13 +91,14 @@ int PyChar_init(PyChar *self, PyObject *args, PyObject *kwds) {
   }
 
   // make sure a character with the UID exists
-  if(!propertyTableGet(mob_table, uid)) {
+  if(!uidTableGet(mob_table, uid)) {
     PyErr_Format(PyExc_TypeError, 
                     "Character with uid, %d, does not exist", uid);
     return -1;
   }
 
   self->uid = uid;
+  self->ch  = NULL;
   return 0;
 }
 
@@ -279,22 +283,17 @@ PyObject *PyChar_getclass(PyChar *self, void *closure) {
   else           return NULL;
 }
 
+//
+// the list of objects a character is carrying, for viewing from Python
+LIST *pychar_inv_list(PyObject *self) {
+  CHAR_DATA *ch = PyChar_AsChar(self);
+  return (ch == NULL ? NULL : charGetInventory(ch));
+}
+
 PyObject *PyChar_getinv(PyChar *self, PyObject *args) {
-  CHAR_DATA *ch = PyChar_AsChar((PyObject *)self);
-  if(ch == NULL) 
+  if(PyChar_AsChar((PyObject *)self) == NULL) 
     return NULL;
-
-  LIST_ITERATOR *inv_i = newListIterator(charGetInventory(ch));
-  PyObject *list = PyList_New(0);
-  OBJ_DATA *obj;
-  
-  // for each obj in the inventory, add it to the Python list
-  ITERATE_LIST(obj, inv_i)
-    PyList_Append(list, objGetPyFormBorrowed(obj));
-  deleteListIterator(inv_i);
-  PyObject *retval = Py_BuildValue("O", list);
-  Py_DECREF(list);
-  return retval;
+  return newPyListView((PyObject *)self, pychar_inv_list,objGetPyFormBorrowed);
 }
 
 PyObject *PyChar_geteq(PyChar *self, PyObject *args) {
@@ -304,11 +303,12 @@ PyObject *PyChar_geteq(PyChar *self, PyObject *args) {
 
   PyObject      *list = PyList_New(0);
   LIST      *equipped = bodyGetAllEq(charGetBody(ch));
-  LIST_ITERATOR *eq_i = newListIterator(equipped);
+  LIST_ITERATOR eq_i;
+  listIteratorStart(&eq_i, equipped);
   OBJ_DATA        *eq = NULL;
-  ITERATE_LIST(eq, eq_i) {
+  ITERATE_LIST(eq, &eq_i) {
     PyList_Append(list, objGetPyFormBorrowed(eq));
-  } deleteListIterator(eq_i);
+  } listIteratorStop(&eq_i);
   PyObject *retval = Py_BuildValue("O", list);
   Py_DECREF(list);
   deleteList(equipped);
@@ -358,11 +358,11 @@ PyObject *PyChar_getsocket(PyChar *self, void *closure) {
 // Standard check to make sure the character exists when
 // trying to set a value for it. If successful, assign the
 // character to ch. Otherwise, return -1 (error)
-#define PYCHAR_CHECK_CHAR_EXISTS(uid, ch)                                      \
-  ch = propertyTableGet(mob_table, uid);                                       \
+#define PYCHAR_CHECK_CHAR_EXISTS(self, ch)                                     \
+  ch = PyChar_AsChar((PyObject *)self);                                        \
   if(ch == NULL) {                                                             \
     PyErr_Format(PyExc_TypeError,                                              \
-		    "Tried to modify nonexistant character, %d", uid);         \
+		    "Tried to modify nonexistant character, %d", (self)->uid); \
     return -1;                                                                 \
   }                                                                            
 
@@ -379,7 +379,7 @@ int PyChar_setname(PyChar *self, PyObject *value, void *closure) {
   }
 
   CHAR_DATA *ch;
-  PYCHAR_CHECK_CHAR_EXISTS(self->uid, ch);
+  PYCHAR_CHECK_CHAR_EXISTS(self, ch);
   charSetName(ch, PyString_AsString(value));
   return 0;
 }
@@ -396,20 +396,21 @@ int PyChar_setkeywords(PyChar *self, PyObject *value, void *closure) {
   }
 
   CHAR_DATA *ch;
-  PYCHAR_CHECK_CHAR_EXISTS(self->uid, ch);
+  PYCHAR_CHECK_CHAR_EXISTS(self, ch);
 
   // clean up empty keywords, and rebuild it
   LIST           *kwds = parse_keywords(PyString_AsString(value));
   BUFFER     *new_kwds = newBuffer(1);
-  LIST_ITERATOR *kwd_i = newListIterator(kwds);
+  LIST_ITERATOR kwd_i;
+  listIteratorStart(&kwd_i, kwds);
   char            *kwd = NULL;
 
-  ITERATE_LIST(kwd, kwd_i) {
+  ITERATE_LIST(kwd, &kwd_i) {
     // if we already have content, add a comma
     if(bufferLength(new_kwds) > 0)
       bufferCat(new_kwds, ", ");
     bufferCat(new_kwds, kwd);
-  } deleteListIterator(kwd_i);
+  } listIteratorStop(&kwd_i);
 
   // set our keywords
   charSetKeywords(ch, bufferString(new_kwds));
@@ -432,7 +433,7 @@ int PyChar_setmname(PyChar *self, PyObject *value, void *closure) {
   }
 
   CHAR_DATA *ch;
-  PYCHAR_CHECK_CHAR_EXISTS(self->uid, ch);
+  PYCHAR_CHECK_CHAR_EXISTS(self, ch);
   charSetMultiName(ch, PyString_AsString(value));
   return 0;
 }
@@ -449,14 +450,14 @@ int PyChar_setdesc(PyChar *self, PyObject *value, void *closure) {
   }
 
   CHAR_DATA *ch;
-  PYCHAR_CHECK_CHAR_EXISTS(self->uid, ch);
+  PYCHAR_CHECK_CHAR_EXISTS(self, ch);
   charSetDesc(ch, PyString_AsString(value));
   return 0;
 }
 
 int PyChar_sethidden(PyObject *self, PyObject *value, void *closure) {
   CHAR_DATA *ch = NULL;
-  PYCHAR_CHECK_CHAR_EXISTS(PyChar_AsUid(self), ch);
+  PYCHAR_CHECK_CHAR_EXISTS((PyChar *)self, ch);
 
   if(value == NULL || value == Py_None)
     charSetHidden(ch, 0);
@@ -474,7 +475,7 @@ int PyChar_sethidden(PyObject *self, PyObject *value, void *closure) {
 
 int PyChar_setweight(PyObject *self, PyObject *value, void *closure) {
   CHAR_DATA *ch = NULL;
-  PYCHAR_CHECK_CHAR_EXISTS(PyChar_AsUid(self), ch);
+  PYCHAR_CHECK_CHAR_EXISTS((PyChar *)self, ch);
 
   if(value == NULL || value == Py_None)
     charSetWeight(ch, 0.0);
@@ -504,7 +505,7 @@ int PyChar_setlookbuf(PyChar *self, PyObject *value, void *closure) {
   }
 
   CHAR_DATA *ch;
-  PYCHAR_CHECK_CHAR_EXISTS(self->uid, ch);
+  PYCHAR_CHECK_CHAR_EXISTS(self, ch);
   bufferClear(charGetLookBuffer(ch));
   bufferCat(charGetLookBuffer(ch), PyString_AsString(value));
   return 0;
@@ -522,7 +523,7 @@ int PyChar_setrdesc(PyChar *self, PyObject *value, void *closure) {
   }
 
   CHAR_DATA *ch;
-  PYCHAR_CHECK_CHAR_EXISTS(self->uid, ch);
+  PYCHAR_CHECK_CHAR_EXISTS(self, ch);
   charSetRdesc(ch, PyString_AsString(value));
   return 0;
 }
@@ -539,7 +540,7 @@ int PyChar_setmdesc(PyChar *self, PyObject *value, void *closure) {
   }
 
   CHAR_DATA *ch;
-  PYCHAR_CHECK_CHAR_EXISTS(self->uid, ch);
+  PYCHAR_CHECK_CHAR_EXISTS(self, ch);
   charSetMultiRdesc(ch, PyString_AsString(value));
   return 0;
 }
@@ -560,7 +561,7 @@ int PyChar_setrace(PyChar *self, PyObject *value, void *closure) {
     return -1;
 
   CHAR_DATA *ch;
-  PYCHAR_CHECK_CHAR_EXISTS(self->uid, ch);
+  PYCHAR_CHECK_CHAR_EXISTS(self, ch);
   charSetRace(ch, race);
   charResetBody(ch);
   return 0;
@@ -573,14 +574,14 @@ int PyChar_seton(PyChar *self, PyObject *value, void *closure) {
   }
 
   CHAR_DATA *ch;
-  PYCHAR_CHECK_CHAR_EXISTS(self->uid, ch);
+  PYCHAR_CHECK_CHAR_EXISTS(self, ch);
 
   if (value == Py_None) {
     char_from_furniture(ch);
     return 0;
   }
   else if(PyObj_Check(value)) {
-    OBJ_DATA *obj = propertyTableGet(obj_table, PyObj_AsUid(value));
+    OBJ_DATA *obj = uidTableGet(obj_table, PyObj_AsUid(value));
     if(obj == NULL) {
       PyErr_Format(PyExc_TypeError, 
 		   "Tried to %s's furniture to a nonexistant object.",
@@ -621,7 +622,7 @@ int PyChar_setsex(PyChar *self, PyObject *value, void *closure) {
   }
 
   CHAR_DATA *ch;
-  PYCHAR_CHECK_CHAR_EXISTS(self->uid, ch);
+  PYCHAR_CHECK_CHAR_EXISTS(self, ch);
   charSetSex(ch, sex);
   return 0;
 }
@@ -646,7 +647,7 @@ int PyChar_setposition(PyChar *self, PyObject *value, void *closure) {
   }
 
   CHAR_DATA *ch;
-  PYCHAR_CHECK_CHAR_EXISTS(self->uid, ch);
+  PYCHAR_CHECK_CHAR_EXISTS(self, ch);
   charSetPos(ch, pos);
   // players can't be on furniture if they are standing or flying
   if(poscmp(charGetPos(ch), POS_STANDING) >= 0 && charGetFurniture(ch))
@@ -661,7 +662,7 @@ int PyChar_setroom(PyChar *self, PyObject *value, void *closure) {
   }
 
   CHAR_DATA *ch;
-  PYCHAR_CHECK_CHAR_EXISTS(self->uid, ch);
+  PYCHAR_CHECK_CHAR_EXISTS(self, ch);
 
   ROOM_DATA *room = NULL;
 
@@ -831,9 +832,10 @@ PyObject *PyChar_sendaround(PyObject *self, PyObject *args, PyObject *kwds) {
     PyDict_SetItemString(dict, "me", self);
 
   // go through all of the characters in our room and send out messages
-  LIST_ITERATOR *char_i = newListIterator(roomGetCharacters(charGetRoom(me)));
+  LIST_ITERATOR char_i;
+  listIteratorStart(&char_i, roomGetCharacters(charGetRoom(me)));
   CHAR_DATA         *ch = NULL;
-  ITERATE_LIST(ch, char_i) {
+  ITERATE_LIST(ch, &char_i) {
     // it's us, or a linkdead character. Ignore
     if(me == ch || charGetSocket(ch) == NULL)
       continue;
@@ -842,7 +844,7 @@ PyObject *PyChar_sendaround(PyObject *self, PyObject *args, PyObject *kwds) {
       continue;
     PyDict_SetItemString(dict, "ch", charGetPyFormBorrowed(ch));
     expand_to_char(ch, text, dict, get_script_locale(), newline);
-  } deleteListIterator(char_i);
+  } listIteratorStop(&char_i);
   return Py_BuildValue("");
 }
 
@@ -1262,13 +1264,14 @@ PyObject *PyChar_getslottypes(PyChar *self, PyObject *args) {
   PyObject *ret = PyList_New(0);
   LIST   *where = parse_keywords(bodyEquippedWhere(charGetBody(ch), obj));
   if(where > 0) {
-    LIST_ITERATOR *where_i = newListIterator(where);
+    LIST_ITERATOR where_i;
+    listIteratorStart(&where_i, where);
     const char        *pos = NULL;
-    ITERATE_LIST(pos, where_i) {
+    ITERATE_LIST(pos, &where_i) {
       PyObject *str = Py_BuildValue("s", bodyposGetName(bodyGetPart(charGetBody(ch), pos)));
       PyList_Append(ret, str);
       Py_DECREF(str);
-    } deleteListIterator(where_i);
+    } listIteratorStop(&where_i);
   }
   deleteListWith(where, free);
   return ret;
@@ -1296,7 +1299,7 @@ PyObject *PyChar_attach(PyChar *self, PyObject *args) {
     worldGetType(gameworld, "trigger", 
 		 get_fullkey_relative(key, get_script_locale()));
   if(trig != NULL) {
-    triggerListAdd(charGetTriggers(ch), triggerGetKey(trig));
+    charAttachTrigger(ch, triggerGetKey(trig));
     return Py_BuildValue("i", 1);
   }
   else {
@@ -1322,7 +1325,7 @@ PyObject *PyChar_detach(PyChar *self, PyObject *args) {
   CHAR_DATA    *ch = PyChar_AsChar((PyObject *)self);
   if(ch != NULL) {
     const char *fkey = get_fullkey_relative(key, get_script_locale());
-    triggerListRemove(charGetTriggers(ch), fkey);
+    charDetachTrigger(ch, fkey);
     return Py_BuildValue("i", 1);
   }
   else {
@@ -1679,7 +1682,7 @@ PyObject *PyChar_load_mob(PyObject *self, PyObject *args) {
   else if(PyRoom_Check(to))
     room = PyRoom_AsRoom(to);
   else if(PyObj_Check(to))
-    on = propertyTableGet(obj_table, PyObj_AsUid(to));
+    on = uidTableGet(obj_table, PyObj_AsUid(to));
   else {
     PyErr_Format(PyExc_TypeError, 
                     "Load char failed: invalid load-to type.");
@@ -1807,11 +1810,12 @@ PyObject *PyChar_find_char_key(PyObject *self, PyObject *args) {
 				 get_fullkey_relative(key, get_script_locale()),
 				 must_see);
     PyObject         *list = PyList_New(0);
-    LIST_ITERATOR *found_i = newListIterator(found);
+    LIST_ITERATOR found_i;
+    listIteratorStart(&found_i, found);
     CHAR_DATA   *one_found = NULL;
-    ITERATE_LIST(one_found, found_i) {
+    ITERATE_LIST(one_found, &found_i) {
       PyList_Append(list, charGetPyFormBorrowed(one_found));
-    } deleteListIterator(found_i);
+    } listIteratorStop(&found_i);
     deleteList(found);
     PyObject *retval = Py_BuildValue("O", list);
     Py_DECREF(list);
@@ -1847,7 +1851,7 @@ PyObject *PyChar_count_mobs(PyObject *self, PyObject *args) {
   else if(PyRoom_Check(in))
     room = PyRoom_AsRoom(in);
   else if(PyObj_Check(in))
-    furniture = propertyTableGet(obj_table, PyObj_AsUid(in));
+    furniture = uidTableGet(obj_table, PyObj_AsUid(in));
 
   // now find the list we're dealing with
   if(room)      list = roomGetCharacters(room);
@@ -1864,11 +1868,12 @@ PyObject *PyChar_count_mobs(PyObject *self, PyObject *args) {
 
 PyObject *PyChar_all_chars(PyObject *self) {
   PyObject      *list = PyList_New(0);
-  LIST_ITERATOR *ch_i = newListIterator(mobile_list);
+  LIST_ITERATOR ch_i;
+  listIteratorStart(&ch_i, mobile_list);
   CHAR_DATA       *ch = NULL;
-  ITERATE_LIST(ch, ch_i)
+  ITERATE_LIST(ch, &ch_i)
     PyList_Append(list, charGetPyFormBorrowed(ch));
-  deleteListIterator(ch_i);
+  listIteratorStop(&ch_i);
   return list;
 }
 
@@ -2244,12 +2249,19 @@ int PyChar_AsUid(PyObject *ch) {
 }
 
 CHAR_DATA *PyChar_AsChar(PyObject *ch) {
-  return propertyTableGet(mob_table, PyChar_AsUid(ch));
+  PyChar *self = (PyChar *)ch;
+  if(self->ch == NULL || self->generation != uidTableGeneration(mob_table)) {
+    self->ch        = uidTableGet(mob_table, self->uid);
+    self->generation = uidTableGeneration(mob_table);
+  }
+  return self->ch;
 }
 
 PyObject *
 newPyChar(CHAR_DATA *ch) {
   PyChar *py_ch = (PyChar *)PyChar_new(&PyChar_Type, NULL, NULL);
-  py_ch->uid = charGetUID(ch);
+  py_ch->uid        = charGetUID(ch);
+  py_ch->ch        = ch;
+  py_ch->generation = uidTableGeneration(mob_table);
   return (PyObject *)py_ch;
 }
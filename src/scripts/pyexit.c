@@ -65,7 +65,7 @@ int PyExit_init(PyExit *self, PyObject *args, PyObject *kwds) {
   }
 
   // make sure a exit with the uid exists
-  if(!propertyTableGet(exit_table, uid)) {
+  if(!uidTableGet(exit_table, uid)) {
     PyErr_Format(PyExc_TypeError, 
 		 "Exit with uid, %d, does not exist", uid);
     return -1;
@@ -199,7 +199,7 @@ PyObject *PyExit_getroom(PyObject *self, void *closure) {
 // Standard check to make sure the exit exists when trying to set a value for 
 // it. If successful, assign the exit to ex. Otherwise, return -1 (error)
 #define PYEXIT_CHECK_EXIT_EXISTS(uid, ex)                                      \
-  ex = propertyTableGet(exit_table, uid);                                      \
+  ex = uidTableGet(exit_table, uid);                                      \
   if(ex == NULL) {                                                             \
     PyErr_Format(PyExc_TypeError,                                              \
 		    "Tried to modify nonexistent exit, %d", uid);              \
@@ -506,7 +506,7 @@ PyObject *PyExit_open(PyExit *self, PyObject *value) {
   exitSetLocked(ex, FALSE);
 
   if(was_closed && exitGetRoom(ex))
-    hookRun("room_change", hookBuildInfo("rm", exitGetRoom(ex)));
+    hookRunTyped("room_change", "rm", exitGetRoom(ex));
 
   return Py_BuildValue("i", 1);
 }
@@ -525,7 +525,7 @@ PyObject *PyExit_close(PyExit *self, PyObject *value) {
   exitSetClosed(ex, TRUE);
 
   if(was_open && exitGetRoom(ex))
-    hookRun("room_change", hookBuildInfo("rm", exitGetRoom(ex)));
+    hookRunTyped("room_change", "rm", exitGetRoom(ex));
 
   return Py_BuildValue("i", 1);
 }
@@ -545,7 +545,7 @@ PyObject *PyExit_lock(PyExit *self, PyObject *value) {
   exitSetLocked(ex, TRUE);
 
   if((was_open || was_unlocked) && exitGetRoom(ex))
-    hookRun("room_change", hookBuildInfo("rm", exitGetRoom(ex)));
+    hookRunTyped("room_change", "rm", exitGetRoom(ex));
 
   return Py_BuildValue("i", 1);
 }
@@ -563,7 +563,7 @@ PyObject *PyExit_unlock(PyExit *self, PyObject *value) {
   exitSetLocked(ex, FALSE);
 
   if(was_locked && exitGetRoom(ex))
-    hookRun("room_change", hookBuildInfo("rm", exitGetRoom(ex)));
+    hookRunTyped("room_change", "rm", exitGetRoom(ex));
 
   return Py_BuildValue("i", 1);
 }
@@ -743,7 +743,7 @@ int PyExit_AsUid(PyObject *exit) {
 }
 
 EXIT_DATA *PyExit_AsExit(PyObject *exit) {
-  return propertyTableGet(exit_table, PyExit_AsUid(exit));
+  return uidTableGet(exit_table, PyExit_AsUid(exit));
 }
 
 int PyExit_Check(PyObject *value) {
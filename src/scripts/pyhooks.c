@@ -31,6 +31,135 @@ LIST *pyhooks_methods = NULL;
 // a table of python hooks we have installed
 HASHTABLE *pyhook_table = NULL;
 
+// the info strings of the hooks Python is currently running, and the tuples
+// parse_info would have built from them. Hooks can set off other hooks, so
+// this is a stack; the innermost hook is at the head. A tuple is only good
+// for one listener, since the listener can extract or move what's in it. It
+// is NULL until the next listener asks for it
+typedef struct pyhook_parsed {
+  const char    *info;
+  PyObject     *tuple;
+} PYHOOK_PARSED;
+
+LIST *pyhook_parsed = NULL;
+
+//
+// build the tuple hooks.parse_info returns, straight from a hook's arguments.
+// Returns a new reference
+PyObject *pyhook_args_to_tuple(HOOK_ARGS *args) {
+  PyObject *tuple = PyTuple_New(args->num);
+  int i;
+  for(i = 0; i < args->num; i++) {
+    HOOK_ARG  *arg = &args->arg[i];
+    PyObject *item = NULL;
+    if(arg->val.ptr == NULL && arg->type <= HOOK_ARG_SOCK)
+      item = NULL;
+    else if(arg->type == HOOK_ARG_CH)
+      item = charGetPyForm(arg->val.ptr);
+    else if(arg->type == HOOK_ARG_OBJ)
+      item = objGetPyForm(arg->val.ptr);
+    else if(arg->type == HOOK_ARG_ROOM)
+      item = roomGetPyForm(arg->val.ptr);
+    else if(arg->type == HOOK_ARG_EXIT)
+      item = newPyExit(arg->val.ptr);
+    else if(arg->type == HOOK_ARG_SOCK)
+      item = socketGetPyForm(arg->val.ptr);
+    else if(arg->type == HOOK_ARG_STR)
+      item = Py_BuildValue("s", arg->val.str);
+    else if(arg->type == HOOK_ARG_INT)
+      item = Py_BuildValue("i", arg->val.num);
+    else if(arg->type == HOOK_ARG_DBL)
+      item = Py_BuildValue("d", arg->val.dbl);
+
+    if(item == NULL) {
+      Py_INCREF(Py_None);
+      item = Py_None;
+    }
+    PyTuple_SetItem(tuple, i, item);
+  }
+  return tuple;
+}
+
+//
+// build the tuple hooks.parse_info returns from an info string, looking each
+// thing up by its UID. Things that are gone come back as None. Returns a new
+// reference
+PyObject *pyhook_info_to_tuple(const char *info) {
+  // parse out all of our tokens
+  LIST           *tokens = parse_hook_info_tokens(info);
+  LIST_ITERATOR token_i;
+  listIteratorStart(&token_i, tokens);
+  char            *token = NULL;
+  PyObject         *list = PyTuple_New(listSize(tokens));
+  int                  i = 0;
+
+  // id number we'll need for parsing some values
+  int id = 0;
+
+  // go through all of our tokens
+  ITERATE_LIST(token, &token_i) {
+    if(startswith(token, "ch")) {
+      sscanf(token, "ch.%d", &id);
+      CHAR_DATA *ch = uidTableGet(mob_table, id);
+      PyTuple_SetItem(list, i, (ch ? charGetPyForm(ch) : Py_BuildValue("")));
+    }
+    else if(startswith(token, "obj")) {
+      sscanf(token, "obj.%d", &id);
+      OBJ_DATA *obj = uidTableGet(obj_table, id);
+      PyTuple_SetItem(list, i, (obj ? objGetPyForm(obj) : Py_BuildValue("")));
+    }
+    else if(startswith(token, "rm")) {
+      sscanf(token, "rm.%d", &id);
+      ROOM_DATA *rm = uidTableGet(room_table, id);
+      PyTuple_SetItem(list, i, (rm ? roomGetPyForm(rm) : Py_BuildValue("")));
+    }
+    else if(startswith(token, "room")) {
+      sscanf(token, "room.%d", &id);
+      ROOM_DATA *rm = uidTableGet(room_table, id);
+      PyTuple_SetItem(list, i, (rm ? roomGetPyForm(rm) : Py_BuildValue("")));
+    }
+    else if(startswith(token, "exit")) {
+      sscanf(token, "exit.%d", &id);
+      EXIT_DATA *ex = uidTableGet(exit_table, id);
+      PyTuple_SetItem(list, i, (ex ? newPyExit(ex) : Py_BuildValue("")));
+    }
+    else if(startswith(token, "ex")) {
+      sscanf(token, "ex.%d", &id);
+      EXIT_DATA *ex = uidTableGet(exit_table, id);
+      PyTuple_SetItem(list, i, (ex ? newPyExit(ex) : Py_BuildValue("")));
+    }
+    else if(startswith(token, "sk")) {
+      sscanf(token, "sk.%d", &id);
+      SOCKET_DATA *sock = uidTableGet(sock_table, id);
+      PyTuple_SetItem(list, i, (sock ? socketGetPyForm(sock) :
+				Py_BuildValue("")));
+    }
+    else if(startswith(token, "sock")) {
+      sscanf(token, "sock.%d", &id);
+      SOCKET_DATA *sock = uidTableGet(sock_table, id);
+      PyTuple_SetItem(list, i, (sock ? socketGetPyForm(sock) :
+				Py_BuildValue("")));
+    }
+    else if(*token == HOOK_STR_MARKER) {
+      char *str = strdup(token + 1);
+      str[strlen(str)-1] = '\0';
+      PyTuple_SetItem(list,i, Py_BuildValue("s", str));
+      free(str);
+    }
+    else if(isdigit(*token)) {
+      // integer or double?
+      if(next_letter_in(token, '.') > -1)
+	PyTuple_SetItem(list, i, Py_BuildValue("d", atof(token)));
+      else
+	PyTuple_SetItem(list,i, Py_BuildValue("i", atoi(token)));
+    }
+    i++;
+  } listIteratorStop(&token_i);
+  deleteListWith(tokens, free);
+
+  return list;
+}
+
 
 
 //*****************************************************************************
@@ -62,11 +191,12 @@ PyObject *PyHooks_BuildInfo(PyObject *self, PyObject *args) {
 
   // build each of our tokens into the info
   BUFFER            *buf = newBuffer(1);
-  LIST_ITERATOR *token_i = newListIterator(tokens);
+  LIST_ITERATOR token_i;
+  listIteratorStart(&token_i, tokens);
   char            *token = NULL;
   int                  i = 0;
   PyObject          *var = NULL;
-  ITERATE_LIST(token, token_i) {
+  ITERATE_LIST(token, &token_i) {
     if(!strcasecmp(token, "ch")) {
       var = PyTuple_GetItem(vars, i);
       if(!PyChar_Check(var)) {
@@ -137,7 +267,7 @@ PyObject *PyHooks_BuildInfo(PyObject *self, PyObject *args) {
     if(i < listSize(tokens) - 1)
       bprintf(buf, " ");
     i++;
-  } deleteListIterator(token_i);
+  } listIteratorStop(&token_i);
   deleteListWith(tokens, free);
 
   // did we manage to go through all of our tokens or not?
@@ -161,76 +291,23 @@ PyObject *PyHooks_ParseInfo(PyObject *self, PyObject *args) {
     return NULL;
   }
 
-  // parse out all of our tokens
-  LIST           *tokens = parse_hook_info_tokens(info);
-  LIST_ITERATOR *token_i = newListIterator(tokens);
-  char            *token = NULL;
-  PyObject         *list = PyTuple_New(listSize(tokens));
-  int                  i = 0;
-
-  // id number we'll need for parsing some values
-  int id = 0;
-
-  // go through all of our tokens
-  ITERATE_LIST(token, token_i) {
-    if(startswith(token, "ch")) {
-      sscanf(token, "ch.%d", &id);
-      CHAR_DATA *ch = propertyTableGet(mob_table, id);
-      PyTuple_SetItem(list, i, (ch ? charGetPyForm(ch) : Py_None));
-    }
-    else if(startswith(token, "obj")) {
-      sscanf(token, "obj.%d", &id);
-      OBJ_DATA *obj = propertyTableGet(obj_table, id);
-      PyTuple_SetItem(list, i, (obj ? objGetPyForm(obj) : Py_None));
-    }
-    else if(startswith(token, "rm")) {
-      sscanf(token, "rm.%d", &id);
-      ROOM_DATA *rm = propertyTableGet(room_table, id);
-      PyTuple_SetItem(list, i, (rm ? roomGetPyForm(rm) : Py_None));
-    }
-    else if(startswith(token, "room")) {
-      sscanf(token, "room.%d", &id);
-      ROOM_DATA *rm = propertyTableGet(room_table, id);
-      PyTuple_SetItem(list, i, (rm ? roomGetPyForm(rm) : Py_None));
-    }
-    else if(startswith(token, "exit")) {
-      sscanf(token, "exit.%d", &id);
-      EXIT_DATA *ex = propertyTableGet(exit_table, id);
-      PyTuple_SetItem(list, i, (ex ? newPyExit(ex) : Py_None));
-    }
-    else if(startswith(token, "ex")) {
-      sscanf(token, "ex.%d", &id);
-      EXIT_DATA *ex = propertyTableGet(exit_table, id);
-      PyTuple_SetItem(list, i, (ex ? newPyExit(ex) : Py_None));
-    }
-    else if(startswith(token, "sk")) {
-      sscanf(token, "sk.%d", &id);
-      SOCKET_DATA *sock = propertyTableGet(sock_table, id);
-      PyTuple_SetItem(list,i, (sock ? socketGetPyForm(sock) : Py_None));
-    }
-    else if(startswith(token, "sock")) {
-      sscanf(token, "sock.%d", &id);
-      SOCKET_DATA *sock = propertyTableGet(sock_table, id);
-      PyTuple_SetItem(list,i, (sock ? socketGetPyForm(sock) : Py_None));
-    }
-    else if(*token == HOOK_STR_MARKER) {
-      char *str = strdup(token + 1);
-      str[strlen(str)-1] = '\0';
-      PyTuple_SetItem(list,i, Py_BuildValue("s", str));
-      free(str);
-    }
-    else if(isdigit(*token)) {
-      // integer or double?
-      if(next_letter_in(token, '.') > -1)
-	PyTuple_SetItem(list, i, Py_BuildValue("d", atof(token)));
-      else
-	PyTuple_SetItem(list,i, Py_BuildValue("i", atoi(token)));
-    }
-    i++;
-  } deleteListIterator(token_i);
-  deleteListWith(tokens, free);
+  // are we being asked to parse the info of a hook we are running? Then we
+  // already have the tuple made
+  LIST_ITERATOR parsed_i;
+  listIteratorStart(&parsed_i, pyhook_parsed);
+  PYHOOK_PARSED *parsed = NULL;
+  ITERATE_LIST(parsed, &parsed_i) {
+    if(!strcmp(parsed->info, info))
+      break;
+  } listIteratorStop(&parsed_i);
+  if(parsed != NULL) {
+    if(parsed->tuple == NULL)
+      parsed->tuple = pyhook_info_to_tuple(info);
+    Py_INCREF(parsed->tuple);
+    return parsed->tuple;
+  }
 
-  return list;
+  return pyhook_info_to_tuple(info);
 }
 
 
@@ -289,15 +366,25 @@ PyObject *PyHooks_Remove(PyObject *self, PyObject *args) {
 
 
 //
-// monitors hook activity, and handles the ones on the Python end
-void PyHooks_Monitor(const char *type, const char *info) {
+// monitors hook activity, and handles the ones on the Python end. Python
+// hooks take the info string, and nearly always parse it right back out with
+// hooks.parse_info. So, the string is made once, here, and only if a Python
+// hook is listening for this type. The first listener's tuple is made straight
+// from the arguments. Later ones are looked back up from the info string, in
+// case an earlier listener extracted something
+void PyHooks_Monitor(const char *type, HOOK_ARGS *args) {
   LIST *list = hashGet(pyhook_table, type);
-  if(list != NULL) {
-    char *info_dup = strdup(info);
-    LIST_ITERATOR *list_i = newListIterator(list);
+  if(list != NULL && listSize(list) > 0) {
+    PYHOOK_PARSED parsed;
+    parsed.info  = hookArgsInfo(args);
+    parsed.tuple = pyhook_args_to_tuple(args);
+    listPush(pyhook_parsed, &parsed);
+
+    PyObject *arglist = Py_BuildValue("(s)", parsed.info);
+    LIST_ITERATOR list_i;
+    listIteratorStart(&list_i, list);
     PyObject *func = NULL;
-    ITERATE_LIST(func, list_i) {
-      PyObject *arglist = Py_BuildValue("(s)", info_dup);
+    ITERATE_LIST(func, &list_i) {
       PyObject *retval  = PyEval_CallObject(func, arglist);
       // check for an error:
       if(retval == NULL)
@@ -305,9 +392,13 @@ void PyHooks_Monitor(const char *type, const char *info) {
 
       // garbage collection
       Py_XDECREF(retval);
-      Py_XDECREF(arglist);
-    } deleteListIterator(list_i);
-    free(info_dup);
+      Py_XDECREF(parsed.tuple);
+      parsed.tuple = NULL;
+    } listIteratorStop(&list_i);
+
+    // garbage collection
+    listRemove(pyhook_parsed, &parsed);
+    Py_XDECREF(arglist);
   }
 }
 
@@ -341,8 +432,9 @@ init_PyHooks(void) {
     "The python module for registering and running hooks.");
 
   // set up our hook monitor
-  pyhook_table = newHashtable();
-  hookAddMonitor(PyHooks_Monitor);
+  pyhook_table  = newHashtable();
+  pyhook_parsed = newList();
+  hookAddTypedMonitor(PyHooks_Monitor);
 }
 
 void PyHooks_addMethod(const char *name, void *f, int flags, const char *doc) {
@@ -0,0 +1,383 @@
+//*****************************************************************************
+//
+// pylistview.c
+//
+// A read-only Python sequence over one of the mud's lists. See pylistview.h
+// for documentation.
+//
+//*****************************************************************************
+
+#include "../mud.h"
+#include "../utils.h"
+#include "../hooks.h"
+#include "../character.h"
+#include "../object.h"
+#include "../room.h"
+
+#include "scripts.h"
+#include "pylistview.h"
+
+
+
+//*****************************************************************************
+// local structures and defines
+//*****************************************************************************
+typedef struct {
+  PyObject_HEAD
+  PyObject               *owner; // the Python form of whatever has the list
+  LIST *(* get_list)(PyObject *owner);
+  PyObject *(* convertor)(void *elem);
+} PyListView;
+
+typedef struct {
+  PyObject_HEAD
+  PyListView              *view;
+  LIST                    *list; // the list we're going over. NULL when done
+  LIST_ITERATOR             it;
+} PyListViewIter;
+
+PyTypeObject PyListView_Type;
+PyTypeObject PyListViewIter_Type;
+
+// the iterators that are still going over their list. When something leaves
+// the game, the ones going over its lists are stopped while the lists are
+// still around, since they may be deleted right after
+LIST *live_iters = NULL;
+
+//
+// stop the iterator from going over its list any further
+void PyListViewIter_stop(PyListViewIter *self) {
+  if(self->list != NULL) {
+    listIteratorStop(&self->it);
+    self->list = NULL;
+    listRemove(live_iters, self);
+  }
+}
+
+//
+// stop every iterator that is going over the list
+void pylistview_list_gone(LIST *list) {
+  LIST_ITERATOR  iter_i;
+  PyListViewIter  *iter = NULL;
+  listIteratorStart(&iter_i, live_iters);
+  ITERATE_LIST(iter, &iter_i) {
+    if(iter->list == list)
+      PyListViewIter_stop(iter);
+  } listIteratorStop(&iter_i);
+}
+
+//
+// something is leaving the game. Stop iterators going over its lists
+void pylistview_char_from_game(HOOK_ARGS *args) {
+  CHAR_DATA *ch = NULL;
+  hookArgsParse(args, &ch);
+  pylistview_list_gone(charGetInventory(ch));
+}
+
+void pylistview_obj_from_game(HOOK_ARGS *args) {
+  OBJ_DATA *obj = NULL;
+  hookArgsParse(args, &obj);
+  pylistview_list_gone(objGetContents(obj));
+  pylistview_list_gone(objGetUsers(obj));
+}
+
+void pylistview_room_from_game(HOOK_ARGS *args) {
+  ROOM_DATA *room = NULL;
+  hookArgsParse(args, &room);
+  pylistview_list_gone(roomGetCharacters(room));
+  pylistview_list_gone(roomGetContents(room));
+}
+
+//
+// return the list the view is looking at. If its owner no longer exists, set
+// an error and return NULL
+LIST *PyListView_list(PyListView *self) {
+  LIST *list = self->get_list(self->owner);
+  if(list == NULL)
+    PyErr_Format(PyExc_TypeError,
+		 "Tried to use the list of something that no longer exists");
+  return list;
+}
+
+//
+// return a copy of the view as a normal Python list, or NULL if its owner no
+// longer exists
+PyObject *PyListView_copy(PyListView *self) {
+  LIST *list = PyListView_list(self);
+  if(list == NULL)
+    return NULL;
+
+  PyObject  *pylist = PyList_New(0);
+  LIST_ITERATOR  it;
+  void        *elem = NULL;
+  listIteratorStart(&it, list);
+  ITERATE_LIST(elem, &it) {
+    PyList_Append(pylist, self->convertor(elem));
+  } listIteratorStop(&it);
+  return pylist;
+}
+
+//
+// views can be used anywhere lists can be, for things that won't change them.
+// Return a new reference to a list for value: a copy if it is a view, or the
+// value itself if not
+PyObject *PyListView_asList(PyObject *value) {
+  if(PyListView_Check(value))
+    return PyListView_copy((PyListView *)value);
+  Py_INCREF(value);
+  return value;
+}
+
+
+
+//*****************************************************************************
+// the view iterator
+//*****************************************************************************
+void PyListViewIter_dealloc(PyListViewIter *self) {
+  PyListViewIter_stop(self);
+  Py_DECREF(self->view);
+  self->ob_type->tp_free((PyObject *)self);
+}
+
+PyObject *PyListViewIter_next(PyListViewIter *self) {
+  // we've run off the end, or our owner left the game and stopped us
+  if(self->list == NULL)
+    return NULL;
+  else {
+    // move on right away. If the element after this one is taken out of the
+    // list before we're called again, it is skipped over like it would be
+    // by ITERATE_LIST
+    void *elem = listIteratorCurrent(&self->it);
+    if(elem == NULL) {
+      PyListViewIter_stop(self);
+      return NULL;
+    }
+    listIteratorNext(&self->it);
+
+    PyObject *pyelem = self->view->convertor(elem);
+    Py_INCREF(pyelem);
+    return pyelem;
+  }
+}
+
+PyTypeObject PyListViewIter_Type = {
+    PyObject_HEAD_INIT(NULL)
+    0,                         /*ob_size*/
+    "listview_iterator",       /*tp_name*/
+    sizeof(PyListViewIter),    /*tp_basicsize*/
+    0,                         /*tp_itemsize*/
+    (destructor)PyListViewIter_dealloc,/*tp_dealloc*/
+    0,                         /*tp_print*/
+    0,                         /*tp_getattr*/
+    0,                         /*tp_setattr*/
+    0,                         /*tp_compare*/
+    0,                         /*tp_repr*/
+    0,                         /*tp_as_number*/
+    0,                         /*tp_as_sequence*/
+    0,                         /*tp_as_mapping*/
+    0,                         /*tp_hash */
+    0,                         /*tp_call*/
+    0,                         /*tp_str*/
+    0,                         /*tp_getattro*/
+    0,                         /*tp_setattro*/
+    0,                         /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT,        /*tp_flags*/
+    "Iterator over a mud list view", /* tp_doc */
+    0,		               /* tp_traverse */
+    0,		               /* tp_clear */
+    0,		               /* tp_richcompare */
+    0,		               /* tp_weaklistoffset */
+    PyObject_SelfIter,         /* tp_iter */
+    (iternextfunc)PyListViewIter_next, /* tp_iternext */
+};
+
+
+
+//*****************************************************************************
+// the view itself
+//*****************************************************************************
+void PyListView_dealloc(PyListView *self) {
+  Py_DECREF(self->owner);
+  self->ob_type->tp_free((PyObject *)self);
+}
+
+Py_ssize_t PyListView_length(PyListView *self) {
+  LIST *list = PyListView_list(self);
+  return (list == NULL ? -1 : listSize(list));
+}
+
+PyObject *PyListView_item(PyListView *self, Py_ssize_t i) {
+  LIST *list = PyListView_list(self);
+  if(list == NULL)
+    return NULL;
+  else if(i < 0 || i >= listSize(list)) {
+    PyErr_SetString(PyExc_IndexError, "list index out of range");
+    return NULL;
+  }
+  else {
+    LIST_ITERATOR it;
+    void       *elem = NULL;
+    listIteratorStart(&it, list);
+    ITERATE_LIST(elem, &it) {
+      if(i-- == 0)
+	break;
+    } listIteratorStop(&it);
+
+    PyObject *pyelem = self->convertor(elem);
+    Py_INCREF(pyelem);
+    return pyelem;
+  }
+}
+
+PyObject *PyListView_slice(PyListView *self, Py_ssize_t i, Py_ssize_t j) {
+  PyObject *pylist = PyListView_copy(self);
+  if(pylist == NULL)
+    return NULL;
+  PyObject *slice = PyList_GetSlice(pylist, i, j);
+  Py_DECREF(pylist);
+  return slice;
+}
+
+int PyListView_contains(PyListView *self, PyObject *value) {
+  LIST *list = PyListView_list(self);
+  if(list == NULL)
+    return -1;
+
+  LIST_ITERATOR it;
+  void       *elem = NULL;
+  int       found = 0;
+  listIteratorStart(&it, list);
+  ITERATE_LIST(elem, &it) {
+    if((found = PyObject_RichCompareBool(self->convertor(elem), value,Py_EQ))!=0)
+      break;
+  } listIteratorStop(&it);
+  return found;
+}
+
+PyObject *PyListView_iter(PyListView *self) {
+  LIST *list = PyListView_list(self);
+  if(list == NULL)
+    return NULL;
+
+  PyListViewIter *iter = PyObject_New(PyListViewIter, &PyListViewIter_Type);
+  if(iter == NULL)
+    return NULL;
+  Py_INCREF(self);
+  iter->view = self;
+  iter->list = list;
+  listIteratorStart(&iter->it, list);
+  listPut(live_iters, iter);
+  return (PyObject *)iter;
+}
+
+//
+// view + list, list + view, and view + view all give a new list
+PyObject *PyListView_add(PyObject *left, PyObject *right) {
+  PyObject  *pyleft = PyListView_asList(left);
+  PyObject *pyright = NULL;
+  PyObject  *retval = NULL;
+  if(pyleft != NULL && (pyright = PyListView_asList(right)) != NULL)
+    retval = PySequence_Concat(pyleft, pyright);
+  Py_XDECREF(pyleft);
+  Py_XDECREF(pyright);
+  return retval;
+}
+
+PyObject *PyListView_richcompare(PyObject *left, PyObject *right, int op) {
+  PyObject  *pyleft = PyListView_asList(left);
+  PyObject *pyright = NULL;
+  PyObject  *retval = NULL;
+  if(pyleft != NULL && (pyright = PyListView_asList(right)) != NULL)
+    retval = PyObject_RichCompare(pyleft, pyright, op);
+  Py_XDECREF(pyleft);
+  Py_XDECREF(pyright);
+  return retval;
+}
+
+PyObject *PyListView_repr(PyListView *self) {
+  PyObject *pylist = PyListView_copy(self);
+  if(pylist == NULL)
+    return NULL;
+  PyObject *repr = PyObject_Repr(pylist);
+  Py_DECREF(pylist);
+  return repr;
+}
+
+PyNumberMethods PyListView_as_number = {
+  (binaryfunc)PyListView_add,  /* nb_add */
+};
+
+PySequenceMethods PyListView_as_sequence = {
+  (lenfunc)PyListView_length,  /* sq_length */
+  0,                           /* sq_concat; nb_add covers it */
+  0,                           /* sq_repeat */
+  (ssizeargfunc)PyListView_item, /* sq_item */
+  (ssizessizeargfunc)PyListView_slice, /* sq_slice */
+  0,                           /* sq_ass_item */
+  0,                           /* sq_ass_slice */
+  (objobjproc)PyListView_contains, /* sq_contains */
+};
+
+PyTypeObject PyListView_Type = {
+    PyObject_HEAD_INIT(NULL)
+    0,                         /*ob_size*/
+    "listview",                /*tp_name*/
+    sizeof(PyListView),        /*tp_basicsize*/
+    0,                         /*tp_itemsize*/
+    (destructor)PyListView_dealloc,/*tp_dealloc*/
+    0,                         /*tp_print*/
+    0,                         /*tp_getattr*/
+    0,                         /*tp_setattr*/
+    0,                         /*tp_compare*/
+    (reprfunc)PyListView_repr, /*tp_repr*/
+    &PyListView_as_number,     /*tp_as_number*/
+    &PyListView_as_sequence,   /*tp_as_sequence*/
+    0,                         /*tp_as_mapping*/
+    0,                         /*tp_hash */
+    0,                         /*tp_call*/
+    0,                         /*tp_str*/
+    0,                         /*tp_getattro*/
+    0,                         /*tp_setattro*/
+    0,                         /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_CHECKTYPES, /*tp_flags*/
+    "A read-only view of a list of things in the mud. Use list() to copy\n"
+    "it into a list that can be changed.", /* tp_doc */
+    0,		               /* tp_traverse */
+    0,		               /* tp_clear */
+    (richcmpfunc)PyListView_richcompare, /* tp_richcompare */
+    0,		               /* tp_weaklistoffset */
+    (getiterfunc)PyListView_iter, /* tp_iter */
+    0,		               /* tp_iternext */
+};
+
+
+
+//*****************************************************************************
+// implementation of pylistview.h
+//*****************************************************************************
+PyMODINIT_FUNC init_PyListView(void) {
+  if(PyType_Ready(&PyListView_Type) < 0)
+    return;
+  if(PyType_Ready(&PyListViewIter_Type) < 0)
+    return;
+
+  live_iters = newList();
+  hookAddTyped("char_from_game", pylistview_char_from_game);
+  hookAddTyped("obj_from_game",  pylistview_obj_from_game);
+  hookAddTyped("room_from_game", pylistview_room_from_game);
+}
+
+PyObject *newPyListView(PyObject *owner, void *get_list, void *convertor) {
+  PyListView *view = PyObject_New(PyListView, &PyListView_Type);
+  if(view == NULL)
+    return NULL;
+  Py_INCREF(owner);
+  view->owner     = owner;
+  view->get_list  = get_list;
+  view->convertor = convertor;
+  return (PyObject *)view;
+}
+
+int PyListView_Check(PyObject *value) {
+  return PyObject_TypeCheck(value, &PyListView_Type);
+}
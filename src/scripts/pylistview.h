@@ -0,0 +1,37 @@
+#ifndef PYLISTVIEW_H
+#define PYLISTVIEW_H
+//*****************************************************************************
+//
+// pylistview.h
+//
+// A read-only Python sequence that looks straight at one of the mud's lists
+// (a character's inventory, a room's characters, etc.) instead of copying it
+// into a new Python list every time it is asked for. Views support len(),
+// iteration, indexing, slicing, "in", and + ; slicing and + give back real
+// Python lists, as does list(view) for scripts that want a copy to change.
+//
+// Views do not hold on to the list itself. They hold on to the Python form of
+// the thing that owns it, and ask for the list each time they are used, so
+// they are never left pointing at a list that has been deleted. Iterating
+// over a view uses the list's own iterator, so things can be taken out of the
+// list while scripts are going over it. If the owner leaves the game, its
+// iterators stop where they are.
+//
+//*****************************************************************************
+
+//
+// called by init_scripts() to set up the view type
+PyMODINIT_FUNC init_PyListView(void);
+
+//
+// make a new view. get_list takes owner, and returns the list that is to be
+// looked at, or NULL if owner no longer exists. convertor takes an element of
+// the list and returns a borrowed reference to its Python form, e.g.
+// charGetPyFormBorrowed
+PyObject *newPyListView(PyObject *owner, void *get_list, void *convertor);
+
+//
+// returns whether the PyObject is a list view
+int PyListView_Check(PyObject *value);
+
+#endif // PYLISTVIEW_H
@@ -29,6 +29,7 @@
 #include "pyplugs.h"
 #include "pyexit.h"
 #include "pysocket.h"
+#include "pylistview.h"
 
 
 
@@ -508,17 +509,19 @@ PyObject *mud_send(PyObject *self, PyObject *args, PyObject *kwds) {
     return NULL;
   }
 
-  // make sure the list is a list
-  if(!PyList_Check(list)) {
+  // make sure the list is a list (or something like one, e.g. room.chars)
+  if(!PyList_Check(list) && !PyListView_Check(list)) {
     PyErr_Format(PyExc_TypeError, "mud.send expects first argument to be a list of characters.");
     return NULL;
   }
+  if((list = PySequence_Fast(list, "")) == NULL)
+    return NULL;
 
   // go through our list of characters, and send each of them the message
   int i = 0;
-  for(; i < PyList_Size(list); i++) {
+  for(; i < PySequence_Fast_GET_SIZE(list); i++) {
     // make sure it's a character, and it has a socket
-    PyObject *pych = PyList_GetItem(list, i);
+    PyObject *pych = PySequence_Fast_GET_ITEM(list, i);
     CHAR_DATA  *ch = NULL;
     if(!PyChar_Check(pych))
       continue;
@@ -528,6 +531,7 @@ PyObject *mud_send(PyObject *self, PyObject *args, PyObject *kwds) {
       PyDict_SetItemString(dict, "ch", charGetPyFormBorrowed(ch));
     expand_to_char(ch, text, dict, get_script_locale(), newline);
   }
+  Py_DECREF(list);
   return Py_BuildValue("");
 }
 
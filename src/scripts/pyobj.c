@@ -28,6 +28,7 @@
 #include "pyobj.h"
 #include "pyauxiliary.h"
 #include "pystorage.h"
+#include "pylistview.h"
 
 
 
@@ -52,6 +53,8 @@ LIST *pyobj_methods = NULL;
 typedef struct {
   PyObject_HEAD
   int uid;
+  OBJ_DATA *obj; // what uid was when we last looked it up, or NULL.
+  int generation; // obj_table's generation then; if it changes, look it up again
 } PyObj;
 
 
@@ -83,13 +86,14 @@ int PyObj_init(PyObj *self, PyObject *args, PyObject *kwds) {
   }
 
   // make sure a object with the UID exists
-  if(!propertyTableGet(obj_table, uid)) {
+  if(!uidTableGet(obj_table, uid)) {
     PyErr_Format(PyExc_TypeError, 
                     "Object with uid, %d, does not exist", uid);
     return -1;
   }
 
   self->uid = uid;
+  self->obj = NULL;
   return 0;
 }
 
@@ -190,40 +194,31 @@ PyObject *PyObj_getage(PyObject *self, void *closure) {
   else            return NULL;  
 }
 
+//
+// the lists of objects in an object and characters using it, for viewing
+// from Python
+LIST *pyobj_contents_list(PyObject *self) {
+  OBJ_DATA *obj = PyObj_AsObj(self);
+  return (obj == NULL ? NULL : objGetContents(obj));
+}
+
+LIST *pyobj_users_list(PyObject *self) {
+  OBJ_DATA *obj = PyObj_AsObj(self);
+  return (obj == NULL ? NULL : objGetUsers(obj));
+}
+
 PyObject *PyObj_getcontents(PyObj *self, PyObject *args) {
-  OBJ_DATA *obj = PyObj_AsObj((PyObject *)self);
-  if(obj == NULL) 
+  if(PyObj_AsObj((PyObject *)self) == NULL) 
     return NULL;
-
-  LIST_ITERATOR *cont_i = newListIterator(objGetContents(obj));
-  PyObject *list = PyList_New(0);
-  OBJ_DATA *cont;
-  
-  // for each obj in the contentory, add it to the Python list
-  ITERATE_LIST(cont, cont_i)
-    PyList_Append(list, objGetPyFormBorrowed(cont));
-  deleteListIterator(cont_i);
-  PyObject *retval = Py_BuildValue("O", list);
-  Py_DECREF(list);
-  return retval;
+  return newPyListView((PyObject *)self, pyobj_contents_list,
+		       objGetPyFormBorrowed);
 }
 
 PyObject *PyObj_getchars(PyObj *self, PyObject *args) {
-  OBJ_DATA *obj = PyObj_AsObj((PyObject *)self);
-  if(obj == NULL) 
+  if(PyObj_AsObj((PyObject *)self) == NULL) 
     return NULL;
-
-  LIST_ITERATOR *char_i = newListIterator(objGetUsers(obj));
-  PyObject *list = PyList_New(0);
-  CHAR_DATA *ch;
-  
-  // for each obj in the contentory, add it to the Python list
-  ITERATE_LIST(ch, char_i)
-    PyList_Append(list, charGetPyFormBorrowed(ch));
-  deleteListIterator(char_i);
-  PyObject *retval = Py_BuildValue("O", list);
-  Py_DECREF(list);
-  return retval;
+  return newPyListView((PyObject *)self, pyobj_users_list,
+		       charGetPyFormBorrowed);
 }
 
 PyObject *PyObj_getcarrier(PyObj *self, void *closure) {
@@ -266,11 +261,11 @@ PyObject *PyObj_getcontainer(PyObj *self, void *closure) {
 // Standard check to make sure the object exists when
 // trying to set a value for it. If successful, assign the
 // object to ch. Otherwise, return -1 (error)
-#define PYOBJ_CHECK_OBJ_EXISTS(uid, obj)                                       \
-  obj = propertyTableGet(obj_table, uid);                                      \
+#define PYOBJ_CHECK_OBJ_EXISTS(self, obj)                                      \
+  obj = PyObj_AsObj((PyObject *)self);                                         \
   if(obj == NULL) {                                                            \
     PyErr_Format(PyExc_TypeError,                                              \
-		    "Tried to modify nonexistant object, %d", uid);            \
+		    "Tried to modify nonexistant object, %d", (self)->uid);    \
     return -1;                                                                 \
   }                                                                            
 
@@ -287,7 +282,7 @@ int PyObj_setname(PyObj *self, PyObject *value, void *closure) {
   }
 
   OBJ_DATA *obj;
-  PYOBJ_CHECK_OBJ_EXISTS(self->uid, obj);
+  PYOBJ_CHECK_OBJ_EXISTS(self, obj);
   objSetName(obj, PyString_AsString(value));
   return 0;
 }
@@ -305,7 +300,7 @@ int PyObj_setmname(PyObj *self, PyObject *value, void *closure) {
   }
 
   OBJ_DATA *obj;
-  PYOBJ_CHECK_OBJ_EXISTS(self->uid, obj);
+  PYOBJ_CHECK_OBJ_EXISTS(self, obj);
   objSetMultiName(obj, PyString_AsString(value));
   return 0;
 }
@@ -323,7 +318,7 @@ int PyObj_setbits(PyObj *self, PyObject *value, void *closure) {
   }
 
   OBJ_DATA *obj;
-  PYOBJ_CHECK_OBJ_EXISTS(self->uid, obj);
+  PYOBJ_CHECK_OBJ_EXISTS(self, obj);
   bitClear(objGetBits(obj));
   bitSet(objGetBits(obj), PyString_AsString(value));
   return 0;
@@ -342,20 +337,21 @@ int PyObj_setkeywords(PyObj *self, PyObject *value, void *closure) {
   }
 
   OBJ_DATA *obj;
-  PYOBJ_CHECK_OBJ_EXISTS(self->uid, obj);
+  PYOBJ_CHECK_OBJ_EXISTS(self, obj);
 
   // clean up empty keywords, and rebuild it
   LIST           *kwds = parse_keywords(PyString_AsString(value));
   BUFFER     *new_kwds = newBuffer(1);
-  LIST_ITERATOR *kwd_i = newListIterator(kwds);
+  LIST_ITERATOR kwd_i;
+  listIteratorStart(&kwd_i, kwds);
   char            *kwd = NULL;
 
-  ITERATE_LIST(kwd, kwd_i) {
+  ITERATE_LIST(kwd, &kwd_i) {
     // if we already have content, add a comma
     if(bufferLength(new_kwds) > 0)
       bufferCat(new_kwds, ", ");
     bufferCat(new_kwds, kwd);
-  } deleteListIterator(kwd_i);
+  } listIteratorStop(&kwd_i);
 
   // set our keywords
   objSetKeywords(obj, bufferString(new_kwds));
@@ -379,7 +375,7 @@ int PyObj_setdesc(PyObj *self, PyObject *value, void *closure) {
   }
 
   OBJ_DATA *obj;
-  PYOBJ_CHECK_OBJ_EXISTS(self->uid, obj);
+  PYOBJ_CHECK_OBJ_EXISTS(self, obj);
   objSetDesc(obj, PyString_AsString(value));
   return 0;
 }
@@ -397,7 +393,7 @@ int PyObj_setrdesc(PyObj *self, PyObject *value, void *closure) {
   }
 
   OBJ_DATA *obj;
-  PYOBJ_CHECK_OBJ_EXISTS(self->uid, obj);
+  PYOBJ_CHECK_OBJ_EXISTS(self, obj);
   objSetRdesc(obj, PyString_AsString(value));
   return 0;
 }
@@ -415,7 +411,7 @@ int PyObj_setmdesc(PyObj *self, PyObject *value, void *closure) {
   }
 
   OBJ_DATA *obj;
-  PYOBJ_CHECK_OBJ_EXISTS(self->uid, obj);
+  PYOBJ_CHECK_OBJ_EXISTS(self, obj);
   objSetMultiRdesc(obj, PyString_AsString(value));
   return 0;
 }
@@ -437,14 +433,14 @@ int PyObj_setweight(PyObj *self, PyObject *value, void *closure) {
   }
 
   OBJ_DATA *obj;
-  PYOBJ_CHECK_OBJ_EXISTS(self->uid, obj);
+  PYOBJ_CHECK_OBJ_EXISTS(self, obj);
   objSetWeightRaw(obj, weight);
   return 0;
 }
 
 int PyObj_sethidden(PyObject *self, PyObject *value, void *closure) {
   OBJ_DATA *obj = NULL;
-  PYOBJ_CHECK_OBJ_EXISTS(PyObj_AsUid(self), obj);
+  PYOBJ_CHECK_OBJ_EXISTS((PyObj *)self, obj);
 
   if(value == NULL || value == Py_None)
     objSetHidden(obj, 0);
@@ -472,7 +468,7 @@ int PyObj_setcarrier(PyObj *self, PyObject *value, void *closure) {
   }
 
   OBJ_DATA *obj;
-  PYOBJ_CHECK_OBJ_EXISTS(self->uid, obj);
+  PYOBJ_CHECK_OBJ_EXISTS(self, obj);
   CHAR_DATA *carrier = PyChar_AsChar(value);
   // remove us from whatever we're currently in
   if(objGetRoom(obj))
@@ -516,7 +512,7 @@ int PyObj_setroom(PyObj *self, PyObject *value, void *closure) {
   }
 
   OBJ_DATA *obj;
-  PYOBJ_CHECK_OBJ_EXISTS(self->uid, obj);
+  PYOBJ_CHECK_OBJ_EXISTS(self, obj);
   // remove us from whatever we're currently in
   if(objGetRoom(obj))
     obj_from_room(obj);
@@ -550,8 +546,8 @@ int PyObj_setcontainer(PyObj *self, PyObject *value, void *closure) {
   }
 
   OBJ_DATA *obj, *cont;
-  PYOBJ_CHECK_OBJ_EXISTS(self->uid, obj);
-  PYOBJ_CHECK_OBJ_EXISTS(((PyObj *)value)->uid, cont);
+  PYOBJ_CHECK_OBJ_EXISTS(self, obj);
+  PYOBJ_CHECK_OBJ_EXISTS((PyObj *)value, cont);
   // remove us from whatever we're currently in
   if(objGetRoom(obj))
     obj_from_room(obj);
@@ -599,7 +595,7 @@ PyObject *PyObj_attach(PyObj *self, PyObject *args) {
     worldGetType(gameworld, "trigger", 
 		 get_fullkey_relative(key, get_script_locale()));
   if(trig != NULL) {
-    triggerListAdd(objGetTriggers(obj), triggerGetKey(trig));
+    objAttachTrigger(obj, triggerGetKey(trig));
     return Py_BuildValue("i", 1);
   }
   else {
@@ -624,7 +620,7 @@ PyObject *PyObj_detach(PyObj *self, PyObject *args) {
   OBJ_DATA    *obj = PyObj_AsObj((PyObject *)self);
   if(obj != NULL) {
     const char *fkey = get_fullkey_relative(key, get_script_locale());
-    triggerListRemove(objGetTriggers(obj), fkey);
+    objDetachTrigger(obj, fkey);
     return Py_BuildValue("i", 1);
   }
   else {
@@ -961,9 +957,9 @@ PyObject *PyObj_load_obj(PyObject *self, PyObject *args) {
   else if(PyRoom_Check(in))
     room = PyRoom_AsRoom(in);
   else if(PyObj_Check(in))
-    cont = propertyTableGet(obj_table, PyObj_AsUid(in));
+    cont = uidTableGet(obj_table, PyObj_AsUid(in));
   else if(PyChar_Check(in))
-    ch = propertyTableGet(mob_table, PyChar_AsUid(in));
+    ch = uidTableGet(mob_table, PyChar_AsUid(in));
 
   // make sure a destination exists
   if(room == NULL && cont == NULL && ch == NULL && in != Py_None) {
@@ -1048,9 +1044,9 @@ PyObject *PyObj_count_objs(PyObject *self, PyObject *args) {
   else if(PyRoom_Check(in))
     room = PyRoom_AsRoom(in);
   else if(PyObj_Check(in))
-    cont = propertyTableGet(obj_table, PyObj_AsUid(in));
+    cont = uidTableGet(obj_table, PyObj_AsUid(in));
   else if(PyChar_Check(in))
-    ch   = propertyTableGet(mob_table, PyChar_AsUid(in));
+    ch   = uidTableGet(mob_table, PyChar_AsUid(in));
 
   // now find the list we're dealing with
   if(room) list = roomGetContents(room);
@@ -1090,14 +1086,14 @@ PyObject *PyObj_find_obj(PyObject *self, PyObject *args) {
     else if(PyRoom_Check(in))
       room = PyRoom_AsRoom(in);
     else if(PyObj_Check(in))
-      cont = propertyTableGet(obj_table, PyObj_AsUid(in));
+      cont = uidTableGet(obj_table, PyObj_AsUid(in));
     else if(PyChar_Check(in))
-      ch   = propertyTableGet(mob_table, PyChar_AsUid(in));
+      ch   = uidTableGet(mob_table, PyChar_AsUid(in));
   }
 
   // check to see who's looking
   if(looker && PyChar_Check(looker))
-    looker_ch = propertyTableGet(mob_table, PyChar_AsUid(looker));
+    looker_ch = uidTableGet(mob_table, PyChar_AsUid(looker));
 
   // now find the list we're dealing with
   if(room) list = roomGetContents(room);
@@ -1153,14 +1149,14 @@ PyObject *PyObj_find_obj_key(PyObject *self, PyObject *args) {
     else if(PyRoom_Check(in))
       room = PyRoom_AsRoom(in);
     else if(PyObj_Check(in))
-      cont = propertyTableGet(obj_table, PyObj_AsUid(in));
+      cont = uidTableGet(obj_table, PyObj_AsUid(in));
     else if(PyChar_Check(in))
-      ch   = propertyTableGet(mob_table, PyChar_AsUid(in));
+      ch   = uidTableGet(mob_table, PyChar_AsUid(in));
   }
 
   // check to see who's looking
   if(looker && PyChar_Check(looker))
-    looker_ch = propertyTableGet(mob_table, PyChar_AsUid(looker));
+    looker_ch = uidTableGet(mob_table, PyChar_AsUid(looker));
 
   // now, do the search
   int count = 1;
@@ -1186,11 +1182,12 @@ PyObject *PyObj_find_obj_key(PyObject *self, PyObject *args) {
 
 PyObject *PyObj_all_objs(PyObject *self) {
   PyObject      *list = PyList_New(0);
-  LIST_ITERATOR *obj_i = newListIterator(object_list);
+  LIST_ITERATOR obj_i;
+  listIteratorStart(&obj_i, object_list);
   OBJ_DATA        *obj = NULL;
-  ITERATE_LIST(obj, obj_i) {
+  ITERATE_LIST(obj, &obj_i) {
     PyList_Append(list, objGetPyFormBorrowed(obj));
-  } deleteListIterator(obj_i);
+  } listIteratorStop(&obj_i);
   return list;
 }
 
@@ -1426,12 +1423,19 @@ int PyObj_AsUid(PyObject *obj) {
 }
 
 OBJ_DATA *PyObj_AsObj(PyObject *obj) {
-  return propertyTableGet(obj_table, PyObj_AsUid(obj));
+  PyObj *self = (PyObj *)obj;
+  if(self->obj == NULL || self->generation != uidTableGeneration(obj_table)) {
+    self->obj        = uidTableGet(obj_table, self->uid);
+    self->generation = uidTableGeneration(obj_table);
+  }
+  return self->obj;
 }
 
 PyObject *
 newPyObj(OBJ_DATA *obj) {
   PyObj *py_obj = (PyObj *)PyObj_new(&PyObj_Type, NULL, NULL);
-  py_obj->uid = objGetUID(obj);
+  py_obj->uid        = objGetUID(obj);
+  py_obj->obj       = obj;
+  py_obj->generation = uidTableGeneration(obj_table);
   return (PyObject *)py_obj;
 }
@@ -18,6 +18,7 @@
 #include "../mud.h"
 #include "../utils.h"
 #include "../character.h"
+#include "scripts.h"
 #include "pyplugs.h"
 
 
@@ -87,6 +88,9 @@ bool PyModule_Reload(char *fname, char *mname) {
     else
       Py_DECREF(module);
     Py_DECREF(code);
+
+    // scripts may need to see the reloaded module's new contents
+    reset_script_dicts();
     return TRUE;
   }
 }
@@ -31,6 +31,7 @@
 #include "pyroom.h"
 #include "pymudsys.h"
 #include "pyauxiliary.h"
+#include "pylistview.h"
 
 
 
@@ -61,6 +62,8 @@ LIST *pyroom_methods = NULL;
 typedef struct {
   PyObject_HEAD
   int uid;
+  ROOM_DATA *room; // what uid was when we last looked it up, or NULL.
+  int generation; // room_table's generation then; if it changes, look it up again
 } PyRoom;
 
 
@@ -94,19 +97,21 @@ int PyRoom_init(PyRoom *self, PyObject *args, PyObject *kwds) {
   if(PyInt_Check(who)) {
     uid = (int)PyInt_AsLong(who);
     // make sure a room with the uid exists
-    if(!propertyTableGet(room_table, uid)) {
+    if(!uidTableGet(room_table, uid)) {
       PyErr_Format(PyExc_TypeError, 
 		   "Room with uid, %d, does not exist", uid);
       return -1;
     }
 
-    self->uid = uid;
+    self->uid  = uid;
+    self->room = NULL;
     return 0;
   }
   else if(PyString_Check(who)) {
     ROOM_DATA *room = NULL;
     if( (room = worldGetRoom(gameworld, get_fullkey_relative(PyString_AsString(who), get_script_locale()))) != NULL) {
-      self->uid = roomGetUID(room);
+      self->uid  = roomGetUID(room);
+      self->room = NULL;
       return 0;
     }
     // create a fresh room with the given key, and add it to the game
@@ -116,7 +121,8 @@ int PyRoom_init(PyRoom *self, PyObject *args, PyObject *kwds) {
 					      get_script_locale()));
       worldPutRoom(gameworld, roomGetClass(room), room);
       room_to_game(room);
-      self->uid = roomGetUID(room);
+      self->uid  = roomGetUID(room);
+      self->room = NULL;
       return 0;
     }
   }
@@ -281,53 +287,42 @@ PyObject *PyRoom_getexnames(PyRoom *self, void *closure) {
 
   PyObject      *list = PyList_New(0);
   LIST       *ex_list = roomGetExitNames(room);
-  LIST_ITERATOR *ex_i = newListIterator(ex_list);
+  LIST_ITERATOR ex_i;
+  listIteratorStart(&ex_i, ex_list);
   char           *dir = NULL;
-  ITERATE_LIST(dir, ex_i) {
+  ITERATE_LIST(dir, &ex_i) {
     PyObject    *cont = Py_BuildValue("s", dir);
     PyList_Append(list, cont);
     Py_DECREF(cont);
-  } deleteListIterator(ex_i);
+  } listIteratorStop(&ex_i);
   deleteListWith(ex_list, free);
   return list;
 }
 
+//
+// the lists of characters and objects in a room, for viewing from Python
+LIST *pyroom_chars_list(PyObject *self) {
+  ROOM_DATA *room = PyRoom_AsRoom(self);
+  return (room == NULL ? NULL : roomGetCharacters(room));
+}
+
+LIST *pyroom_contents_list(PyObject *self) {
+  ROOM_DATA *room = PyRoom_AsRoom(self);
+  return (room == NULL ? NULL : roomGetContents(room));
+}
+
 PyObject *PyRoom_getchars(PyRoom *self, PyObject *args) {
-  ROOM_DATA *room = PyRoom_AsRoom((PyObject *)self);
-  if(room == NULL)
+  if(PyRoom_AsRoom((PyObject *)self) == NULL)
     return NULL;
-  else {
-    LIST_ITERATOR *char_i = newListIterator(roomGetCharacters(room));
-    PyObject *list = PyList_New(0);
-    CHAR_DATA *ch;
-
-    // for each char in the room list, add him to a Python list
-    ITERATE_LIST(ch, char_i)
-      PyList_Append(list, charGetPyFormBorrowed(ch));
-    deleteListIterator(char_i);
-    PyObject *retval = Py_BuildValue("O", list);
-    Py_DECREF(list);
-    return retval;
-  }
+  return newPyListView((PyObject *)self, pyroom_chars_list,
+		       charGetPyFormBorrowed);
 }
 
 PyObject *PyRoom_getobjs(PyRoom *self, PyObject *args) {
-  ROOM_DATA *room = PyRoom_AsRoom((PyObject *)self);
-  if(room == NULL)
+  if(PyRoom_AsRoom((PyObject *)self) == NULL)
     return NULL;
-  else {
-    LIST_ITERATOR *obj_i = newListIterator(roomGetContents(room));
-    PyObject *list = PyList_New(0);
-    OBJ_DATA *obj;
-
-    // for each obj in the room list, add him to a Python list
-    ITERATE_LIST(obj, obj_i)
-      PyList_Append(list, objGetPyFormBorrowed(obj));
-    deleteListIterator(obj_i);
-    PyObject *retval = Py_BuildValue("O", list);
-    Py_DECREF(list);
-    return retval;
-  }
+  return newPyListView((PyObject *)self, pyroom_contents_list,
+		       objGetPyFormBorrowed);
 }
 
 PyObject *PyRoom_getbits(PyRoom *self, void *closure) {
@@ -340,11 +335,11 @@ PyObject *PyRoom_getbits(PyRoom *self, void *closure) {
 //
 // Standard check to make sure the room exists when trying to set a value for 
 // it. If successful, assign the room to rm. Otherwise, return -1 (error)
-#define PYROOM_CHECK_ROOM_EXISTS(uid, room)			  	\
-  room = propertyTableGet(room_table, uid);				\
+#define PYROOM_CHECK_ROOM_EXISTS(self, room)			  	\
+  room = PyRoom_AsRoom((PyObject *)self);				\
   if(room == NULL) {							\
     PyErr_Format(PyExc_TypeError,					\
-		 "Tried to modify nonexistent room, %d", uid);		\
+		 "Tried to modify nonexistent room, %d", (self)->uid);		\
     return -1;                                                          \
   }                                                                            
 
@@ -361,7 +356,7 @@ int PyRoom_setname(PyRoom *self, PyObject *value, void *closure) {
   }
 
   ROOM_DATA *room;
-  PYROOM_CHECK_ROOM_EXISTS(self->uid, room);
+  PYROOM_CHECK_ROOM_EXISTS(self, room);
   roomSetName(room, PyString_AsString(value));
   return 0;
 }
@@ -379,7 +374,7 @@ int PyRoom_setdesc(PyRoom *self, PyObject *value, void *closure) {
   }
 
   ROOM_DATA *room;
-  PYROOM_CHECK_ROOM_EXISTS(self->uid, room);
+  PYROOM_CHECK_ROOM_EXISTS(self, room);
   roomSetDesc(room, PyString_AsString(value));
   return 0;
 }
@@ -403,7 +398,7 @@ int PyRoom_setterrain(PyRoom *self, PyObject *value, void *closure) {
 
 
   ROOM_DATA *room;
-  PYROOM_CHECK_ROOM_EXISTS(self->uid, room);
+  PYROOM_CHECK_ROOM_EXISTS(self, room);
   roomSetTerrain(room, terrainGetNum(PyString_AsString(value)));
   return 0;
 }
@@ -420,7 +415,7 @@ int PyRoom_setbits(PyRoom *self, PyObject *value, void *closure) {
   }
 
   ROOM_DATA *room;
-  PYROOM_CHECK_ROOM_EXISTS(self->uid, room);
+  PYROOM_CHECK_ROOM_EXISTS(self, room);
   bitClear(roomGetBits(room));
   bitSet(roomGetBits(room), PyString_AsString(value));
   return 0;
@@ -651,11 +646,12 @@ PyObject *PyRoom_dig(PyRoom *self, PyObject *value) {
       CMD_DATA *cmd = newPyCmd(cdir, get_cmd_move(), "player", TRUE);
 
       // add all of our movement checks
-      LIST_ITERATOR *chk_i = newListIterator(get_move_checks());
+      LIST_ITERATOR chk_i;
+      listIteratorStart(&chk_i, get_move_checks());
       PyObject        *chk = NULL;
-      ITERATE_LIST(chk, chk_i) {
+      ITERATE_LIST(chk, &chk_i) {
 	cmdAddPyCheck(cmd, chk);
-      } deleteListIterator(chk_i);
+      } listIteratorStop(&chk_i);
 
       //cmdAddCheck(cmd, chk_can_move);
       roomAddCmd(room, cdir, NULL, cmd);
@@ -691,7 +687,7 @@ PyObject *PyRoom_attach(PyRoom *self, PyObject *args) {
     worldGetType(gameworld, "trigger", 
 		 get_fullkey_relative(key, get_script_locale()));
   if(trig != NULL) {
-    triggerListAdd(roomGetTriggers(room), triggerGetKey(trig));
+    roomAttachTrigger(room, triggerGetKey(trig));
     return Py_BuildValue("i", 1);
   }
   else {
@@ -717,7 +713,7 @@ PyObject *PyRoom_detach(PyRoom *self, PyObject *args) {
   ROOM_DATA *room = PyRoom_AsRoom((PyObject *)self);
   if(room != NULL) {
     const char *fkey = get_fullkey_relative(key, get_script_locale());
-    triggerListRemove(roomGetTriggers(room), fkey);
+    roomDetachTrigger(room, fkey);
     return Py_BuildValue("i", 1);
   }
   else {
@@ -974,7 +970,7 @@ PyObject *PyRoom_reset(PyRoom *self, void *closure) {
 		 self->uid);
     return NULL;
   }
-  hookRun("reset_room", hookBuildInfo("rm", room));
+  hookRunTyped("reset_room", "rm", room);
   return Py_BuildValue("");
 }
 
@@ -1266,7 +1262,12 @@ int PyRoom_AsUid(PyObject *room) {
 }
 
 ROOM_DATA *PyRoom_AsRoom(PyObject *room) {
-  return propertyTableGet(room_table, PyRoom_AsUid(room));
+  PyRoom *self = (PyRoom *)room;
+  if(self->room == NULL || self->generation != uidTableGeneration(room_table)) {
+    self->room        = uidTableGet(room_table, self->uid);
+    self->generation = uidTableGeneration(room_table);
+  }
+  return self->room;
 }
 
 int PyRoom_Check(PyObject *value) {
@@ -1276,6 +1277,8 @@ int PyRoom_Check(PyObject *value) {
 PyObject *
 newPyRoom(ROOM_DATA *room) {
   PyRoom *py_room = (PyRoom *)PyRoom_new(&PyRoom_Type, NULL, NULL);
-  py_room->uid = roomGetUID(room);
+  py_room->uid        = roomGetUID(room);
+  py_room->room      = room;
+  py_room->generation = uidTableGeneration(room_table);
   return (PyObject *)py_room;
 }
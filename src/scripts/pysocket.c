@@ -11,6 +11,7 @@
 #include "../utils.h"
 #include "../socket.h"
 #include "../character.h"
+#include "../colour.h"
 
 #include "scripts.h"
 #include "pyplugs.h"
@@ -69,7 +70,7 @@ int PySocket_init(PySocket *self, PyObject *args, PyObject *kwds) {
   }
 
   // make sure an socket with this name exists
-  if(!propertyTableGet(sock_table, uid)) {
+  if(!uidTableGet(sock_table, uid)) {
     PyErr_Format(PyExc_TypeError, "Socket with uid, %d, does not exist", uid);
     return -1;
   }
@@ -159,6 +160,65 @@ int PySocket_set_outbound_text(PySocket *self, PyObject *value, void *closure) {
   }
 }
 
+PyObject *PySocket_getcolour(PySocket *self, void *closure) {
+  SOCKET_DATA *sock = PySocket_AsSocket((PyObject *)self);
+  if(sock == NULL)
+    return NULL;
+  else
+    return Py_BuildValue("i", socketGetColour(sock));
+}
+
+int PySocket_setcolour(PySocket *self, PyObject *value, void *closure) {
+  SOCKET_DATA *sock = PySocket_AsSocket((PyObject *)self);
+  if(sock == NULL)
+    return -1;
+  else {
+    socketSetColour(sock, PyObject_IsTrue(value));
+    return 0;
+  }
+}
+
+PyObject *PySocket_getcompresslevel(PySocket *self, void *closure) {
+  SOCKET_DATA *sock = PySocket_AsSocket((PyObject *)self);
+  if(sock == NULL)
+    return NULL;
+  else
+    return Py_BuildValue("i", socketGetCompressLevel(sock));
+}
+
+int PySocket_setcompresslevel(PySocket *self, PyObject *value, void *closure) {
+  SOCKET_DATA *sock = PySocket_AsSocket((PyObject *)self);
+  if(sock == NULL)
+    return -1;
+  else if(!PyInt_Check(value) ||
+	  !socketSetCompressLevel(sock, (int)PyInt_AsLong(value))) {
+    PyErr_Format(PyExc_ValueError, "Compression levels run from 0 to 9.");
+    return -1;
+  }
+  return 0;
+}
+
+PyObject *PySocket_getcompressmemlevel(PySocket *self, void *closure) {
+  SOCKET_DATA *sock = PySocket_AsSocket((PyObject *)self);
+  if(sock == NULL)
+    return NULL;
+  else
+    return Py_BuildValue("i", socketGetCompressMemLevel(sock));
+}
+
+int PySocket_setcompressmemlevel(PySocket *self, PyObject *value,
+				 void *closure) {
+  SOCKET_DATA *sock = PySocket_AsSocket((PyObject *)self);
+  if(sock == NULL)
+    return -1;
+  else if(!PyInt_Check(value) ||
+	  !socketSetCompressMemLevel(sock, (int)PyInt_AsLong(value))) {
+    PyErr_Format(PyExc_ValueError, "Compression memLevels run from 1 to 9.");
+    return -1;
+  }
+  return 0;
+}
+
 PyObject *PySocket_get_can_use(PySocket *self, void *closure) {
   SOCKET_DATA *sock = PySocket_AsSocket((PyObject *)self);
   if(sock == NULL)
@@ -464,10 +524,29 @@ PyObject *PySocket_all_sockets(PyObject *self) {
   return retval;
 }
 
+PyObject *PySocket_add_colour_code(PyObject *self, PyObject *args) {
+  char       *code = NULL;
+  char   *sequence = NULL;
+  if(!PyArg_ParseTuple(args, "sz", &code, &sequence))
+    return NULL;
+  else if(strlen(code) != 1 || *code == '{') {
+    PyErr_Format(PyExc_ValueError, 
+		 "Colour codes must be one character, other than {.");
+    return NULL;
+  }
+  colourAddCode(*code, sequence);
+  return Py_BuildValue("");
+}
+
 PyMethodDef socket_module_methods[] = {
   { "socket_list", (PyCFunction)PySocket_all_sockets, METH_NOARGS,
     "socket_list()\n\n"
     "Returns a list of all sockets currently connected." },
+  { "add_colour_code", PySocket_add_colour_code, METH_VARARGS,
+    "add_colour_code(code, sequence)\n\n"
+    "Makes {code in outbound text turn into sequence (e.g. an ANSI escape\n"
+    "sequence). Replaces whatever the code did before. A sequence of None\n"
+    "makes the code stop being a code." },
   {NULL, NULL, 0, NULL}  /* Sentinel */
 };
 
@@ -526,6 +605,17 @@ init_PySocket(void) {
     PySocket_addGetSetter("outbound_text",
        PySocket_get_outbound_text, PySocket_set_outbound_text,
        "The socket's outbound text.");
+    PySocket_addGetSetter("colour", PySocket_getcolour, PySocket_setcolour,
+       "True or False if colour codes sent to the socket become colours. If\n"
+       "False, the codes are removed from outbound text instead.");
+    PySocket_addGetSetter("compress_level",
+       PySocket_getcompresslevel, PySocket_setcompresslevel,
+       "The zlib level (0 to 9) MCCP compresses the socket's output with.\n"
+       "Higher levels compress better, but cost more time every pulse.");
+    PySocket_addGetSetter("compress_mem_level",
+       PySocket_getcompressmemlevel, PySocket_setcompressmemlevel,
+       "The zlib memLevel (1 to 9) MCCP compresses the socket's output with.\n"
+       "Only takes effect the next time the socket starts compressing.");
     PySocket_addGetSetter("can_use", PySocket_get_can_use, NULL,
       "True or False if the socket is ready for use. Socket becomes available\n"
       "after its dns addresss resolves. Immutable.");
@@ -611,7 +701,7 @@ int PySocket_AsUid(PyObject *sock) {
 }
 
 SOCKET_DATA *PySocket_AsSocket(PyObject *ch) {
-  return propertyTableGet(sock_table, PySocket_AsUid(ch));
+  return uidTableGet(sock_table, PySocket_AsUid(ch));
 }
 
 PyObject *
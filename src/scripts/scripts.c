@@ -41,6 +41,7 @@
 #include "pyauxiliary.h"
 #include "trighooks.h"
 #include "pyolc.h"
+#include "pylistview.h"
 
 // online editor stuff
 #include "../editor/editor.h"
@@ -65,17 +66,36 @@
 typedef struct {
   LIST   *triggers;
   PyObject *pyform;
+  HASHTABLE *index; // trigger type -> list of the attached triggers of it
+  int  index_version; // the trigger_version our index was built at
 } TRIGGER_AUX_DATA;
 
+// bumped whenever a trigger is attached, detached, or has its type or key
+// changed. Attaching and detaching only throw away the index of the thing
+// they were done to. Other changes can touch anything's triggers, so they
+// set trigger_edited, and every index built before it is rebuilt when next used
+int trigger_version = 0;
+int trigger_edited  = 0;
+
+//
+// the thing's triggers were attached or detached. Throw away its index
+void trigger_aux_changed(TRIGGER_AUX_DATA *data) {
+  data->index_version = NOTHING;
+  trigger_version++;
+}
+
 TRIGGER_AUX_DATA *newTriggerAuxData(void) {
   TRIGGER_AUX_DATA *data = malloc(sizeof(TRIGGER_AUX_DATA));
   data->triggers         = newList();
   data->pyform           = NULL;
+  data->index            = NULL;
+  data->index_version    = NOTHING;
   return data;
 }
 
 void deleteTriggerAuxData(TRIGGER_AUX_DATA *data) {
   deleteListWith(data->triggers, free);
+  if(data->index) deleteHashtableWith(data->index, deleteList);
   if(data->pyform && data->pyform->ob_refcnt > 1)
     log_string("LEAK: Memory leak (%d refcnt) on someone or something's pyform",
 	       (int)data->pyform->ob_refcnt);
@@ -86,6 +106,7 @@ void deleteTriggerAuxData(TRIGGER_AUX_DATA *data) {
 void triggerAuxDataCopyTo(TRIGGER_AUX_DATA *from, TRIGGER_AUX_DATA *to) {
   deleteListWith(to->triggers, free);
   to->triggers = listCopyWith(from->triggers, strdup);
+  trigger_aux_changed(to);
 }
 
 TRIGGER_AUX_DATA *triggerAuxDataCopy(TRIGGER_AUX_DATA *data) {
@@ -102,6 +123,8 @@ TRIGGER_AUX_DATA *triggerAuxDataRead(STORAGE_SET *set) {
   TRIGGER_AUX_DATA *data = malloc(sizeof(TRIGGER_AUX_DATA));
   data->triggers = gen_read_list(read_list(set, "triggers"), read_one_trigger);
   data->pyform   = NULL;
+  data->index    = NULL;
+  data->index_version = NOTHING;
   return data;
 }
 
@@ -127,6 +150,11 @@ STORAGE_SET *triggerAuxDataStore(TRIGGER_AUX_DATA *data) {
 // a stack that keeps track of the locale scripts are running in
 LIST *locale_stack = NULL;
 
+//
+// templates for expanding dynamic descriptions, by the text they were parsed
+// from. See expand_dynamic_descs_dict()
+HASHTABLE *dyn_templates = NULL;
+
 //
 // Many thanks to Xanthros who pointed out that, if two scripts trigger
 // eachother, we could get tossed into an infinite loop. He suggested a
@@ -138,10 +166,10 @@ int script_loop_depth   = 0;
 // a local variable used for storing whether or not the last script ran fine
 bool script_ok = TRUE;
 
-void expand_char_dynamic_descs(const char *info) {
+void expand_char_dynamic_descs(HOOK_ARGS *args) {
   CHAR_DATA *me = NULL;
   CHAR_DATA *ch = NULL;
-  hookParseInfo(info, &me, &ch);
+  hookArgsParse(args, &me, &ch);
 
   // if we're an NPC, do some special work for displaying us. We don't do 
   // dynamic descs for PCs because they will probably be describing themselves,
@@ -155,10 +183,10 @@ void expand_char_dynamic_descs(const char *info) {
   }
 }
 
-void  expand_obj_dynamic_descs(const char *info) {
+void  expand_obj_dynamic_descs(HOOK_ARGS *args) {
   OBJ_DATA  *me = NULL;
   CHAR_DATA *ch = NULL;
-  hookParseInfo(info, &me, &ch);
+  hookArgsParse(args, &me, &ch);
 
   PyObject *pyme = objGetPyForm(me);
   char   *locale = strdup(get_key_locale(objGetClass(me))); 
@@ -167,10 +195,10 @@ void  expand_obj_dynamic_descs(const char *info) {
   free(locale);
 }
 
-void expand_room_dynamic_descs(const char *info) {
+void expand_room_dynamic_descs(HOOK_ARGS *args) {
   ROOM_DATA *me = NULL;
   CHAR_DATA *ch = NULL;
-  hookParseInfo(info, &me, &ch);
+  hookArgsParse(args, &me, &ch);
 
   PyObject *pyme = roomGetPyForm(me);
   char   *locale = strdup(get_key_locale(roomGetClass(me))); 
@@ -179,10 +207,10 @@ void expand_room_dynamic_descs(const char *info) {
   free(locale);
 }
 
-void expand_exit_dynamic_descs(const char *info) {
+void expand_exit_dynamic_descs(HOOK_ARGS *args) {
   EXIT_DATA *me = NULL;
   CHAR_DATA *ch = NULL;
-  hookParseInfo(info, &me, &ch);
+  hookArgsParse(args, &me, &ch);
 
   PyObject *pyme = newPyExit(me);
   char   *locale = strdup(get_key_locale(roomGetClass(exitGetRoom(me)))); 
@@ -195,7 +223,7 @@ void finalize_scripts(void) {
   Py_Finalize();
 }
 
-void finalize_scripts_hook(const char *info) {
+void finalize_scripts_hook(HOOK_ARGS *args) {
   finalize_scripts();
 }
 
@@ -251,15 +279,15 @@ COMMAND(cmd_attach) {
     // what are we trying to attach it to?
     if(found_type == PARSE_CHAR) {
       send_to_char(ch, "Trigger %s attached to %s.\r\n", key, charGetName(tgt));
-      triggerListAdd(charGetTriggers(tgt), triggerGetKey(trig));
+      charAttachTrigger(tgt, triggerGetKey(trig));
     }
     else if(found_type == PARSE_ROOM) {
       send_to_char(ch, "Trigger %s attached to %s.\r\n", key, roomGetName(tgt));
-      triggerListAdd(roomGetTriggers(tgt), triggerGetKey(trig));
+      roomAttachTrigger(tgt, triggerGetKey(trig));
     }
     else {
       send_to_char(ch, "Trigger %s attached to %s.\r\n", key, objGetName(tgt));
-      triggerListAdd(objGetTriggers(tgt), triggerGetKey(trig));
+      objAttachTrigger(tgt, triggerGetKey(trig));
     }
   }  
 }
@@ -288,17 +316,17 @@ COMMAND(cmd_detach) {
     if(found_type == PARSE_CHAR) {
       send_to_char(ch, "Trigger %s detached from %s.\r\n", key,
 		   charGetName(tgt));
-      triggerListRemove(charGetTriggers(tgt), triggerGetKey(trig));
+      charDetachTrigger(tgt, triggerGetKey(trig));
     }
     else if(found_type == PARSE_ROOM) {
       send_to_char(ch, "Trigger %s detached from %s.\r\n", key,
 		   roomGetName(tgt));
-      triggerListRemove(roomGetTriggers(tgt), triggerGetKey(trig));
+      roomDetachTrigger(tgt, triggerGetKey(trig));
     }
     else {
       send_to_char(ch, "Trigger %s detached to %s.\r\n", key,
 		   objGetName(tgt));
-      triggerListRemove(objGetTriggers(tgt), triggerGetKey(trig));
+      objDetachTrigger(tgt, triggerGetKey(trig));
     }
   }
 }
@@ -338,13 +366,15 @@ COMMAND(cmd_trename) {
 // implementation of scripts.h - triggers portion in triggers.c
 //*****************************************************************************
 void init_scripts(void) {
-  // create our locale stack
-  locale_stack = newList();
+  // create our locale stack, and our table of dynamic description templates
+  locale_stack  = newList();
+  dyn_templates = newHashtable();
 
   // initialize python
   Py_Initialize();
 
   // initialize all of our modules written in C
+  init_PyListView();
   init_PyMudSys();
   init_PyAuxiliary();
   init_PyEvent();
@@ -380,11 +410,11 @@ void init_scripts(void) {
 				       triggerAuxDataStore,triggerAuxDataRead));
 
   // add in some hooks for preprocessing scripts embedded in descs
-  hookAdd("preprocess_room_desc", expand_room_dynamic_descs);
-  hookAdd("preprocess_char_desc", expand_char_dynamic_descs);
-  hookAdd("preprocess_obj_desc",  expand_obj_dynamic_descs);
-  hookAdd("preprocess_exit_desc", expand_exit_dynamic_descs);
-  hookAdd("shutdown", finalize_scripts_hook);
+  hookAddTyped("preprocess_room_desc", expand_room_dynamic_descs);
+  hookAddTyped("preprocess_char_desc", expand_char_dynamic_descs);
+  hookAddTyped("preprocess_obj_desc",  expand_obj_dynamic_descs);
+  hookAddTyped("preprocess_exit_desc", expand_exit_dynamic_descs);
+  hookAddTyped("shutdown", finalize_scripts_hook);
 
   /*
   // add new player commands
@@ -400,6 +430,24 @@ void init_scripts(void) {
   add_cmd("trename", NULL, cmd_trename,"scripter", FALSE);
 }
 
+//
+// Every script used to get a dictionary with all of the mud's modules merged
+// into it. That meant importing and merging hundreds of names every time a
+// trigger fired. Now, the merging is done once and the result is cached. For
+// restricted scripts, the cached names go in with the restricted builtins, and
+// a copy of that is handed to the script as its __builtins__. Python looks
+// there for any name the script doesn't set itself, so each script's own
+// dictionary only has to hold its own variables (me, ch, etc). The copy is
+// needed because Python will only take a real dictionary for __builtins__,
+// and a script that changed a shared one would change it for every script
+// that ran after it. Copying a dictionary is cheap next to building it.
+
+// all of the names from the mud's modules
+PyObject *script_names = NULL;
+
+// the restricted builtins, with script_names merged over them
+PyObject *restricted_builtins = NULL;
+
 //
 // makes a dictionary with all of the neccessary stuff in it, but without
 // a __builtin__ module set
@@ -438,22 +486,49 @@ PyObject *mud_script_dict(void) {
   return dict;
 }
 
-PyObject *restricted_script_dict(void) {
-  // build up our basic dictionary
-  PyObject *dict = mud_script_dict();
-  
-  // add restricted builtin modules
-  PyObject *builtins = PyImport_ImportModule("__restricted_builtin__");
-  if(builtins != NULL) {
-    PyDict_SetItemString(dict, "__builtins__", builtins);
-    Py_DECREF(builtins);
+//
+// return the names from the mud's modules, merging them if we haven't yet
+PyObject *get_script_names(void) {
+  if(script_names == NULL)
+    script_names = mud_script_dict();
+  return script_names;
+}
+
+//
+// return the restricted builtins with the mud's names merged in, building
+// them if we haven't yet
+PyObject *get_restricted_builtins(void) {
+  if(restricted_builtins == NULL) {
+    restricted_builtins = PyDict_New();
+    PyObject *builtins = PyImport_ImportModule("__restricted_builtin__");
+    if(builtins != NULL) {
+      PyDict_Update(restricted_builtins, PyModule_GetDict(builtins));
+      Py_DECREF(builtins);
+    }
+    PyDict_Update(restricted_builtins, get_script_names());
   }
+  return restricted_builtins;
+}
 
+void reset_script_dicts(void) {
+  Py_XDECREF(script_names);
+  Py_XDECREF(restricted_builtins);
+  script_names        = NULL;
+  restricted_builtins = NULL;
+}
+
+PyObject *restricted_script_dict(void) {
+  PyObject *dict     = PyDict_New();
+  PyObject *builtins = PyDict_Copy(get_restricted_builtins());
+  PyDict_SetItemString(dict, "__builtins__", builtins);
+  Py_DECREF(builtins);
   return dict;
 }
 
 PyObject *unrestricted_script_dict(void) {
-  PyObject *dict = mud_script_dict();
+  // scripts with the real builtins can't have our names slipped in with
+  // them; Python would consider them restricted. They get a copy instead
+  PyObject *dict = PyDict_Copy(get_script_names());
 
   // add builtins
   PyObject *builtins = PyImport_ImportModule("__builtin__");
@@ -530,188 +605,293 @@ PyObject *eval_script(PyObject *dict, const char *statement,const char *locale){
 }
 
 //
-// Tries to expand out a conditional statement. Returns whatever is expanded.
-// Moves i to the proper place after the conditional has been expanded in the
-// originating buffer.
-BUFFER *expand_dynamic_conditional(BUFFER *desc,     PyObject *dict, 
-				   PyObject *retval, const char *locale,
-				   int *pos) {
-  BUFFER *new_desc = newBuffer(bufferLength(desc)*2);
-  BUFFER     *code = newBuffer(1); // code we have to evaluate
-  int         j, i = *pos + 1;     // +1 to skip the current closing ]
-  bool       match = PyObject_IsTrue(retval);
+// Dynamic descriptions are parsed once into a template: spans of literal text,
+// compiled expressions, and conditionals. Templates are kept in a table by the
+// text they were parsed from, so when a description changes, the new text
+// simply gets a new template. The table is emptied out when it gets too big
+#define DYN_TEMPLATE_TABLE_MAX  2000
 
-  while(TRUE) {
-    // copy over all of our contents for the new desc and increment i
-    while(*(bufferString(desc)+i) &&
-	  !startswith(bufferString(desc)+i, "[else]") &&
-	  !startswith(bufferString(desc)+i, "[elif ") &&
-	  !startswith(bufferString(desc)+i, "[/if]")) {
-      if(match == TRUE)
-	bprintf(new_desc, "%c", *(bufferString(desc) + i));
-      i++;
-    }
+#define DYN_TEXT                   0
+#define DYN_EXPR                   1
+#define DYN_IF                     2
 
-    // did we terminate?
-    if(match == TRUE || startswith(bufferString(desc)+i, "[/if]"))
-      break;
-    // we haven't had a match yet. Are we trying an else or elif?
-    else if(startswith(bufferString(desc)+i, "[else]")) {
-      match  = TRUE;
-      i     += 6;
+typedef struct dyn_template DYN_TEMPLATE;
+
+typedef struct {
+  char          *code; // the code to evaluate. NULL for an [else]
+  PyObject    *pycode; // code, compiled. NULL if it did not compile
+  DYN_TEMPLATE  *body; // what we expand to if we are the branch taken
+} DYN_BRANCH;
+
+typedef struct {
+  int            type;
+  int           start; // where our text is in the template source (DYN_TEXT)
+  int             len;
+  DYN_BRANCH   *exprs; // our expression (DYN_EXPR), or [if], [elif]s, [else]
+  int       num_exprs;
+} DYN_NODE;
+
+struct dyn_template {
+  char     *source; // the text we were parsed from
+  DYN_NODE  *nodes;
+  int    num_nodes;
+};
+
+// how many templates are being expanded right now. Expressions can expand
+// other dynamic descriptions, so we can't empty out the table while this is
+// above zero
+int dyn_expand_depth = 0;
+
+DYN_TEMPLATE *newDynTemplate(const char *source, int len);
+
+void deleteDynTemplate(DYN_TEMPLATE *tmpl) {
+  int i, j;
+  for(i = 0; i < tmpl->num_nodes; i++) {
+    for(j = 0; j < tmpl->nodes[i].num_exprs; j++) {
+      DYN_BRANCH *branch = &tmpl->nodes[i].exprs[j];
+      if(branch->code) free(branch->code);
+      if(branch->body) deleteDynTemplate(branch->body);
+      Py_XDECREF(branch->pycode);
     }
-    else if(startswith(bufferString(desc)+i, "[elif ")) {
-      // skip the elif and spaces
-      i += 6;
-      while(isspace(*(bufferString(desc)+i)))
-	i++;
+    if(tmpl->nodes[i].exprs) free(tmpl->nodes[i].exprs);
+  }
+  if(tmpl->nodes) free(tmpl->nodes);
+  free(tmpl->source);
+  free(tmpl);
+}
 
-      // find our end
-      int end = next_letter_in(bufferString(desc) + i, ']');
+//
+// add a new node to the end of the template, and return it
+DYN_NODE *dyn_template_add(DYN_TEMPLATE *tmpl, int type) {
+  tmpl->nodes = realloc(tmpl->nodes, sizeof(DYN_NODE) * (tmpl->num_nodes + 1));
+  DYN_NODE *node = &tmpl->nodes[tmpl->num_nodes++];
+  memset(node, 0, sizeof(DYN_NODE));
+  node->type = type;
+  return node;
+}
 
-      // make sure we have it
-      if(end == -1)
-	break;
+//
+// add a new branch to the node. Takes over code. If code does not compile, its
+// error is reported when the branch is evaluated
+void dyn_node_add(DYN_NODE *node, char *code, DYN_TEMPLATE *body) {
+  node->exprs = realloc(node->exprs, sizeof(DYN_BRANCH) * (node->num_exprs+1));
+  DYN_BRANCH *branch = &node->exprs[node->num_exprs++];
+  branch->code   = code;
+  branch->body   = body;
+  branch->pycode = NULL;
+  if(code != NULL &&
+     (branch->pycode = Py_CompileString(code, "<string>", Py_eval_input))==NULL)
+    PyErr_Clear();
+}
 
-      // copy everything between start and end, and format the code
-      bufferClear(code);
-      for(j = 0; j < end; j++)
-	bprintf(code, "%c", *(bufferString(desc) + i + j));
-      bufferReplace(code, "\n", "", TRUE);
+//
+// copy len characters of the text, taking out every occurence of strip and
+// replacing newlines with newline
+char *dyn_code_copy(const char *text, int len, const char *newline, 
+		    const char *strip) {
+  BUFFER *buf = newBuffer(len + 1);
+  char  *code = NULL;
+  bufferCatLength(buf, text, len);
+  bufferReplace(buf, "\n", newline, TRUE);
+  if(strip != NULL)
+    bufferReplace(buf, strip, "", TRUE);
+  code = strdup(bufferString(buf));
+  deleteBuffer(buf);
+  return code;
+}
 
-      // skip i up to and beyond the ] marker
-      i = i + end + 1;
-      
-      // evaluate the code
-      PyObject *retval = eval_script(dict, bufferString(code), locale);
-      match            = retval && PyObject_IsTrue(retval);
+//
+// Parses a conditional statement, starting just after the closing ] of the
+// [if]. Adds a branch to the node for the [if] and every [elif] and [else] up
+// to the closing [/if], and moves i to just after it.
+void dyn_parse_conditional(DYN_NODE *node, const char *src, char *cond, int *pos){
+  int i = *pos, start, end;
+
+  while(TRUE) {
+    // everything up to the next marker is what we expand to if we match
+    for(start = i; src[i] &&
+	  !startswith(src + i, "[else]") &&
+	  !startswith(src + i, "[elif ") &&
+	  !startswith(src + i, "[/if]"); i++)
+      ;
+    dyn_node_add(node, cond, (i > start ? newDynTemplate(src+start, i-start) :
+			      NULL));
+
+    // did we terminate? Nothing after an [else] can ever match
+    if(cond == NULL || !src[i] || startswith(src + i, "[/if]"))
+      break;
+    // are we trying an else or elif?
+    else if(startswith(src + i, "[else]")) {
+      cond  = NULL;
+      i    += 6;
+    }
+    else {
+      // skip the elif and spaces
+      for(i += 6; isspace(src[i]); i++)
+	;
 
-      // did we encounter an error?
-      if(retval == NULL)
+      // find our end, and make sure we have it
+      if((end = next_letter_in(src + i, ']')) == -1)
 	break;
+      cond = dyn_code_copy(src + i, end, "", NULL);
+      i    = i + end + 1;
     }
   }
 
-  // skip everything up to our closing [/if]
-  while(*(bufferString(desc)+i) && !startswith(bufferString(desc)+i, "[/if]"))
+  // skip everything up to and past our closing [/if]
+  while(src[i] && !startswith(src + i, "[/if]"))
     i++;
-  if(startswith(bufferString(desc)+i, "[/if]"))
-    i += 4; // put us at the closing ], not the end of the ending if block
-
-  // garbage collection
-  deleteBuffer(code);
- 
-  // return our expansion and move our i
+  if(src[i])
+    i += 5;
   *pos = i;
-  return new_desc;
 }
 
-void expand_dynamic_descs_dict(BUFFER *desc, PyObject *dict,const char *locale){
-  // make our new buffer
-  BUFFER *new_desc = newBuffer(bufferLength(desc)*2);
-  BUFFER     *code = newBuffer(1); // for things we have to evaluate
-  bool   proc_cond = FALSE; // are we processing a conditional statement?
-
-  // copy over all of our description that is not dynamic text
-  int start, end, i, j, size = bufferLength(desc);
-  for(i = 0; i < size; i++) {
-    // figure out when our next dynamic desc is.
-    start = next_letter_in(bufferString(desc) + i, '[');
-
-    // no more
-    if(start == -1) {
-      // copy the rest and skip to the end of the buffer
-      bprintf(new_desc, "%s", bufferString(desc) + i);
-      i = size - 1;
+//
+// parse the first len characters of source into a template
+DYN_TEMPLATE *newDynTemplate(const char *source, int len) {
+  DYN_TEMPLATE *tmpl = calloc(1, sizeof(DYN_TEMPLATE));
+  DYN_NODE     *node = NULL;
+  int    i, start, end;
+  tmpl->source = strndup(source, len);
+
+  for(i = 0; i < len; ) {
+    // figure out when our next dynamic desc is
+    start = next_letter_in(tmpl->source + i, '[');
+
+    // copy everything up to it
+    if(start != 0) {
+      node        = dyn_template_add(tmpl, DYN_TEXT);
+      node->start = i;
+      node->len   = (start == -1 ? len - i : start);
     }
-    // we have another desc
-    else {
-      // copy everything up to start
-      while(start > 0) {
-	bprintf(new_desc, "%c", *(bufferString(desc) + i));
-	start--;
-	i++;
-      }
-
-      // skip the start marker
-      i++;
+    if(start == -1)
+      break;
 
-      // find our end
-      end = next_letter_in(bufferString(desc) + i, ']');
+    // skip the start marker, and find our end. Without an end, whatever is
+    // left over is left out
+    i = i + start + 1;
+    if((end = next_letter_in(tmpl->source + i, ']')) == -1)
+      break;
+    char *code = dyn_code_copy(tmpl->source + i, end, " ", "\r");
+    i = i + end + 1;
+
+    // are we processing a conditional statement?
+    if(!strncasecmp(code, "if ", 3)) {
+      char *ptr = code + 3;
+      while(isspace(*ptr))
+	ptr++;
+      char *cond = strdup(ptr);
+      free(code);
+      dyn_parse_conditional(dyn_template_add(tmpl, DYN_IF), tmpl->source,
+			    cond, &i);
+    }
+    else
+      dyn_node_add(dyn_template_add(tmpl, DYN_EXPR), code, NULL);
+  }
 
-      // make sure we have it
-      if(end == -1)
-	break;
+  return tmpl;
+}
 
-      // copy everything between start and end, and format the code
-      bufferClear(code);
-      for(j = 0; j < end; j++)
-	bprintf(code, "%c", *(bufferString(desc) + i + j));
-      bufferReplace(code, "\n", " ", TRUE);
-      bufferReplace(code, "\r", "", TRUE);
-
-      // skip i up to the end
-      i = i + end;
-
-      // are we trying to process a conditional statement?
-      if(!strncasecmp(bufferString(code), "if ", 3)) {
-	// strip out the leading if and whitespace
-	char *code_copy = strdup(bufferString(code));
-	char       *ptr = code_copy + 3;
-	while(isspace(*ptr)) ptr++;
-	
-	// copy over the cleaned-up code, signal we're processing a conditional
-	bufferClear(code);
-	bufferCat(code, ptr);
-	proc_cond = TRUE;
-
-	// garbage collection
-	free(code_copy);
-      }
+//
+// evaluate one expression in a template
+PyObject *dyn_branch_eval(DYN_BRANCH *branch, PyObject *dict, 
+			  const char *locale) {
+  // if we didn't compile, eval_script will report why
+  if(branch->pycode == NULL)
+    return eval_script(dict, branch->code, locale);
 
-      // evaluate the code
-      PyObject *retval = eval_script(dict, bufferString(code), locale);
+  listPush(locale_stack, strdupsafe(locale));
+  PyObject *retval = PyEval_EvalCode((PyCodeObject *)branch->pycode,dict,dict);
+  if(retval == NULL)
+    log_pyerr("eval_script terminated with an error:\r\n%s", branch->code);
+  free(listPop(locale_stack));
+  return retval;
+}
 
-      // did we encounter an error?
-      if(retval == NULL)
-	break;
-      // are we evaluating a conditional or no?
-      else if(proc_cond) {
-	BUFFER *cond_retval =
-	  expand_dynamic_conditional(desc, dict, retval, locale, &i);
-
-	// if we have something to print, expand its embedded python
-	if(*bufferString(cond_retval))
-	  expand_dynamic_descs_dict(cond_retval, dict, locale);
-
-	bufferCat(new_desc, bufferString(cond_retval));
-	deleteBuffer(cond_retval);
-	proc_cond = FALSE;
-      }
-      // append the output
+//
+// expand the template onto the end of the buffer. Returns FALSE if an
+// expression failed, in which case the rest of the template was left out
+bool dyn_template_expand(DYN_TEMPLATE *tmpl, BUFFER *buf, PyObject *dict,
+			 const char *locale) {
+  PyObject *retval = NULL;
+  int i, j;
+
+  for(i = 0; i < tmpl->num_nodes; i++) {
+    DYN_NODE *node = &tmpl->nodes[i];
+    if(node->type == DYN_TEXT)
+      bufferCatLength(buf, tmpl->source + node->start, node->len);
+    else if(node->type == DYN_EXPR) {
+      if((retval = dyn_branch_eval(node->exprs, dict, locale)) == NULL)
+	return FALSE;
       else if(PyString_Check(retval))
-	bprintf(new_desc, "%s", PyString_AsString(retval));
+	bufferCat(buf, PyString_AsString(retval));
       else if(PyInt_Check(retval))
-	bprintf(new_desc, "%ld", PyInt_AsLong(retval));
+	bprintf(buf, "%ld", PyInt_AsLong(retval));
       else if(PyFloat_Check(retval))
-	bprintf(new_desc, "%lf", PyFloat_AsDouble(retval));
+	bprintf(buf, "%lf", PyFloat_AsDouble(retval));
       // invalid return type...
       else if(retval != Py_None)
-	log_string("dynamic desc had invalid evaluation: %s", 
-		   bufferString(code));
-
-      // oddly, freeing retval here corrupt memory. 
-      // And not freeing it doesn't cause a memory leak. So bizarre...
-      //   Py_XDECREF(retval);
+	log_string("dynamic desc had invalid evaluation: %s",node->exprs->code);
+      Py_DECREF(retval);
+    }
+    else {
+      // find the first branch that matches. If the [if] itself fails, so do
+      // we. If an [elif] fails, nothing in the conditional is expanded
+      for(j = 0; j < node->num_exprs; j++) {
+	DYN_BRANCH *branch = &node->exprs[j];
+	bool         match = TRUE;
+	if(branch->code != NULL) {
+	  if((retval = dyn_branch_eval(branch, dict, locale)) == NULL) {
+	    if(j == 0)
+	      return FALSE;
+	    break;
+	  }
+	  match = PyObject_IsTrue(retval);
+	  Py_DECREF(retval);
+	}
+	if(match) {
+	  if(branch->body != NULL)
+	    dyn_template_expand(branch->body, buf, dict, locale);
+	  break;
+	}
+      }
     }
   }
+  return TRUE;
+}
+
+void expand_dynamic_descs_dict(BUFFER *desc, PyObject *dict,const char *locale){
+  // no dynamic text, nothing to do
+  if(strchr(bufferString(desc), '[') == NULL)
+    return;
 
-  // copy over our contents
+  // find our template, or parse a new one. Templates are found without
+  // regard to case, so make sure we got the one for exactly our text
+  DYN_TEMPLATE *tmpl = hashGet(dyn_templates, bufferString(desc));
+  bool        cached = TRUE;
+  if(tmpl == NULL || strcmp(tmpl->source, bufferString(desc))) {
+    bool replace = (tmpl == NULL);
+    tmpl = newDynTemplate(bufferString(desc), bufferLength(desc));
+    if(replace && dyn_expand_depth == 0 &&
+       hashSize(dyn_templates) >= DYN_TEMPLATE_TABLE_MAX)
+      hashClearWith(dyn_templates, deleteDynTemplate);
+    if(replace && hashSize(dyn_templates) < DYN_TEMPLATE_TABLE_MAX)
+      hashPut(dyn_templates, tmpl->source, tmpl);
+    else
+      cached = FALSE;
+  }
+
+  // expand it and copy over our contents
+  BUFFER *new_desc = newBuffer(bufferLength(desc)*2);
+  dyn_expand_depth++;
+  dyn_template_expand(tmpl, new_desc, dict, locale);
+  dyn_expand_depth--;
   bufferCopyTo(new_desc, desc);
 
   // garbage collection
-  deleteBuffer(code);
   deleteBuffer(new_desc);
+  if(!cached)
+    deleteDynTemplate(tmpl);
 }
 
 void expand_dynamic_descs(BUFFER *desc, PyObject *me, CHAR_DATA *ch, 
@@ -939,6 +1119,111 @@ LIST *roomGetTriggers(ROOM_DATA *room) {
   return data->triggers;
 }
 
+//
+// make sure the index of triggers by type is up to date with the triggers
+// attached, and return the ones of the given type
+LIST *trigger_aux_get_by_type(TRIGGER_AUX_DATA *data, const char *type) {
+  if(listSize(data->triggers) == 0)
+    return NULL;
+  if(data->index_version == NOTHING || data->index_version < trigger_edited) {
+    if(data->index == NULL)
+      data->index = newHashtableSize(listSize(data->triggers));
+    else
+      hashClearWith(data->index, deleteList);
+
+    // triggers that don't exist are left out; they didn't run before, either
+    LIST_ITERATOR key_i;
+    listIteratorStart(&key_i, data->triggers);
+    char             *key = NULL;
+    TRIGGER_DATA    *trig = NULL;
+    ITERATE_LIST(key, &key_i) {
+      if((trig = worldGetType(gameworld, "trigger", key)) != NULL) {
+	LIST *trigs = hashGet(data->index, triggerGetType(trig));
+	if(trigs == NULL) {
+	  trigs = newList();
+	  hashPut(data->index, triggerGetType(trig), trigs);
+	}
+	listQueue(trigs, trig);
+      }
+    } listIteratorStop(&key_i);
+    data->index_version = trigger_version;
+  }
+  return hashGet(data->index, type);
+}
+
+//
+// attach or detach the trigger with the given key. Returns whether the list
+// of triggers attached changed
+bool trigger_list_add(LIST *list, const char *trigger) {
+  if(listGetWith(list, trigger, strcasecmp))
+    return FALSE;
+  listPut(list, strdup(trigger));
+  return TRUE;
+}
+
+bool trigger_list_remove(LIST *list, const char *trigger) {
+  char *val = listRemoveWith(list, trigger, strcasecmp);
+  if(val == NULL)
+    return FALSE;
+  free(val);
+  return TRUE;
+}
+
+void trigger_aux_attach(TRIGGER_AUX_DATA *data, const char *trigger) {
+  if(trigger_list_add(data->triggers, trigger))
+    trigger_aux_changed(data);
+}
+
+void trigger_aux_detach(TRIGGER_AUX_DATA *data, const char *trigger) {
+  if(trigger_list_remove(data->triggers, trigger))
+    trigger_aux_changed(data);
+}
+
+void charAttachTrigger(CHAR_DATA *ch, const char *key) {
+  trigger_aux_attach(charGetAuxiliaryData(ch, "trigger_data"), key);
+}
+
+void objAttachTrigger(OBJ_DATA *obj, const char *key) {
+  trigger_aux_attach(objGetAuxiliaryData(obj, "trigger_data"), key);
+}
+
+void roomAttachTrigger(ROOM_DATA *room, const char *key) {
+  trigger_aux_attach(roomGetAuxiliaryData(room, "trigger_data"), key);
+}
+
+void charDetachTrigger(CHAR_DATA *ch, const char *key) {
+  trigger_aux_detach(charGetAuxiliaryData(ch, "trigger_data"), key);
+}
+
+void objDetachTrigger(OBJ_DATA *obj, const char *key) {
+  trigger_aux_detach(objGetAuxiliaryData(obj, "trigger_data"), key);
+}
+
+void roomDetachTrigger(ROOM_DATA *room, const char *key) {
+  trigger_aux_detach(roomGetAuxiliaryData(room, "trigger_data"), key);
+}
+
+LIST *charGetTriggersByType(CHAR_DATA *ch, const char *type) {
+  return trigger_aux_get_by_type(charGetAuxiliaryData(ch, "trigger_data"),type);
+}
+
+LIST *objGetTriggersByType(OBJ_DATA *obj, const char *type) {
+  return trigger_aux_get_by_type(objGetAuxiliaryData(obj,"trigger_data"),type);
+}
+
+LIST *roomGetTriggersByType(ROOM_DATA *room, const char *type) {
+  return trigger_aux_get_by_type(roomGetAuxiliaryData(room, "trigger_data"),
+				 type);
+}
+
+void triggers_changed(void) {
+  trigger_edited = ++trigger_version;
+}
+
+int triggers_version(void) {
+  return trigger_version;
+}
+
 PyObject *charGetPyFormBorrowed(CHAR_DATA *ch) {
   TRIGGER_AUX_DATA *data = charGetAuxiliaryData(ch, "trigger_data");
   if(data->pyform == NULL)
@@ -1007,24 +1292,25 @@ PyObject *socketGetPyForm(SOCKET_DATA *sock) {
 PyObject *PyList_fromList(LIST *list, void *convertor) {
   PyObject *pylist = PyList_New(0);
   PyObject *(*conv_func)(void *) = convertor; 
-  LIST_ITERATOR *list_i = newListIterator(list);
+  LIST_ITERATOR list_i;
+  listIteratorStart(&list_i, list);
   void            *elem = NULL;
-  ITERATE_LIST(elem, list_i) {
+  ITERATE_LIST(elem, &list_i) {
     PyObject *pyelem = conv_func(elem);
     PyList_Append(pylist, pyelem);
     Py_DECREF(pyelem);
-  } deleteListIterator(list_i);
+  } listIteratorStop(&list_i);
   return pylist;
 }
 
 void triggerListAdd(LIST *list, const char *trigger) {
-  if(!listGetWith(list, trigger, strcasecmp))
-    listPut(list, strdup(trigger));
+  if(trigger_list_add(list, trigger))
+    triggers_changed();
 }
 
 void triggerListRemove(LIST *list, const char *trigger) {
-  char *val = listRemoveWith(list, trigger, strcasecmp);
-  if(val) free(val);
+  if(trigger_list_remove(list, trigger))
+    triggers_changed();
 }
 
 
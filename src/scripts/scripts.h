@@ -80,6 +80,35 @@ LIST *charGetTriggers(CHAR_DATA *ch);
 LIST *objGetTriggers (OBJ_DATA  *obj);
 LIST *roomGetTriggers(ROOM_DATA *room);
 
+//
+// returns the triggers of the given type installed on the thing, in the order
+// they were attached, or NULL if there are none. Unlike the functions above,
+// the lists hold the actual triggers. They are kept in an index that is
+// rebuilt whenever triggers_changed() has been called since it was last used,
+// so they must not be held on to past that point, or modified
+LIST *charGetTriggersByType(CHAR_DATA *ch,   const char *type);
+LIST *objGetTriggersByType (OBJ_DATA  *obj,  const char *type);
+LIST *roomGetTriggersByType(ROOM_DATA *room, const char *type);
+
+//
+// attach the trigger with the given key to the thing, if it isn't already, or
+// detach it. Only the thing's own index of triggers by type is rebuilt
+void charAttachTrigger(CHAR_DATA *ch,   const char *key);
+void objAttachTrigger (OBJ_DATA  *obj,  const char *key);
+void roomAttachTrigger(ROOM_DATA *room, const char *key);
+void charDetachTrigger(CHAR_DATA *ch,   const char *key);
+void objDetachTrigger (OBJ_DATA  *obj,  const char *key);
+void roomDetachTrigger(ROOM_DATA *room, const char *key);
+
+//
+// must be called whenever a trigger's type or key changes, or a trigger list
+// from one of the functions above is changed by hand, so indexes of triggers
+// by type are rebuilt. It rebuilds every thing's index, so attach and detach
+// with the functions above when you can. triggers_version() goes up every
+// time it is called, and every time a trigger is attached or detached
+void triggers_changed(void);
+int  triggers_version(void);
+
 //
 // get the python form for a character, object, or room. These are persistent
 // from the first time the python form is created. Before the pyform is 
@@ -112,12 +141,14 @@ PyObject *py_gen_do_trigs(PyObject *self, PyObject *args, PyObject *kwds);
 PyObject *PyList_fromList(LIST *list, void *convertor);
 
 //
-// adds a trigger to the trigger list. Makes sure it's not a duplicate copy
+// adds a trigger to the trigger list. Makes sure it's not a duplicate copy.
+// If the list belongs to something, use charAttachTrigger and co. instead
 void triggerListAdd(LIST *list, const char *trigger);
 
 //
 // removes a trigger with the given name from the trigger list. Frees the
-// name of the removed trigger as needed.
+// name of the removed trigger as needed. If the list belongs to something,
+// use charDetachTrigger and co. instead
 void triggerListRemove(LIST *list, const char *trigger);
 
 //
@@ -143,6 +174,12 @@ bool trigger_list_parser (SOCKET_DATA *sock, LIST *triggers, int choice,
 PyObject   *restricted_script_dict(void);
 PyObject *unrestricted_script_dict(void);
 
+//
+// the names every script can see (the mud's modules, the builtins) are only
+// gathered up once. If any of the modules they come from are reloaded, this
+// must be called so they are gathered up again
+void reset_script_dicts(void);
+
 //
 // Runs an arbitrary block of python code using the given dictionary. If the
 // script has a locale (i.e. zone) associated with it (for instance, running
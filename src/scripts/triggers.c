@@ -49,6 +49,7 @@ void deleteTrigger(TRIGGER_DATA *trigger) {
   deleteBuffer(trigger->code);
   Py_XDECREF(trigger->pycode);
   free(trigger);
+  triggers_changed();
 }
 
 STORAGE_SET *triggerStore(TRIGGER_DATA *trigger) {
@@ -88,11 +89,13 @@ void triggerSetName(TRIGGER_DATA *trigger, const char *name) {
 void triggerSetType(TRIGGER_DATA *trigger, const char *type) {
   if(trigger->type) free(trigger->type);
   trigger->type = strdupsafe(type);
+  triggers_changed();
 }
 
 void triggerSetKey(TRIGGER_DATA *trigger, const char *key) {
   if(trigger->key) free(trigger->key);
   trigger->key = strdupsafe(key);
+  triggers_changed();
 }
 
 void triggerSetCode(TRIGGER_DATA *trigger, const char *code) {
@@ -135,10 +135,11 @@ void gen_do_trig(TRIGGER_DATA *trig,
 
   // now, add any optional variables
   if(optional) {
-    LIST_ITERATOR *opt_i = newListIterator(optional);
+    LIST_ITERATOR opt_i;
+    listIteratorStart(&opt_i, optional);
     OPT_VAR         *opt = NULL;
     PyObject      *pyopt = NULL;
-    ITERATE_LIST(opt, opt_i) {
+    ITERATE_LIST(opt, &opt_i) {
       pyopt = NULL;
       switch(opt->type) {
       case TRIGVAR_CHAR:  pyopt = charGetPyForm(opt->data); break;
@@ -148,7 +149,7 @@ void gen_do_trig(TRIGGER_DATA *trig,
       PyDict_SetItemString(dict, opt->name, pyopt);
       listPut(varnames, strdup(opt->name));
       Py_XDECREF(pyopt);
-    } deleteListIterator(opt_i);
+    } listIteratorStop(&opt_i);
   }
 
   // run the script, then kill our dictionary
@@ -158,11 +159,12 @@ void gen_do_trig(TRIGGER_DATA *trig,
   // dictionary. This is a known memory leak. We'll try to mitigate it by
   // cleaning out some of the contents. A better solution is needed, that
   // makes sure the dictionary itself is not leaked
-  LIST_ITERATOR *vname_i = newListIterator(varnames);
+  LIST_ITERATOR vname_i;
+  listIteratorStart(&vname_i, varnames);
   char            *vname = NULL;
-  ITERATE_LIST(vname, vname_i) {
+  ITERATE_LIST(vname, &vname_i) {
     PyDict_DelItemString(dict, vname);
-  } deleteListIterator(vname_i);
+  } listIteratorStop(&vname_i);
   deleteListWith(varnames, free);
   Py_XDECREF(dict);
 }
@@ -172,26 +174,45 @@ void gen_do_trig(TRIGGER_DATA *trig,
 void gen_do_trigs(void *me, int me_type, const char *type,
 		  CHAR_DATA *ch,OBJ_DATA *obj, ROOM_DATA *room, EXIT_DATA *exit,
 		  const char *command, const char *arg, LIST *optional) {
-  // find our list of triggers
-  LIST *trig_keys = NULL;
+  // find our triggers of the right type
+  LIST *trigs = NULL;
   if(me_type == TRIGVAR_CHAR)
-    trig_keys = charGetTriggers(me);
+    trigs = charGetTriggersByType(me, type);
   else if(me_type == TRIGVAR_OBJ)
-    trig_keys = objGetTriggers(me);
+    trigs = objGetTriggersByType(me, type);
   else if(me_type == TRIGVAR_ROOM)
-    trig_keys = roomGetTriggers(me);
+    trigs = roomGetTriggersByType(me, type);
 
-  if(trig_keys == NULL || listSize(trig_keys) == 0)
+  if(trigs == NULL || listSize(trigs) == 0)
     return;
-  
-  char        *trig_key = NULL;
-  LIST_ITERATOR *trig_i = newListIterator(trig_keys);
+
+  // triggers can attach and detach other triggers, or edit them, while they
+  // run. Go over a copy of the list, and if anything has changed, make sure
+  // each trigger is still one of ours before running it
+  int         num_trigs = listSize(trigs), i;
+  int           version = triggers_version();
+  TRIGGER_DATA *to_run[num_trigs];
+  LIST_ITERATOR  trig_i;
   TRIGGER_DATA    *trig = NULL;
-  ITERATE_LIST(trig_key, trig_i) {
-    if((trig = worldGetType(gameworld, "trigger", trig_key)) != NULL &&
-       !strcasecmp(triggerGetType(trig), type))
-      gen_do_trig(trig,me,me_type,ch,obj,room,exit,command,arg,optional);
-  } deleteListIterator(trig_i);
+  listIteratorStart(&trig_i, trigs);
+  i = 0;
+  ITERATE_LIST(trig, &trig_i) {
+    to_run[i++] = trig;
+  } listIteratorStop(&trig_i);
+
+  for(i = 0; i < num_trigs; i++) {
+    if(triggers_version() != version) {
+      if(me_type == TRIGVAR_CHAR)
+	trigs = charGetTriggersByType(me, type);
+      else if(me_type == TRIGVAR_OBJ)
+	trigs = objGetTriggersByType(me, type);
+      else
+	trigs = roomGetTriggersByType(me, type);
+      if(trigs == NULL || !listIn(trigs, to_run[i]))
+	continue;
+    }
+    gen_do_trig(to_run[i],me,me_type,ch,obj,room,exit,command,arg,optional);
+  }
 }
 
 
@@ -199,11 +220,11 @@ void gen_do_trigs(void *me, int me_type, const char *type,
 //*****************************************************************************
 // trighooks
 //*****************************************************************************
-void do_give_trighooks(const char *info) {
+void do_give_trighooks(HOOK_ARGS *args) {
   CHAR_DATA   *ch = NULL;
   CHAR_DATA *recv = NULL;
   OBJ_DATA   *obj = NULL;
-  hookParseInfo(info, &ch, &recv, &obj);
+  hookArgsParse(args, &ch, &recv, &obj);
 
   gen_do_trigs(ch,TRIGVAR_CHAR,"give",recv,obj,NULL,NULL,NULL,NULL,NULL);
   gen_do_trigs(recv,TRIGVAR_CHAR,"receive",ch,obj,NULL,NULL,NULL,NULL,NULL);
@@ -216,188 +237,183 @@ void do_give_trighooks(const char *info) {
   deleteListWith(opts, deleteOptVar);
 }
 
-void do_get_trighooks(const char *info) {
+void do_get_trighooks(HOOK_ARGS *args) {
   CHAR_DATA *ch = NULL;
   OBJ_DATA *obj = NULL;
-  hookParseInfo(info, &ch, &obj);
+  hookArgsParse(args, &ch, &obj);
 
   gen_do_trigs(obj,TRIGVAR_OBJ,"get",ch,NULL,NULL,NULL,NULL,NULL,NULL);
   gen_do_trigs(charGetRoom(ch),TRIGVAR_ROOM,"get",ch,obj,NULL,NULL,NULL,NULL,NULL);
 }
 
-void do_drop_trighooks(const char *info) {
+void do_drop_trighooks(HOOK_ARGS *args) {
   CHAR_DATA *ch = NULL;
   OBJ_DATA *obj = NULL;
-  hookParseInfo(info, &ch, &obj);
+  hookArgsParse(args, &ch, &obj);
   gen_do_trigs(obj,TRIGVAR_OBJ,"drop",ch,NULL,NULL,NULL,NULL,NULL,NULL);
   gen_do_trigs(charGetRoom(ch),TRIGVAR_ROOM,"drop",ch,obj,NULL,NULL,NULL,NULL,NULL);
 }
 
-void do_enter_trighooks(const char *info) {
+void do_enter_trighooks(HOOK_ARGS *args) {
   CHAR_DATA   *ch = NULL;
   ROOM_DATA *room = NULL;
-  hookParseInfo(info, &ch, &room);
+  hookArgsParse(args, &ch, &room);
 
-  LIST_ITERATOR *mob_i = newListIterator(roomGetCharacters(room));
+  LIST_ITERATOR mob_i;
+  listIteratorStart(&mob_i, roomGetCharacters(room));
   CHAR_DATA       *mob = NULL;
-  ITERATE_LIST(mob, mob_i) {
+  ITERATE_LIST(mob, &mob_i) {
     if(ch != mob)
       gen_do_trigs(mob,TRIGVAR_CHAR,"enter",ch,NULL,NULL,NULL,NULL,NULL,NULL);
-  } deleteListIterator(mob_i);
+  } listIteratorStop(&mob_i);
   gen_do_trigs(room,TRIGVAR_ROOM,"enter",ch,NULL,NULL,NULL,NULL,NULL,NULL);
   gen_do_trigs(ch,TRIGVAR_CHAR,"self enter",NULL,NULL,NULL,NULL,NULL,NULL,NULL);
 }
 
-void do_exit_trighooks(const char *info) {
+void do_exit_trighooks(HOOK_ARGS *args) {
   CHAR_DATA   *ch = NULL;
   ROOM_DATA *room = NULL;
   EXIT_DATA *exit = NULL;
-  hookParseInfo(info, &ch, &room, &exit);
+  hookArgsParse(args, &ch, &room, &exit);
 
-  LIST_ITERATOR *mob_i = newListIterator(roomGetCharacters(room));
+  LIST_ITERATOR mob_i;
+  listIteratorStart(&mob_i, roomGetCharacters(room));
   CHAR_DATA       *mob = NULL;
-  ITERATE_LIST(mob, mob_i) {
+  ITERATE_LIST(mob, &mob_i) {
     if(ch != mob)
       gen_do_trigs(mob,TRIGVAR_CHAR,"exit",ch,NULL,NULL,exit,NULL,NULL,NULL);
-  } deleteListIterator(mob_i);
+  } listIteratorStop(&mob_i);
   gen_do_trigs(room,TRIGVAR_ROOM,"exit",ch,NULL,NULL,exit,NULL,NULL,NULL);
   gen_do_trigs(ch,TRIGVAR_CHAR,"self exit",NULL,NULL,NULL,exit,NULL,NULL,NULL);
 }
 
-void do_ask_trighooks(const char *info) {
+void do_ask_trighooks(HOOK_ARGS *args) {
   CHAR_DATA       *ch = NULL;
   CHAR_DATA *listener = NULL;
-  char        *speech = NULL;
-  hookParseInfo(info, &ch, &listener, &speech);
+  const char  *speech = NULL;
+  hookArgsParse(args, &ch, &listener, &speech);
   gen_do_trigs(listener,TRIGVAR_CHAR,"speech",ch,NULL,NULL,NULL,NULL,speech,NULL);
-
-  // garbage collection
-  free(speech);
 }
 
-void do_say_trighooks(const char *info) {
+void do_say_trighooks(HOOK_ARGS *args) {
   CHAR_DATA *ch = NULL;
-  char  *speech = NULL;
-  hookParseInfo(info, &ch, &speech);
+  const char *speech = NULL;
+  hookArgsParse(args, &ch, &speech);
 
-  LIST_ITERATOR *mob_i = newListIterator(roomGetCharacters(charGetRoom(ch)));
+  LIST_ITERATOR mob_i;
+  listIteratorStart(&mob_i, roomGetCharacters(charGetRoom(ch)));
   CHAR_DATA       *mob = NULL;
-  ITERATE_LIST(mob, mob_i) {
+  ITERATE_LIST(mob, &mob_i) {
     if(ch != mob)
      gen_do_trigs(mob,TRIGVAR_CHAR,"speech",ch,NULL,NULL,NULL,NULL,speech,NULL);
-  } deleteListIterator(mob_i);
+  } listIteratorStop(&mob_i);
   gen_do_trigs(charGetRoom(ch),TRIGVAR_ROOM,"speech",ch,NULL,NULL,NULL,NULL,speech,NULL);
-
-  // garbage collection
-  free(speech);
 }
 
-void do_greet_trighooks(const char *info) {
+void do_greet_trighooks(HOOK_ARGS *args) {
   CHAR_DATA      *ch = NULL;
   CHAR_DATA *greeted = NULL;
-  hookParseInfo(info, &ch, &greeted);
+  hookArgsParse(args, &ch, &greeted);
   gen_do_trigs(greeted,TRIGVAR_CHAR,"greet",ch,NULL,NULL,NULL,NULL,NULL,NULL);
 }
 
-void do_wear_trighooks(const char *info) {
+void do_wear_trighooks(HOOK_ARGS *args) {
   CHAR_DATA *ch = NULL;
   OBJ_DATA *obj = NULL;
-  hookParseInfo(info, &ch, &obj);
+  hookArgsParse(args, &ch, &obj);
   gen_do_trigs(ch,TRIGVAR_CHAR,"wear",NULL,obj,NULL,NULL,NULL,NULL,NULL);
   gen_do_trigs(obj,TRIGVAR_OBJ,"wear",ch,NULL,NULL,NULL,NULL,NULL,NULL);
 }
 
-void do_remove_trighooks(const char *info) {
+void do_remove_trighooks(HOOK_ARGS *args) {
   CHAR_DATA *ch = NULL;
   OBJ_DATA *obj = NULL;
-  hookParseInfo(info, &ch, &obj);
+  hookArgsParse(args, &ch, &obj);
   gen_do_trigs(ch,TRIGVAR_CHAR,"remove",NULL,obj,NULL,NULL,NULL,NULL,NULL);
   gen_do_trigs(obj,TRIGVAR_OBJ,"remove",ch,NULL,NULL,NULL,NULL,NULL,NULL);
 }
 
-void do_reset_trighooks(const char *info) {
-  char  *zone_key = NULL;
-  hookParseInfo(info, &zone_key);
+void do_reset_trighooks(HOOK_ARGS *args) {
+  const char *zone_key = NULL;
+  hookArgsParse(args, &zone_key);
   ZONE_DATA *zone = worldGetZone(gameworld, zone_key);
 
-  LIST_ITERATOR *res_i = newListIterator(zoneGetResettable(zone));
+  LIST_ITERATOR res_i;
+  listIteratorStart(&res_i, zoneGetResettable(zone));
   char           *name = NULL;
   const char   *locale = zoneGetKey(zone);
   ROOM_DATA      *room = NULL;
-  ITERATE_LIST(name, res_i) {
+  ITERATE_LIST(name, &res_i) {
     room = worldGetRoom(gameworld, get_fullkey(name, locale));
     if(room != NULL)
      gen_do_trigs(room,TRIGVAR_ROOM,"reset",NULL,NULL,NULL,NULL,NULL,NULL,NULL);
-  } deleteListIterator(res_i);
-
-  // garbage collection
-  free(zone_key);
+  } listIteratorStop(&res_i);
 }
 
-void do_open_door_trighooks(const char *info) {
+void do_open_door_trighooks(HOOK_ARGS *args) {
   CHAR_DATA *ch = NULL;
   EXIT_DATA *ex = NULL;
-  hookParseInfo(info, &ch, &ex);
+  hookArgsParse(args, &ch, &ex);
   gen_do_trigs(charGetRoom(ch),TRIGVAR_ROOM,"open",ch,NULL,NULL,ex,NULL,NULL,NULL);
 }
 
-void do_open_obj_trighooks(const char *info) {
+void do_open_obj_trighooks(HOOK_ARGS *args) {
   CHAR_DATA *ch = NULL;
   OBJ_DATA *obj = NULL;
-  hookParseInfo(info, &ch, &obj);
+  hookArgsParse(args, &ch, &obj);
   gen_do_trigs(obj,TRIGVAR_OBJ,"open",ch,NULL,NULL,NULL,NULL,NULL,NULL);
 }
 
-void do_close_door_trighooks(const char *info) {
+void do_close_door_trighooks(HOOK_ARGS *args) {
   CHAR_DATA *ch = NULL;
   EXIT_DATA *ex = NULL;
-  hookParseInfo(info, &ch, &ex);
+  hookArgsParse(args, &ch, &ex);
   gen_do_trigs(charGetRoom(ch),TRIGVAR_ROOM,"close",ch,NULL,NULL,ex,NULL,NULL,NULL);
 }
 
-void do_close_obj_trighooks(const char *info) {
+void do_close_obj_trighooks(HOOK_ARGS *args) {
   CHAR_DATA *ch = NULL;
   OBJ_DATA *obj = NULL;
-  hookParseInfo(info, &ch, &obj);
+  hookArgsParse(args, &ch, &obj);
   gen_do_trigs(obj,TRIGVAR_OBJ,"close",ch,NULL,NULL,NULL,NULL,NULL,NULL);
 }
 
-void do_look_at_obj_trighooks(const char *info) {
+void do_look_at_obj_trighooks(HOOK_ARGS *args) {
   OBJ_DATA     *obj = NULL;
   CHAR_DATA *looker = NULL;
-  hookParseInfo(info, &obj, &looker);
+  hookArgsParse(args, &obj, &looker);
   gen_do_trigs(obj,TRIGVAR_OBJ,"look",looker,NULL,NULL,NULL,NULL,NULL,NULL);
 }
 
-void do_look_at_room_trighooks(const char *info) {
+void do_look_at_room_trighooks(HOOK_ARGS *args) {
   ROOM_DATA   *room = NULL;
   CHAR_DATA *looker = NULL;
-  hookParseInfo(info, &room, &looker);
+  hookArgsParse(args, &room, &looker);
   gen_do_trigs(room,TRIGVAR_ROOM,"look",looker,NULL,NULL,NULL,NULL,NULL,NULL);
 }
 
-void do_look_at_char_trighooks(const char *info) {
+void do_look_at_char_trighooks(HOOK_ARGS *args) {
   CHAR_DATA     *ch = NULL;
   CHAR_DATA *looker = NULL;
-  hookParseInfo(info, &ch, &looker);
+  hookArgsParse(args, &ch, &looker);
   gen_do_trigs(ch,TRIGVAR_CHAR,"look",looker,NULL,NULL,NULL,NULL,NULL,NULL);
 }
 
-void do_obj_to_game_trighooks(const char *info) {
+void do_obj_to_game_trighooks(HOOK_ARGS *args) {
   OBJ_DATA *obj = NULL;
-  hookParseInfo(info, &obj);
+  hookArgsParse(args, &obj);
   gen_do_trigs(obj,TRIGVAR_OBJ,"to_game",NULL,NULL,NULL,NULL,NULL,NULL,NULL);
 }
 
-void do_char_to_game_trighooks(const char *info) {
+void do_char_to_game_trighooks(HOOK_ARGS *args) {
   CHAR_DATA *ch = NULL;
-  hookParseInfo(info, &ch);
+  hookArgsParse(args, &ch);
   gen_do_trigs(ch, TRIGVAR_CHAR,"to_game",NULL,NULL,NULL,NULL,NULL,NULL,NULL);
 }
 
-void do_room_to_game_trighooks(const char *info) {
+void do_room_to_game_trighooks(HOOK_ARGS *args) {
   ROOM_DATA *rm = NULL;
-  hookParseInfo(info, &rm);
+  hookArgsParse(args, &rm);
   gen_do_trigs(rm,TRIGVAR_ROOM,"to_game",NULL,NULL,NULL,NULL,NULL,NULL,NULL);
 }
 
@@ -408,27 +424,27 @@ void do_room_to_game_trighooks(const char *info) {
 //*****************************************************************************
 void init_trighooks(void) {
   // add all of our hooks to the game
-  hookAdd("give",           do_give_trighooks);
-  hookAdd("get",            do_get_trighooks);
-  hookAdd("drop",           do_drop_trighooks);
-  hookAdd("enter",          do_enter_trighooks);
-  hookAdd("exit",           do_exit_trighooks);
-  hookAdd("ask",            do_ask_trighooks);
-  hookAdd("say",            do_say_trighooks);
-  hookAdd("greet",          do_greet_trighooks);
-  hookAdd("wear",           do_wear_trighooks);
-  hookAdd("remove",         do_remove_trighooks);
-  hookAdd("reset",          do_reset_trighooks);
-  hookAdd("open_door",      do_open_door_trighooks);
-  hookAdd("open_obj",       do_open_obj_trighooks);
-  hookAdd("close_door",     do_close_door_trighooks);
-  hookAdd("close_obj",      do_close_obj_trighooks);
-  hookAdd("look_at_obj",    do_look_at_obj_trighooks);
-  hookAdd("look_at_char",   do_look_at_char_trighooks);
-  hookAdd("look_at_room",   do_look_at_room_trighooks);
-  hookAdd("obj_to_game",    do_obj_to_game_trighooks);
-  hookAdd("char_to_game",   do_char_to_game_trighooks);
-  hookAdd("room_to_game",   do_room_to_game_trighooks);
+  hookAddTyped("give",           do_give_trighooks);
+  hookAddTyped("get",            do_get_trighooks);
+  hookAddTyped("drop",           do_drop_trighooks);
+  hookAddTyped("enter",          do_enter_trighooks);
+  hookAddTyped("exit",           do_exit_trighooks);
+  hookAddTyped("ask",            do_ask_trighooks);
+  hookAddTyped("say",            do_say_trighooks);
+  hookAddTyped("greet",          do_greet_trighooks);
+  hookAddTyped("wear",           do_wear_trighooks);
+  hookAddTyped("remove",         do_remove_trighooks);
+  hookAddTyped("reset",          do_reset_trighooks);
+  hookAddTyped("open_door",      do_open_door_trighooks);
+  hookAddTyped("open_obj",       do_open_obj_trighooks);
+  hookAddTyped("close_door",     do_close_door_trighooks);
+  hookAddTyped("close_obj",      do_close_obj_trighooks);
+  hookAddTyped("look_at_obj",    do_look_at_obj_trighooks);
+  hookAddTyped("look_at_char",   do_look_at_char_trighooks);
+  hookAddTyped("look_at_room",   do_look_at_room_trighooks);
+  hookAddTyped("obj_to_game",    do_obj_to_game_trighooks);
+  hookAddTyped("char_to_game",   do_char_to_game_trighooks);
+  hookAddTyped("room_to_game",   do_room_to_game_trighooks);
 
   // add our trigger displays
   register_tedit_opt("speech",         "mob, room" );
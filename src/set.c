@@ -160,11 +160,12 @@ LIST *setCollect(SET *set) {
 
   for(i = 0; i < set->num_buckets; i++) {
     if(set->buckets[i] == NULL) continue;
-    LIST_ITERATOR *list_i = newListIterator(set->buckets[i]);
+    LIST_ITERATOR list_i;
+    listIteratorStart(&list_i, set->buckets[i]);
     void            *elem = NULL;
-    ITERATE_LIST(elem, list_i) {
+    ITERATE_LIST(elem, &list_i) {
       listPut(list, elem);
-    } deleteListIterator(list_i);
+    } listIteratorStop(&list_i);
   }
   return list;
 }
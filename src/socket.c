@@ -11,17 +11,22 @@
 #include <netdb.h>
 #include <sys/ioctl.h>
 #include <arpa/inet.h> 
-#include <zlib.h>
 #include <pthread.h>
+#include <signal.h>
 
 #include "mud.h"
 #include "character.h"
 #include "account.h"
 #include "save.h"
+#include "storage_writer.h"
 #include "utils.h"
 #include "socket.h"
 #include "auxiliary.h"
 #include "hooks.h"
+#include "io_poll.h"
+#include "outqueue.h"
+#include "deflate_pool.h"
+#include "colour.h"
 #include "scripts/scripts.h"
 #include "scripts/pyplugs.h"
 #include "dyn_vars/dyn_vars.h"
@@ -40,6 +45,21 @@
 #define START_SOCK_UID           1
 int next_sock_uid = START_SOCK_UID;
 
+// once this much output is waiting for a socket's descriptor to take it, new
+// output from the game is dropped until it drains back below the low mark.
+// If it ever gets as high as the max mark, the socket is closed
+#define OUTPUT_HIGH_MARK         (64 * 1024)
+#define OUTPUT_LOW_MARK          (16 * 1024)
+#define OUTPUT_MAX_MARK          (1024 * 1024)
+
+// when output can't be left queued (e.g. before a copyover), how long we'll
+// wait on a full descriptor to take more of it, in seconds
+#define OUTPUT_DRAIN_SECS        2
+
+// sent to sockets when we start dropping their output
+#define OUTPUT_DROPPED_MSG \
+  "\r\n[Output dropped: your connection is not keeping up.]\r\n"
+
 
 //
 // Here it is... the big ol' datastructure for sockets. Yum.
@@ -54,10 +74,12 @@ struct socket_data {
   bool            cmd_read;
   bool            bust_prompt;
   bool            closed;
+  bool            readable;      // might the descriptor have unread input?
+  bool            active;        // is input_handler() due to look at us?
   int             lookup_status;
   int             control;
   int             uid;
-  double          idle;          // how many pulses have we been idle for?
+  unsigned long   last_cmd_pulse;// the input pulse we last ran a command on
 
   char          * page_string;   // the string that has been paged to us
   int             curr_page;     // the current page we're on
@@ -65,14 +87,25 @@ struct socket_data {
   
   BUFFER        * text_editor;   // where we do our actual work
   BUFFER        * outbuf;        // our buffer of pending output
+  BUFFER        * colour_buf;    // where outbuf has its colour codes processed
+  bool            colour;        // do colour codes become ANSI colours?
+
+  OUT_QUEUE     * outq;          // output our descriptor hasn't taken yet
+  bool            blocked;       // is our descriptor too full to write to?
+  bool            write_error;   // has writing to our descriptor failed?
+  bool            throttled;     // are we dropping output until outq drains?
+  long            bytes_queued;  // stats for the outqueue command
+  long            bytes_sent;
+  long            bytes_dropped;
 
   LIST          * input_handlers;// a stack of our input handlers and prompts
   LIST          * input;         // lines of input we have received
   LIST          * command_hist;  // the commands we've executed in the past
 
   unsigned char   compressing;                 /* MCCP support */
-  z_stream      * out_compress;                /* MCCP support */
-  unsigned char * out_compress_buf;            /* MCCP support */
+  DEFLATE_STREAM* out_compress;                /* MCCP support */
+  int             compress_level;              /* MCCP support */
+  int             compress_mem_level;          /* MCCP support */
 
   AUX_TABLE     * auxiliary;     // auxiliary data installed by other modules
 };
@@ -99,9 +132,43 @@ typedef struct lookup_data {
 
 
 
-/* global variables */
-fd_set        fSet;             /* the socket list for polling       */
-fd_set        rFd;
+// sockets that input_handler() has to look at on the next pulse: ones that
+// have become readable, or still have commands buffered up from before. Idle
+// sockets are never in here, and cost us nothing per pulse
+LIST *active_socks   = NULL;
+LIST *handling_socks = NULL;
+
+// how many times has input_handler() been called? Used for idle times
+unsigned long input_pulses = 0;
+
+// output stats for every socket there has been, for the outqueue command
+long total_bytes_queued  = 0;
+long total_bytes_sent    = 0;
+long total_bytes_dropped = 0;
+long times_throttled     = 0; // times a socket started having output dropped
+long times_overflowed    = 0; // times a socket was closed for OUTPUT_MAX_MARK
+
+// MCCP stats for every socket that has stopped compressing
+long   total_compress_in  = 0; // bytes of text compressed
+long   total_compress_out = 0; // bytes of compressed output made from them
+double total_compress_ms  = 0; // time spent compressing, in milliseconds
+
+//
+// make sure input_handler() looks at the socket on its next call
+void socketActivate(SOCKET_DATA *sock) {
+  if(!sock->active) {
+    sock->active = TRUE;
+    listQueue(active_socks, sock);
+  }
+}
+
+//
+// called by our readiness backend when a socket's descriptor is readable
+void socket_readable(int fd, void *data) {
+  SOCKET_DATA *sock = data;
+  sock->readable = TRUE;
+  socketActivate(sock);
+}
 
 /* mccp support */
 const unsigned char compress_will   [] = { IAC, WILL, TELOPT_COMPRESS,  '\0' };
@@ -117,6 +184,17 @@ void deleteInputHandler(IH_PAIR *pair) {
   free(pair);
 }
 
+//
+// prepare the lists input_handler() uses to keep track of active sockets
+void init_socket_handler(void) {
+  active_socks   = newList();
+  handling_socks = newList();
+
+  // writing to a socket whose other end has gone away should fail, and let us
+  // close it, instead of killing the mud
+  signal(SIGPIPE, SIG_IGN);
+}
+
 /*
  * Init_socket()
  *
@@ -177,19 +255,21 @@ SOCKET_DATA *new_socket(int sock)
   /* create and clear the socket */
   sock_new = calloc(1, sizeof(SOCKET_DATA));
 
-  /* attach the new connection to the socket list */
-  FD_SET(sock, &fSet);
-
   /* clear out the socket */
   clear_socket(sock_new, sock);
   sock_new->closed = FALSE;
 
+  /* attach the new connection to our readiness backend */
+  sock_new->readable = TRUE;
+  ioPollAdd(sock, socket_readable, sock_new);
+  socketActivate(sock_new);
+
   /* set the socket as non-blocking */
   ioctl(sock, FIONBIO, &argp);
 
   /* update the socket list and table */
   listPut(socket_list, sock_new);
-  propertyTablePut(sock_table, sock_new);
+  uidTablePut(sock_table, sock_new);
 
   /* do a host lookup */
   size = sizeof(sock_addr);
@@ -247,7 +327,7 @@ void close_socket(SOCKET_DATA *dsock, bool reconnect)
   dsock->lookup_status += 2;
 
   /* remove the socket from the polling list */
-  FD_CLR(dsock->control, &fSet);
+  ioPollRemove(dsock->control);
 
   /* remove ourself from the list */
   //
@@ -328,8 +408,12 @@ bool read_from_socket(SOCKET_DATA *dsock)
       log_string("Read_from_socket: EOF");
       return FALSE;
     }
-    else if (errno == EAGAIN || sInput == wanted)
+    else if (errno == EAGAIN || errno == EWOULDBLOCK)
+    {
+      /* drained; our backend will tell us when more arrives */
+      dsock->readable = FALSE;
       break;
+    }
     else
     {
       perror("Read_from_socket");
@@ -341,75 +425,148 @@ bool read_from_socket(SOCKET_DATA *dsock)
 }
 
 
-/*
- * Text_to_socket()
- *
- * Sends text directly to the socket,
- * will compress the data if needed.
- */
-bool text_to_socket(SOCKET_DATA *dsock, const char *txt)
-{
-  int iBlck, iPtr, iWrt = 0, length, control = dsock->control;
+//
+// returns FALSE if the socket has let so much output pile up in its queue
+// that it needs to be closed
+bool socket_check_overflow(SOCKET_DATA *dsock) {
+  // our descriptor isn't taking anything. Give up on it
+  if (outQueueLength(dsock->outq) > OUTPUT_MAX_MARK) {
+    if (!dsock->write_error) {
+      times_overflowed++;
+      log_string("Closing link to %s; %d bytes of output were waiting",
+		 (dsock->player ? charGetName(dsock->player) : dsock->hostname),
+		 outQueueLength(dsock->outq));
+    }
+    dsock->write_error = TRUE;
+    return FALSE;
+  }
+  return TRUE;
+}
+
+//
+// move whatever MCCP has compressed for us into our output queue. Returns
+// FALSE if compression failed, or the socket needs to be closed for having
+// too much output waiting
+bool socket_queue_compressed(SOCKET_DATA *dsock) {
+  int len = deflateStreamCollect(dsock->out_compress, dsock->outq);
+  if(len < 0)
+    return FALSE;
+  dsock->bytes_queued += len;
+  total_bytes_queued  += len;
+  return socket_check_overflow(dsock);
+}
 
-  length = strlen(txt);
+//
+// compress everything that has been queued for the socket since its stream
+// was last flushed, and put it in our output queue
+bool socket_compress(SOCKET_DATA *dsock) {
+  if (!dsock->out_compress)
+    return TRUE;
+  deflateStreamFlush(dsock->out_compress, FALSE);
+  return socket_queue_compressed(dsock);
+}
 
-  /* write compressed */
-  if (dsock && dsock->out_compress)
+//
+// put len bytes of txt in the socket's output queue. If we're using MCCP, the
+// text goes into our stream instead, and is not compressed and queued until
+// the stream is flushed. Returns FALSE if the socket has let so much output
+// pile up that it needs to be closed
+bool socket_queue(SOCKET_DATA *dsock, const char *txt, int len) {
+  /* write compressed; it is checked when it reaches our queue */
+  if (dsock->out_compress)
   {
-    dsock->out_compress->next_in  = (unsigned char *) txt;
-    dsock->out_compress->avail_in = length;
-
-    while (dsock->out_compress->avail_in)
-    {
-      dsock->out_compress->avail_out = COMPRESS_BUF_SIZE - (dsock->out_compress->next_out - dsock->out_compress_buf);
+    deflateStreamCat(dsock->out_compress, txt, len);
+    return TRUE;
+  }
 
-      if (dsock->out_compress->avail_out)
-      {
-        int status = deflate(dsock->out_compress, Z_SYNC_FLUSH);
+  /* write uncompressed */
+  if (len > 0)
+  {
+    outQueueCat(dsock->outq, txt, len);
+    dsock->bytes_queued += len;
+    total_bytes_queued  += len;
+  }
+  return socket_check_overflow(dsock);
+}
 
-        if (status != Z_OK)
-        return FALSE;
-      }
+void socket_writable(int fd, void *data);
 
-      length = dsock->out_compress->next_out - dsock->out_compress_buf;
-      if (length > 0)
-      {
-        for (iPtr = 0; iPtr < length; iPtr += iWrt)
-        {
-          iBlck = UMIN(length - iPtr, 4096);
-          if ((iWrt = write(control, dsock->out_compress_buf + iPtr, iBlck)) < 0)
-          {
-            perror("Text_to_socket (compressed):");
-            return FALSE;
-          }
-        }
-        if (iWrt <= 0) break;
-        if (iPtr > 0)
-        {
-          if (iPtr < length)
-            memmove(dsock->out_compress_buf, dsock->out_compress_buf + iPtr, length - iPtr);
-
-          dsock->out_compress->next_out = dsock->out_compress_buf + length - iPtr;
-        }
-      }
-    }
+//
+// write as much of the socket's queued output as its descriptor will take.
+// If it fills up, our readiness backend tells us when there's room for the
+// rest. Returns FALSE if the descriptor can't be written to
+bool socket_send(SOCKET_DATA *dsock) {
+  if (dsock->write_error)
+    return FALSE;
+  if (dsock->blocked || outQueueLength(dsock->outq) == 0)
     return TRUE;
-  }
 
-  /* write uncompressed */
-  for (iPtr = 0; iPtr < length; iPtr += iWrt)
+  int wrote = outQueueFlush(dsock->outq, dsock->control, &dsock->blocked);
+  if (wrote < 0)
   {
-    iBlck = UMIN(length - iPtr, 4096);
-    if ((iWrt = write(control, txt + iPtr, iBlck)) < 0)
-    {
-      perror("Text_to_socket:");
-      return FALSE;
-    }
+    perror("Socket_send:");
+    dsock->write_error = TRUE;
+    ioPollWatchWrite(dsock->control, NULL);
+    return FALSE;
   }
+  dsock->bytes_sent += wrote;
+  total_bytes_sent  += wrote;
+  ioPollWatchWrite(dsock->control, (dsock->blocked ? socket_writable : NULL));
 
+  // if we were dropping output, and have caught up, start sending it again
+  if (dsock->throttled && outQueueLength(dsock->outq) < OUTPUT_LOW_MARK)
+    dsock->throttled = FALSE;
   return TRUE;
 }
 
+//
+// write out everything queued for the socket, waiting on its descriptor when
+// it is full, until it goes OUTPUT_DRAIN_SECS without taking anything. For
+// when the output can't be left waiting, like right before a copyover
+void socket_drain(SOCKET_DATA *dsock) {
+  struct timeval timeout = { OUTPUT_DRAIN_SECS, 0 }, no_timeout = { 0, 0 };
+  int   blocking = 0, nonblocking = 1;
+  if (dsock->write_error || outQueueLength(dsock->outq) == 0)
+    return;
+
+  ioctl(dsock->control, FIONBIO, &blocking);
+  setsockopt(dsock->control, SOL_SOCKET, SO_SNDTIMEO,
+	     &timeout, sizeof(timeout));
+  int wrote = outQueueFlush(dsock->outq, dsock->control, &dsock->blocked);
+  if (wrote < 0)
+    dsock->write_error = TRUE;
+  else {
+    dsock->bytes_sent += wrote;
+    total_bytes_sent  += wrote;
+  }
+  setsockopt(dsock->control, SOL_SOCKET, SO_SNDTIMEO,
+	     &no_timeout, sizeof(no_timeout));
+  ioctl(dsock->control, FIONBIO, &nonblocking);
+}
+
+//
+// called by our readiness backend when a socket's descriptor has room for
+// more output. If writing fails, output_handler() will close the socket
+void socket_writable(int fd, void *data) {
+  SOCKET_DATA *sock = data;
+  sock->blocked = FALSE;
+  socket_send(sock);
+}
+
+
+/*
+ * Text_to_socket()
+ *
+ * Sends text directly to the socket, skipping
+ * the socket's outbound buffer. Will compress
+ * the data if needed.
+ */
+bool text_to_socket(SOCKET_DATA *dsock, const char *txt)
+{
+  return (socket_queue(dsock, txt, strlen(txt)) && socket_compress(dsock) &&
+	  socket_send(dsock));
+}
+
 
 void  send_to_socket( SOCKET_DATA *dsock, const char *format, ...) {
   if(format && *format) {
@@ -509,8 +666,17 @@ int read_iac_sequence(SOCKET_DATA *dsock, int start) {
 
   // broadcast the message we parsed, and prepare for the next sequence
   if(done == TRUE) {
-    hookRun("receive_iac", 
-	    hookBuildInfo("sk str", dsock,bufferString(dsock->iac_sequence)));
+    // the client has answered our offer of MCCP
+    const char *seq = bufferString(dsock->iac_sequence);
+    if(bufferLength(dsock->iac_sequence) == 3 &&
+       (seq[2] == TELOPT_COMPRESS || seq[2] == TELOPT_COMPRESS2)) {
+      if(seq[1] == (signed char) DO)
+	compressStart(dsock, seq[2]);
+      else if(seq[1] == (signed char) DONT)
+	compressEnd(dsock, seq[2], FALSE);
+    }
+    hookRunTyped("receive_iac", "sk str",
+		 dsock, bufferString(dsock->iac_sequence));
     bufferClear(dsock->iac_sequence);
   }
   return len;
@@ -571,45 +737,83 @@ void next_cmd_from_buffer(SOCKET_DATA *dsock) {
 
 
 
+//
+// process the colour codes in our pending output
+void socket_render_colour(SOCKET_DATA *dsock) {
+  if(colourRender(bufferString(dsock->outbuf), dsock->colour_buf,
+		  dsock->colour)) {
+    BUFFER *rendered   = dsock->colour_buf;
+    dsock->colour_buf  = dsock->outbuf;
+    dsock->outbuf      = rendered;
+    bufferClear(dsock->colour_buf);
+  }
+}
+
+//
+// send off the output flush_output has queued. Compressed output is flushed
+// through our stream once per pulse, all at once. If there are workers to
+// compress it, one of them does, and output_handler sends it when they're done
+bool flush_queued(SOCKET_DATA *dsock) {
+  if (dsock->out_compress && deflateStreamPending(dsock->out_compress) > 0) {
+    if (deflatePoolWorkers() > 0) {
+      deflateStreamFlush(dsock->out_compress, TRUE);
+      return TRUE;
+    }
+    if (!socket_compress(dsock))
+      return FALSE;
+  }
+  return socket_send(dsock);
+}
+
 bool flush_output(SOCKET_DATA *dsock) {
   bool  success = TRUE;
-  BUFFER   *buf = NULL;
 
   // run any hooks prior to flushing our text
-  hookRun("flush", hookBuildInfo("sk", dsock));
+  hookRunTyped("flush", "sk", dsock);
 
   // quit if we have no output and don't need/can't have a prompt
   if(bufferLength(dsock->outbuf) <= 0 && 
      (!dsock->bust_prompt || !socketHasPrompt(dsock)))
-    return success;
-
-  buf = newBuffer(1);
+    return flush_queued(dsock);
+
+  // if our descriptor has fallen too far behind, drop our output until it
+  // catches up. Our prompt stays busted, and is sent once it has
+  if(!dsock->throttled && outQueueLength(dsock->outq) >= OUTPUT_HIGH_MARK) {
+    dsock->throttled = TRUE;
+    times_throttled++;
+    socket_queue(dsock, OUTPUT_DROPPED_MSG, strlen(OUTPUT_DROPPED_MSG));
+  }
+  if(dsock->throttled) {
+    dsock->bytes_dropped += bufferLength(dsock->outbuf);
+    total_bytes_dropped  += bufferLength(dsock->outbuf);
+    bufferClear(dsock->outbuf);
+    return flush_queued(dsock);
+  }
 
-  // send our outbound text
+  // queue our outbound text
   if(bufferLength(dsock->outbuf) > 0) {
-    hookRun("process_outbound_text",  hookBuildInfo("sk", dsock));
-    hookRun("finalize_outbound_text", hookBuildInfo("sk", dsock));
-    //success = text_to_socket(dsock, bufferString(dsock->outbuf));
-    bufferCat(buf, bufferString(dsock->outbuf));
+    hookRunTyped("process_outbound_text",  "sk", dsock);
+    socket_render_colour(dsock);
+    hookRunTyped("finalize_outbound_text", "sk", dsock);
+    success = socket_queue(dsock, bufferString(dsock->outbuf),
+			   bufferLength(dsock->outbuf));
     bufferClear(dsock->outbuf);
   }
 
-  // send our prompt
+  // queue our prompt
   if(dsock->bust_prompt && success) {
     socketShowPrompt(dsock);
-    hookRun("process_outbound_prompt",  hookBuildInfo("sk", dsock));
-    hookRun("finalize_outbound_prompt", hookBuildInfo("sk", dsock));
-    //success = text_to_socket(dsock, bufferString(dsock->outbuf));
-    bufferCat(buf, bufferString(dsock->outbuf));
+    hookRunTyped("process_outbound_prompt",  "sk", dsock);
+    socket_render_colour(dsock);
+    hookRunTyped("finalize_outbound_prompt", "sk", dsock);
+    success = socket_queue(dsock, bufferString(dsock->outbuf),
+			   bufferLength(dsock->outbuf));
     bufferClear(dsock->outbuf);
     dsock->bust_prompt = FALSE;
   }
 
-  success = text_to_socket(dsock, bufferString(buf));
-  deleteBuffer(buf);
-
-  // return our success
-  return success;
+  // and send them both off together
+  return (success && flush_queued(dsock));
 }
 
 
@@ -628,6 +832,8 @@ void deleteSocket(SOCKET_DATA *sock) {
   if(sock->page_string)   free(sock->page_string);
   if(sock->text_editor)   deleteBuffer(sock->text_editor);
   if(sock->outbuf)        deleteBuffer(sock->outbuf);
+  if(sock->colour_buf)    deleteBuffer(sock->colour_buf);
+  if(sock->outq)          deleteOutQueue(sock->outq);
   if(sock->next_command)  deleteBuffer(sock->next_command);
   if(sock->iac_sequence)  deleteBuffer(sock->iac_sequence);
   if(sock->input_handlers)deleteListWith(sock->input_handlers,deleteInputHandler);
@@ -637,11 +843,23 @@ void deleteSocket(SOCKET_DATA *sock) {
   free(sock);
 }
 
+//
+// read one of the MCCP settings. If it isn't set (an unset setting reads as
+// an empty string, or 0) or is not between min and 9, use dflt instead
+int compress_setting(const char *key, int min, int dflt) {
+  int val = mudsettingGetInt(key);
+  if(!*mudsettingGetString(key) || val < min || val > 9)
+    return dflt;
+  return val;
+}
+
 void clear_socket(SOCKET_DATA *sock_new, int sock)
 {
   if(sock_new->page_string)    free(sock_new->page_string);
   if(sock_new->text_editor)    deleteBuffer(sock_new->text_editor);
   if(sock_new->outbuf)         deleteBuffer(sock_new->outbuf);
+  if(sock_new->colour_buf)     deleteBuffer(sock_new->colour_buf);
+  if(sock_new->outq)           deleteOutQueue(sock_new->outq);
   if(sock_new->next_command)   deleteBuffer(sock_new->next_command);
   if(sock_new->iac_sequence)   deleteBuffer(sock_new->iac_sequence);
   if(sock_new->input_handlers) deleteListWith(sock_new->input_handlers, deleteInputHandler);
@@ -657,9 +875,17 @@ void clear_socket(SOCKET_DATA *sock_new, int sock)
   sock_new->control        = sock;
   sock_new->lookup_status  = TSTATE_LOOKUP;
   sock_new->uid            = next_sock_uid++;
+  sock_new->last_cmd_pulse = input_pulses;
 
   sock_new->text_editor    = newBuffer(1);
   sock_new->outbuf         = newBuffer(MAX_OUTPUT);
+  sock_new->colour_buf     = newBuffer(MAX_OUTPUT);
+  sock_new->colour         = TRUE;
+  sock_new->outq           = newOutQueue();
+  sock_new->compress_level     = compress_setting("mccp_level", 0,
+						DFLT_MCCP_LEVEL);
+  sock_new->compress_mem_level = compress_setting("mccp_mem_level", 1,
+						DFLT_MCCP_MEM_LEVEL);
   sock_new->next_command   = newBuffer(1);
   sock_new->iac_sequence   = newBuffer(1);
 }
@@ -700,35 +926,48 @@ void *lookup_address(void *arg)
 void recycle_sockets()
 {
   SOCKET_DATA *dsock;
-  LIST_ITERATOR *sock_i = newListIterator(socket_list);
+  LIST_ITERATOR sock_i;
+  listIteratorStart(&sock_i, socket_list);
 
-  ITERATE_LIST(dsock, sock_i) {
+  ITERATE_LIST(dsock, &sock_i) {
     if (dsock->lookup_status != TSTATE_CLOSED) 
       continue;
 
     /* remove the socket from the main list */
     listRemove(socket_list, dsock);
-    propertyTableRemove(sock_table, dsock->uid);
-
-    /* close the socket */
-    close(dsock->control);
+    uidTableRemove(sock_table, dsock->uid);
+    if(dsock->active)
+      listRemove(active_socks, dsock);
 
     /* stop compression */
     compressEnd(dsock, dsock->compressing, TRUE);
 
+    /* send what we can of our last words, and close the socket */
+    socket_send(dsock);
+    dsock->bytes_dropped += outQueueLength(dsock->outq);
+    total_bytes_dropped  += outQueueClear(dsock->outq);
+    close(dsock->control);
+
     /* delete the socket from memory */
     deleteSocket(dsock);
-  } deleteListIterator(sock_i);
+  } listIteratorStop(&sock_i);
 }
 
 
 /* reset all of the sockets' control values */
 void reconnect_copyover_sockets() {
-  LIST_ITERATOR *sock_i = newListIterator(socket_list);
+  LIST_ITERATOR sock_i;
+  listIteratorStart(&sock_i, socket_list);
   SOCKET_DATA     *sock = NULL; 
-  ITERATE_LIST(sock, sock_i)
-    FD_SET(sock->control, &fSet);
-  deleteListIterator(sock_i);
+  ITERATE_LIST(sock, &sock_i) {
+    if(sock->closed)
+      continue;
+    ioPollAdd(sock->control, socket_readable, sock);
+    sock->readable = TRUE;
+    socketActivate(sock);
+    if(sock->blocked)
+      ioPollWatchWrite(sock->control, socket_writable);
+  } listIteratorStop(&sock_i);
 }
 
 
@@ -767,7 +1006,7 @@ void copyover_recover() {
 
     dsock->hostname = strdup(host);
     listPut(socket_list, dsock);
-    propertyTablePut(sock_table, dsock);
+    uidTablePut(sock_table, dsock);
 
     // load account data
     if((account = get_account(acct)) != NULL)
@@ -811,7 +1050,7 @@ void copyover_recover() {
     dsock->lookup_status  =  TSTATE_DONE;
 
     // let our modules know we've finished copying over a socket
-    hookRun("copyover_complete", hookBuildInfo("sk", dsock));
+    hookRunTyped("copyover_complete", "sk", dsock);
 
     // negotiate compression
     text_to_buffer(dsock, (char *) compress_will2);
@@ -819,15 +1058,16 @@ void copyover_recover() {
   }
   fclose(fp);
 
-  // now, set all of the sockets' control to the new fSet
+  // now, have our readiness backend watch all of the sockets' control
   reconnect_copyover_sockets();
 }     
 
 void output_handler() {
-  LIST_ITERATOR *sock_i = newListIterator(socket_list);
+  LIST_ITERATOR sock_i;
+  listIteratorStart(&sock_i, socket_list);
   SOCKET_DATA     *sock = NULL; 
 
-  ITERATE_LIST(sock, sock_i) {
+  ITERATE_LIST(sock, &sock_i) {
     /* if the player quits or get's disconnected */
     if(sock->closed)
       continue;
@@ -835,17 +1075,119 @@ void output_handler() {
     /* Send all new data to the socket and close it if any errors occour */
     if (!flush_output(sock))
       close_socket(sock, FALSE);
-  } deleteListIterator(sock_i);
+  } listIteratorStop(&sock_i);
+
+  // if workers have been compressing output, send it now that they're done
+  if(deflatePoolWorkers() > 0) {
+    listIteratorStart(&sock_i, socket_list);
+    ITERATE_LIST(sock, &sock_i) {
+      if(sock->closed || !sock->out_compress)
+	continue;
+      if (!socket_queue_compressed(sock) || !socket_send(sock))
+	close_socket(sock, FALSE);
+    } listIteratorStop(&sock_i);
+  }
+}
+
+//
+// show how output is making its way out to sockets: totals for every socket
+// there has been, and the sockets that have output waiting or dropped
+COMMAND(cmd_outqueue) {
+  BUFFER        *rows = newBuffer(MAX_BUFFER);
+  SOCKET_DATA   *sock = NULL;
+  int    pending_bytes = 0, pending_socks = 0, blocked = 0, throttled = 0;
+  int       compressing = 0;
+  long      compress_in = total_compress_in, compress_out = total_compress_out;
+  double    compress_ms = total_compress_ms;
+  LIST_ITERATOR sock_i;
+  listIteratorStart(&sock_i, socket_list);
+
+  ITERATE_LIST(sock, &sock_i) {
+    int pending = outQueueLength(sock->outq);
+    if(sock->out_compress) {
+      compressing++;
+      compress_in  += deflateStreamBytesIn(sock->out_compress);
+      compress_out += deflateStreamBytesOut(sock->out_compress);
+      compress_ms  += deflateStreamMs(sock->out_compress);
+    }
+    if(pending > 0) {
+      pending_bytes += pending;
+      pending_socks++;
+    }
+    if(sock->blocked)   blocked++;
+    if(sock->throttled) throttled++;
+    if(pending > 0 || sock->bytes_dropped > 0)
+      bprintf(rows, "{c  %-20s {g%8d pending %10ld sent %8ld dropped%s\r\n",
+	      (sock->player ? charGetName(sock->player) : sock->hostname),
+	      pending, sock->bytes_sent, sock->bytes_dropped,
+	      (sock->throttled ? " {r(throttled)" :
+	       sock->blocked   ? " {y(blocked)"   : ""));
+  } listIteratorStop(&sock_i);
+
+  send_to_char(ch,
+	       "{gOutput queues:\r\n"
+	       "{g  bytes queued      : {c%ld\r\n"
+	       "{g  bytes sent        : {c%ld\r\n"
+	       "{g  bytes dropped     : {c%ld\r\n"
+	       "{g  pending           : {c%d {gbytes, for {c%d {gsocket%s\r\n"
+	       "{g  blocked           : {c%d {gsocket%s\r\n"
+	       "{g  throttled         : {c%d {gnow, {c%ld {gtimes in all "
+	       "(at %dk pending, until below %dk)\r\n"
+	       "{g  closed, overflow  : {c%ld {g(at %dk pending){n\r\n",
+	       total_bytes_queued, total_bytes_sent, total_bytes_dropped,
+	       pending_bytes, pending_socks, (pending_socks == 1 ? "" : "s"),
+	       blocked, (blocked == 1 ? "" : "s"),
+	       throttled, times_throttled,
+	       OUTPUT_HIGH_MARK / 1024, OUTPUT_LOW_MARK / 1024,
+	       times_overflowed, OUTPUT_MAX_MARK / 1024);
+  send_to_char(ch,
+	       "{gMCCP compression:\r\n"
+	       "{g  compressing       : {c%d {gsocket%s, with {c%d {gworker%s\r\n"
+	       "{g  bytes compressed  : {c%ld {ginto {c%ld {g(%.1f%%)\r\n"
+	       "{g  time compressing  : {c%.1f {gms (%.2f ms per 100k){n\r\n",
+	       compressing, (compressing == 1 ? "" : "s"),
+	       deflatePoolWorkers(), (deflatePoolWorkers() == 1 ? "" : "s"),
+	       compress_in, compress_out,
+	       (compress_in > 0 ? 100.0 * compress_out / compress_in : 0.0),
+	       compress_ms,
+	       (compress_in > 0 ? compress_ms * 102400 / compress_in : 0.0));
+  if(bufferLength(rows) > 0)
+    send_to_char(ch, "{gSockets with output waiting or dropped:\r\n%s{n",
+		 bufferString(rows));
+  deleteBuffer(rows);
+}
+
+//
+// does the socket still have input that needs handling on our next pulse?
+bool socketHasPendingInput(SOCKET_DATA *sock) {
+  return (sock->readable || sock->cmd_read || listSize(sock->input) > 0 ||
+	  strchr(sock->inbuf, '\n') != NULL
+#ifdef MODULE_ALIAS
+	  || (sock->player && charGetAliasesQueued(sock->player) > 0)
+#endif
+	  );
 }
 
 void input_handler() {
-  LIST_ITERATOR *sock_i = newListIterator(socket_list);
-  SOCKET_DATA     *sock = NULL; 
+  SOCKET_DATA *sock = NULL;
+  LIST         *tmp = NULL;
+
+  input_pulses++;
+
+  // only look at sockets that were readable or had leftover input. Anything
+  // that still needs attention afterwards re-activates itself for next pulse
+  tmp            = handling_socks;
+  handling_socks = active_socks;
+  active_socks   = tmp;
+
+  while((sock = listPop(handling_socks)) != NULL) {
+    sock->active = FALSE;
+    if(sock->closed)
+      continue;
 
-  ITERATE_LIST(sock, sock_i) {
     // Close sockects we are unable to read from, or if we have no handler
     // to take in input
-    if ((FD_ISSET(sock->control, &rFd) && !read_from_socket(sock)) ||
+    if ((sock->readable && !read_from_socket(sock)) ||
 	listSize(sock->input_handlers) == 0) {
       close_socket(sock, FALSE);
       continue;
@@ -854,12 +1196,9 @@ void input_handler() {
     /* Ok, check for a new command */
     next_cmd_from_buffer(sock);
     
-    // are we idling?
-    if(!sock->cmd_read)
-      sock->idle +=  1.0 / PULSES_PER_SECOND;
     /* Is there a new command pending ? */
-    else if (sock->cmd_read) {
-      sock->idle = 0.0;
+    if (sock->cmd_read) {
+      sock->last_cmd_pulse = input_pulses;
       IH_PAIR *pair = listGet(sock->input_handlers, 0);
       if(pair->python == FALSE) {
 	void (* handler)(SOCKET_DATA *, char *) = pair->handler;
@@ -904,7 +1243,11 @@ void input_handler() {
 	charSetAliasesQueued(sock->player, --alias_queue);
     }
 #endif
-  } deleteListIterator(sock_i);
+
+    // if we have more to do, make sure we're looked at next pulse
+    if(!sock->closed && socketHasPendingInput(sock))
+      socketActivate(sock);
+  }
 }
 
 
@@ -1036,7 +1379,8 @@ void  start_reader(SOCKET_DATA *dsock, const char *text) {
 
 
 void do_copyover(void) {
-  LIST_ITERATOR *sock_i = newListIterator(socket_list);
+  LIST_ITERATOR sock_i;
+  listIteratorStart(&sock_i, socket_list);
   SOCKET_DATA     *sock = NULL;
   FILE *fp;
   char buf[100];
@@ -1049,12 +1393,13 @@ void do_copyover(void) {
   sprintf(buf, "\n\r <*>            The world starts spinning             <*>\n\r");
 
   // For each playing descriptor, save its character and account
-  ITERATE_LIST(sock, sock_i) {
+  ITERATE_LIST(sock, &sock_i) {
     compressEnd(sock, sock->compressing, FALSE);
     // kick off anyone who hasn't yet logged in a character
     if (!socketGetChar(sock) || !socketGetAccount(sock) || 
 	!charGetRoom(socketGetChar(sock))) {
       text_to_socket(sock, "\r\nSorry, we are rebooting. Come back in a few minutes.\r\n");
+      socket_drain(sock);
       close_socket(sock, FALSE);
     }
     // save account and player info to file
@@ -1066,8 +1411,10 @@ void do_copyover(void) {
       save_player(sock->player);
       save_account(sock->account);
       text_to_socket(sock, buf);
+      // nothing left queued survives the exec
+      socket_drain(sock);
     }
-  } deleteListIterator(sock_i);
+  } listIteratorStop(&sock_i);
   
   fprintf (fp, "-1\n");
   fclose (fp);
@@ -1075,6 +1422,9 @@ void do_copyover(void) {
   // close any pending sockets
   recycle_sockets();
 
+  // the writer won't survive the exec. Let it finish what's pending
+  storage_writer_sync(NULL);
+
 #ifdef MODULE_WEBSERVER
   // if we have a webserver set up, finalize that
   finalize_webserver();
@@ -1115,6 +1465,38 @@ BUFFER *socketGetOutbound    ( SOCKET_DATA *sock) {
   return sock->outbuf;
 }
 
+int socketGetCompressLevel   ( SOCKET_DATA *sock) {
+  return sock->compress_level;
+}
+
+int socketGetCompressMemLevel( SOCKET_DATA *sock) {
+  return sock->compress_mem_level;
+}
+
+bool socketSetCompressLevel  ( SOCKET_DATA *sock, int level) {
+  if(level < 0 || level > 9)
+    return FALSE;
+  if(sock->out_compress && !deflateStreamSetLevel(sock->out_compress, level))
+    return FALSE;
+  sock->compress_level = level;
+  return TRUE;
+}
+
+bool socketSetCompressMemLevel( SOCKET_DATA *sock, int mem_level) {
+  if(mem_level < 1 || mem_level > 9)
+    return FALSE;
+  sock->compress_mem_level = mem_level;
+  return TRUE;
+}
+
+bool socketGetColour         ( SOCKET_DATA *sock) {
+  return sock->colour;
+}
+
+void socketSetColour         ( SOCKET_DATA *sock, bool colour) {
+  sock->colour = colour;
+}
+
 void socketPushInputHandler  ( SOCKET_DATA *socket, 
 			       void handler(SOCKET_DATA *socket, char *input),
 			       void prompt (SOCKET_DATA *socket),
@@ -1156,6 +1538,9 @@ void socketPopInputHandler   ( SOCKET_DATA *socket) {
   IH_PAIR *pair = listPop(socket->input_handlers);
   if(pair != NULL)
     deleteInputHandler(pair);
+  // sockets without input handlers get closed by input_handler()
+  if(listSize(socket->input_handlers) == 0)
+    socketActivate(socket);
 }
 
 void socketReplaceInputHandler( SOCKET_DATA *socket,
@@ -1168,6 +1553,7 @@ void socketReplaceInputHandler( SOCKET_DATA *socket,
 
 void socketQueueCommand( SOCKET_DATA *sock, const char *cmd) {
   listQueue(sock->input, strdup(cmd));
+  socketActivate(sock);
 }
 
 bool socketHasCommand(SOCKET_DATA *sock) {
@@ -1228,7 +1614,7 @@ const char *socketGetState(SOCKET_DATA *sock) {
 }
 
 double socketGetIdleTime(SOCKET_DATA *sock) {
-  return sock->idle;
+  return (double)(input_pulses - sock->last_cmd_pulse) / PULSES_PER_SECOND;
 }
 
 
@@ -1264,62 +1650,34 @@ bool  processCompressed       ( SOCKET_DATA *dsock );
 const unsigned char enable_compress  [] = { IAC, SB, TELOPT_COMPRESS, WILL, SE, 0 };
 const unsigned char enable_compress2 [] = { IAC, SB, TELOPT_COMPRESS2, IAC, SE, 0 };
 
-/*
- * Memory management - zlib uses these hooks to allocate and free memory
- * it needs
- */
-void *zlib_alloc(void *opaque, unsigned int items, unsigned int size)
-{
-  return calloc(items, size);
-}
-
-void zlib_free(void *opaque, void *address)
-{
-  free(address);
-}
-
 /*
  * Begin compressing data on `desc'
  */
 bool compressStart(SOCKET_DATA *dsock, unsigned char teleopt)
 {
-  z_stream *s;
+  DEFLATE_STREAM *s;
 
   /* already compressing */
   if (dsock->out_compress)
     return TRUE;
 
-  /* allocate and init stream, buffer */
-  s = (z_stream *) malloc(sizeof(*s));
-  dsock->out_compress_buf = (unsigned char *) malloc(COMPRESS_BUF_SIZE);
-
-  s->next_in    =  NULL;
-  s->avail_in   =  0;
-  s->next_out   =  dsock->out_compress_buf;
-  s->avail_out  =  COMPRESS_BUF_SIZE;
-  s->zalloc     =  zlib_alloc;
-  s->zfree      =  zlib_free;
-  s->opaque     =  NULL;
-
-  if (deflateInit(s, 9) != Z_OK)
+  /* version 1 or 2 support */
+  if (teleopt != TELOPT_COMPRESS && teleopt != TELOPT_COMPRESS2)
   {
-    free(dsock->out_compress_buf);
-    free(s);
+    bug("Bad teleoption %d passed", teleopt);
     return FALSE;
   }
 
-  /* version 1 or 2 support */
+  /* allocate and init stream */
+  s = newDeflateStream(dsock->compress_level, dsock->compress_mem_level);
+  if (s == NULL)
+    return FALSE;
+
+  /* everything before this goes out uncompressed */
   if (teleopt == TELOPT_COMPRESS)
     text_to_socket(dsock, (char *) enable_compress);
-  else if (teleopt == TELOPT_COMPRESS2)
-    text_to_socket(dsock, (char *) enable_compress2);
   else
-  {
-    bug("Bad teleoption %d passed", teleopt);
-    free(dsock->out_compress_buf);
-    free(s);
-    return FALSE;
-  }
+    text_to_socket(dsock, (char *) enable_compress2);
 
   /* now we're compressing */
   dsock->compressing = teleopt;
@@ -1332,32 +1690,29 @@ bool compressStart(SOCKET_DATA *dsock, unsigned char teleopt)
 /* Cleanly shut down compression on `desc' */
 bool compressEnd(SOCKET_DATA *dsock, unsigned char teleopt, bool forced)
 {
-  unsigned char dummy[1];
-
   if (!dsock->out_compress)
     return TRUE;
 
   if (dsock->compressing != teleopt)
     return FALSE;
 
-  dsock->out_compress->avail_in = 0;
-  dsock->out_compress->next_in = dummy;
-
   /* No terminating signature is needed - receiver will get Z_STREAM_END */
-  if (deflate(dsock->out_compress, Z_FINISH) != Z_STREAM_END && !forced)
+  if (!deflateStreamFinish(dsock->out_compress) && !forced)
     return FALSE;
 
   /* try to send any residual data */
   if (!processCompressed(dsock) && !forced)
     return FALSE;
 
+  /* keep the stats for the outqueue command */
+  total_compress_in  += deflateStreamBytesIn(dsock->out_compress);
+  total_compress_out += deflateStreamBytesOut(dsock->out_compress);
+  total_compress_ms  += deflateStreamMs(dsock->out_compress);
+
   /* reset compression values */
-  deflateEnd(dsock->out_compress);
-  free(dsock->out_compress_buf);
-  free(dsock->out_compress);
+  deleteDeflateStream(dsock->out_compress);
   dsock->compressing      = 0;
   dsock->out_compress     = NULL;
-  dsock->out_compress_buf = NULL;
 
   /* success */
   return TRUE;
@@ -1366,40 +1721,10 @@ bool compressEnd(SOCKET_DATA *dsock, unsigned char teleopt, bool forced)
 /* Try to send any pending compressed-but-not-sent data in `desc' */
 bool processCompressed(SOCKET_DATA *dsock)
 {
-  int iStart, nBlock, nWrite, len;
-
   if (!dsock->out_compress)
     return TRUE;
-    
-  len = dsock->out_compress->next_out - dsock->out_compress_buf;
-  if (len > 0)
-  {
-    for (iStart = 0; iStart < len; iStart += nWrite)
-    {
-      nBlock = UMIN (len - iStart, 4096);
-      if ((nWrite = write(dsock->control, dsock->out_compress_buf + iStart, nBlock)) < 0)
-      {
-        if (errno == EAGAIN/* || errno == ENOSR*/)
-          break;
 
-        /* write error */
-        return FALSE;
-      }
-      if (nWrite <= 0)
-        break;
-    }
-
-    if (iStart)
-    {
-      if (iStart < len)
-        memmove(dsock->out_compress_buf, dsock->out_compress_buf+iStart, len - iStart);
-
-      dsock->out_compress->next_out = dsock->out_compress_buf + len - iStart;
-    }
-  }
-
-  /* success */
-  return TRUE;
+  return (socket_queue_compressed(dsock) && socket_send(dsock));
 }
 
 //
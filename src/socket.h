@@ -6,6 +6,7 @@
 // all of the functions needed for working with character sockets
 //*****************************************************************************
 
+void  init_socket_handler   ( void );
 int   init_socket           ( void );
 SOCKET_DATA  *new_socket    ( int sock );
 void  close_socket          ( SOCKET_DATA *dsock, bool reconnect );
@@ -58,6 +59,18 @@ void *socketGetAuxiliaryData  ( SOCKET_DATA *sock, const char *name);
 const char *socketGetHostname ( SOCKET_DATA *sock);
 BUFFER *socketGetTextEditor   ( SOCKET_DATA *sock);
 BUFFER *socketGetOutbound     ( SOCKET_DATA *sock);
+bool    socketGetColour       ( SOCKET_DATA *sock);
+void    socketSetColour       ( SOCKET_DATA *sock, bool colour);
+
+//
+// how hard MCCP compresses the socket's output: the zlib level (0 to 9) and
+// memLevel (1 to 9). They start out as the mccp_level and mccp_mem_level mud
+// settings. A new level is used straight away if the socket is compressing; a
+// new memLevel only the next time it starts. Return FALSE for bad values
+int  socketGetCompressLevel   ( SOCKET_DATA *sock);
+int  socketGetCompressMemLevel( SOCKET_DATA *sock);
+bool socketSetCompressLevel   ( SOCKET_DATA *sock, int level);
+bool socketSetCompressMemLevel( SOCKET_DATA *sock, int mem_level);
 void socketQueueCommand       ( SOCKET_DATA *sock, const char *cmd);
 int               socketGetUID( SOCKET_DATA *sock);
 
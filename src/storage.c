@@ -9,6 +9,12 @@
 // storing data. Most of them are based on what I learned from my (brief)
 // exposure to YAML.
 //
+// Oct 16/26:
+//   Sets can also be kept in a compact binary format, which is much quicker to
+// read than the text one. storage_read() can tell the two apart by the magic
+// header binary files start with, and storage_write() keeps a file in
+// whichever format it is already in. See the binary storage section below.
+//
 //******************************************************************************
 
 #include <time.h>
@@ -28,26 +34,55 @@
 #define STRING_MARKER         '~'
 #define TYPELESS_MARKER       ' '
 
+// the kinds of values a piece of storage data can hold. Numbers are kept as
+// they are until they are written out, or read back as some other type
+#define DATA_STRING           0
+#define DATA_SET              1
+#define DATA_LIST             2
+#define DATA_INT              3
+#define DATA_LONG             4
+#define DATA_DOUBLE           5
+#define DATA_BOOL             6
+
+// keys shorter than this are kept in the data itself, instead of being
+// allocated. Most keys are
+#define SHORT_KEY_LEN        24
+
+// sets with more entries than this get an index, instead of having their
+// entries looked through one by one
+#define SET_INDEX_SIZE       12
+
+// how big numbers can get when they are printed
+#define NUMBER_LEN           20
+
+typedef struct storage_data {
+  char        *long_key; // our key, if it didn't fit in short_key
+  char short_key[SHORT_KEY_LEN];
+  int              type; // what kind of value we hold. See DATA_XXX
+  union {
+    char             *str_val;
+    STORAGE_SET      *set_val;
+    STORAGE_SET_LIST *list_val;
+    long              long_val; // ints, longs, and bools
+    double          double_val;
+  } val;
+} STORAGE_DATA;
 
 struct storage_set {
-  HASHTABLE *entries;
-  int    longest_key;
-  int      top_entry;
+  STORAGE_DATA *entries; // in the order they were put in the set
+  int              size;
+  int          max_size;
+  HASHTABLE      *index; // key -> position + 1. Only made for big sets
+  int       longest_key;
 };
 
 struct storage_set_list {
-  LIST            *list;
-  LIST_ITERATOR *list_i;
+  STORAGE_SET     **sets;
+  int              size;
+  int          max_size;
+  int              next; // the next set storage_list_next will give
 };
 
-typedef struct storage_data {
-  char                  *key; // what is the variable name we're known by?
-  char              *str_val; // what is the data's string value?
-  STORAGE_SET_LIST *list_val; // list value?
-  STORAGE_SET       *set_val; // set value?
-  int              entry_num; // used by storage_set to keep track of order
-} STORAGE_DATA;
-
 
 
 /* local functions */
@@ -64,80 +99,138 @@ void write_storage_data(STORAGE_DATA *data, FILEBUF *fb, int key_width,int inden
 
 
 void delete_storage_set(STORAGE_SET *set) {
-  HASH_ITERATOR *hash_i = newHashIterator(set->entries);
-  STORAGE_DATA    *data = NULL;
-  const char       *key = NULL;
-  
-  ITERATE_HASH(key, data, hash_i)
-    delete_storage_data(data);
-  deleteHashIterator(hash_i);
-
-  deleteHashtable(set->entries);
+  int i;
+  for(i = 0; i < set->size; i++)
+    delete_storage_data(&set->entries[i]);
+  if(set->entries) free(set->entries);
+  if(set->index)   deleteHashtable(set->index);
   free(set);
 }
 
 void delete_storage_list(STORAGE_SET_LIST *list) {
-  if(list->list_i) deleteListIterator(list->list_i);
-  deleteListWith(list->list, delete_storage_set);
+  int i;
+  for(i = 0; i < list->size; i++)
+    delete_storage_set(list->sets[i]);
+  if(list->sets) free(list->sets);
   free(list);
 }
 
+//
+// delete the data's key and value. The data itself lives in its set's
+// entries, and isn't freed
+//
 void delete_storage_data(STORAGE_DATA *data) {
-  if(data->key)      free(data->key);
-  if(data->str_val)  free(data->str_val);
-  if(data->list_val) delete_storage_list(data->list_val);
-  if(data->set_val)  delete_storage_set(data->set_val);
-  free(data);
+  if(data->long_key) free(data->long_key);
+  switch(data->type) {
+  case DATA_STRING: free(data->val.str_val);                  break;
+  case DATA_SET:    delete_storage_set(data->val.set_val);    break;
+  case DATA_LIST:   delete_storage_list(data->val.list_val);  break;
+  }
 }
 
-STORAGE_DATA *new_storage_data(const char *key) {
-  STORAGE_DATA *data = calloc(1, sizeof(STORAGE_DATA));
-  data->key     = strdup(key);
-  return data;
+const char *storage_data_key(STORAGE_DATA *data) {
+  return (data->long_key ? data->long_key : data->short_key);
 }
 
-STORAGE_DATA *new_data_set(STORAGE_SET *val, const char *key) {
-  STORAGE_DATA *data = new_storage_data(key);
-  data->set_val  = val;
-  data->list_val = new_storage_list();
-  data->str_val  = strdup("");
-  return data;
-}
+//
+// return where the entry with the given key is in the set, or NOTHING if
+// there isn't one. Keys are not case-sensitive
+//
+int storage_find(STORAGE_SET *set, const char *key) {
+  int i;
+  if(set->size > SET_INDEX_SIZE) {
+    // build our index, if we don't have one yet
+    if(set->index == NULL) {
+      set->index = newHashtableSize(set->size * 2);
+      for(i = 0; i < set->size; i++)
+	hashPut(set->index, storage_data_key(&set->entries[i]),
+		(void *)(long)(i + 1));
+    }
+    return (int)(long)hashGet(set->index, key) - 1;
+  }
 
-STORAGE_DATA   *new_data_list(STORAGE_SET_LIST *val, const char *key) {
-  STORAGE_DATA *data = new_storage_data(key);
-  data->list_val = val;
-  data->set_val  = new_storage_set();
-  data->str_val  = strdup("");
-  return data;
+  for(i = 0; i < set->size; i++)
+    if(!strcasecmp(storage_data_key(&set->entries[i]), key))
+      return i;
+  return NOTHING;
 }
 
-STORAGE_DATA *new_data_string(const char *val, const char *key) {
-  STORAGE_DATA *data = new_storage_data(key);
-  data->str_val      = strdup(val);
-  data->list_val     = new_storage_list();
-  data->set_val      = new_storage_set();
-  return data;
+//
+// return the data in the set with the given key, or NULL if there is none
+//
+STORAGE_DATA *storage_get(STORAGE_SET *set, const char *key) {
+  int pos = storage_find(set, key);
+  return (pos == NOTHING ? NULL : &set->entries[pos]);
 }
 
-STORAGE_DATA    *new_data_bool(bool val, const char *key) {
-  char str_val[4]; sprintf(str_val, (val ? "yes" : "no"));
-  return new_data_string(str_val, key);
-}
+//
+// add new data with the given key and type to the end of the set, replacing
+// whatever data had the key before, and return it so its value can be filled
+// in. The returned data is only good until something else is put in the set
+//
+STORAGE_DATA *storage_put(STORAGE_SET *set, const char *key, int type) {
+  int key_len = strlen(key);
+  int     pos = storage_find(set, key);
+  set->longest_key = MAX(set->longest_key, key_len);
+
+  // if we already have data by this name, delete it. Everything after it
+  // moves up, so our index is no good anymore
+  if(pos != NOTHING) {
+    delete_storage_data(&set->entries[pos]);
+    memmove(set->entries + pos, set->entries + pos + 1,
+	    sizeof(STORAGE_DATA) * (set->size - pos - 1));
+    set->size--;
+    if(set->index != NULL) {
+      deleteHashtable(set->index);
+      set->index = NULL;
+    }
+  }
 
-STORAGE_DATA    *new_data_int(int val, const char *key) {
-  char str_val[20]; snprintf(str_val, 20, "%d", val);
-  return new_data_string(str_val, key);
+  // add the new data
+  if(set->size == set->max_size) {
+    set->max_size = MAX(4, set->max_size * 2);
+    set->entries  = realloc(set->entries, sizeof(STORAGE_DATA)*set->max_size);
+  }
+  STORAGE_DATA *data = &set->entries[set->size++];
+  memset(data, 0, sizeof(STORAGE_DATA));
+  if(key_len < SHORT_KEY_LEN)
+    strcpy(data->short_key, key);
+  else
+    data->long_key = strdup(key);
+  data->type = type;
+  if(set->index != NULL)
+    hashPut(set->index, key, (void *)(long)set->size);
+  return data;
 }
 
-STORAGE_DATA    *new_data_long(long val, const char *key) {
-  char str_val[20]; snprintf(str_val, 20, "%ld", val);
-  return new_data_string(str_val, key);
+//
+// return the data's value as a string. Numbers are printed into buf, which
+// must be at least NUMBER_LEN long. Sets and lists have no string value
+//
+const char *storage_data_string(STORAGE_DATA *data, char *buf) {
+  switch(data->type) {
+  case DATA_STRING: return data->val.str_val;
+  case DATA_INT:    snprintf(buf, NUMBER_LEN, "%d", (int)data->val.long_val);
+                    return buf;
+  case DATA_LONG:   snprintf(buf, NUMBER_LEN, "%ld", data->val.long_val);
+                    return buf;
+  case DATA_DOUBLE: snprintf(buf, NUMBER_LEN, "%lf", data->val.double_val);
+                    return buf;
+  case DATA_BOOL:   return (data->val.long_val ? "yes" : "no");
+  default:          return "";
+  }
 }
 
-STORAGE_DATA *new_data_double(double val, const char *key) {
-  char str_val[20]; snprintf(str_val, 20, "%lf", val);
-  return new_data_string(str_val, key);
+//
+// return true if the data would not be written out. Numbers always are
+//
+bool data_is_empty(STORAGE_DATA *data) {
+  switch(data->type) {
+  case DATA_STRING: return !*data->val.str_val;
+  case DATA_SET:    return set_is_empty(data->val.set_val);
+  case DATA_LIST:   return list_is_empty(data->val.list_val);
+  default:          return FALSE;
+  }
 }
 
 
@@ -164,7 +257,9 @@ void print_key(FILEBUF *fb, const char *key, int key_width, int indent) {
 // write a string containing newlines to a file
 //
 void write_string_data(const char *string, FILEBUF *fb, int indent) {
-  static char buf[SMALL_BUFFER];
+  // not static; sets may be written from the background writer and the game
+  // loop at the same time
+  char buf[SMALL_BUFFER];
   int i, str_i, do_indent;
   *buf = '\0';
   do_indent = TRUE;
@@ -190,22 +285,10 @@ void write_string_data(const char *string, FILEBUF *fb, int indent) {
 // return true if the storage set is empty, and false if it is not
 //
 bool set_is_empty(STORAGE_SET *set) {
-  // if the hashtable has a size of 0, we know for sure it's empty
-  if(hashSize(set->entries) > 0) {
-    HASH_ITERATOR *hash_i = newHashIterator(set->entries);
-    STORAGE_DATA    *data = NULL;
-    const char       *key = NULL;
-
-    ITERATE_HASH(key, data, hash_i) {
-      if(*data->str_val || 
-	 !set_is_empty(data->set_val) || !list_is_empty(data->list_val)) {
-	deleteHashIterator(hash_i);
-	return FALSE;
-      }
-    }
-    deleteHashIterator(hash_i);
-  }
-
+  int i;
+  for(i = 0; i < set->size; i++)
+    if(!data_is_empty(&set->entries[i]))
+      return FALSE;
   return TRUE;
 }
 
@@ -214,86 +297,57 @@ bool set_is_empty(STORAGE_SET *set) {
 // return true if the storage list is empty, and false if it is not
 //
 bool list_is_empty(STORAGE_SET_LIST *list) {
-  // if the list size is 0, we know for sure it's empty
-  if(listSize(list->list) > 0) {
-    LIST_ITERATOR *list_i = newListIterator(list->list);
-    STORAGE_SET      *set = NULL;
-    ITERATE_LIST(set, list_i) {
-      if(!set_is_empty(set)) {
-	deleteListIterator(list_i);
-	return FALSE;
-      }
-    }
-    deleteListIterator(list_i);
-  }
+  int i;
+  for(i = 0; i < list->size; i++)
+    if(!set_is_empty(list->sets[i]))
+      return FALSE;
   return TRUE;
 }
 
 
 void write_storage_data(STORAGE_DATA *data, FILEBUF *fb, int key_width,int indent){
+  char        buf[NUMBER_LEN];
+  const char *key = storage_data_key(data);
+
   // first, we see if we have a string value. If we do, print it
-  if(*data->str_val) {
-    print_key(fb, data->key, key_width, indent);
+  if(data->type != DATA_SET && data->type != DATA_LIST) {
+    const char *str_val = storage_data_string(data, buf);
+    if(!*str_val)
+      return;
+    print_key(fb, key, key_width, indent);
     // if we have a newline in our string, we have to write
     // it in a special way so as to preserve the lines
-    if(count_letters(data->str_val, '\n', strlen(data->str_val)) > 0) {
+    if(strchr(str_val, '\n') != NULL) {
       // first, print the string marker and skip down to a newline
       fbprintf(fb, "%c\n", STRING_MARKER);
       // now, write the string
-      write_string_data(data->str_val, fb, indent+2);
+      write_string_data(str_val, fb, indent+2);
     }
     else
-      fbprintf(fb, "%c%s\n", TYPELESS_MARKER, data->str_val);
+      fbprintf(fb, "%c%s\n", TYPELESS_MARKER, str_val);
   }
 
   // If that fails, check if we have a set value. If we do, print it
-  else if(!set_is_empty(data->set_val)) {
-    print_key(fb, data->key, key_width, indent);
+  else if(data->type == DATA_SET && !set_is_empty(data->val.set_val)) {
+    print_key(fb, key, key_width, indent);
     fbprintf(fb, "%c\n", SET_MARKER);
-    write_storage_set(data->set_val, fb, indent+2);
+    write_storage_set(data->val.set_val, fb, indent+2);
   }
 
   // otherwise, check if we have a list value. If we do, print it
-  else if(!list_is_empty(data->list_val)) {
-    print_key(fb, data->key, key_width, indent);
+  else if(data->type == DATA_LIST && !list_is_empty(data->val.list_val)) {
+    print_key(fb, key, key_width, indent);
     fbprintf(fb, "%c\n", LIST_MARKER);
-    write_storage_list(data->list_val, fb, indent+2);
+    write_storage_list(data->val.list_val, fb, indent+2);
   }
 }
 
 
-//
-// Compares two variables on their entry_num. This is used by
-// write_storage_set to print data out in the same order it was
-// entered.
-//
-int cmp_storage_vars(STORAGE_DATA *data1, STORAGE_DATA *data2) {
-  if(data1->entry_num == data2->entry_num)
-    return 0;
-  else if(data1->entry_num < data2->entry_num)
-    return -1;
-  return 1;
-}
-
-
 void write_storage_set(STORAGE_SET *set, FILEBUF *fb, int indent) {
-  // collect all of the items in our hashtable
-  LIST           *elems = newList();
-  HASH_ITERATOR *hash_i = newHashIterator(set->entries);
-  STORAGE_DATA    *data = NULL;
-  const char       *key = NULL;
-
-  ITERATE_HASH(key, data, hash_i)
-    listPut(elems, data);
-  deleteHashIterator(hash_i);
-
-  // now, sort them all
-  listSortWith(elems, cmp_storage_vars);
-
-  // now, for each one, print it
-  while( (data = listPop(elems)) != NULL)
-    write_storage_data(data, fb, set->longest_key, indent);
-  deleteList(elems);
+  // our entries are already in the order they were put in. Print each one
+  int i;
+  for(i = 0; i < set->size; i++)
+    write_storage_data(&set->entries[i], fb, set->longest_key, indent);
 
   // print our indent and the end-of-set marker
   print_indent(fb, indent);
@@ -302,12 +356,9 @@ void write_storage_set(STORAGE_SET *set, FILEBUF *fb, int indent) {
 
 
 void write_storage_list(STORAGE_SET_LIST *list, FILEBUF *fb, int indent) {
-  LIST_ITERATOR *list_i = newListIterator(list->list);
-  STORAGE_SET      *set = NULL;
-
-  ITERATE_LIST(set, list_i)
-    write_storage_set(set, fb, indent);
-  deleteListIterator(list_i);
+  int i;
+  for(i = 0; i < list->size; i++)
+    write_storage_set(list->sets[i], fb, indent);
 }
 
 
@@ -479,20 +530,16 @@ STORAGE_SET *parse_storage_set(FILEBUF *fb, int indent) {
     char type = parse_type(fb);
 
     switch(type) {
-    case TYPELESS_MARKER: {
-      char *line = parse_line(fb);
-      store_string(set, key, line);
-      free(line);
+    // strings we parse are ours already; no need to copy them again
+    case TYPELESS_MARKER:
+      storage_put(set, key, DATA_STRING)->val.str_val = parse_line(fb);
       break;
-    }
 
-    case STRING_MARKER: {
+    case STRING_MARKER:
       fbgetc(fb); // kill the newline
-      char *string = parse_string(fb, indent+2);
-      store_string(set, key, string);
-      free(string);
+      storage_put(set, key, DATA_STRING)->val.str_val =
+	parse_string(fb, indent+2);
       break;
-    }
 
     case SET_MARKER:
       fbgetc(fb); // kill the newline
@@ -516,6 +563,324 @@ STORAGE_SET *parse_storage_set(FILEBUF *fb, int indent) {
 
 
 
+//*****************************************************************************
+//
+// Binary storage files. These hold the same sets, lists, and strings as the
+// text format, but are laid out to be read quickly instead of by people. A
+// file is the magic header, a version byte, and then the top set:
+//
+//   set   : <count> <entry> * count
+//   entry : <key> <type> <value>
+//   key   : <index> if the key has been seen before in this file, otherwise
+//           <number of keys seen so far> <length> <bytes>
+//   value : a string is <length> <bytes>, a set is a set, and a list is
+//           <count> <set> * count
+//
+// Counts, lengths, and indexes are unsigned LEB128 varints. Each key is only
+// written out in full the first time it shows up in a file; after that, it is
+// written as the order it was first seen in. Like the text format, empty
+// strings, sets, and lists are not written at all.
+//
+//*****************************************************************************
+#define BINARY_MAGIC          "\x7fNMS"
+#define BINARY_MAGIC_LEN      4
+#define BINARY_VERSION        1
+
+#define BINARY_STRING         's'
+#define BINARY_SET            't'
+#define BINARY_LIST           'l'
+
+typedef struct binary_writer {
+  unsigned char  *buf;
+  int             len;
+  int         max_len;
+  HASHTABLE     *keys; // key -> its index + 1. Case-insensitive, so check it
+  char     **key_strs; // the keys, in the order they were first written
+  int        num_keys;
+  int        max_keys;
+} BINARY_WRITER;
+
+typedef struct binary_reader {
+  const unsigned char *pos;
+  const unsigned char *end;
+  char              **keys; // the keys we've seen so far, by index
+  int             num_keys;
+  int             max_keys;
+  bool               error; // set if the file ends early or makes no sense
+} BINARY_READER;
+
+/* local functions */
+void binary_write_set(BINARY_WRITER *wr, STORAGE_SET *set);
+STORAGE_SET *binary_read_set(BINARY_READER *rd);
+
+
+//
+// make room for at least len more bytes in the writer
+//
+void binary_reserve(BINARY_WRITER *wr, int len) {
+  if(wr->len + len > wr->max_len) {
+    wr->max_len = MAX(wr->max_len * 2, wr->len + len);
+    wr->buf     = realloc(wr->buf, wr->max_len);
+  }
+}
+
+void binary_write_bytes(BINARY_WRITER *wr, const void *bytes, int len) {
+  binary_reserve(wr, len);
+  memcpy(wr->buf + wr->len, bytes, len);
+  wr->len += len;
+}
+
+void binary_write_varint(BINARY_WRITER *wr, unsigned int val) {
+  binary_reserve(wr, 5);
+  while(val >= 0x80) {
+    wr->buf[wr->len++] = (val & 0x7F) | 0x80;
+    val >>= 7;
+  }
+  wr->buf[wr->len++] = val;
+}
+
+void binary_write_string(BINARY_WRITER *wr, const char *str) {
+  int len = strlen(str);
+  binary_write_varint(wr, len);
+  binary_write_bytes(wr, str, len);
+}
+
+//
+// write a key, by its index if we have written it before
+//
+void binary_write_key(BINARY_WRITER *wr, const char *key) {
+  int index = (int)(long)hashGet(wr->keys, key) - 1;
+  // the table doesn't care about case, but we do
+  if(index >= 0 && !strcmp(wr->key_strs[index], key))
+    binary_write_varint(wr, index);
+  else {
+    binary_write_varint(wr, wr->num_keys);
+    binary_write_string(wr, key);
+    if(index < 0)
+      hashPut(wr->keys, key, (void *)(long)(wr->num_keys + 1));
+    if(wr->num_keys == wr->max_keys) {
+      wr->max_keys = MAX(16, wr->max_keys * 2);
+      wr->key_strs = realloc(wr->key_strs, sizeof(char *) * wr->max_keys);
+    }
+    wr->key_strs[wr->num_keys++] = strdup(key);
+  }
+}
+
+void binary_write_list(BINARY_WRITER *wr, STORAGE_SET_LIST *list) {
+  int count = 0, i;
+  for(i = 0; i < list->size; i++)
+    if(!set_is_empty(list->sets[i]))
+      count++;
+
+  binary_write_varint(wr, count);
+  for(i = 0; i < list->size; i++)
+    if(!set_is_empty(list->sets[i]))
+      binary_write_set(wr, list->sets[i]);
+}
+
+void binary_write_set(BINARY_WRITER *wr, STORAGE_SET *set) {
+  char  buf[NUMBER_LEN];
+  int count = 0, i;
+
+  // skip everything the text format wouldn't write
+  for(i = 0; i < set->size; i++)
+    if(!data_is_empty(&set->entries[i]))
+      count++;
+
+  binary_write_varint(wr, count);
+  for(i = 0; i < set->size; i++) {
+    STORAGE_DATA *data = &set->entries[i];
+    if(data_is_empty(data))
+      continue;
+    binary_write_key(wr, storage_data_key(data));
+    if(data->type == DATA_SET) {
+      binary_write_bytes(wr, (char []){ BINARY_SET }, 1);
+      binary_write_set(wr, data->val.set_val);
+    }
+    else if(data->type == DATA_LIST) {
+      binary_write_bytes(wr, (char []){ BINARY_LIST }, 1);
+      binary_write_list(wr, data->val.list_val);
+    }
+    else {
+      binary_write_bytes(wr, (char []){ BINARY_STRING }, 1);
+      binary_write_string(wr, storage_data_string(data, buf));
+    }
+  }
+}
+
+unsigned int binary_read_varint(BINARY_READER *rd) {
+  unsigned int val = 0;
+  int        shift = 0;
+  while(rd->pos < rd->end && shift < 32) {
+    unsigned char byte = *rd->pos++;
+    val |= (unsigned int)(byte & 0x7F) << shift;
+    if(!(byte & 0x80))
+      return val;
+    shift += 7;
+  }
+  rd->error = TRUE;
+  return 0;
+}
+
+//
+// read a string of the given length, and return a copy of it
+//
+char *binary_read_string(BINARY_READER *rd) {
+  unsigned int len = binary_read_varint(rd);
+  if(rd->error || len > (unsigned int)(rd->end - rd->pos)) {
+    rd->error = TRUE;
+    return NULL;
+  }
+  char *str = malloc(len + 1);
+  memcpy(str, rd->pos, len);
+  str[len]  = '\0';
+  rd->pos  += len;
+  return str;
+}
+
+//
+// read a key. Returns the reader's copy of it, or NULL if there's a problem
+//
+const char *binary_read_key(BINARY_READER *rd) {
+  unsigned int index = binary_read_varint(rd);
+  if(rd->error)
+    return NULL;
+  else if(index < (unsigned int)rd->num_keys)
+    return rd->keys[index];
+  else if(index > (unsigned int)rd->num_keys) {
+    rd->error = TRUE;
+    return NULL;
+  }
+  else {
+    char *key = binary_read_string(rd);
+    if(key == NULL)
+      return NULL;
+    if(rd->num_keys == rd->max_keys) {
+      rd->max_keys = MAX(16, rd->max_keys * 2);
+      rd->keys     = realloc(rd->keys, sizeof(char *) * rd->max_keys);
+    }
+    rd->keys[rd->num_keys++] = key;
+    return key;
+  }
+}
+
+STORAGE_SET_LIST *binary_read_list(BINARY_READER *rd) {
+  STORAGE_SET_LIST *list = new_storage_list();
+  unsigned int     count = binary_read_varint(rd);
+  for(; !rd->error && count > 0; count--) {
+    STORAGE_SET *set = binary_read_set(rd);
+    if(set != NULL)
+      storage_list_put(list, set);
+  }
+  return list;
+}
+
+STORAGE_SET *binary_read_set(BINARY_READER *rd) {
+  STORAGE_SET  *set = new_storage_set();
+  unsigned int count = binary_read_varint(rd);
+
+  for(; !rd->error && count > 0; count--) {
+    const char *key = binary_read_key(rd);
+    if(key == NULL || rd->pos >= rd->end) {
+      rd->error = TRUE;
+      break;
+    }
+
+    switch(*rd->pos++) {
+    case BINARY_STRING: {
+      // take the string as it is, instead of copying it again
+      char *str = binary_read_string(rd);
+      if(str != NULL)
+	storage_put(set, key, DATA_STRING)->val.str_val = str;
+      break;
+    }
+
+    case BINARY_SET:
+      store_set(set, key, binary_read_set(rd));
+      break;
+
+    case BINARY_LIST:
+      store_list(set, key, binary_read_list(rd));
+      break;
+
+    default:
+      rd->error = TRUE;
+      break;
+    }
+  }
+  return set;
+}
+
+//
+// parse the binary storage set in the bytes following the magic header.
+// Returns NULL if it's not something we can read
+//
+STORAGE_SET *binary_parse(const unsigned char *bytes, int len) {
+  if(len < 1 || bytes[0] > BINARY_VERSION)
+    return NULL;
+
+  BINARY_READER rd;
+  memset(&rd, 0, sizeof(BINARY_READER));
+  rd.pos = bytes + 1;
+  rd.end = bytes + len;
+
+  STORAGE_SET *set = binary_read_set(&rd);
+  while(rd.num_keys > 0)
+    free(rd.keys[--rd.num_keys]);
+  if(rd.keys) free(rd.keys);
+
+  if(rd.error) {
+    delete_storage_set(set);
+    return NULL;
+  }
+  return set;
+}
+
+//
+// read in a binary storage file whose magic header has already been read
+//
+STORAGE_SET *binary_read_file(FILE *fl) {
+  unsigned char *bytes = NULL;
+  int              len = 0;
+  int          max_len = 0;
+  int             amnt = 0;
+
+  do {
+    if(len == max_len) {
+      max_len = MAX(MAX_BUFFER, max_len * 2);
+      bytes   = realloc(bytes, max_len);
+    }
+    amnt = fread(bytes + len, 1, max_len - len, fl);
+    len += amnt;
+  } while(amnt > 0);
+
+  STORAGE_SET *set = binary_parse(bytes, len);
+  free(bytes);
+  return set;
+}
+
+//
+// write the set out in the binary format
+//
+void binary_write_file(STORAGE_SET *set, FILE *fl) {
+  BINARY_WRITER wr;
+  memset(&wr, 0, sizeof(BINARY_WRITER));
+  wr.keys     = newHashtable();
+
+  binary_write_bytes(&wr, BINARY_MAGIC, BINARY_MAGIC_LEN);
+  binary_write_bytes(&wr, (char []){ BINARY_VERSION }, 1);
+  binary_write_set(&wr, set);
+  fwrite(wr.buf, 1, wr.len, fl);
+
+  while(wr.num_keys > 0)
+    free(wr.key_strs[--wr.num_keys]);
+  if(wr.key_strs) free(wr.key_strs);
+  deleteHashtable(wr.keys);
+  if(wr.buf) free(wr.buf);
+}
+
+
+
 
 //*****************************************************************************
 //
@@ -524,21 +889,48 @@ STORAGE_SET *parse_storage_set(FILEBUF *fb, int indent) {
 //
 //*****************************************************************************
 void storage_write(STORAGE_SET *set, const char *fname) {
-  FILEBUF *fb = NULL;
-  // we wanted to open a file, but we couldn't ... abort
-  if((fb = fbopen(fname, "w+")) == NULL)
-    return;
-  write_storage_set(set, fb, 0);
-  fbclose(fb);
+  // keep the file in whatever format it's already in
+  int format = storage_format(fname);
+  storage_write_format(set, fname,
+		       (format == NOTHING ? STORAGE_FORMAT_TEXT : format));
+}
+
+
+bool storage_write_format(STORAGE_SET *set, const char *fname, int format) {
+  if(format == STORAGE_FORMAT_BINARY) {
+    FILE *fl = NULL;
+    if((fl = fopen(fname, "wb")) == NULL)
+      return FALSE;
+    binary_write_file(set, fl);
+    bool ok = !ferror(fl);
+    return (fclose(fl) == 0 && ok);
+  }
+  else {
+    FILEBUF *fb = NULL;
+    // we wanted to open a file, but we couldn't ... abort
+    if((fb = fbopen(fname, "w+")) == NULL)
+      return FALSE;
+    write_storage_set(set, fb, 0);
+    return fbclose(fb);
+  }
+}
+
+
+int storage_format(const char *fname) {
+  char magic[BINARY_MAGIC_LEN];
+  FILE   *fl = fopen(fname, "rb");
+  if(fl == NULL)
+    return NOTHING;
+  int amnt = fread(magic, 1, BINARY_MAGIC_LEN, fl);
+  fclose(fl);
+  if(amnt == BINARY_MAGIC_LEN && !memcmp(magic, BINARY_MAGIC,BINARY_MAGIC_LEN))
+    return STORAGE_FORMAT_BINARY;
+  return STORAGE_FORMAT_TEXT;
 }
 
 
 STORAGE_SET *new_storage_set() {
-  STORAGE_SET *set = malloc(sizeof(STORAGE_SET));
-  set->entries     = newHashtableSize(20);
-  set->longest_key = 0;
-  set->top_entry   = 0;
-  return set;
+  return calloc(1, sizeof(STORAGE_SET));
 }
 
 
@@ -548,6 +940,26 @@ void storage_close(STORAGE_SET *set) {
 
 
 STORAGE_SET *storage_read(const char *fname) {
+  // binary files are read straight in. Anything else is text
+  char magic[BINARY_MAGIC_LEN];
+  FILE   *fl = fopen(fname, "rb");
+  if(fl == NULL)
+    return NULL;
+  if(fread(magic, 1, BINARY_MAGIC_LEN, fl) == BINARY_MAGIC_LEN &&
+     !memcmp(magic, BINARY_MAGIC, BINARY_MAGIC_LEN)) {
+    STORAGE_SET *set = binary_read_file(fl);
+    fclose(fl);
+    // a file that is there always reads as a set, like text ones do. Callers
+    // count on it, so a bad file reads as an empty one
+    if(set == NULL) {
+      bug("storage_read: %s is truncated, corrupt, or from a newer version",
+	  fname);
+      set = new_storage_set();
+    }
+    return set;
+  }
+  fclose(fl);
+
   FILEBUF *fb = NULL;
   // we wanted to open a file, but we couldn't ... return an empty set
   if((fb = fbopen(fname, "r")) == NULL)
@@ -571,123 +983,146 @@ STORAGE_SET *storage_read(const char *fname) {
 }
 
 STORAGE_SET_LIST *new_storage_list() {
-  STORAGE_SET_LIST *list = malloc(sizeof(STORAGE_SET_LIST));
-  list->list = newList();
-  list->list_i = NULL;
-  return list;
+  return calloc(1, sizeof(STORAGE_SET_LIST));
 }
 
 STORAGE_SET *storage_list_next(STORAGE_SET_LIST *list) {
-  if(list->list_i == NULL)
-    list->list_i = newListIterator(list->list);
-  else
-    listIteratorNext(list->list_i);
-  return listIteratorCurrent(list->list_i);
+  if(list->next < list->size)
+    return list->sets[list->next++];
+  return NULL;
 }
 
 void storage_list_put(STORAGE_SET_LIST *list, STORAGE_SET *set) {
-  listQueue(list->list, set);
-}
-
-void   storage_put(STORAGE_SET *set, STORAGE_DATA *data) {
-  // see if it's our longest key
-  int key_len      = strlen(data->key);
-  set->longest_key = MAX(set->longest_key, key_len);
-  // if we already have data by this name, delete it
-  STORAGE_DATA *olddata = hashGet(set->entries, data->key);
-  if(olddata) delete_storage_data(olddata);
-  // add the new data
-  hashPut(set->entries, data->key, data);
-  data->entry_num = ++set->top_entry;
+  if(list->size == list->max_size) {
+    list->max_size = MAX(4, list->max_size * 2);
+    list->sets = realloc(list->sets, sizeof(STORAGE_SET *) * list->max_size);
+  }
+  list->sets[list->size++] = set;
 }
 
 
 void   store_set(STORAGE_SET *set, const char *key, STORAGE_SET *val) {
-  storage_put(set, new_data_set(val, key));
+  storage_put(set, key, DATA_SET)->val.set_val = val;
 }
 
 void   store_list(STORAGE_SET *set, const char *key, STORAGE_SET_LIST *val) {
-  storage_put(set, new_data_list(val, key));
+  storage_put(set, key, DATA_LIST)->val.list_val = val;
 }
 
 void store_string(STORAGE_SET *set, const char *key, const char *val) {
-  storage_put(set, new_data_string(val, key));
+  // val might belong to the data we're replacing. Copy it first
+  char *copy = strdup(val);
+  storage_put(set, key, DATA_STRING)->val.str_val = copy;
 }
 
 void store_double(STORAGE_SET *set, const char *key, double val) {
-  storage_put(set, new_data_double(val, key));
+  storage_put(set, key, DATA_DOUBLE)->val.double_val = val;
 }
 
 void store_bool(STORAGE_SET *set, const char *key, bool val) {
-  storage_put(set, new_data_bool(val, key));
+  storage_put(set, key, DATA_BOOL)->val.long_val = (val != FALSE);
 }
 
 void store_int(STORAGE_SET *set, const char *key, int val) {
-  storage_put(set, new_data_int(val, key));
+  storage_put(set, key, DATA_INT)->val.long_val = val;
 }
 
 void store_long(STORAGE_SET *set, const char *key, long val) {
-  storage_put(set, new_data_long(val, key));
+  storage_put(set, key, DATA_LONG)->val.long_val = val;
 }
 
+//
+// sets and lists that are asked for but aren't there are made, so whatever
+// is put in them is kept. If the key holds something else, it is replaced
 STORAGE_SET *read_set(STORAGE_SET *set, const char *key) {
-  STORAGE_DATA *data = hashGet(set->entries, key);
-  if(data) 
-    return data->set_val;
+  STORAGE_DATA *data = storage_get(set, key);
+  if(data && data->type == DATA_SET)
+    return data->val.set_val;
   else {
-    store_set(set, key, new_storage_set());
-    return read_set(set, key);
+    STORAGE_SET *val = new_storage_set();
+    store_set(set, key, val);
+    return val;
   }
 }
 
 STORAGE_SET_LIST *read_list(STORAGE_SET *set, const char *key) {
-  STORAGE_DATA *data = hashGet(set->entries, key);
-  if(data) 
-    return data->list_val;
+  STORAGE_DATA *data = storage_get(set, key);
+  if(data && data->type == DATA_LIST)
+    return data->val.list_val;
   else {
-    store_list(set, key, new_storage_list());
-    return read_list(set, key);
+    STORAGE_SET_LIST *val = new_storage_list();
+    store_list(set, key, val);
+    return val;
   }
 }
 
+//
+// numbers read back as strings are turned into strings for good, so the
+// string we return stays around as long as the data does
 const char *read_string(STORAGE_SET *set, const char *key) {
-  STORAGE_DATA *data = hashGet(set->entries, key);
-  if(data) return data->str_val;
-  else     return "";
+  STORAGE_DATA *data = storage_get(set, key);
+  char      buf[NUMBER_LEN];
+  if(data == NULL || data->type == DATA_SET || data->type == DATA_LIST)
+    return "";
+  else if(data->type != DATA_STRING) {
+    char *str_val      = strdup(storage_data_string(data, buf));
+    data->type         = DATA_STRING;
+    data->val.str_val  = str_val;
+  }
+  return data->val.str_val;
 }
 
+//
+// numbers read back as the type they were stored as are given straight
+// back. Otherwise, they are read from their string value, as if they had just
+// been loaded from a file
 bool read_bool(STORAGE_SET *set, const char *key) {
-  STORAGE_DATA *data = hashGet(set->entries, key);
+  STORAGE_DATA *data = storage_get(set, key);
+  char      buf[NUMBER_LEN];
   if(data == NULL) 
     return FALSE;
-  else if(!strcasecmp(data->str_val, "Yes"))
-    return TRUE;
-  else if(atoi(data->str_val) != 0)
-    return TRUE;
-  else
-    return FALSE;
+  else if(data->type == DATA_BOOL)
+    return (data->val.long_val != 0);
+  else {
+    const char *str_val = storage_data_string(data, buf);
+    return (!strcasecmp(str_val, "Yes") || atoi(str_val) != 0);
+  }
 }
 
 double read_double(STORAGE_SET *set, const char *key) {
-  STORAGE_DATA *data = hashGet(set->entries, key);
-  if(data) return atof(data->str_val);
-  else     return 0;
+  STORAGE_DATA *data = storage_get(set, key);
+  char      buf[NUMBER_LEN];
+  if(data == NULL)
+    return 0;
+  else if(data->type == DATA_DOUBLE)
+    return data->val.double_val;
+  else if(data->type == DATA_INT || data->type == DATA_LONG)
+    return data->val.long_val;
+  return atof(storage_data_string(data, buf));
 }
 
 int read_int(STORAGE_SET *set, const char *key) {
-  STORAGE_DATA *data = hashGet(set->entries, key);
-  if(data) return atoi(data->str_val);
-  else     return 0;
+  STORAGE_DATA *data = storage_get(set, key);
+  char      buf[NUMBER_LEN];
+  if(data == NULL)
+    return 0;
+  else if(data->type == DATA_INT)
+    return data->val.long_val;
+  return atoi(storage_data_string(data, buf));
 }
 
 long read_long(STORAGE_SET *set, const char *key) {
-  STORAGE_DATA *data = hashGet(set->entries, key);
-  if(data) return atol(data->str_val);
-  else     return 0;
+  STORAGE_DATA *data = storage_get(set, key);
+  char      buf[NUMBER_LEN];
+  if(data == NULL)
+    return 0;
+  else if(data->type == DATA_INT || data->type == DATA_LONG)
+    return data->val.long_val;
+  return atol(storage_data_string(data, buf));
 }
 
 bool storage_contains(STORAGE_SET *set, const char *key) {
-  return (hashGet(set->entries, key) != NULL);
+  return (storage_find(set, key) != NOTHING);
 }
 
 //
@@ -697,12 +1132,13 @@ STORAGE_SET_LIST *gen_store_list(LIST *list, void *storer) {
   STORAGE_SET *(* store_func)(void *) = storer;
   STORAGE_SET_LIST *set_list = new_storage_list();
 
-  LIST_ITERATOR *list_i = newListIterator(list);
+  LIST_ITERATOR list_i;
+  listIteratorStart(&list_i, list);
   void            *elem = NULL;
 
-  ITERATE_LIST(elem, list_i)
+  ITERATE_LIST(elem, &list_i)
     storage_list_put(set_list, store_func(elem));
-  deleteListIterator(list_i);
+  listIteratorStop(&list_i);
   return set_list;
 }
 
@@ -11,8 +11,15 @@
 // storing data. Most of them are based on what I learned from my (brief)
 // exposure to YAML.
 //
+// Sets can be written as text, or in a compact binary format that is much
+// quicker to read back in. storage_read() reads either one.
+//
 //******************************************************************************
 
+// the formats storage sets can be written in
+#define STORAGE_FORMAT_TEXT        0
+#define STORAGE_FORMAT_BINARY      1
+
 
 //
 // Create a new storage set for storing data
@@ -27,17 +34,33 @@ STORAGE_SET_LIST *new_storage_list();
 
 
 //
-// write the storage set to the specified file
+// write the storage set to the specified file. If the file already exists, it
+// is kept in the format it is in. New files are written as text
 //
 void storage_write(STORAGE_SET *set, const char *fname);
 
 
 //
-// read the storage set from the specified file
+// write the storage set to the specified file, in the given format. Returns
+// FALSE if the file could not be opened or written
+//
+bool storage_write_format(STORAGE_SET *set, const char *fname, int format);
+
+
+//
+// read the storage set from the specified file, whichever format it is in.
+// Returns NULL if the file cannot be opened. A binary file that can't be
+// parsed is reported with bug(), and read as an empty set
 //
 STORAGE_SET *storage_read(const char *fname);
 
 
+//
+// return the format the specified file is in, or NOTHING if it can't be read
+//
+int storage_format(const char *fname);
+
+
 //
 // close and delete the specified storage set
 //
@@ -0,0 +1,334 @@
+//*****************************************************************************
+//
+// storage_writer.c
+//
+// Writes storage sets to disk on a background thread. See storage_writer.h
+// for documentation.
+//
+// Saves wait in a first-in, first-out queue. There is never more than one
+// save of the same file in the queue; saving a file again replaces whatever
+// was pending for it, in the same place in line. Because of that, and because
+// there is only one writer, saves of a file always hit the disk in the order
+// they were made. The writer never logs anything itself, since logging talks
+// to sockets. Failures are noted down, and logged by the game loop.
+//
+//*****************************************************************************
+
+#include <errno.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include "mud.h"
+#include "utils.h"
+#include "storage.h"
+#include "event.h"
+#include "character.h"
+#include "storage_writer.h"
+
+
+
+//*****************************************************************************
+// local datastructures, functions, and defines
+//*****************************************************************************
+
+// the most saves that can be waiting to be written at once
+#define STORAGE_WRITER_MAX_QUEUE      256
+
+typedef struct storage_job {
+  char               *fname;
+  STORAGE_SET          *set; // NULL if the file is being deleted
+  struct storage_job  *next;
+} STORAGE_JOB;
+
+pthread_mutex_t writer_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t  writer_work = PTHREAD_COND_INITIALIZER; // there's a job to do
+pthread_cond_t  writer_done = PTHREAD_COND_INITIALIZER; // a job was finished
+                                                        // or taken off the queue
+bool         writer_running = FALSE;
+
+STORAGE_JOB     *queue_head = NULL;
+STORAGE_JOB     *queue_tail = NULL;
+int               queue_len = 0;
+STORAGE_JOB        *writing = NULL; // the job the writer is working on
+
+// stats for the admin command. All of them are protected by writer_lock
+long         writes_queued = 0; // saves and deletions asked for
+long      writes_coalesced = 0; // ones that replaced a pending one
+long        writes_written = 0; // files written or deleted
+long         writes_failed = 0; // ones that could not be done
+long        writes_in_sync = 0; // ones done by the game loop, so it could read
+int        queue_high_mark = 0; // the most saves that were ever pending
+long            full_waits = 0; // times the game loop waited on a full queue
+double        full_wait_ms = 0; // and how long it waited, in total
+double            write_ms = 0; // time spent writing files
+long         failed_logged = 0; // how many failures the game loop has logged
+char      last_failed[MAX_BUFFER] = "";
+
+double writer_now_ms(void) {
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return now.tv_sec * 1000.0 + now.tv_usec / 1000.0;
+}
+
+//
+// make every missing directory leading up to fname
+void writer_make_dirs(const char *fname) {
+  char path[MAX_BUFFER];
+  char *ptr = NULL;
+  snprintf(path, sizeof(path), "%s", fname);
+  for(ptr = strchr(path + 1, '/'); ptr != NULL; ptr = strchr(ptr + 1, '/')) {
+    *ptr = '\0';
+    mkdir(path, S_IRWXU | S_IRWXG);
+    *ptr = '/';
+  }
+}
+
+//
+// write out or delete the job's file. The set is written to a temporary file
+// that is then renamed over the real one. Returns whether it worked
+bool writer_do_job(STORAGE_JOB *job) {
+  char tmp[MAX_BUFFER];
+  if(job->set == NULL)
+    return (unlink(job->fname) == 0 || errno == ENOENT);
+
+  int format = storage_format(job->fname);
+  if(format == NOTHING)
+    format = STORAGE_FORMAT_TEXT;
+  snprintf(tmp, sizeof(tmp), "%s.tmp", job->fname);
+
+  // the directory we're saving into might not exist yet
+  bool ok = storage_write_format(job->set, tmp, format);
+  if(!ok && errno == ENOENT) {
+    writer_make_dirs(job->fname);
+    ok = storage_write_format(job->set, tmp, format);
+  }
+  if(ok && rename(tmp, job->fname) != 0)
+    ok = FALSE;
+  if(!ok)
+    unlink(tmp);
+  return ok;
+}
+
+void deleteStorageJob(STORAGE_JOB *job) {
+  if(job->set)
+    storage_close(job->set);
+  free(job->fname);
+  free(job);
+}
+
+//
+// note how a job went. Must be called with writer_lock held
+void writer_job_done(STORAGE_JOB *job, bool ok, double ms) {
+  write_ms += ms;
+  if(ok)
+    writes_written++;
+  else {
+    writes_failed++;
+    snprintf(last_failed, sizeof(last_failed), "%s", job->fname);
+  }
+}
+
+//
+// the background writer. Takes jobs off the front of the queue, forever
+void *storage_writer_thread(void *unused) {
+  pthread_mutex_lock(&writer_lock);
+  for(;;) {
+    while(queue_head == NULL)
+      pthread_cond_wait(&writer_work, &writer_lock);
+
+    STORAGE_JOB *job = queue_head;
+    queue_head = job->next;
+    if(queue_head == NULL)
+      queue_tail = NULL;
+    queue_len--;
+    writing = job;
+    pthread_mutex_unlock(&writer_lock);
+
+    double start = writer_now_ms();
+    bool      ok = writer_do_job(job);
+    double    ms = writer_now_ms() - start;
+
+    pthread_mutex_lock(&writer_lock);
+    writer_job_done(job, ok, ms);
+    writing = NULL;
+    pthread_cond_broadcast(&writer_done);
+    pthread_mutex_unlock(&writer_lock);
+    deleteStorageJob(job);
+    pthread_mutex_lock(&writer_lock);
+  }
+  return NULL;
+}
+
+//
+// return the queued job for fname, or NULL if there isn't one. The queue is
+// never long, so a scan is cheaper than keeping an index in step with it.
+// Must be called with writer_lock held
+STORAGE_JOB *writer_find_job(const char *fname, STORAGE_JOB **prev) {
+  STORAGE_JOB *job = NULL;
+  if(prev) *prev = NULL;
+  for(job = queue_head; job != NULL; job = job->next) {
+    if(!strcmp(job->fname, fname))
+      return job;
+    if(prev) *prev = job;
+  }
+  return NULL;
+}
+
+//
+// put a save (or deletion, if set is NULL) of fname in the queue
+void storage_writer_queue(STORAGE_SET *set, const char *fname) {
+  // if something went wrong starting the writer, just do it ourself
+  if(!writer_running) {
+    STORAGE_JOB job = { (char *)fname, set, NULL };
+    writer_do_job(&job);
+    if(set) storage_close(set);
+    return;
+  }
+
+  pthread_mutex_lock(&writer_lock);
+  writes_queued++;
+
+  // is there already a save waiting for this file? Take its place
+  STORAGE_JOB *job = writer_find_job(fname, NULL);
+  STORAGE_SET *old = NULL;
+  if(job != NULL) {
+    old      = job->set;
+    job->set = set;
+    writes_coalesced++;
+  }
+  else {
+    // back pressure: if the writer has fallen too far behind, wait for it
+    if(queue_len >= STORAGE_WRITER_MAX_QUEUE) {
+      double start = writer_now_ms();
+      while(queue_len >= STORAGE_WRITER_MAX_QUEUE)
+	pthread_cond_wait(&writer_done, &writer_lock);
+      full_waits++;
+      full_wait_ms += writer_now_ms() - start;
+    }
+
+    job        = malloc(sizeof(STORAGE_JOB));
+    job->fname = strdup(fname);
+    job->set   = set;
+    job->next  = NULL;
+    if(queue_tail != NULL)
+      queue_tail->next = job;
+    else
+      queue_head = job;
+    queue_tail = job;
+    queue_len++;
+    queue_high_mark = MAX(queue_high_mark, queue_len);
+    pthread_cond_signal(&writer_work);
+  }
+  pthread_mutex_unlock(&writer_lock);
+
+  // the set we replaced was never handed to the writer. It's still ours
+  if(old != NULL)
+    storage_close(old);
+}
+
+//
+// log any saves the writer could not make since we last checked
+void storage_writer_check_event(void *owner, void *data, const char *arg) {
+  char fname[MAX_BUFFER];
+  long  failed = 0;
+  pthread_mutex_lock(&writer_lock);
+  failed = writes_failed - failed_logged;
+  failed_logged = writes_failed;
+  snprintf(fname, sizeof(fname), "%s", last_failed);
+  pthread_mutex_unlock(&writer_lock);
+
+  if(failed > 0)
+    log_string("ERROR: background writer failed to save %ld file%s; last was "
+	       "%s", failed, (failed == 1 ? "" : "s"), fname);
+}
+
+//
+// show stats about the background writer
+COMMAND(cmd_savequeue) {
+  pthread_mutex_lock(&writer_lock);
+  double avg_write = (writes_written + writes_failed > 0 ?
+		      write_ms / (writes_written + writes_failed) : 0);
+  send_to_char(ch,
+	       "{gBackground writer%s:\r\n"
+	       "{g  pending           : {c%d {g(at most %d, highest was %d)\r\n"
+	       "{g  saves asked for   : {c%ld\r\n"
+	       "{g  replaced pending  : {c%ld\r\n"
+	       "{g  written           : {c%ld {g(%.2f ms each, on average)\r\n"
+	       "{g  failed            : {c%ld\r\n"
+	       "{g  done by game loop : {c%ld {gso it could read them\r\n"
+	       "{g  waits, queue full : {c%ld {g(%.1f ms in total){n\r\n",
+	       (writer_running ? "" : " {r(not running){g"),
+	       queue_len, STORAGE_WRITER_MAX_QUEUE, queue_high_mark,
+	       writes_queued, writes_coalesced, writes_written, avg_write,
+	       writes_failed, writes_in_sync, full_waits, full_wait_ms);
+  pthread_mutex_unlock(&writer_lock);
+}
+
+
+
+//*****************************************************************************
+// implementation of storage_writer.h
+//*****************************************************************************
+void init_storage_writer(void) {
+  pthread_attr_t attr;
+  pthread_t    thread;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  if(pthread_create(&thread, &attr, storage_writer_thread, NULL) == 0)
+    writer_running = TRUE;
+  else
+    log_string("ERROR: could not start the background writer. Saving "
+	       "in the foreground instead");
+  pthread_attr_destroy(&attr);
+
+  start_update(NULL, 1 SECOND, storage_writer_check_event, NULL, NULL, NULL);
+  add_cmd("savequeue", NULL, cmd_savequeue, "admin", FALSE);
+}
+
+void storage_write_later(STORAGE_SET *set, const char *fname) {
+  storage_writer_queue(set, fname);
+}
+
+void storage_remove_later(const char *fname) {
+  storage_writer_queue(NULL, fname);
+}
+
+void storage_writer_sync(const char *fname) {
+  STORAGE_JOB *job = NULL, *prev = NULL;
+  pthread_mutex_lock(&writer_lock);
+  if(fname == NULL) {
+    while(queue_head != NULL || writing != NULL)
+      pthread_cond_wait(&writer_done, &writer_lock);
+    pthread_mutex_unlock(&writer_lock);
+    return;
+  }
+
+  // if the writer is busy with it, wait for it to finish
+  while(writing != NULL && !strcmp(writing->fname, fname))
+    pthread_cond_wait(&writer_done, &writer_lock);
+
+  // if it's still waiting in line, pull it out and do it ourself. Nobody
+  // else can queue a save of it while we hold the game loop
+  if((job = writer_find_job(fname, &prev)) != NULL) {
+    if(prev != NULL)
+      prev->next = job->next;
+    else
+      queue_head = job->next;
+    if(queue_tail == job)
+      queue_tail = prev;
+    queue_len--;
+    writes_in_sync++;
+    pthread_cond_broadcast(&writer_done);
+  }
+  pthread_mutex_unlock(&writer_lock);
+
+  if(job != NULL) {
+    double start = writer_now_ms();
+    bool      ok = writer_do_job(job);
+    double    ms = writer_now_ms() - start;
+    pthread_mutex_lock(&writer_lock);
+    writer_job_done(job, ok, ms);
+    pthread_mutex_unlock(&writer_lock);
+    deleteStorageJob(job);
+  }
+}
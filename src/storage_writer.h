@@ -0,0 +1,42 @@
+#ifndef STORAGE_WRITER_H
+#define STORAGE_WRITER_H
+//*****************************************************************************
+//
+// storage_writer.h
+//
+// Writes storage sets to disk on a background thread, so the game loop does
+// not stall on disk I/O when lots of rooms, players, and accounts are saved at
+// once. The game loop builds a storage set as usual, and hands it off; it is
+// written out (and closed) later, by the writer.
+//
+// Files are written to a temporary file first, and then renamed over the old
+// one, so a crash part way through a save never leaves a half-written file.
+// If a file is saved again before its last save has been written, the newer
+// set simply takes the older one's place in line. The queue only holds so
+// many saves; once it is full, the game loop waits for the writer to catch up.
+//
+// Anything that reads a file that might have a save pending must call
+// storage_writer_sync on it first.
+//
+//*****************************************************************************
+
+//
+// start up the writer, and the admin command for viewing its stats
+void init_storage_writer(void);
+
+//
+// Queue the set to be written to fname. The writer takes ownership of the
+// set, and closes it when it is done; the caller must not touch it again. As
+// with storage_write, files are kept in the format they are already in
+void storage_write_later(STORAGE_SET *set, const char *fname);
+
+//
+// Queue fname to be deleted. Any save of it that is still pending is dropped
+void storage_remove_later(const char *fname);
+
+//
+// make sure any pending save or deletion of fname has made it to disk before
+// returning. If fname is NULL, wait for everything that is pending
+void storage_writer_sync(const char *fname);
+
+#endif // STORAGE_WRITER_H
@@ -203,3 +203,105 @@ char *strfind(char *txt, char *sub)
 
   return NULL;
 }
+
+//
+// Calculates how many characters until we hit the next whitespace. Newlines,
+// tabs, and spaces are treated as whitespace.
+int next_space_in(const char *string) {
+  int i = 0;
+  for(i = 0; string[i] != '\0'; i++)
+    if(isspace(string[i]))
+      return i;
+  return -1; // none found
+}
+
+//
+// If we're at the beginning of a new paragraph, return where the new paragraph
+// starts. Otherwise, return our current position (index)
+int is_paragraph_marker(const char *string, int index) {
+  int nl_count = 0;
+  int i = 0;
+  for(i = index; isspace(string[i]); i++) {
+    if(string[i] == '\n')
+      nl_count++;
+  }
+  if(nl_count > 1)
+    return i;
+  else
+    return index;
+}
+
+//
+// counts how many times ch occurs in string
+//
+int count_letters(const char *string, const char ch, const int strlen) {
+
+  int i, n;
+  for(i = n = 0; i < strlen; i++)
+    if(string[i] == ch)
+      n++;
+
+  return n;
+}
+
+//
+// counts how many times word occurs in string. Assumes strlen(word) >= 1
+//
+int count_occurences(const char *string, const char *word) {
+  int count = 0, i = 0, word_len = strlen(word);
+  for(; string[i] != '\0'; i++) {
+    if(!strncmp(string+i, word, word_len)) {
+      count++;
+      i += word_len;
+    }
+  }
+  return count;
+}
+
+//
+// return a pointer to the start of the line num (lines are ended with \n's).
+// return NULL if the line does not exist
+//
+char *line_start(char *string, int line) {
+  // skip forward to the appropriate line
+  int i, count = 1;
+
+  // are we looking for the start?
+  if(line == 1) return string;
+
+  for(i = 0; string[i] != '\0'; i++) {
+    if(string[i] == '\n')
+      count++;
+    if(count == line)
+      return string+i+1;
+  }
+
+  return NULL;
+}
+
+//
+// trim trailing and leading whitespace
+//
+void trim(char *string) {
+  int len = strlen(string);
+  int max = len-1;
+  int min = 0;
+  int i;
+
+  // kill all whitespace to the right
+  for(max = len - 1; max >= 0; max--) {
+    if(isspace(string[max]))
+      string[max] = '\0';
+    else
+      break;
+  }
+
+  // find our first non-whitespace
+  while(isspace(string[min]))
+    min++;
+
+  // shift everything to the left
+  for(i = 0; i <= max-min; i++)
+    string[i] = string[i+min];
+  string[i] = '\0';
+}
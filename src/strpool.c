@@ -0,0 +1,215 @@
+//*****************************************************************************
+//
+// strpool.c
+//
+// A pool of shared, reference counted strings. See strpool.h for
+// documentation.
+//
+// Each string in the pool is kept in one block along with its reference
+// count, length and hash, so a reference (a pointer to the string's first
+// character) can find its way back to the block without a lookup. The blocks
+// are indexed by an open-addressed table that is probed linearly. Unlike the
+// mud's hashtables, strings are compared case-sensitively; "A Sword" and
+// "a sword" are different strings. Removals shift the following slots back
+// instead of leaving tombstones behind.
+//
+//*****************************************************************************
+
+#include <stddef.h>
+#include "mud.h"
+#include "utils.h"
+#include "character.h"
+#include "strpool.h"
+
+
+
+//*****************************************************************************
+// local datastructures, functions, and defines
+//*****************************************************************************
+
+// the smallest index we'll make. Must be a power of two
+#define STRPOOL_MIN_SLOTS      1024
+
+typedef struct pooled_string {
+  unsigned int  hash;
+  int           refs; // how many references there are to the string
+  int            len;
+  char         str[]; // the string itself. Never changed
+} POOLED_STRING;
+
+POOLED_STRING   **pool_slots = NULL; // the index. NULL slots are empty
+unsigned int  pool_slot_mask = 0;    // number of slots - 1
+int                pool_size = 0;    // how many strings are in the pool
+long               pool_refs = 0;    // how many references to them there are
+long              pool_bytes = 0;    // bytes used by the strings themselves
+long              pool_saved = 0;    // bytes we'd use if nothing was shared
+
+//
+// a one-pass FNV-1a hash, that also figures out the string's length
+unsigned int strpool_hash(const char *str, int *len) {
+  const char *start = str;
+  unsigned int    h = 2166136261U;
+  for(; *str; str++)
+    h = (h ^ (unsigned char)*str) * 16777619U;
+  *len = str - start;
+  return h;
+}
+
+//
+// find the block a reference points into
+POOLED_STRING *strpool_block(const char *str) {
+  return (POOLED_STRING *)(str - offsetof(POOLED_STRING, str));
+}
+
+//
+// make the index twice as big as it is now (or its minimum size, if we have
+// no index yet) and put everything back in it
+void strpool_grow(void) {
+  unsigned int old_slots = (pool_slots == NULL ? 0 : pool_slot_mask + 1);
+  unsigned int num_slots = (old_slots == 0 ? STRPOOL_MIN_SLOTS : old_slots*2);
+  POOLED_STRING  **slots = calloc(num_slots, sizeof(POOLED_STRING *));
+  unsigned int         i;
+
+  for(i = 0; i < old_slots; i++) {
+    if(pool_slots[i] != NULL) {
+      unsigned int slot = pool_slots[i]->hash & (num_slots - 1);
+      while(slots[slot] != NULL)
+	slot = (slot + 1) & (num_slots - 1);
+      slots[slot] = pool_slots[i];
+    }
+  }
+
+  if(pool_slots != NULL)
+    free(pool_slots);
+  pool_slots     = slots;
+  pool_slot_mask = num_slots - 1;
+}
+
+//
+// take the string in the given slot out of the index, and shift whatever
+// comes after it back so no later string is left unreachable
+void strpool_remove_slot(unsigned int slot) {
+  unsigned int next = (slot + 1) & pool_slot_mask;
+  while(pool_slots[next] != NULL) {
+    unsigned int home = pool_slots[next]->hash & pool_slot_mask;
+    // the string in next can fill the hole if the hole is no closer to next
+    // than next's home slot is
+    if(((next - home) & pool_slot_mask) >= ((next - slot) & pool_slot_mask)) {
+      pool_slots[slot] = pool_slots[next];
+      slot = next;
+    }
+    next = (next + 1) & pool_slot_mask;
+  }
+  pool_slots[slot] = NULL;
+}
+
+//
+// show stats about the string pool
+COMMAND(cmd_memory) {
+  send_to_char(ch,
+	       "{gShared strings:\r\n"
+	       "{g  different strings : {c%d\r\n"
+	       "{g  references        : {c%ld\r\n"
+	       "{g  bytes in the pool : {c%ld {g(plus %ld for the index)\r\n"
+	       "{g  bytes saved       : {c%ld {gby sharing copies{n\r\n",
+	       strpoolSize(), strpoolRefs(), strpoolBytes(),
+	       (long)((pool_slots == NULL ? 0 : pool_slot_mask + 1) *
+		      sizeof(POOLED_STRING *)),
+	       strpoolBytesSaved());
+}
+
+
+
+//*****************************************************************************
+// implementation of strpool.h
+//*****************************************************************************
+void init_strpool(void) {
+  if(pool_slots == NULL)
+    strpool_grow();
+  add_cmd("memory", NULL, cmd_memory, "admin", FALSE);
+}
+
+const char *strpoolGet(const char *str) {
+  if(str == NULL)
+    str = "";
+
+  int                len = 0;
+  unsigned int      hash = strpool_hash(str, &len);
+  unsigned int      slot = 0;
+  POOLED_STRING   *block = NULL;
+
+  if(pool_slots == NULL)
+    strpool_grow();
+
+  // see if we already have it
+  for(slot = hash & pool_slot_mask; (block = pool_slots[slot]) != NULL;
+      slot = (slot + 1) & pool_slot_mask) {
+    if(block->hash == hash && block->len == len && !strcmp(block->str, str)) {
+      block->refs++;
+      pool_refs++;
+      pool_saved += len + 1;
+      return block->str;
+    }
+  }
+
+  // we don't. Make a new copy. Keep the index under 3/4 full
+  block = malloc(sizeof(POOLED_STRING) + len + 1);
+  block->hash = hash;
+  block->refs = 1;
+  block->len  = len;
+  memcpy(block->str, str, len + 1);
+
+  if((pool_size + 1) * 4 > (int)(pool_slot_mask + 1) * 3) {
+    strpool_grow();
+    for(slot = hash & pool_slot_mask; pool_slots[slot] != NULL;
+	slot = (slot + 1) & pool_slot_mask)
+      ;
+  }
+  pool_slots[slot] = block;
+  pool_size++;
+  pool_refs++;
+  pool_bytes += sizeof(POOLED_STRING) + len + 1;
+  return block->str;
+}
+
+void strpoolRelease(const char *str) {
+  if(str == NULL)
+    return;
+
+  POOLED_STRING *block = strpool_block(str);
+  pool_refs--;
+  if(--block->refs > 0)
+    pool_saved -= block->len + 1;
+  else {
+    unsigned int slot = block->hash & pool_slot_mask;
+    while(pool_slots[slot] != block)
+      slot = (slot + 1) & pool_slot_mask;
+    strpool_remove_slot(slot);
+    pool_size--;
+    pool_bytes -= sizeof(POOLED_STRING) + block->len + 1;
+    free(block);
+  }
+}
+
+void strpoolSet(const char **field, const char *str) {
+  // get the new one first, in case str is part of the one we're letting go of
+  const char *old = *field;
+  *field = strpoolGet(str);
+  strpoolRelease(old);
+}
+
+int strpoolSize(void) {
+  return pool_size;
+}
+
+long strpoolRefs(void) {
+  return pool_refs;
+}
+
+long strpoolBytes(void) {
+  return pool_bytes;
+}
+
+long strpoolBytesSaved(void) {
+  return pool_saved;
+}
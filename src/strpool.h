@@ -0,0 +1,50 @@
+#ifndef STRPOOL_H
+#define STRPOOL_H
+//*****************************************************************************
+//
+// strpool.h
+//
+// A pool of shared, reference counted strings. Most objects and mobiles that
+// come from the same prototype end up with byte-for-byte the same name,
+// keywords, descriptions, etc. Rather than each of them holding its own copy,
+// they can all hold a reference to one copy in the pool. A string is only
+// copied into the pool the first time it is asked for; after that, asking for
+// it again just adds a reference. When the last reference is let go of, the
+// string is freed.
+//
+// Strings in the pool must never be changed. Something that wants a different
+// string lets go of the one it has and asks the pool for the new one, so
+// sharing lasts until a script actually changes one of the copies.
+//
+//*****************************************************************************
+
+//
+// set up the pool, and the admin command for viewing its stats
+void init_strpool(void);
+
+//
+// Return a reference to a pooled copy of str. NULL is treated as the empty
+// string. The reference must be let go of with strpoolRelease when it is no
+// longer needed
+const char *strpoolGet(const char *str);
+
+//
+// Let go of a reference made with strpoolGet. Does nothing if str is NULL
+void strpoolRelease(const char *str);
+
+//
+// Point *field at a pooled copy of str, letting go of whatever *field pointed
+// to before (if anything). str may be *field itself, or a part of it
+void strpoolSet(const char **field, const char *str);
+
+//
+// Stats for the pool: how many different strings it holds, how many
+// references there are to them, how many bytes the pool is using, and how
+// many bytes it is saving by sharing strings instead of each reference having
+// its own copy
+int  strpoolSize(void);
+long strpoolRefs(void);
+long strpoolBytes(void);
+long strpoolBytesSaved(void);
+
+#endif // STRPOOL_H
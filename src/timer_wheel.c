@@ -0,0 +1,205 @@
+//*****************************************************************************
+//
+// timer_wheel.c
+//
+// A hierarchical timing wheel. See timer_wheel.h for documentation. The wheel
+// is laid out like the timer wheels in most operating system kernels: the
+// first level has a slot for each of the next 64 pulses, the second level
+// has a slot for each of the next 64 blocks of 64 pulses, and so on. Every
+// time the first level wraps around, one slot of the second level is
+// cascaded down into it, and so on up the levels.
+//
+// pulse is always the next pulse we are going to advance to. Timers are
+// placed relative to it, which guarantees a timer is cascaded down into the
+// first level before its pulse comes up.
+//
+//*****************************************************************************
+
+#include "mud.h"
+#include "timer_wheel.h"
+
+
+
+//*****************************************************************************
+// local datastructures, functions, and defines
+//*****************************************************************************
+#define WHEEL_BITS               6
+#define WHEEL_SLOTS             (1 << WHEEL_BITS)
+#define WHEEL_MASK              (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS             5
+
+// the furthest into the future we can schedule something. Anything further
+// out is scheduled at this delay (roughly three years at 10 pulses a second)
+#define WHEEL_MAX_DELAY         ((1UL << (WHEEL_BITS * WHEEL_LEVELS)) - 1)
+
+struct timer_wheel {
+  TIMER_NODE slots[WHEEL_LEVELS][WHEEL_SLOTS]; // list heads for each slot
+  TIMER_NODE                          expired; // popped by timerWheelPop
+  unsigned long                         pulse; // the next pulse to advance to
+  int                                    size; // how many timers we hold
+};
+
+
+//
+// initialize a list head so that it points to itself
+void timer_list_init(TIMER_NODE *head) {
+  head->prev = head->next = head;
+  head->elem = NULL;
+  head->expires = 0;
+}
+
+//
+// tack a node on to the end of a slot's list
+void timer_list_append(TIMER_NODE *head, TIMER_NODE *node) {
+  node->prev       = head->prev;
+  node->next       = head;
+  head->prev->next = node;
+  head->prev       = node;
+}
+
+//
+// take a node out of whatever slot list it is in
+void timer_list_unlink(TIMER_NODE *node) {
+  node->prev->next = node->next;
+  node->next->prev = node->prev;
+  node->prev = node->next = NULL;
+}
+
+//
+// move everything in one list to the end of another
+void timer_list_splice(TIMER_NODE *from, TIMER_NODE *to) {
+  if(from->next == from)
+    return;
+  from->next->prev = to->prev;
+  from->prev->next = to;
+  to->prev->next   = from->next;
+  to->prev         = from->prev;
+  timer_list_init(from);
+}
+
+//
+// figure out which slot the node should go in, and put it there
+void timer_wheel_place(TIMER_WHEEL *wheel, TIMER_NODE *node) {
+  unsigned long idx = node->expires - wheel->pulse;
+  int level;
+
+  // already expired? Possible when cascading. It goes off on the next pulse
+  if((long)idx < 0) {
+    node->expires = wheel->pulse;
+    idx = 0;
+  }
+
+  for(level = 0; level < WHEEL_LEVELS - 1; level++)
+    if(idx < (1UL << (WHEEL_BITS * (level + 1))))
+      break;
+
+  timer_list_append(&wheel->slots[level][(node->expires >> (WHEEL_BITS*level))
+					 & WHEEL_MASK], node);
+}
+
+//
+// re-place all of the timers in one slot of a level. Returns the index of
+// the slot we cascaded, so the caller knows whether to cascade the next level
+int timer_wheel_cascade(TIMER_WHEEL *wheel, int level) {
+  int      index = (wheel->pulse >> (WHEEL_BITS * level)) & WHEEL_MASK;
+  TIMER_NODE *head = &wheel->slots[level][index];
+  TIMER_NODE  list;
+
+  timer_list_init(&list);
+  timer_list_splice(head, &list);
+  while(list.next != &list) {
+    TIMER_NODE *node = list.next;
+    timer_list_unlink(node);
+    timer_wheel_place(wheel, node);
+  }
+  return index;
+}
+
+
+
+//*****************************************************************************
+// implementation of timer_wheel.h
+//*****************************************************************************
+TIMER_WHEEL *newTimerWheel(void) {
+  TIMER_WHEEL *wheel = malloc(sizeof(TIMER_WHEEL));
+  int level, slot;
+  for(level = 0; level < WHEEL_LEVELS; level++)
+    for(slot = 0; slot < WHEEL_SLOTS; slot++)
+      timer_list_init(&wheel->slots[level][slot]);
+  timer_list_init(&wheel->expired);
+  wheel->pulse = 1;
+  wheel->size  = 0;
+  return wheel;
+}
+
+void deleteTimerWheel(TIMER_WHEEL *wheel) {
+  free(wheel);
+}
+
+void timerNodeInit(TIMER_NODE *node, void *elem) {
+  node->prev    = node->next = NULL;
+  node->elem    = elem;
+  node->expires = 0;
+}
+
+bool timerNodeScheduled(TIMER_NODE *node) {
+  return (node->next != NULL);
+}
+
+void *timerNodeElem(TIMER_NODE *node) {
+  return node->elem;
+}
+
+void timerWheelAdd(TIMER_WHEEL *wheel, TIMER_NODE *node, int delay) {
+  timerWheelRemove(wheel, node);
+  wheel->size++;
+
+  // no delay; this goes off with whatever else is expired right now
+  if(delay <= 0) {
+    node->expires = wheel->pulse - 1;
+    timer_list_append(&wheel->expired, node);
+  }
+  else {
+    if((unsigned long)delay > WHEEL_MAX_DELAY)
+      delay = WHEEL_MAX_DELAY;
+    node->expires = wheel->pulse + delay - 1;
+    timer_wheel_place(wheel, node);
+  }
+}
+
+void timerWheelRemove(TIMER_WHEEL *wheel, TIMER_NODE *node) {
+  if(timerNodeScheduled(node)) {
+    timer_list_unlink(node);
+    wheel->size--;
+  }
+}
+
+void timerWheelAdvance(TIMER_WHEEL *wheel) {
+  int index = wheel->pulse & WHEEL_MASK, level;
+
+  // when the first level wraps around, pull down the next slot from the level
+  // above. If that level just wrapped around too, keep going up
+  if(index == 0)
+    for(level = 1; level < WHEEL_LEVELS; level++)
+      if(timer_wheel_cascade(wheel, level) != 0)
+	break;
+
+  timer_list_splice(&wheel->slots[0][index], &wheel->expired);
+  wheel->pulse++;
+}
+
+TIMER_NODE *timerWheelPop(TIMER_WHEEL *wheel) {
+  TIMER_NODE *node = wheel->expired.next;
+  if(node == &wheel->expired)
+    return NULL;
+  timerWheelRemove(wheel, node);
+  return node;
+}
+
+int timerWheelSize(TIMER_WHEEL *wheel) {
+  return wheel->size;
+}
+
+unsigned long timerWheelPulse(TIMER_WHEEL *wheel) {
+  return wheel->pulse - 1;
+}
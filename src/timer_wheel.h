@@ -0,0 +1,83 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+//*****************************************************************************
+//
+// timer_wheel.h
+//
+// A hierarchical timing wheel, for scheduling things that happen some number
+// of pulses in the future (events, actions, etc). Adding and removing timers
+// is O(1), and advancing the wheel by a pulse only costs as much as there are
+// timers expiring on that pulse (plus the occasional cascade of a coarser
+// level down into a finer one). Compare this to keeping everything in a list
+// and decrementing every delay, every pulse.
+//
+// Timers are intrusive; whatever is being scheduled embeds a TIMER_NODE and
+// hands the wheel a pointer to it, so scheduling never allocates. The fields
+// of a TIMER_NODE belong to the wheel, and should not be touched directly.
+//
+// A wheel is used like so:
+//
+//   timerWheelAdvance(wheel);
+//   while((node = timerWheelPop(wheel)) != NULL)
+//     ... run whatever node is embedded in ...
+//
+// Timers added while expired timers are being popped with a delay of 0 or
+// less are popped on the same pulse, after everything else that expired.
+// Timers with a delay of N expire on the Nth call to timerWheelAdvance.
+//
+//*****************************************************************************
+
+typedef struct timer_wheel                TIMER_WHEEL;
+typedef struct timer_node                 TIMER_NODE;
+
+struct timer_node {
+  TIMER_NODE       *prev; // the slot list we're in. NULL if unscheduled
+  TIMER_NODE       *next; //
+  void             *elem; // the thing that is being scheduled
+  unsigned long  expires; // the pulse we expire on
+};
+
+//
+// create and delete timing wheels. Deleting a wheel does not touch any of
+// the timers that are still scheduled on it
+TIMER_WHEEL *newTimerWheel(void);
+void      deleteTimerWheel(TIMER_WHEEL *wheel);
+
+//
+// prepare a timer node for use. Must be done once before it is scheduled
+void    timerNodeInit(TIMER_NODE *node, void *elem);
+
+//
+// is the timer node currently scheduled on a wheel?
+bool    timerNodeScheduled(TIMER_NODE *node);
+
+//
+// return the thing a timer node was set up to schedule
+void   *timerNodeElem(TIMER_NODE *node);
+
+//
+// schedule the timer to expire in delay pulses. If it is already scheduled,
+// it is rescheduled
+void    timerWheelAdd(TIMER_WHEEL *wheel, TIMER_NODE *node, int delay);
+
+//
+// unschedule a timer. Nothing happens if it is not scheduled
+void    timerWheelRemove(TIMER_WHEEL *wheel, TIMER_NODE *node);
+
+//
+// move ahead by one pulse, and collect all of the timers that expire on it
+void    timerWheelAdvance(TIMER_WHEEL *wheel);
+
+//
+// unschedule and return the next expired timer. NULL if there are none left
+TIMER_NODE *timerWheelPop(TIMER_WHEEL *wheel);
+
+//
+// how many timers are scheduled, expired or not?
+int     timerWheelSize(TIMER_WHEEL *wheel);
+
+//
+// how many pulses has the wheel been advanced by?
+unsigned long timerWheelPulse(TIMER_WHEEL *wheel);
+
+#endif // TIMER_WHEEL_H
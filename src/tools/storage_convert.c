@@ -0,0 +1,137 @@
+//*****************************************************************************
+//
+// storage_convert.c
+//
+// Converts storage files (world files, pfiles, etc) between the text and
+// binary formats storage.c can read. Directories are gone through
+// recursively, and every file in them is converted in place: the converted
+// file is written next to the original, and only moved over it once it has
+// been written out in full. Files already in the format being converted to
+// are left alone. Make sure the mud is not
+// running when converting its files, or it may write over them.
+//
+// usage: ./storage_convert <text | binary> <file or directory> ...
+//   e.g. ./tools/storage_convert binary ../lib/world ../lib/players
+//
+//*****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../mud.h"
+#include "../storage.h"
+
+
+
+//*****************************************************************************
+// local functions, and variables
+//*****************************************************************************
+
+// how many files we converted, skipped, and couldn't read or write
+int converted = 0;
+int   skipped = 0;
+int    failed = 0;
+
+// did storage_read report the file it was reading as bad?
+bool bad_file = FALSE;
+
+//
+// storage_read reports binary files it can't parse through bug(), and reads
+// them as an empty set. We must not write that over the file
+void bug(const char *txt, ...) {
+  va_list args;
+  va_start(args, txt);
+  vfprintf(stderr, txt, args);
+  va_end(args);
+  fprintf(stderr, "\n");
+  bad_file = TRUE;
+}
+
+//
+// convert one file to the format, if it isn't already in it
+void convert_file(const char *fname, int format) {
+  STORAGE_SET *set = NULL;
+  bad_file = FALSE;
+  if(storage_format(fname) == format)
+    skipped++;
+  else if((set = storage_read(fname)) == NULL || bad_file) {
+    fprintf(stderr, "could not read %s\n", fname);
+    if(set) storage_close(set);
+    failed++;
+  }
+  else {
+    char tmp[MAX_BUFFER];
+    snprintf(tmp, sizeof(tmp), "%s.converting", fname);
+    if(!storage_write_format(set, tmp, format) || rename(tmp, fname) != 0) {
+      fprintf(stderr, "could not write %s\n", fname);
+      unlink(tmp);
+      failed++;
+    }
+    else
+      converted++;
+    storage_close(set);
+  }
+}
+
+//
+// convert the file, or everything in the directory if it is one. Files and
+// directories starting with . are skipped
+void convert_path(const char *path, int format) {
+  struct stat st;
+  if(stat(path, &st) != 0) {
+    fprintf(stderr, "could not find %s\n", path);
+    failed++;
+  }
+  else if(!S_ISDIR(st.st_mode))
+    convert_file(path, format);
+  else {
+    DIR             *dir = opendir(path);
+    struct dirent *entry = NULL;
+    char buf[MAX_BUFFER];
+    if(dir == NULL) {
+      fprintf(stderr, "could not open %s\n", path);
+      failed++;
+      return;
+    }
+    while((entry = readdir(dir)) != NULL) {
+      if(*entry->d_name == '.')
+	continue;
+      snprintf(buf, sizeof(buf), "%s/%s", path, entry->d_name);
+      convert_path(buf, format);
+    }
+    closedir(dir);
+  }
+}
+
+
+
+//*****************************************************************************
+// main
+//*****************************************************************************
+int main(int argc, char **argv) {
+  int format, i;
+  if(argc < 3)
+    format = NOTHING;
+  else if(!strcmp(argv[1], "text"))
+    format = STORAGE_FORMAT_TEXT;
+  else if(!strcmp(argv[1], "binary"))
+    format = STORAGE_FORMAT_BINARY;
+  else
+    format = NOTHING;
+
+  if(format == NOTHING) {
+    fprintf(stderr, "usage: %s <text | binary> <file or directory> ...\n",
+	    argv[0]);
+    return 1;
+  }
+
+  for(i = 2; i < argc; i++)
+    convert_path(argv[i], format);
+  printf("%d files converted to %s, %d already were, %d could not be "
+	 "converted\n",
+	 converted, argv[1], skipped, failed);
+  return (failed > 0);
+}
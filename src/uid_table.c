@@ -0,0 +1,228 @@
+//*****************************************************************************
+//
+// uid_table.c
+//
+// A table of game entities by UID. See uid_table.h for documentation.
+//
+// Elements live packed together in one array, next to their UID. A UID is
+// mapped to its element's position in that array through a directory of
+// pages: the high bits of the UID pick the page, and the low bits pick the
+// slot in it that holds the position. Pages are only made for the ranges of
+// UIDs that have something in them, and are let go of when they empty out.
+//
+// Slots are never cleared. Instead, whatever position a slot holds is checked
+// against the UID stored beside the element there; if they don't match, the
+// slot is stale and the UID isn't in the table. When an element is removed,
+// the last element in the array is moved into its place and its slot is
+// updated, so the array never has holes in it.
+//
+//*****************************************************************************
+
+#include "mud.h"
+#include "utils.h"
+#include "uid_table.h"
+
+
+
+//*****************************************************************************
+// local datastructures, functions, and defines
+//*****************************************************************************
+
+// how many UIDs each page of the directory covers. Must be a power of two
+#define UID_PAGE_BITS           10
+#define UID_PAGE_SIZE          (1 << UID_PAGE_BITS)
+#define UID_PAGE_MASK          (UID_PAGE_SIZE - 1)
+
+// how many elements we make room for when the first one is put in
+#define UID_TABLE_MIN_SIZE      64
+
+typedef struct uid_table_entry {
+  int            uid;
+  void         *elem;
+} UID_ENTRY;
+
+typedef struct uid_table_page {
+  int            used; // how many of our UIDs are in the table
+  int pos[UID_PAGE_SIZE]; // where each UID's element is. May be stale
+} UID_PAGE;
+
+struct uid_table {
+  int (* key_function)(void *elem);
+  UID_ENTRY  *entries; // the elements in the table, packed together
+  int           size; // how many elements are in the table
+  int       max_size; // how many elements we have room for
+  UID_PAGE    **pages; // the directory. NULL for pages with nothing in them
+  int      num_pages;
+  int     generation; // goes up whenever an element is removed or replaced
+};
+
+struct uid_table_iterator {
+  UID_TABLE   *table;
+  int           curr; // position in the entry array. We go backwards
+};
+
+
+//
+// find where the element with the given UID is in the entry array. Returns
+// NOTHING if it's not in the table
+int uid_table_find(UID_TABLE *table, int uid) {
+  int page = uid >> UID_PAGE_BITS;
+  if(uid < 0 || page >= table->num_pages || table->pages[page] == NULL)
+    return NOTHING;
+  else {
+    int pos = table->pages[page]->pos[uid & UID_PAGE_MASK];
+    if(pos < table->size && table->entries[pos].uid == uid)
+      return pos;
+    return NOTHING;
+  }
+}
+
+//
+// return the page that covers uid, making it and growing the directory to
+// reach it if needed
+UID_PAGE *uid_table_page(UID_TABLE *table, int uid) {
+  int page = uid >> UID_PAGE_BITS;
+  if(page >= table->num_pages) {
+    int num_pages = MAX(page + 1, table->num_pages * 2);
+    table->pages  = realloc(table->pages, sizeof(UID_PAGE *) * num_pages);
+    memset(table->pages + table->num_pages, 0,
+	   sizeof(UID_PAGE *) * (num_pages - table->num_pages));
+    table->num_pages = num_pages;
+  }
+  if(table->pages[page] == NULL)
+    table->pages[page] = calloc(1, sizeof(UID_PAGE));
+  return table->pages[page];
+}
+
+
+
+//*****************************************************************************
+// implementation of uid_table.h
+// documentation in uid_table.h
+//*****************************************************************************
+UID_TABLE *newUIDTable(void *key_function) {
+  UID_TABLE *table    = calloc(1, sizeof(UID_TABLE));
+  table->key_function = key_function;
+  return table;
+}
+
+void deleteUIDTable(UID_TABLE *table) {
+  int i;
+  for(i = 0; i < table->num_pages; i++)
+    if(table->pages[i] != NULL)
+      free(table->pages[i]);
+  if(table->pages)   free(table->pages);
+  if(table->entries) free(table->entries);
+  free(table);
+}
+
+void uidTablePut(UID_TABLE *table, void *elem) {
+  int uid = table->key_function(elem);
+  int pos = uid_table_find(table, uid);
+
+  if(uid < 0)
+    return;
+  // already in. Just replace whatever was there
+  else if(pos != NOTHING) {
+    if(table->entries[pos].elem != elem)
+      table->generation++;
+    table->entries[pos].elem = elem;
+  }
+  else {
+    UID_PAGE *page = uid_table_page(table, uid);
+    if(table->size == table->max_size) {
+      table->max_size = MAX(UID_TABLE_MIN_SIZE, table->max_size * 2);
+      table->entries  = realloc(table->entries,
+				sizeof(UID_ENTRY) * table->max_size);
+    }
+    table->entries[table->size].uid  = uid;
+    table->entries[table->size].elem = elem;
+    page->pos[uid & UID_PAGE_MASK]   = table->size++;
+    page->used++;
+  }
+}
+
+void *uidTableRemove(UID_TABLE *table, int uid) {
+  int pos = uid_table_find(table, uid);
+  if(pos == NOTHING)
+    return NULL;
+  else {
+    UID_PAGE *page = table->pages[uid >> UID_PAGE_BITS];
+    void     *elem = table->entries[pos].elem;
+    table->generation++;
+
+    // fill in the hole with the last element
+    table->size--;
+    if(pos != table->size) {
+      UID_ENTRY *last = &table->entries[table->size];
+      table->entries[pos] = *last;
+      table->pages[last->uid >> UID_PAGE_BITS]->pos[last->uid & UID_PAGE_MASK]
+	= pos;
+    }
+
+    // let go of the page if nothing else is on it
+    if(--page->used == 0) {
+      free(page);
+      table->pages[uid >> UID_PAGE_BITS] = NULL;
+    }
+    return elem;
+  }
+}
+
+void *uidTableGet(UID_TABLE *table, int uid) {
+  int pos = uid_table_find(table, uid);
+  return (pos == NOTHING ? NULL : table->entries[pos].elem);
+}
+
+bool uidTableIn(UID_TABLE *table, int uid) {
+  return (uid_table_find(table, uid) != NOTHING);
+}
+
+int uidTableSize(UID_TABLE *table) {
+  return table->size;
+}
+
+int uidTableGeneration(UID_TABLE *table) {
+  return table->generation;
+}
+
+
+
+//*****************************************************************************
+// implementation of the UID table iterator
+// documentation in uid_table.h
+//
+// we go from the end of the entry array to the start. That way, when the
+// element we're on is removed and the last element is moved into its place,
+// the one that is moved is one we've already been over.
+//*****************************************************************************
+UID_TABLE_ITERATOR *newUIDTableIterator(UID_TABLE *table) {
+  UID_TABLE_ITERATOR *I = malloc(sizeof(UID_TABLE_ITERATOR));
+  I->table = table;
+  uidTableIteratorReset(I);
+  return I;
+}
+
+void deleteUIDTableIterator(UID_TABLE_ITERATOR *I) {
+  free(I);
+}
+
+void uidTableIteratorReset(UID_TABLE_ITERATOR *I) {
+  I->curr = I->table->size - 1;
+}
+
+void *uidTableIteratorNext(UID_TABLE_ITERATOR *I) {
+  // the element we were on was the last one, and it's been removed. The one
+  // before it is now the last one, and we haven't been over it yet
+  if(I->curr >= I->table->size)
+    I->curr = I->table->size - 1;
+  else if(I->curr >= 0)
+    I->curr--;
+  return uidTableIteratorCurrent(I);
+}
+
+void *uidTableIteratorCurrent(UID_TABLE_ITERATOR *I) {
+  if(I->curr < 0 || I->curr >= I->table->size)
+    return NULL;
+  return I->table->entries[I->curr].elem;
+}
@@ -0,0 +1,89 @@
+#ifndef __UID_TABLE_H
+#define __UID_TABLE_H
+//*****************************************************************************
+//
+// uid_table.h
+//
+// A table of the things in the game (characters, objects, rooms, exits,
+// sockets) by their UID. Like a property table used to, it is given a
+// function when it is created that pulls the UID out of an element, so
+// elements are put in without a key and looked up and removed by UID.
+//
+// UIDs are handed out in increasing order by next_uid(), so the ones in use
+// at any one time are bunched together. The table takes advantage of that:
+// putting, getting and removing are all a couple of array lookups no matter
+// how many elements are in the table, and the table grows as needed. Elements
+// are also kept packed in one array, so going over all of them only touches
+// the ones that are live.
+//
+// UIDs must not be negative. Looking up a negative UID (e.g. NOTHING) simply
+// finds nothing.
+//
+//*****************************************************************************
+
+typedef struct uid_table                  UID_TABLE;
+typedef struct uid_table_iterator         UID_TABLE_ITERATOR;
+
+//
+// Create a new UID table. The key function takes an element and returns its
+// UID, e.g. charGetUID
+UID_TABLE *newUIDTable(void *key_function);
+
+//
+// Delete the table, but not the elements in it
+void    deleteUIDTable(UID_TABLE *table);
+
+//
+// Put an element in the table, under the UID the key function gives for it.
+// If something else is already in the table under that UID, it is replaced
+void    uidTablePut(UID_TABLE *table, void *elem);
+
+//
+// Remove and return the element with the given UID. Returns NULL if there
+// is no such element
+void   *uidTableRemove(UID_TABLE *table, int uid);
+
+//
+// Return the element with the given UID, or NULL if there is none
+void   *uidTableGet(UID_TABLE *table, int uid);
+
+//
+// Return true if an element with the given UID is in the table
+bool    uidTableIn(UID_TABLE *table, int uid);
+
+//
+// how many elements are in the table?
+int     uidTableSize(UID_TABLE *table);
+
+//
+// Returns a number that goes up every time an element is removed from the
+// table, or replaced by another one. Something that looked up an element can
+// hold on to it for as long as the generation stays the same, rather than
+// looking it up again
+int     uidTableGeneration(UID_TABLE *table);
+
+
+
+//*****************************************************************************
+// the UID table iterator
+//
+// goes over every element in the table, in no particular order. The element
+// the iterator is on may be removed from the table while iterating. Putting
+// or removing anything else may cause elements to be skipped or seen twice.
+//*****************************************************************************
+UID_TABLE_ITERATOR *newUIDTableIterator(UID_TABLE *table);
+void             deleteUIDTableIterator(UID_TABLE_ITERATOR *I);
+
+//
+// Point the iterator back at the start of the table
+void    uidTableIteratorReset(UID_TABLE_ITERATOR *I);
+
+//
+// Skip to the next element and return it, or NULL if there are none left
+void   *uidTableIteratorNext(UID_TABLE_ITERATOR *I);
+
+//
+// Return the element the iterator is on, or NULL if there are none left
+void   *uidTableIteratorCurrent(UID_TABLE_ITERATOR *I);
+
+#endif // __UID_TABLE_H
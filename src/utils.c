@@ -87,11 +87,12 @@ void extract_mobile(CHAR_DATA *ch) {
   // and send it to inventory
   unequip_all(ch);
   // extract everything in the character's inventory
-  LIST_ITERATOR *obj_i = newListIterator(charGetInventory(ch));
+  LIST_ITERATOR obj_i;
+  listIteratorStart(&obj_i, charGetInventory(ch));
   OBJ_DATA        *obj = NULL;
-  ITERATE_LIST(obj, obj_i) {
+  ITERATE_LIST(obj, &obj_i) {
     extract_obj(obj);
-  } deleteListIterator(obj_i);
+  } listIteratorStop(&obj_i);
 
   // make sure we're not attached to anything
   if(charGetFurniture(ch))
@@ -134,11 +135,12 @@ void extract_room(ROOM_DATA *room) {
     worldRemoveRoom(gameworld, roomGetClass(room));
 
   // If anyone's last room was us, make sure we set the last room to NULL
-  LIST_ITERATOR *ch_i = newListIterator(mobile_list);
-  ITERATE_LIST(ch, ch_i) {
+  LIST_ITERATOR ch_i;
+  listIteratorStart(&ch_i, mobile_list);
+  ITERATE_LIST(ch, &ch_i) {
     if(charGetLastRoom(ch) == room)
       charSetLastRoom(ch, NULL);
-  } deleteListIterator(ch_i);
+  } listIteratorStop(&ch_i);
 
   if(!listIn(rooms_to_delete, room))
     listPut(rooms_to_delete, room);
@@ -242,9 +244,10 @@ bool try_enter_game(CHAR_DATA *ch) {
 
 CHAR_DATA *check_reconnect(const char *player) {
   CHAR_DATA *dMob;
-  LIST_ITERATOR *mob_i = newListIterator(mobile_list);
+  LIST_ITERATOR mob_i;
+  listIteratorStart(&mob_i, mobile_list);
 
-  ITERATE_LIST(dMob, mob_i) {
+  ITERATE_LIST(dMob, &mob_i) {
     if (!charIsNPC(dMob) && charIsName(dMob, player)) {
       if (charGetSocket(dMob)) {
         close_socket(charGetSocket(dMob), TRUE);
@@ -252,30 +255,32 @@ CHAR_DATA *check_reconnect(const char *player) {
       }
       break;
     }
-  } deleteListIterator(mob_i);
+  } listIteratorStop(&mob_i);
   return dMob;
 }
 
 void do_mass_transfer(ROOM_DATA *from, ROOM_DATA *to, bool chars, bool mobs,
 		      bool objs) {
   if(chars || mobs) {
-    LIST_ITERATOR *ch_i = newListIterator(roomGetCharacters(from));
+    LIST_ITERATOR ch_i;
+    listIteratorStart(&ch_i, roomGetCharacters(from));
     CHAR_DATA       *ch = NULL;
-    ITERATE_LIST(ch, ch_i) {
+    ITERATE_LIST(ch, &ch_i) {
       if(mobs || (chars && !charIsNPC(ch))) {
 	char_from_room(ch);
 	char_to_room(ch, to);
       }
-    } deleteListIterator(ch_i);
+    } listIteratorStop(&ch_i);
   }
 
   if(objs) {
-    LIST_ITERATOR *obj_i = newListIterator(roomGetContents(from));
+    LIST_ITERATOR obj_i;
+    listIteratorStart(&obj_i, roomGetContents(from));
     OBJ_DATA        *obj = NULL;
-    ITERATE_LIST(obj, obj_i) {
+    ITERATE_LIST(obj, &obj_i) {
       obj_from_room(obj);
       obj_to_room(obj, to);
-    } deleteListIterator(obj_i);
+    } listIteratorStop(&obj_i);
   }
 }
 
@@ -335,13 +340,14 @@ bool  can_see_char(CHAR_DATA *ch, CHAR_DATA *target) {
 
   bool ret = TRUE;
   if(char_see_checks != NULL) {
-    LIST_ITERATOR *chk_i = newListIterator(char_see_checks);
+    LIST_ITERATOR chk_i;
+    listIteratorStart(&chk_i, char_see_checks);
     bool (*chk)(CHAR_DATA *, CHAR_DATA *) = NULL;
-    ITERATE_LIST(chk, chk_i) {
+    ITERATE_LIST(chk, &chk_i) {
       ret = chk(ch, target);
       if(ret == FALSE)
 	break;
-    } deleteListIterator(chk_i);
+    } listIteratorStop(&chk_i);
   }
   return ret;
 }
@@ -352,13 +358,14 @@ bool can_see_obj(CHAR_DATA *ch, OBJ_DATA  *target) {
 
   bool ret = TRUE;
   if(obj_see_checks != NULL) {
-    LIST_ITERATOR *chk_i = newListIterator(obj_see_checks);
+    LIST_ITERATOR chk_i;
+    listIteratorStart(&chk_i, obj_see_checks);
     bool (*chk)(CHAR_DATA *, OBJ_DATA *) = NULL;
-    ITERATE_LIST(chk, chk_i) {
+    ITERATE_LIST(chk, &chk_i) {
       ret = chk(ch, target);
       if(ret == FALSE)
 	break;
-    } deleteListIterator(chk_i);
+    } listIteratorStop(&chk_i);
   }
   return ret;
 }
@@ -369,13 +376,14 @@ bool can_see_exit(CHAR_DATA *ch, EXIT_DATA *target) {
 
   bool ret = TRUE;
   if(exit_see_checks != NULL) {
-    LIST_ITERATOR *chk_i = newListIterator(exit_see_checks);
+    LIST_ITERATOR chk_i;
+    listIteratorStart(&chk_i, exit_see_checks);
     bool (*chk)(CHAR_DATA *, EXIT_DATA *) = NULL;
-    ITERATE_LIST(chk, chk_i) {
+    ITERATE_LIST(chk, &chk_i) {
       ret = chk(ch, target);
       if(ret == FALSE)
 	break;
-    } deleteListIterator(chk_i);
+    } listIteratorStop(&chk_i);
   }
   return ret;
 }
@@ -452,12 +460,19 @@ int name_as_uid(const char *name) {
 
 int count_objs(CHAR_DATA *looker, LIST *list, const char *name, 
 	       const char *prototype, bool must_see) {
-  LIST_ITERATOR *obj_i = newListIterator(list);
+  // counting up a prototype's instances in the whole game is a common enough
+  // thing to do that we keep a running count of it
+  if(list == object_list && !must_see && (name == NULL || !*name) &&
+     prototype && *prototype)
+    return count_obj_instances(prototype);
+
+  LIST_ITERATOR obj_i;
+  listIteratorStart(&obj_i, list);
   OBJ_DATA *obj;
   int count = 0;
   int   uid = name_as_uid(name);
 
-  ITERATE_LIST(obj, obj_i) {
+  ITERATE_LIST(obj, &obj_i) {
     if(must_see && !can_see_obj(looker, obj))
       continue;
     // if we have a name, search by it
@@ -467,18 +482,23 @@ int count_objs(CHAR_DATA *looker, LIST *list, const char *name,
     else if(prototype && *prototype && objIsInstance(obj, prototype))
       count++;
   }
-  deleteListIterator(obj_i);
+  listIteratorStop(&obj_i);
   return count;
 }
 
 int count_chars(CHAR_DATA *looker, LIST *list, const char *name,
 		const char *prototype, bool must_see) {
-  LIST_ITERATOR *char_i = newListIterator(list);
+  if(list == mobile_list && !must_see && (name == NULL || !*name) &&
+     prototype && *prototype)
+    return count_char_instances(prototype);
+
+  LIST_ITERATOR char_i;
+  listIteratorStart(&char_i, list);
   CHAR_DATA *ch;
   int count = 0;
   int   uid = name_as_uid(name);
 
-  ITERATE_LIST(ch, char_i) {
+  ITERATE_LIST(ch, &char_i) {
     if(must_see && !can_see_char(looker, ch))
       continue;
     // if we have a name, search by it
@@ -487,7 +507,7 @@ int count_chars(CHAR_DATA *looker, LIST *list, const char *name,
     // otherwise, search by prototype
     else if(prototype && *prototype && charIsInstance(ch, prototype))
       count++;
-  } deleteListIterator(char_i);
+  } listIteratorStop(&char_i);
 
   return count;
 }
@@ -506,14 +526,15 @@ CHAR_DATA *find_char(CHAR_DATA *looker, LIST *list, int num, const char *name,
   // is everything in the description a number? Search by UID
   int uid = name_as_uid(name);
   if(uid != NOBODY) {
-    ch = propertyTableGet(mob_table, uid);
+    ch = uidTableGet(mob_table, uid);
     if(listIn(list, ch) && can_see_char(looker, ch))
       return ch;
     return NULL;
   }
 
-  LIST_ITERATOR *char_i = newListIterator(list);
-  ITERATE_LIST(ch, char_i) {
+  LIST_ITERATOR char_i;
+  listIteratorStart(&char_i, list);
+  ITERATE_LIST(ch, &char_i) {
     if(must_see && !can_see_char(looker, ch))
       continue;
     // if we have a name, search by name
@@ -524,7 +545,7 @@ CHAR_DATA *find_char(CHAR_DATA *looker, LIST *list, int num, const char *name,
       num--;
     if(num == 0)
       break;
-  } deleteListIterator(char_i);
+  } listIteratorStop(&char_i);
   return ch;
 }
 
@@ -542,14 +563,15 @@ OBJ_DATA *find_obj(CHAR_DATA *looker, LIST *list, int num,
   // is everything in the description a number? Search by UID
   int uid = name_as_uid(name);
   if(uid != NOTHING) {
-    obj = propertyTableGet(obj_table, uid);
+    obj = uidTableGet(obj_table, uid);
     if(listIn(list, obj) && can_see_obj(looker, obj))
       return obj;
     return NULL;
   }
 
-  LIST_ITERATOR *obj_i = newListIterator(list);
-  ITERATE_LIST(obj, obj_i) {
+  LIST_ITERATOR obj_i;
+  listIteratorStart(&obj_i, list);
+  ITERATE_LIST(obj, &obj_i) {
     if(must_see && !can_see_obj(looker, obj))
       continue;
     // if a name is supplied, search by name
@@ -560,7 +582,7 @@ OBJ_DATA *find_obj(CHAR_DATA *looker, LIST *list, int num,
       num--;
     if(num == 0)
       break;
-  } deleteListIterator(obj_i);
+  } listIteratorStop(&obj_i);
   return obj;
 }
 
@@ -571,19 +593,20 @@ OBJ_DATA *find_obj(CHAR_DATA *looker, LIST *list, int num,
 //
 LIST *find_all_chars(CHAR_DATA *looker, LIST *list, const char *name,
 		     const char *prototype, bool must_see) {
-  LIST_ITERATOR *char_i = newListIterator(list);
+  LIST_ITERATOR char_i;
+  listIteratorStart(&char_i, list);
   LIST *char_list = newList();
   int         uid = name_as_uid(name);
   CHAR_DATA *ch;
 
-  ITERATE_LIST(ch, char_i) {
+  ITERATE_LIST(ch, &char_i) {
     if(must_see && !can_see_char(looker, ch))
       continue;
     if((name && (!*name || charIsName(ch, name))) || charGetUID(ch) == uid)
       listPut(char_list, ch);
     else if(prototype && *prototype && charIsInstance(ch, prototype))
       listPut(char_list, ch);
-  } deleteListIterator(char_i);
+  } listIteratorStop(&char_i);
   return char_list;
 }
 
@@ -595,19 +618,20 @@ LIST *find_all_chars(CHAR_DATA *looker, LIST *list, const char *name,
 LIST *find_all_objs(CHAR_DATA *looker, LIST *list, const char *name, 
 		    const char *prototype, bool must_see) {
 
-  LIST_ITERATOR *obj_i = newListIterator(list);
+  LIST_ITERATOR obj_i;
+  listIteratorStart(&obj_i, list);
   LIST       *obj_list = newList();
   int              uid = name_as_uid(name);
   OBJ_DATA *obj;
 
-  ITERATE_LIST(obj, obj_i) {
+  ITERATE_LIST(obj, &obj_i) {
     if(must_see && !can_see_obj(looker, obj))
       continue;
     if((name && (!*name || objIsName(obj, name))) || objGetUID(obj) == uid)
       listPut(obj_list, obj);
     else if(prototype && *prototype && objIsInstance(obj, prototype))
       listPut(obj_list, obj);
-  } deleteListIterator(obj_i);
+  } listIteratorStop(&obj_i);
   return obj_list;
 }
 
@@ -668,33 +692,6 @@ int next_letter_in(const char *string, char marker) {
 }
 
 
-//
-// Calculates how many characters until we hit the next whitespace. Newlines,
-// tabs, and spaces are treated as whitespace.
-int next_space_in(const char *string) {
-  int i = 0;
-  for(i = 0; string[i] != '\0'; i++)
-    if(isspace(string[i]))
-      return i;
-  return -1; // none found
-}
-
-//
-// If we're at the beginning of a new paragraph, return where the new paragraph
-// starts. Otherwise, return our current position (index)
-int is_paragraph_marker(const char *string, int index) {
-  int nl_count = 0;
-  int i = 0;
-  for(i = index; isspace(string[i]); i++) {
-    if(string[i] == '\n')
-      nl_count++;
-  }
-  if(nl_count > 1)
-    return i;
-  else
-    return index;
-}
-
 //
 // hashing array 1 for pearson hashing
 int pearson_table1[] = { 66, 93, 11, 153, 155, 113, 214, 132, 91, 193, 240, 82, 175, 145, 84, 34, 76, 217, 250, 230, 139, 172, 65, 254, 196, 56, 165, 116, 48, 219, 199, 142, 35, 27, 210, 149, 45, 127, 41, 150, 85, 87, 253, 100, 234, 216, 192, 226, 154, 106, 78, 146, 131, 38, 120, 151, 177, 29, 50, 231, 68, 168, 227, 161, 126, 141, 36, 191, 110, 81, 197, 190, 9, 236, 140, 0, 20, 162, 23, 189, 42, 130, 117, 86, 243, 123, 237, 249, 64, 135, 61, 167, 39, 57, 96, 148, 118, 13, 235, 188, 19, 71, 49, 115, 21, 182, 15, 200, 179, 251, 75, 77, 204, 32, 180, 16, 218, 22, 171, 88, 30, 248, 47, 238, 105, 94, 92, 67, 28, 69, 33, 215, 1, 7, 241, 109, 209, 98, 12, 208, 156, 52, 195, 89, 185, 55, 170, 104, 17, 173, 122, 138, 4, 202, 136, 247, 169, 222, 163, 211, 144, 252, 2, 186, 201, 40, 207, 107, 18, 24, 46, 129, 44, 14, 174, 26, 124, 194, 37, 223, 102, 183, 99, 114, 70, 158, 53, 111, 147, 119, 73, 152, 79, 203, 157, 221, 10, 97, 133, 62, 229, 178, 205, 184, 164, 176, 198, 80, 58, 245, 31, 59, 128, 101, 60, 181, 246, 232, 63, 143, 121, 213, 187, 206, 43, 134, 6, 225, 228, 72, 54, 233, 224, 5, 8, 239, 112, 244, 255, 137, 3, 74, 108, 159, 83, 125, 103, 51, 220, 25, 166, 90, 160, 212, 95, 242 };
@@ -773,83 +770,6 @@ const char *strcpyto(char *to, const char *from, char end) {
   return from;
 }
 
-//
-// counts how many times ch occurs in string
-//
-int count_letters(const char *string, const char ch, const int strlen) {
-
-  int i, n;
-  for(i = n = 0; i < strlen; i++)
-    if(string[i] == ch)
-      n++;
-
-  return n;
-}
-
-//
-// counts how many times word occurs in string. Assumes strlen(word) >= 1
-//
-int count_occurences(const char *string, const char *word) {
-  int count = 0, i = 0, word_len = strlen(word);
-  for(; string[i] != '\0'; i++) {
-    if(!strncmp(string+i, word, word_len)) {
-      count++;
-      i += word_len;
-    }
-  }
-  return count;
-}
-
-//
-// return a pointer to the start of the line num (lines are ended with \n's).
-// return NULL if the line does not exist
-//
-char *line_start(char *string, int line) {
-  // skip forward to the appropriate line
-  int i, count = 1;
-
-  // are we looking for the start?
-  if(line == 1) return string;
-
-  for(i = 0; string[i] != '\0'; i++) {
-    if(string[i] == '\n')
-      count++;
-    if(count == line)
-      return string+i+1;
-  }
-
-  return NULL;
-}
-
-
-//
-// trim trailing and leading whitespace
-//
-void trim(char *string) {
-  int len = strlen(string);
-  int max = len-1;
-  int min = 0;
-  int i;
-
-  // kill all whitespace to the right
-  for(max = len - 1; max >= 0; max--) {
-    if(isspace(string[max]))
-      string[max] = '\0';
-    else
-      break;
-  }
-
-  // find our first non-whitespace
-  while(isspace(string[min]))
-    min++;
-
-  // shift everything to the left
-  for(i = 0; i <= max-min; i++)
-    string[i] = string[i+min];
-  string[i] = '\0';
-}
-
-
 //
 // Returns true if "word" is found in the comma-separated list of
 // keywords
@@ -889,16 +809,17 @@ bool is_keyword(const char *keywords, const char *word, bool abbrev_ok) {
 // keywords. Returns the length of the keyword if it does match
 int find_keyword(const char *keywords, const char *string) {
   LIST           *words = parse_keywords(keywords);
-  LIST_ITERATOR *word_i = newListIterator(words);
+  LIST_ITERATOR word_i;
+  listIteratorStart(&word_i, words);
   char            *word = NULL;
   int               len = 0;
 
   // try to find the longest keyword
-  ITERATE_LIST(word, word_i) {
+  ITERATE_LIST(word, &word_i) {
     int word_len = strlen(word);
     if(!strncasecmp(word, string, word_len) && word_len > len)
       len = word_len;
-  } deleteListIterator(word_i);
+  } listIteratorStop(&word_i);
   deleteListWith(words, free);
 
   return len;
@@ -1007,19 +928,20 @@ void remove_keyword(char *keywords, const char *word) {
 
   // did we find a copy of the bad keyword?
   if(count > 0) {
-    LIST_ITERATOR *word_i = newListIterator(words);
+    LIST_ITERATOR word_i;
+    listIteratorStart(&word_i, words);
     int             key_i = 0;
     count = 0;
 
     // clear the current keywords... we'll rebuild them
     *keywords = '\0';
 
-    ITERATE_LIST(copy, word_i) {
+    ITERATE_LIST(copy, &word_i) {
       count++;
       key_i += sprintf(keywords+key_i, "%s", copy);
       if(count < listSize(words) - 1)
 	key_i += sprintf(keywords+key_i, ", ");
-    } deleteListIterator(word_i);
+    } listIteratorStop(&word_i);
   }
 
   // clean up our garbage
@@ -1269,7 +1191,8 @@ char *print_list(LIST *list, void *descriptor, void *multi_descriptor) {
   int counts[size];
   void *things[size];
   void *thing;
-  LIST_ITERATOR *thing_i = newListIterator(list);
+  LIST_ITERATOR thing_i;
+  listIteratorStart(&thing_i, list);
 
   for(i = 0; i < size; i++) {
     counts[i] = 0;
@@ -1277,7 +1200,7 @@ char *print_list(LIST *list, void *descriptor, void *multi_descriptor) {
   }
 
   // first, collect groups of all the things in the list
-  ITERATE_LIST(thing, thing_i) {
+  ITERATE_LIST(thing, &thing_i) {
     // see if we have one with the current name already
     for(i = 0; i < size; i++) {
       // it's a thing with a new name
@@ -1293,7 +1216,7 @@ char *print_list(LIST *list, void *descriptor, void *multi_descriptor) {
 	break;
       }
     }
-  } deleteListIterator(thing_i);
+  } listIteratorStop(&thing_i);
 
 
   // now, print everything to the buffer
@@ -1330,7 +1253,8 @@ void show_list(CHAR_DATA *ch, LIST *list, void *descriptor,
   int counts[size];
   void *things[size];
   void *thing;
-  LIST_ITERATOR *thing_i = newListIterator(list);
+  LIST_ITERATOR thing_i;
+  listIteratorStart(&thing_i, list);
 
   for(i = 0; i < size; i++) {
     counts[i] = 0;
@@ -1338,7 +1262,7 @@ void show_list(CHAR_DATA *ch, LIST *list, void *descriptor,
   }
 
   // find a list of all things with unique names
-  ITERATE_LIST(thing, thing_i) {
+  ITERATE_LIST(thing, &thing_i) {
     // see if we have one with the current name already
     for(i = 0; i < size; i++) {
       // it's a thing with a new name
@@ -1353,7 +1277,7 @@ void show_list(CHAR_DATA *ch, LIST *list, void *descriptor,
 	break;
       }
     }
-  } deleteListIterator(thing_i);
+  } listIteratorStop(&thing_i);
 
 
   // print out all of the things
@@ -1379,31 +1303,33 @@ void show_list(CHAR_DATA *ch, LIST *list, void *descriptor,
 LIST *get_unused_items(CHAR_DATA *ch, LIST *list, bool invis_ok) {
   OBJ_DATA *obj;
   LIST *newlist = newList();
-  LIST_ITERATOR *obj_i = newListIterator(list);
+  LIST_ITERATOR obj_i;
+  listIteratorStart(&obj_i, list);
 
-  ITERATE_LIST(obj, obj_i) {
+  ITERATE_LIST(obj, &obj_i) {
     if(listSize(objGetUsers(obj)) != 0)
       continue;
     if(!(invis_ok || can_see_obj(ch, obj)))
       continue;
 
     listPut(newlist, obj);
-  } deleteListIterator(obj_i);
+  } listIteratorStop(&obj_i);
   return newlist;
 }
 
 LIST *get_used_items(CHAR_DATA *ch, LIST *list, bool invis_ok) {
   OBJ_DATA *obj;
   LIST *newlist = newList();
-  LIST_ITERATOR *obj_i = newListIterator(list);
+  LIST_ITERATOR obj_i;
+  listIteratorStart(&obj_i, list);
 
-  ITERATE_LIST(obj, obj_i) {
+  ITERATE_LIST(obj, &obj_i) {
     if(listSize(objGetUsers(obj)) < 1)
       continue;
     if(!(invis_ok || can_see_obj(ch, obj)))
       continue;
     listPut(newlist, obj);
-  } deleteListIterator(obj_i);
+  } listIteratorStop(&obj_i);
   return newlist;
 }
 
@@ -1422,11 +1348,12 @@ void *identity_func(void *data) {
 
 LIST *reverse_list(LIST *list) {
   LIST         *newlist = newList();
-  LIST_ITERATOR *list_i = newListIterator(list);
+  LIST_ITERATOR list_i;
+  listIteratorStart(&list_i, list);
   void            *elem = NULL;
-  ITERATE_LIST(elem, list_i) {
+  ITERATE_LIST(elem, &list_i) {
     listPut(newlist, elem);
-  } deleteListIterator(list_i);
+  } listIteratorStop(&list_i);
   return newlist;
 }
 
@@ -1640,18 +1567,19 @@ void do_list(CHAR_DATA *ch, const char *locale, const char *type,
     const char *(* info_func)(void *) = informer;
     LIST *name_list = zoneGetTypeKeys(zone, type);
     listSortWith(name_list, strcasecmp);
-    LIST_ITERATOR *name_i = newListIterator(name_list);
+    LIST_ITERATOR name_i;
+    listIteratorStart(&name_i, name_list);
     char            *name = NULL;
     BUFFER           *buf = newBuffer(1);
     void            *data = NULL;
     bprintf(buf, " {wKey %74s \r\n"
 "{b--------------------------------------------------------------------------------{n\r\n", header);
-    ITERATE_LIST(name, name_i) {
+    ITERATE_LIST(name, &name_i) {
       data = worldGetType(gameworld, type, get_fullkey(name, locale));
       if(data != NULL)
 	bprintf(buf, " {c%-20s %57s{n\r\n", name, 
 		(info_func ? info_func(zoneGetType(zone, type, name)) : ""));
-    } deleteListIterator(name_i);
+    } listIteratorStop(&name_i);
     deleteListWith(name_list, free);
     page_string(charGetSocket(ch), bufferString(buf));
     deleteBuffer(buf);
@@ -8,10 +8,12 @@
 //
 //*****************************************************************************
 
+#include <fcntl.h>
 #include "../mud.h"
 #include "../utils.h"
 #include "../inform.h"
 #include "../event.h"
+#include "../io_poll.h"
 
 #include "webserver.h"
 
@@ -48,6 +50,7 @@ void deleteWebSocket(WEB_SOCKET *sock) {
 }
 
 void webSocketClose(WEB_SOCKET *sock) {
+  ioPollRemove(sock->control);
   close(sock->control);
 }
 
@@ -223,53 +226,54 @@ BUFFER *build_who_html(HASHTABLE *args) {
 }
 
 //
-// the main loop for our web server
-void webserver_loop(void *owner, void *data, char *arg) {
-  WEB_SOCKET  *conn = NULL;
-  struct timeval tv = { 0, 0 }; // we don't wait for any action.
-  fd_set read_fd;
-
-  // get our sets all done up
-  FD_ZERO(&read_fd);
-  FD_SET(web_control, &read_fd);
-
-  // check to see if something happens
-  select(FD_SETSIZE, &read_fd, NULL, NULL, &tv);
-
-  // check for a new connection
-  if(FD_ISSET(web_control, &read_fd)) {
-    conn = newWebSocket();
-    unsigned int socksize;
-
-    // try to accept the connection
-    if((conn->control = accept(web_control, (struct sockaddr *)&conn->addr, 
-			       &socksize)) > 0) {
-      listQueue(web_descs, conn);
-      FD_SET(conn->control, &read_fd);
-    }
+// called by the mud's readiness backend when a connection has sent us
+// something. Read everything that is waiting for us
+void webserver_read(int fd, void *data) {
+  WEB_SOCKET *conn = data;
+  int       in_len = 0;
+
+  while(conn->buf_len < MAX_INPUT_LEN - 1 &&
+	(in_len = read(conn->control, conn->inbuf + conn->buf_len, 
+		       MAX_INPUT_LEN - conn->buf_len - 1)) > 0) {
+    conn->buf_len += in_len;
+    conn->inbuf[conn->buf_len] = '\0';
   }
 
+  if(in_len < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+    webSocketClose(conn);
+    listRemove(web_descs, conn);
+    deleteWebSocket(conn);
+  }
+}
 
-  // do input handling
-  LIST_ITERATOR *conn_i = newListIterator(web_descs);
-  ITERATE_LIST(conn, conn_i) {
-    if(FD_ISSET(conn->control, &read_fd)) {
-      int in_len = read(conn->control, conn->inbuf + conn->buf_len, 
-			MAX_INPUT_LEN - conn->buf_len - 1);
-      if(in_len > 0) {
-	conn->buf_len += in_len;
-	conn->inbuf[conn->buf_len] = '\0';
-      }
-      else if(in_len < 0) {
-	webSocketClose(conn);
-	listRemove(web_descs, conn);
-	deleteWebSocket(conn);
-      }
-    }
-  } deleteListIterator(conn_i);
+//
+// called by the mud's readiness backend when someone is trying to connect
+// to the webserver. Accept everyone who is waiting
+void webserver_accept(int fd, void *data) {
+  WEB_SOCKET *conn = newWebSocket();
+  socklen_t socksize = sizeof(conn->addr);
+
+  while((conn->control = accept(web_control, (struct sockaddr *)&conn->addr, 
+				&socksize)) >= 0) {
+    fcntl(conn->control, F_SETFL, O_NONBLOCK);
+    listQueue(web_descs, conn);
+    ioPollAdd(conn->control, webserver_read, conn);
+
+    conn     = newWebSocket();
+    socksize = sizeof(conn->addr);
+  }
+  deleteWebSocket(conn);
+}
+
+//
+// the main loop for our web server. Connections and input are handled when
+// they happen by webserver_accept and webserver_read; all we need to do is
+// reply to whoever has finished sending their request
+void webserver_loop(void *owner, void *data, char *arg) {
+  WEB_SOCKET  *conn = NULL;
 
   // do output handling
-  conn_i = newListIterator(web_descs);
+  LIST_ITERATOR *conn_i = newListIterator(web_descs);
   ITERATE_LIST(conn, conn_i) {
     // which version are we dealing with, and do we have a request terminator?
     // If we haven't gotten the terminator yet, don't handle or close the socket
@@ -322,8 +326,10 @@ void init_webserver(void) {
         exit(1);
   }
 
-  // set the socket control
+  // set the socket control, and let the mud tell us about new connections
   web_control = sockfd;
+  fcntl(web_control, F_SETFL, O_NONBLOCK);
+  ioPollAdd(web_control, webserver_accept, NULL);
 
   // set up our list of connected sockets, and get the updater rolling
   web_descs   = newList();
@@ -340,8 +346,9 @@ void finalize_webserver(void) {
   WEB_SOCKET      *conn = NULL;
   LIST_ITERATOR *conn_i = newListIterator(web_descs);
   ITERATE_LIST(conn, conn_i) {
-    close(conn->control);
+    webSocketClose(conn);
   } deleteListIterator(conn_i);
+  ioPollRemove(web_control);
   close(web_control);
 }
 
@@ -167,7 +167,7 @@ void zonePulse(ZONE_DATA *zone) {
   zone->pulse--;
   if(zone->pulse == 0) {
     zone->pulse = zone->pulse_timer;
-    hookRun("reset_zone", hookBuildInfo("str", zoneGetKey(zone)));
+    hookRunTyped("reset_zone", "str", zoneGetKey(zone));
   }
 }
 